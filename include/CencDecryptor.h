@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "FMP4StreamParser.h"
+#include "ISOBMFF/SENC.hpp"
+
+// Decrypts Common Encryption samples in place, in the mdat data of a fragment.
+// Supports the 'cenc' (AES-128 CTR) and 'cbcs' (AES-128 CBC with a crypt/skip pattern) schemes, with
+// subsample maps from the senc box. AES-NI is used when the CPU has it, a table based implementation otherwise.
+// A decryptor is not thread-safe: use one per stream, or serialize the calls.
+class CencDecryptor {
+public:
+    static constexpr size_t KeySize = 16;
+
+    // scheme is the schm scheme type, FourCC("cenc") or FourCC("cbcs").
+    // With threadCount > 1, the samples of large fragments are decrypted on that many threads.
+    // Throws std::runtime_error for other schemes and key sizes.
+    CencDecryptor(uint32_t scheme, const uint8_t *key, size_t keySize, size_t threadCount = 1);
+    ~CencDecryptor();
+
+    CencDecryptor(const CencDecryptor&) = delete;
+    CencDecryptor& operator=(const CencDecryptor&) = delete;
+
+    // cbcs pattern in 16-byte blocks, used when decrypt() gets no tenc. 0/0 decrypts every block.
+    void setPattern(uint8_t cryptByteBlock, uint8_t skipByteBlock);
+
+    // Decrypts the samples of every traf with a senc box in fragment.mdat, in place, and returns their count.
+    // Samples are located with the tfhd and trun data offsets. The tenc of the track gives the IV size,
+    // constant IV and pattern; nothing is decrypted if it marks the track as clear. It is required for
+    // constant IV schemes such as cbcs, whose senc box has no IVs. Without a tenc, fragments without a senc
+    // box are clear. A passed-through mdat, whose payload is not kept, is left alone.
+    // Throws std::runtime_error if a protected fragment has no senc box, a sample lies outside the mdat box,
+    // has no IV, or its subsamples exceed the sample size.
+    size_t decrypt(const Fragment &fragment, const ISOBMFF::TENC *tenc = nullptr);
+
+    // Decrypts one sample in place with the configured pattern.
+    void decryptSample(uint8_t *data, size_t size, const ISOBMFF::SENC::Sample &encryption) const;
+
+    static bool hasHardwareAes();
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_impl;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Cuts a time range out of a progressive MP4 into a new progressive MP4 with moov first: ftyp, moov, then a
+// single mdat with the samples of the range.
+// Each track starts at its last sync sample presented at or before the start of the range, so that decoding
+// needs nothing from before the clip, and an edit list hides the samples before the exact start and after the
+// end. Times are presentation times of the source, edit lists included.
+// Only moov is parsed: the sample tables of the clip are built from the source tables, and the chunks of the
+// range are copied from the source file by a RangeCopier, so the cost follows the size of the clip, not of the
+// source.
+// The output descriptor is written at its current position and is not closed. Not thread-safe.
+class Clipper {
+public:
+    // Parses the metadata and selects the samples from start to end, in seconds. Throws std::runtime_error if
+    // the file cannot be read, is fragmented, has inconsistent sample tables, no samples in the range, or a
+    // selected track with per-sample boxes the clip does not rebuild (sample auxiliary information, sample groups,
+    // sdtp, subs, ...).
+    Clipper(const std::string &path, double start, double end);
+    ~Clipper();
+
+    Clipper(const Clipper&) = delete;
+    Clipper& operator=(const Clipper&) = delete;
+
+    // Writes the clip. Throws std::runtime_error on I/O errors.
+    void write(int fd);
+
+    // Presentation time, in seconds, of the sync sample the first track with sync samples starts at.
+    double keyframeTime() const;
+    uint64_t sampleCount() const;
+    // Sample payload bytes copied, and the system calls copying them, over all writes.
+    uint64_t bytesCopied() const;
+    uint64_t copyCalls() const;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_impl;
+};
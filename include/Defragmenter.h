@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Remuxes fragmented MP4 into a progressive MP4 with moov first (faststart): ftyp, moov, then a single mdat.
+// The input is one fragmented file, or an init segment followed by media segment files, as recorded from a live
+// stream. The moof boxes are turned into run-length sample tables: stts and ctts runs, stss only when some
+// samples are not sync samples, a single stsz size when all samples have it, stsc entries only when the run
+// length changes, and co64 instead of stco when offsets need it. Each trun becomes a chunk.
+// Sample data is never read: the trun ranges of each source file are copied to the output by a RangeCopier.
+// Decoding time gaps between fragments are added to the duration of the last sample before them, and tracks
+// starting later than others get an empty edit, so that they stay in sync.
+// The output descriptor is written at its current position and is not closed. Not thread-safe.
+class Defragmenter {
+public:
+    // Parses the metadata of the files. Throws std::runtime_error if a file cannot be read, there is no moov box
+    // before the first moof, or the fragments use features that progressive files cannot carry (sample
+    // encryption).
+    explicit Defragmenter(const std::string &path);
+    explicit Defragmenter(const std::vector<std::string> &paths);
+    ~Defragmenter();
+
+    Defragmenter(const Defragmenter&) = delete;
+    Defragmenter& operator=(const Defragmenter&) = delete;
+
+    // Writes the progressive file. Throws std::runtime_error on I/O errors.
+    void write(int fd);
+
+    uint32_t fragmentCount() const;
+    uint64_t sampleCount() const;
+    // Sample payload bytes copied, and the system calls copying them, over all writes.
+    uint64_t bytesCopied() const;
+    uint64_t copyCalls() const;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_impl;
+};
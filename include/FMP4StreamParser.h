@@ -2,30 +2,163 @@
 
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
 #include "ISOBMFF/IParser.hpp"
 #include "ISOBMFF/SIDX.hpp"
 #include "ISOBMFF/ContainerBox.hpp"
+#include "ISOBMFF/SENC.hpp"
+#include "ISOBMFF/Utils.hpp"
+
+namespace ISOBMFF {
+    class FTYP; class MVHD; class MFHD; class TKHD; class META; class HDLR; class PITM; class IINF;
+    class DREF; class URL;  class URN;  class ILOC; class IREF; class INFE; class IROT; class HVCC;
+    class DIMG; class THMB; class CDSC; class COLR; class ISPE; class IPMA; class PIXI; class IPCO;
+    class STSD; class FRMA; class SCHM; class TRUN; class TFHD; class TFDT; class TENC; class PSSH;
+    class SAIZ; class SAIO; class AVCC; class ESDS; class MDHD; class STTS; class CTTS; class STSS;
+    class STSZ; class STSC; class STCO; class MEHD; class TREX; class ELST;
+}
+
+// Box type of a box class, for FMP4StreamParser::on<BoxType>()
+template<class BoxType> struct BoxFourCC;
+
+#define FMP4_BOX_FOURCC(BoxType, name) \
+    template<> struct BoxFourCC<ISOBMFF::BoxType> { static constexpr uint32_t value = ISOBMFF::Utils::FourCC(name); };
+FMP4_BOX_FOURCC(FTYP, "ftyp")
+FMP4_BOX_FOURCC(MVHD, "mvhd")
+FMP4_BOX_FOURCC(MFHD, "mfhd")
+FMP4_BOX_FOURCC(TKHD, "tkhd")
+FMP4_BOX_FOURCC(META, "meta")
+FMP4_BOX_FOURCC(HDLR, "hdlr")
+FMP4_BOX_FOURCC(PITM, "pitm")
+FMP4_BOX_FOURCC(IINF, "iinf")
+FMP4_BOX_FOURCC(DREF, "dref")
+FMP4_BOX_FOURCC(URL, "url ")
+FMP4_BOX_FOURCC(URN, "urn ")
+FMP4_BOX_FOURCC(ILOC, "iloc")
+FMP4_BOX_FOURCC(IREF, "iref")
+FMP4_BOX_FOURCC(INFE, "infe")
+FMP4_BOX_FOURCC(IROT, "irot")
+FMP4_BOX_FOURCC(HVCC, "hvcC")
+FMP4_BOX_FOURCC(AVCC, "avcC")
+FMP4_BOX_FOURCC(DIMG, "dimg")
+FMP4_BOX_FOURCC(THMB, "thmb")
+FMP4_BOX_FOURCC(CDSC, "cdsc")
+FMP4_BOX_FOURCC(COLR, "colr")
+FMP4_BOX_FOURCC(ISPE, "ispe")
+FMP4_BOX_FOURCC(IPMA, "ipma")
+FMP4_BOX_FOURCC(PIXI, "pixi")
+FMP4_BOX_FOURCC(IPCO, "ipco")
+FMP4_BOX_FOURCC(STSD, "stsd")
+FMP4_BOX_FOURCC(SIDX, "sidx")
+FMP4_BOX_FOURCC(FRMA, "frma")
+FMP4_BOX_FOURCC(SCHM, "schm")
+FMP4_BOX_FOURCC(TRUN, "trun")
+FMP4_BOX_FOURCC(TFHD, "tfhd")
+FMP4_BOX_FOURCC(TFDT, "tfdt")
+FMP4_BOX_FOURCC(TENC, "tenc")
+FMP4_BOX_FOURCC(PSSH, "pssh")
+FMP4_BOX_FOURCC(SENC, "senc")
+FMP4_BOX_FOURCC(SAIZ, "saiz")
+FMP4_BOX_FOURCC(SAIO, "saio")
+FMP4_BOX_FOURCC(ESDS, "esds")
+FMP4_BOX_FOURCC(MDHD, "mdhd")
+FMP4_BOX_FOURCC(STTS, "stts")
+FMP4_BOX_FOURCC(CTTS, "ctts")
+FMP4_BOX_FOURCC(STSS, "stss")
+FMP4_BOX_FOURCC(STSZ, "stsz")
+FMP4_BOX_FOURCC(STSC, "stsc")
+FMP4_BOX_FOURCC(STCO, "stco")
+FMP4_BOX_FOURCC(MEHD, "mehd")
+FMP4_BOX_FOURCC(TREX, "trex")
+FMP4_BOX_FOURCC(ELST, "elst")
+#undef FMP4_BOX_FOURCC
 
 struct Frame {
     int64_t pts{-1};
     std::vector<uint8_t > data;
 };
 
+struct SampleInfo {
+    int64_t  pts{-1};
+    uint32_t size{0};
+    uint64_t offset{0};                 // Stream position of the sample data, from the tfhd and trun offsets
+    uint32_t trackID{0};
+    bool     hasEncryption{false};      // The traf has a senc box
+    ISOBMFF::SENC::Sample encryption;   // From the traf's senc box; empty for clear samples
+};
+
 struct Fragment {
+    // Samples of every traf, in traf order. tenc gives the IV size of the senc entries, which is guessed
+    // from the senc payload otherwise. With a constant IV in tenc, every encrypted sample points to it.
+    std::vector<SampleInfo> getSampleInfo(const ISOBMFF::TENC *tenc = nullptr) const;
+    // Empty if the mdat payload was not kept. Throws if a sample lies outside the mdat box.
     std::vector<Frame> getFrames() const;
     bool isComplete() const;
     void clear();
 
     std::shared_ptr<ISOBMFF::SIDX>          sidx;
     std::shared_ptr<ISOBMFF::ContainerBox>  moof;
-    std::shared_ptr<ISOBMFF::ContainerBox>  mdat;
+    std::shared_ptr<ISOBMFF::ContainerBox>  mdat;     // Data skipped if the payload was passed through
+    uint64_t                                moofOffset{0};    // Stream position of the moof box header
+
+    // styp, prft and emsg boxes received since the previous fragment, in stream order
+    std::vector<std::shared_ptr<ISOBMFF::Box>> leadingBoxes;
+};
+
+// Byte budget shared by several parsers. Bytes are reserved before they are read from the input
+// and released once the data they hold has been consumed.
+class FMP4BufferBudget {
+public:
+    explicit FMP4BufferBudget(size_t limit);
+
+    // Reserves up to maxBytes and returns the number of bytes actually reserved.
+    size_t acquire(size_t maxBytes);
+    void release(size_t bytes);
+
+    size_t limit() const;
+    size_t used() const;
+    size_t highWaterMark() const;
+
+private:
+    const size_t        m_limit;
+    std::atomic<size_t> m_used{0};
+    std::atomic<size_t> m_highWaterMark{0};
 };
 
 class FMP4StreamParser {
 public:
+    enum class ParseStatus : uint8_t {
+        Ok = 0u,
+        Backpressure    // Reading stopped because a buffer budget is exhausted
+    };
+
+    struct Stats {
+        size_t   bufferedBytes{0};      // Input read but not parsed yet
+        size_t   outstandingBytes{0};   // mdat data of delivered fragments that is still referenced
+        size_t   highWaterMark{0};      // Maximum of bufferedBytes + outstandingBytes
+        uint64_t bytesRead{0};
+        uint64_t backpressureCount{0};
+    };
+
+    using BoxCallback                   = std::function<void(const ISOBMFF::Box&)>;
+    // type is the packed box type, see ISOBMFF::Utils::FourCC. size is 0 for a box running to the end of the stream.
+    using SkippedBoxCallback            = std::function<void(uint32_t type, uint64_t size)>;
     using ParsedTopLevelBoxCallback     = std::function<void(const ISOBMFF::Box*)>;
     using SkippedTopLevelBoxCallback    = std::function<void(const std::string&)>;
     using FragmentCallback              = std::function<void(const Fragment&)>;
+    using MdatDataCallback              = std::function<void(const uint8_t *data, size_t size)>;
+    using SamplesCallback               = std::function<void(const std::vector<Frame>&)>;
+    // type is the packed box type, see ISOBMFF::Utils::FourCC
+    using PassThroughDataCallback       = std::function<void(uint32_t type, const uint8_t *data, size_t size)>;
+
+    // What happens to a top-level box, decided from its header alone
+    enum class BoxAction : uint8_t {
+        Parse = 0u,     // Buffered completely and parsed into a box object
+        Skip,           // Dropped as it arrives and reported to onSkippedBox
+        PassThrough     // Payload forwarded as it arrives, to onMdatData for mdat and onPassThroughData otherwise
+    };
 
     FMP4StreamParser();
     ~FMP4StreamParser();
@@ -33,14 +166,76 @@ public:
     // Current stream position needs to be at least 8-byte aligned in the mp4 stream.
     void setInputStream(std::istream *input);
 
-    void parse();
+    ParseStatus parse();
+
+    // Push input, instead of an input stream: appends data and parses as far as possible.
+    // Reports backpressure while the bytes held exceed the buffer limit, or the shared budget cannot cover them.
+    ParseStatus parse(const uint8_t *data, size_t size);
+
+    // Marks the end of pushed input. Completes a box running to the end of the stream.
+    void setEndOfStream();
 
     bool isEOS() const;
 
+    // Parsed boxes of a type: top-level boxes, and boxes nested in parsed top-level boxes right after them.
+    // The type is resolved to a slot here, delivery is a direct call. Subscribe before parsing.
+    void on(uint32_t type, const BoxCallback &callback);
+
+    // Typed variant, e.g. on<ISOBMFF::TRUN>([](const ISOBMFF::TRUN &trun) { ... }).
+    template<class BoxType>
+    void on(const std::function<void(const BoxType&)> &callback) {
+        on(BoxFourCC<BoxType>::value, [callback](const ISOBMFF::Box &box) {
+            callback(static_cast<const BoxType&>(box));
+        });
+    }
+
+    // Skipped top-level boxes of a type.
+    void onSkipped(uint32_t type, const SkippedBoxCallback &callback);
+
+    // Name-based variants of on() and onSkipped().
     void onParsedBox(const std::string  &boxName, const ParsedTopLevelBoxCallback  &callback);
     void onSkippedBox(const std::string &boxName, const SkippedTopLevelBoxCallback &callback);
     void onFragment(const FragmentCallback &fragmentCB);
 
+    // Payload of passed-through mdat boxes, delivered as it arrives. The fragment's mdat box holds no data then.
+    void onMdatData(const MdatDataCallback &callback);
+
+    // mdat boxes with a payload larger than this, or running to the end of the stream (size 0),
+    // are passed through incrementally instead of being buffered. Disabled by default.
+    void setMdatPassThroughThreshold(uint64_t bytes);
+
+    // Delivers every moof+mdat pair as a fragment as soon as it is complete, without waiting for a sidx
+    // (CMAF low-latency chunks). Sample timing is taken from tfdt.
+    void setChunkedMode(bool enabled);
+
+    // Delivers each fragment's samples in batches of up to batchSize as soon as their bytes arrive.
+    // mdat boxes are then passed through, so at most one incomplete sample is buffered.
+    void onSamples(const SamplesCallback &callback, size_t batchSize = 1);
+
+    // Sets the action for a top-level box type. ftyp, styp, sidx, prft, emsg, moof and mdat are parsed
+    // by default, every other type is skipped. Fragments are only delivered while moof and mdat are handled.
+    void setBoxAction(const std::string &type, BoxAction action);
+
+    // Payload of boxes other than mdat whose action is BoxAction::PassThrough.
+    void onPassThroughData(const PassThroughDataCallback &callback);
+
+    // Reuses box objects, and the capacity of their buffers, from fragment to fragment. A box is reused once
+    // no reference to it or to its parent is held outside the parser, so fragments may still be kept.
+    // Only the fragment boxes (ftyp, sidx, moof and its children, mdat) and unregistered boxes are reused.
+    // After warm-up a stream of fixed-shape fragments is parsed without heap allocations.
+    void setBoxRecycling(bool enabled);
+
+    // Caps the bytes held by this parser: unparsed input plus the mdat data of delivered fragments
+    // that callers still reference. Past the limit parse() stops reading and reports backpressure.
+    // mdat boxes that cannot fit are passed through. Unlimited by default.
+    void setBufferLimit(size_t bytes);
+
+    // Additionally charges this parser's bytes against a budget shared with other parsers. Data pushed with
+    // parse(data, size) is charged too, and parse() reports backpressure when the budget cannot cover it.
+    void setSharedBudget(const std::shared_ptr<FMP4BufferBudget> &budget);
+
+    Stats getStats() const;
+
 private:
     struct Private;
     std::unique_ptr<Private> m_impl;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Rewrites a progressive MP4 with moov at the end so that moov comes before the first mdat, and players can
+// start without fetching the end of the file first. Boxes before the first mdat (ftyp, ...) stay first, then
+// moov, then the other boxes in their original order.
+// Only the metadata is parsed and kept in memory. Chunk offsets are moved by the size of moov, per top-level
+// box, and stco tables whose offsets no longer fit in 32 bits become co64 tables; this makes moov larger, so the
+// layout is planned again until it no longer changes. The saio offsets of the sample tables (CENC auxiliary
+// information) are moved the same way, with 64-bit offsets when needed. The boxes other than moov are copied unchanged from the
+// source file by a RangeCopier, in one pass.
+// The output descriptor is written at its current position and is not closed. Not thread-safe.
+class Faststart {
+public:
+    // Parses the metadata and plans the new layout. Throws std::runtime_error if the file cannot be read, has
+    // no moov box, is fragmented, has chunk or saio offsets outside of the boxes other than moov, meta items
+    // stored at file offsets (iloc construction method 0), or boxes in moov that cannot be written back unchanged
+    // (e.g. unknown boxes larger than the parser skip threshold).
+    explicit Faststart(const std::string &path);
+    ~Faststart();
+
+    Faststart(const Faststart&) = delete;
+    Faststart& operator=(const Faststart&) = delete;
+
+    // Writes the rewritten file, or a copy of the source if moov already comes first. Throws std::runtime_error
+    // on I/O errors.
+    void write(int fd);
+
+    // Whether moov already comes before the first mdat.
+    bool isFaststart() const;
+    // stco tables replaced by co64 tables.
+    uint32_t promotedTables() const;
+    uint64_t moovSize() const;
+    // Bytes copied from the source, and the system calls copying them, over all writes.
+    uint64_t bytesCopied() const;
+    uint64_t copyCalls() const;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_impl;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Remuxes a progressive MP4 (sample tables in moov) into fragmented MP4: an init segment (ftyp, moov with mvex
+// and empty sample tables), an optional sidx, then one moof+mdat fragment per keyframe-aligned interval.
+// Fragments are cut at sync samples of the reference track (the first track with an stss box, else the first
+// track) once the target duration is reached, other tracks are cut at the same time.
+// Only the metadata is parsed: sample payloads are copied from the source file to the output descriptor by a
+// RangeCopier, with copy_file_range() or its fallbacks.
+// The output descriptor is written at its current position and is not closed. Not thread-safe.
+class Fragmenter {
+public:
+    struct Options {
+        // Minimum fragment duration, in seconds. Fragments are longer when keyframes are further apart.
+        double fragmentDuration{2.0};
+        // Track to keep, 0 for all tracks. A single track gives one track per file, as CMAF expects.
+        uint32_t trackID{0};
+        // Writes a sidx box indexing the fragments before the first moof.
+        bool sidx{true};
+    };
+
+    // Parses the metadata and plans the fragments. Throws std::runtime_error if the file cannot be read, is
+    // already fragmented, has no such track, inconsistent sample tables, or a selected track that is protected
+    // or has sample groups, which the fragments would not carry.
+    explicit Fragmenter(const std::string &path);
+    Fragmenter(const std::string &path, const Options &options);
+    ~Fragmenter();
+
+    Fragmenter(const Fragmenter&) = delete;
+    Fragmenter& operator=(const Fragmenter&) = delete;
+
+    // Writes the init segment and the media segments. Throws std::runtime_error on I/O errors.
+    void write(int fd);
+    // ftyp and moov.
+    void writeInitSegment(int fd);
+    // sidx, if enabled, then the fragments.
+    void writeMediaSegments(int fd);
+
+    uint32_t fragmentCount() const;
+    // Sample payload bytes copied, and the system calls copying them, over all writes.
+    uint64_t bytesCopied() const;
+    uint64_t copyCalls() const;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_impl;
+};
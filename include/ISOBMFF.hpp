@@ -35,6 +35,7 @@
 #include <ISOBMFF/Utils.hpp>
 #include <ISOBMFF/Parser.hpp>
 #include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/DisplayableObject.hpp>
 #include <ISOBMFF/DisplayableObjectContainer.hpp>
 #include <ISOBMFF/Box.hpp>
@@ -58,6 +59,7 @@
 #include <ISOBMFF/INFE.hpp>
 #include <ISOBMFF/IROT.hpp>
 #include <ISOBMFF/HVCC.hpp>
+#include <ISOBMFF/AVCC.hpp>
 #include <ISOBMFF/SingleItemTypeReferenceBox.hpp>
 #include <ISOBMFF/DIMG.hpp>
 #include <ISOBMFF/THMB.hpp>
@@ -68,9 +70,26 @@
 #include <ISOBMFF/PIXI.hpp>
 #include <ISOBMFF/IPCO.hpp>
 #include <ISOBMFF/ImageGrid.hpp>
+#include <ISOBMFF/ItemIndex.hpp>
+#include <ISOBMFF/GridPlan.hpp>
 #include <ISOBMFF/STSD.hpp>
+#include <ISOBMFF/SampleEntry.hpp>
+#include <ISOBMFF/VisualSampleEntry.hpp>
+#include <ISOBMFF/AudioSampleEntry.hpp>
+#include <ISOBMFF/ESDS.hpp>
 #include <ISOBMFF/FRMA.hpp>
 #include <ISOBMFF/SCHM.hpp>
+#include <ISOBMFF/MDHD.hpp>
+#include <ISOBMFF/STTS.hpp>
+#include <ISOBMFF/CTTS.hpp>
+#include <ISOBMFF/STSS.hpp>
+#include <ISOBMFF/STSZ.hpp>
+#include <ISOBMFF/STSC.hpp>
+#include <ISOBMFF/STCO.hpp>
+#include <ISOBMFF/MEHD.hpp>
+#include <ISOBMFF/TREX.hpp>
+#include <ISOBMFF/ELST.hpp>
+#include <ISOBMFF/SampleTable.hpp>
 
 #ifdef _WIN32
 #include <ISOBMFF/WIN32.hpp>
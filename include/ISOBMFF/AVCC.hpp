@@ -0,0 +1,79 @@
+/*!
+ * @header      AVCC.hpp
+ */
+
+#ifndef ISOBMFF_AVCC_HPP
+#define ISOBMFF_AVCC_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/Box.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       AVCC
+     * @abstract    AVC decoder configuration record (ISO/IEC 14496-15).
+     * @discussion  The chroma format and bit depths, and the SPS extensions,
+     *              are only present for the High profiles (100, 110, 122
+     *              and 144), and are often omitted even then.
+     */
+    class ISOBMFF_EXPORT AVCC: public Box, public XS::PIMPL::Object< AVCC >
+    {
+        public:
+            
+            using XS::PIMPL::Object< AVCC >::impl;
+            
+            AVCC( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            uint8_t GetConfigurationVersion( void )    const;
+            uint8_t GetAVCProfileIndication( void )    const;
+            uint8_t GetProfileCompatibility( void )    const;
+            uint8_t GetAVCLevelIndication( void )      const;
+            uint8_t GetLengthSizeMinusOne( void )      const;
+            bool    HasHighProfileFields( void )       const;
+            uint8_t GetChromaFormat( void )            const;
+            uint8_t GetBitDepthLumaMinus8( void )      const;
+            uint8_t GetBitDepthChromaMinus8( void )    const;
+            
+            void SetConfigurationVersion( uint8_t value );
+            void SetAVCProfileIndication( uint8_t value );
+            void SetProfileCompatibility( uint8_t value );
+            void SetAVCLevelIndication( uint8_t value );
+            void SetLengthSizeMinusOne( uint8_t value );
+            void SetChromaFormat( uint8_t value );
+            void SetBitDepthLumaMinus8( uint8_t value );
+            void SetBitDepthChromaMinus8( uint8_t value );
+            
+            const std::vector< std::vector< uint8_t > > & GetSequenceParameterSets( void )          const;
+            const std::vector< std::vector< uint8_t > > & GetPictureParameterSets( void )           const;
+            const std::vector< std::vector< uint8_t > > & GetSequenceParameterSetExtensions( void ) const;
+            
+            void AddSequenceParameterSet( const std::vector< uint8_t > & value );
+            void AddPictureParameterSet( const std::vector< uint8_t > & value );
+            void AddSequenceParameterSetExtension( const std::vector< uint8_t > & value );
+            
+            /*!
+             * @function    GetParameterSets
+             * @abstract    Gets the parameter sets in Annex-B form.
+             * @result      The SPS, PPS and SPS extension NAL units, each
+             *              preceded by a 4-byte start code.
+             * @discussion  The data is built once, when the box is read or
+             *              a parameter set is added, and is never modified
+             *              afterwards: it can be shared by every consumer of
+             *              the track, on any thread.
+             */
+            std::shared_ptr< const std::vector< uint8_t > > GetParameterSets( void ) const;
+    };
+}
+
+#endif /* ISOBMFF_AVCC_HPP */
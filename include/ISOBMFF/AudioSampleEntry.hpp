@@ -0,0 +1,54 @@
+/*!
+ * @header      AudioSampleEntry.hpp
+ */
+
+#ifndef ISOBMFF_AUDIO_SAMPLE_ENTRY_HPP
+#define ISOBMFF_AUDIO_SAMPLE_ENTRY_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/SampleEntry.hpp>
+#include <cstdint>
+#include <string>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       AudioSampleEntry
+     * @abstract    Sample entry of audio tracks (mp4a, enca).
+     * @discussion  QuickTime version 1 and 2 entries, found in MOV files and
+     *              some MP4 files, are read too. For version 2 the sample
+     *              rate and channel count come from the extended fields.
+     *              The codecs string of MPEG-4 audio carries the object type
+     *              indication from the esds box and the audio object type
+     *              from its decoder specific info.
+     */
+    class ISOBMFF_EXPORT AudioSampleEntry: public SampleEntry, public XS::PIMPL::Object< AudioSampleEntry >
+    {
+        public:
+            
+            using XS::PIMPL::Object< AudioSampleEntry >::impl;
+            
+            AudioSampleEntry( const std::string & name );
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            uint16_t GetVersion( void )       const;
+            uint16_t GetChannelCount( void )  const;
+            uint16_t GetSampleSize( void )    const;
+            double   GetSampleRate( void )    const;
+            
+            void SetVersion( uint16_t value );
+            void SetChannelCount( uint16_t value );
+            void SetSampleSize( uint16_t value );
+            void SetSampleRate( double value );
+        
+        protected:
+            
+            void        ReadFields( IParser * parser, BinaryStream & stream ) override;
+            void        WriteFields( BoxSink & sink ) const override;
+            std::string MakeCodecs( void ) const override;
+    };
+}
+
+#endif /* ISOBMFF_AUDIO_SAMPLE_ENTRY_HPP */
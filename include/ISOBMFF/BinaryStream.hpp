@@ -71,6 +71,15 @@ namespace ISOBMFF
              * @param       bytes   The data bytes from which to create the stream.
              */
             BinaryStream( const std::vector< uint8_t > & bytes );
+            
+            /*!
+             * @function    BinaryStream
+             * @abstract    Creates a stream from a copy of a memory range.
+             * @param       bytes   The first byte of the range.
+             * @param       length  The number of bytes in the range.
+             * @param       offset  The absolute position of the first byte, as reported by GetOffset.
+             */
+            BinaryStream( const uint8_t * bytes, uint64_t length, uint64_t offset = 0 );
 
             /*!
              * @function    BinaryStream
@@ -85,9 +94,35 @@ namespace ISOBMFF
              * @param       stream  The source stream.
              * @param       length  The number of bytes to read from the source stream.
              * @discussion  Bytes from the source-stream will be consumed.
+             *              See SetSubStream.
              */
             BinaryStream( BinaryStream & stream, uint64_t length );
             
+            /*!
+             * @function    SetView
+             * @abstract    Makes the stream read a memory range, without copying it.
+             * @param       bytes   The first byte of the range.
+             * @param       length  The number of bytes in the range.
+             * @param       offset  The absolute position of the first byte, as reported by GetOffset.
+             * @discussion  The range must stay valid and unchanged while the
+             *              stream is used. Bytes owned by the stream are
+             *              released.
+             */
+            void SetView( const uint8_t * bytes, uint64_t length, uint64_t offset = 0 );
+            
+            /*!
+             * @function    SetSubStream
+             * @abstract    Replaces the stream's content with data bytes from another stream.
+             * @param       stream  The source stream.
+             * @param       length  The number of bytes to take from the source stream.
+             * @discussion  Bytes from the source-stream will be consumed.
+             *              If the source is memory-backed, this stream becomes
+             *              a view on its data, which must outlive this stream.
+             *              Otherwise the bytes are copied, reusing storage
+             *              from previous contents.
+             */
+            void SetSubStream( BinaryStream & stream, uint64_t length );
+            
             /*!
              * @function    HasBytesAvailable
              * @abstract    Tests whether the stream has bytes available to read.
@@ -95,6 +130,23 @@ namespace ISOBMFF
              */
             bool HasBytesAvailable( void ) const;
             
+            /*!
+             * @function    GetBytesAvailable
+             * @abstract    Gets the number of bytes left to read in the stream.
+             * @result      The number of bytes available.
+             */
+            uint64_t GetBytesAvailable( void ) const;
+            
+            /*!
+             * @function    GetOffset
+             * @abstract    Gets the absolute offset of the stream's read position.
+             * @result      The read position, relative to the start of the source file.
+             * @discussion  Streams created from another stream keep track of
+             *              the offset they were read from, so nested boxes
+             *              still report their position in the original file.
+             */
+            uint64_t GetOffset( void ) const;
+            
             /*!
              * @function    ReadUInt8
              * @abstract    Reads an 8-bits unsigned integer value from the stream.
@@ -266,6 +318,13 @@ namespace ISOBMFF
              */
             std::vector< uint8_t > ReadAllData( void );
             
+            /*!
+             * @function    ReadAllData
+             * @abstract    Reads all the data available in the stream into an existing vector.
+             * @param       data    The vector to fill. Its capacity is reused.
+             */
+            void ReadAllData( std::vector< uint8_t > & data );
+            
             /*!
              * @function    Read
              * @abstract    Reads bytes from the stream.
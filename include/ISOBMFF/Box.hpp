@@ -43,6 +43,7 @@
 namespace ISOBMFF
 {
     class IParser;
+    class BoxSink;
     
     /*!
      * @class       Box
@@ -91,6 +92,72 @@ namespace ISOBMFF
              * @result      The box data, as a vector of bytes.
              */
             virtual std::vector< uint8_t > GetData( void ) const;
+            
+            /*!
+             * @function    Write
+             * @abstract    Writes the box, header included, to a sink.
+             * @param       sink    The sink receiving the box.
+             * @discussion  The header size is set once the data is written,
+             *              so the sizes of a box tree are computed bottom-up
+             *              in the same pass. Data referenced by the sink
+             *              (e.g. mdat payloads) belongs to the box: it must
+             *              be kept until the sink is output.
+             */
+            virtual void Write( BoxSink & sink ) const;
+            
+            /*!
+             * @function    WriteData
+             * @abstract    Writes box data to a sink, the reverse of ReadData.
+             * @param       sink    The sink receiving the box data.
+             * @discussion  The base implementation writes the data stored by
+             *              Box::ReadData, without copying it. Throws a
+             *              std::runtime_error if the data was skipped while
+             *              parsing.
+             */
+            virtual void WriteData( BoxSink & sink ) const;
+            
+            /*!
+             * @function    GetMutableData
+             * @abstract    Gets the stored box data for in-place modification.
+             * @result      A reference to the box data.
+             * @discussion  Lets payloads be transformed (e.g. decrypted)
+             *              without a copy. Reading the box again replaces
+             *              the data.
+             */
+            std::vector< uint8_t > & GetMutableData( void );
+            
+            /*!
+             * @function    GetDataOffset
+             * @abstract    Gets the offset of the box data in the source file.
+             * @result      The absolute offset of the first byte after the box header.
+             */
+            uint64_t GetDataOffset( void ) const;
+            
+            /*!
+             * @function    GetDataLength
+             * @abstract    Gets the length of the box data in the source file.
+             * @result      The length of the box data, excluding the box header.
+             */
+            uint64_t GetDataLength( void ) const;
+            
+            /*!
+             * @function    IsDataSkipped
+             * @abstract    Tests whether the box data was skipped while parsing.
+             * @result      True if the data was not read, otherwise false.
+             * @discussion  Only the data offset and length are available for
+             *              skipped boxes.
+             * @see         IParser::ShouldSkipBoxData
+             */
+            bool IsDataSkipped( void ) const;
+            
+            /*!
+             * @function    SetDataLocation
+             * @abstract    Sets the location of the box data in the source file.
+             * @param       offset  The absolute offset of the box data.
+             * @param       length  The length of the box data.
+             * @param       skipped Whether the box data was skipped while parsing.
+             */
+            void SetDataLocation( uint64_t offset, uint64_t length, bool skipped = false );
     };
 }
 
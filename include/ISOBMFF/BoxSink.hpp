@@ -0,0 +1,119 @@
+/*!
+ * @header      BoxSink.hpp
+ */
+
+#ifndef ISOBMFF_BOX_SINK_HPP
+#define ISOBMFF_BOX_SINK_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/Matrix.hpp>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       BoxSink
+     * @abstract    Scatter-gather output for serialized boxes.
+     * @discussion  Fields are appended to an internal buffer, while large
+     *              payloads (e.g. mdat data) are only referenced, and the
+     *              output is a list of segments for writev(). A box
+     *              header is reserved by BeginBox and filled by EndBox,
+     *              once the payload size is known: the sizes of a tree are
+     *              computed bottom-up while it is written, and nothing is
+     *              output before they are final.
+     *              Referenced data must stay valid until the sink is
+     *              output or cleared.
+     */
+    class ISOBMFF_EXPORT BoxSink: public XS::PIMPL::Object< BoxSink >
+    {
+        public:
+            
+            using XS::PIMPL::Object< BoxSink >::impl;
+            
+            BoxSink( void );
+            
+            void WriteUInt8( uint8_t value );
+            void WriteBigEndianUInt16( uint16_t value );
+            void WriteBigEndianUInt24( uint32_t value );
+            void WriteBigEndianUInt32( uint32_t value );
+            void WriteBigEndianUInt64( uint64_t value );
+            void WriteBigEndianFixedPoint( double value, unsigned int integerLength, unsigned int fractionalLength );
+            void WriteFourCC( const std::string & value );
+            void WriteNULLTerminatedString( const std::string & value );
+            void WritePascalString( const std::string & value );
+            void WriteMatrix( const Matrix & value );
+            
+            /*!
+             * @function    Write
+             * @abstract    Appends a copy of bytes.
+             */
+            void Write( const uint8_t * data, uint64_t length );
+            void Write( const std::vector< uint8_t > & data );
+            
+            /*!
+             * @function    Reference
+             * @abstract    Appends bytes without copying them.
+             * @discussion  Small blocks are copied anyway, as a segment of
+             *              their own would cost more than the copy.
+             */
+            void Reference( const uint8_t * data, uint64_t length );
+            
+            /*!
+             * @function    BeginBox
+             * @abstract    Reserves the header of a box.
+             * @result      A handle for EndBox.
+             */
+            std::size_t BeginBox( const std::string & name );
+            
+            /*!
+             * @function    EndBox
+             * @abstract    Sets the size in a box header reserved by BeginBox.
+             * @discussion  Boxes over 4 GB get a 64-bit size. Boxes must be
+             *              ended in reverse order of BeginBox.
+             */
+            void EndBox( std::size_t box );
+            
+            /*!
+             * @function    GetSize
+             * @abstract    Gets the number of bytes written so far.
+             */
+            uint64_t GetSize( void ) const;
+            
+            /*!
+             * @function    GetSegments
+             * @abstract    Gets the output, as a list of memory blocks.
+             * @discussion  The pointers are valid until the sink is written
+             *              to or cleared.
+             */
+            std::vector< std::pair< const uint8_t *, uint64_t > > GetSegments( void ) const;
+            
+            /*!
+             * @function    GetBytes
+             * @abstract    Gets a copy of the output.
+             */
+            std::vector< uint8_t > GetBytes( void ) const;
+            
+            /*!
+             * @function    WriteTo
+             * @abstract    Outputs the segments to a file descriptor.
+             * @discussion  Uses writev() in batches of IOV_MAX segments.
+             *              Partial writes are resumed. Throws
+             *              std::runtime_error on errors.
+             */
+            void WriteTo( int fd ) const;
+            void WriteTo( std::ostream & os ) const;
+            
+            /*!
+             * @function    Clear
+             * @abstract    Discards the output, keeping the buffer capacity.
+             */
+            void Clear( void );
+    };
+}
+
+#endif /* ISOBMFF_BOX_SINK_HPP */
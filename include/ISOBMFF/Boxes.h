@@ -17,6 +17,7 @@
 #include <ISOBMFF/INFE.hpp>
 #include <ISOBMFF/IROT.hpp>
 #include <ISOBMFF/HVCC.hpp>
+#include <ISOBMFF/AVCC.hpp>
 #include <ISOBMFF/DIMG.hpp>
 #include <ISOBMFF/THMB.hpp>
 #include <ISOBMFF/CDSC.hpp>
@@ -26,9 +27,29 @@
 #include <ISOBMFF/PIXI.hpp>
 #include <ISOBMFF/IPCO.hpp>
 #include <ISOBMFF/STSD.hpp>
+#include <ISOBMFF/SampleEntry.hpp>
+#include <ISOBMFF/VisualSampleEntry.hpp>
+#include <ISOBMFF/AudioSampleEntry.hpp>
+#include <ISOBMFF/ESDS.hpp>
 #include <ISOBMFF/SIDX.hpp>
 #include <ISOBMFF/FRMA.hpp>
 #include <ISOBMFF/SCHM.hpp>
 #include <ISOBMFF/TRUN.hpp>
 #include <ISOBMFF/TFHD.hpp>
+#include <ISOBMFF/TFDT.hpp>
+#include <ISOBMFF/TENC.hpp>
+#include <ISOBMFF/PSSH.hpp>
+#include <ISOBMFF/SENC.hpp>
+#include <ISOBMFF/SAIZ.hpp>
+#include <ISOBMFF/SAIO.hpp>
+#include <ISOBMFF/MDHD.hpp>
+#include <ISOBMFF/STTS.hpp>
+#include <ISOBMFF/CTTS.hpp>
+#include <ISOBMFF/STSS.hpp>
+#include <ISOBMFF/STSZ.hpp>
+#include <ISOBMFF/STSC.hpp>
+#include <ISOBMFF/STCO.hpp>
+#include <ISOBMFF/MEHD.hpp>
+#include <ISOBMFF/TREX.hpp>
+#include <ISOBMFF/ELST.hpp>
 
@@ -49,6 +49,7 @@ namespace ISOBMFF
             COLR( void );
             
             void                                                 ReadData(IParser *parser, BinaryStream &stream) override;
+            void                                                 WriteData( BoxSink & sink ) const override;
             std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
             
             std::string            GetColourType( void )              const;
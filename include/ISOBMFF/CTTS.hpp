@@ -0,0 +1,55 @@
+/*!
+ * @header      CTTS.hpp
+ */
+
+#ifndef ISOBMFF_CTTS_HPP
+#define ISOBMFF_CTTS_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       CTTS
+     * @abstract    Composition time to sample box.
+     * @discussion  Run-length table of the offsets from decode to
+     *              composition times. Offsets are unsigned in version 0,
+     *              but are stored signed, as written by most muxers.
+     */
+    class ISOBMFF_EXPORT CTTS: public FullBox, public XS::PIMPL::Object< CTTS >
+    {
+        public:
+            
+            struct Entry
+            {
+                uint32_t sampleCount;
+                int32_t  sampleOffset;
+            };
+            
+            using XS::PIMPL::Object< CTTS >::impl;
+            
+            CTTS( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            const std::vector< Entry > & GetEntries( void ) const;
+            
+            /*!
+             * @function    AddEntry
+             * @abstract    Adds a run of samples with the same offset.
+             * @discussion  Merged into the last entry when the offset is the
+             *              same. Negative offsets set version 1.
+             */
+            void AddEntry( uint32_t sampleCount, int32_t sampleOffset );
+            void ClearEntries( void );
+    };
+}
+
+#endif /* ISOBMFF_CTTS_HPP */
@@ -50,6 +50,7 @@ namespace ISOBMFF
             virtual std::vector< std::shared_ptr< Box > > GetBoxes( void )                     const = 0;
             
             void WriteBoxes( std::ostream & os, std::size_t indentLevel ) const;
+            void WriteBoxes( BoxSink & sink ) const;
             
             std::vector< std::shared_ptr< Box > > GetBoxes( const std::string & name ) const;
             std::shared_ptr< Box >                GetBox( const std::string & name )   const;
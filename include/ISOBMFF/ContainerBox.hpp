@@ -50,10 +50,18 @@ namespace ISOBMFF
             ContainerBox( const std::string & name );
             
             void ReadData(IParser *parser, BinaryStream &stream) override;
+            void WriteData( BoxSink & sink ) const override;
             void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
             
             void                                  AddBox( std::shared_ptr< Box > box ) override;
             std::vector< std::shared_ptr< Box > > GetBoxes( void ) const override;
+            
+            /*!
+             * @function    ReplaceBox
+             * @abstract    Replaces a child box, keeping its position.
+             * @result      False if the box is not a child of this box.
+             */
+            bool ReplaceBox( const std::shared_ptr< Box > & box, std::shared_ptr< Box > replacement );
     };
 }
 
@@ -48,6 +48,7 @@ namespace ISOBMFF
             DREF( void );
             
             void ReadData(IParser *parser, BinaryStream &stream) override;
+            void WriteData( BoxSink & sink ) const override;
             void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
             
             void                                  AddBox( std::shared_ptr< Box > box ) override;
@@ -0,0 +1,58 @@
+/*!
+ * @header      ELST.hpp
+ */
+
+#ifndef ISOBMFF_ELST_HPP
+#define ISOBMFF_ELST_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       ELST
+     * @abstract    Edit list box.
+     * @discussion  Maps the media timeline of a track to the presentation.
+     *              Segment durations are in the movie timescale (mvhd),
+     *              media times in the media timescale (mdhd). A media time
+     *              of -1 is an empty edit, delaying the following ones.
+     */
+    class ISOBMFF_EXPORT ELST: public FullBox, public XS::PIMPL::Object< ELST >
+    {
+        public:
+            
+            struct Entry
+            {
+                uint64_t segmentDuration;
+                int64_t  mediaTime;
+                int16_t  mediaRateInteger;
+                int16_t  mediaRateFraction;
+            };
+            
+            using XS::PIMPL::Object< ELST >::impl;
+            
+            ELST( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            const std::vector< Entry > & GetEntries( void ) const;
+            
+            /*!
+             * @function    AddEntry
+             * @abstract    Adds an edit, at normal rate.
+             * @discussion  Values that do not fit in 32 bits set version 1.
+             */
+            void AddEntry( uint64_t segmentDuration, int64_t mediaTime );
+            void AddEntry( const Entry & entry );
+            void ClearEntries( void );
+    };
+}
+
+#endif /* ISOBMFF_ELST_HPP */
@@ -0,0 +1,82 @@
+/*!
+ * @header      ESDS.hpp
+ */
+
+#ifndef ISOBMFF_ESDS_HPP
+#define ISOBMFF_ESDS_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       ESDS
+     * @abstract    Elementary stream descriptor box (ISO/IEC 14496-14).
+     * @discussion  Holds an ES_Descriptor, whose DecoderConfigDescriptor
+     *              gives the object type indication (0x40 for MPEG-4
+     *              audio) and the decoder specific info. For MPEG-4 audio
+     *              the decoder specific info is an AudioSpecificConfig,
+     *              whose main fields are decoded too.
+     */
+    class ISOBMFF_EXPORT ESDS: public FullBox, public XS::PIMPL::Object< ESDS >
+    {
+        public:
+            
+            using XS::PIMPL::Object< ESDS >::impl;
+            
+            ESDS( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            uint16_t GetESID( void )                 const;
+            uint8_t  GetObjectTypeIndication( void ) const;
+            uint8_t  GetStreamType( void )           const;
+            uint32_t GetBufferSizeDB( void )         const;
+            uint32_t GetMaxBitrate( void )           const;
+            uint32_t GetAvgBitrate( void )           const;
+            
+            const std::vector< uint8_t > & GetDecoderSpecificInfo( void ) const;
+            
+            /*!
+             * @function    HasAudioSpecificConfig
+             * @abstract    Whether an MPEG-4 AudioSpecificConfig was decoded.
+             * @discussion  The Get*AudioObjectType, sampling frequency and
+             *              channel configuration getters return 0 otherwise.
+             */
+            bool HasAudioSpecificConfig( void ) const;
+            
+            /*!
+             * @function    GetAudioObjectType
+             * @abstract    Gets the signalled audio object type.
+             * @discussion  For explicit SBR or PS signalling this is 5 or
+             *              29, see GetCoreAudioObjectType.
+             */
+            uint8_t GetAudioObjectType( void ) const;
+            
+            /*!
+             * @function    GetCoreAudioObjectType
+             * @abstract    Gets the audio object type of the core decoder.
+             * @discussion  The object type following the SBR/PS extension
+             *              (usually 2, AAC LC), or the signalled type.
+             */
+            uint8_t GetCoreAudioObjectType( void ) const;
+            
+            /*!
+             * @function    GetSamplingFrequencyIndex
+             * @abstract    Gets the sampling frequency index of the core.
+             * @result      0 to 12, or 15 when the frequency is explicit.
+             */
+            uint8_t  GetSamplingFrequencyIndex( void ) const;
+            uint32_t GetSamplingFrequency( void )      const;
+            uint8_t  GetChannelConfiguration( void )   const;
+    };
+}
+
+#endif /* ISOBMFF_ESDS_HPP */
@@ -46,6 +46,7 @@ namespace ISOBMFF
             FRMA( void );
             
             void                                                 ReadData(IParser *parser, BinaryStream &stream) override;
+            void                                                 WriteData( BoxSink & sink ) const override;
             std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
             
             std::string GetDataFormat( void ) const;
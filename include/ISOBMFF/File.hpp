@@ -47,6 +47,12 @@ namespace ISOBMFF
             File( void );
             
             std::string GetName( void ) const override;
+            
+            /*!
+             * @function    Write
+             * @abstract    Writes the top-level boxes, as a file.
+             */
+            void Write( BoxSink & sink ) const override;
     };
 }
 
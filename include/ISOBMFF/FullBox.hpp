@@ -47,6 +47,7 @@ namespace ISOBMFF
             FullBox( const std::string & name );
             
             void                                                 ReadData(IParser *parser, BinaryStream &stream) override;
+            void                                                 WriteData( BoxSink & sink ) const override;
             KeyValueStringList GetDisplayableProperties( void ) const override;
             
             uint8_t  GetVersion( void ) const;
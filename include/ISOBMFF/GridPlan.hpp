@@ -0,0 +1,126 @@
+/*!
+ * @header      GridPlan.hpp
+ */
+
+#ifndef ISOBMFF_GRID_PLAN_HPP
+#define ISOBMFF_GRID_PLAN_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/ItemIndex.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace ISOBMFF
+{
+    class Parser;
+    
+    /*!
+     * @class       GridPlan
+     * @abstract    Plan for turning the tiles of a HEIF grid image into
+     *              decoder-ready HEVC bitstreams.
+     * @discussion  The plan resolves, once, the grid geometry, the tile
+     *              items referenced by dimg, their data extents in the file
+     *              and their hvcC parameter sets. Tiles are then assembled
+     *              as Annex-B streams (parameter sets followed by the tile
+     *              NAL units, with 4-byte start codes), straight from the
+     *              file into caller-provided buffers.
+     *              The plan only reads the file when assembling, and a
+     *              const plan can be used from several threads.
+     */
+    class ISOBMFF_EXPORT GridPlan: public XS::PIMPL::Object< GridPlan >
+    {
+        public:
+            
+            using XS::PIMPL::Object< GridPlan >::impl;
+            
+            /*!
+             * @struct      Tile
+             * @abstract    A tile of the grid.
+             */
+            struct Tile
+            {
+                uint32_t                                       itemID     = 0;
+                uint32_t                                       row        = 0;
+                uint32_t                                       column     = 0;
+                uint32_t                                       width      = 0;    /* From the tile's ispe, 0 if it has none */
+                uint32_t                                       height     = 0;
+                std::vector< std::pair< uint64_t, uint64_t > > ranges;            /* Absolute (offset, length) of the tile data */
+                uint64_t                                       dataSize   = 0;
+                uint8_t                                        lengthSize = 4;    /* NAL unit length field size, from hvcC */
+                size_t                                         bufferSize = 0;    /* Buffer size needed to assemble the tile */
+            };
+            
+            /*!
+             * @function    GridPlan
+             * @abstract    Plans the primary item of a parsed file.
+             * @param       parser  A parser that has parsed the file.
+             * @discussion  Throws if the primary item is not an HEVC grid.
+             */
+            GridPlan( const Parser & parser ) ISOBMFF_NOEXCEPT( false );
+            
+            /*!
+             * @function    GridPlan
+             * @abstract    Plans a grid item of a parsed file.
+             * @param       parser  A parser that has parsed the file.
+             * @param       itemID  The ID of the grid item.
+             * @discussion  Throws if the item is not a grid, if the number
+             *              of dimg references does not match the grid size,
+             *              or if a tile has no hvcC or no data location.
+             */
+            GridPlan( const Parser & parser, uint32_t itemID ) ISOBMFF_NOEXCEPT( false );
+            
+            uint32_t GetItemID( void )       const;
+            uint32_t GetRows( void )         const;    /* Number of tile rows */
+            uint32_t GetColumns( void )      const;    /* Number of tile columns */
+            uint64_t GetOutputWidth( void )  const;
+            uint64_t GetOutputHeight( void ) const;
+            
+            /*!
+             * @function    GetTiles
+             * @abstract    Gets the tiles, in row-major order.
+             * @result      The tiles.
+             */
+            const std::vector< Tile > & GetTiles( void ) const;
+            
+            /*!
+             * @function    AssembleTile
+             * @abstract    Writes the bitstream of a tile to a buffer.
+             * @param       index   The tile index, in row-major order.
+             * @param       buffer  The output buffer.
+             * @param       size    The size of the buffer, at least the
+             *                      tile's bufferSize.
+             * @result      The number of bytes written.
+             * @discussion  The tile data is read after the parameter sets
+             *              and its NAL units are converted in place by a
+             *              NalConverter, so no other memory is used.
+             *              bufferSize is exact when the length fields are
+             *              4 bytes, and an upper bound otherwise. Throws on
+             *              read errors and on malformed NAL units.
+             */
+            size_t AssembleTile( size_t index, uint8_t * buffer, size_t size ) const ISOBMFF_NOEXCEPT( false );
+            
+            /*!
+             * @function    Assemble
+             * @abstract    Writes the bitstreams of all tiles, in parallel.
+             * @param       buffers     One buffer per tile, in row-major
+             *                          order, each at least the tile's
+             *                          bufferSize.
+             * @param       threadCount The number of threads to use,
+             *                          including the calling thread.
+             * @result      The number of bytes written for each tile.
+             * @discussion  Tiles are handed out one at a time to the
+             *              calling thread and to workers of a pool shared
+             *              by all plans, which is started on first use and
+             *              kept until exit. Each thread reads through its
+             *              own file handle. If a tile fails, the first
+             *              error is rethrown once all threads are done.
+             */
+            std::vector< size_t > Assemble( const std::vector< uint8_t * > & buffers, unsigned int threadCount ) const ISOBMFF_NOEXCEPT( false );
+    };
+}
+
+#endif /* ISOBMFF_GRID_PLAN_HPP */
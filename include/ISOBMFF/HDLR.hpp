@@ -47,6 +47,7 @@ namespace ISOBMFF
             HDLR( void );
             
             void                                                 ReadData(IParser *parser, BinaryStream &stream) override;
+            void                                                 WriteData( BoxSink & sink ) const override;
             std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
             
             std::string GetHandlerType( void ) const;
@@ -37,6 +37,7 @@
 #include <ISOBMFF/DisplayableObject.hpp>
 #include <ISOBMFF/DisplayableObjectContainer.hpp>
 #include <vector>
+#include <memory>
 #include <cstdint>
 
 namespace ISOBMFF
@@ -50,6 +51,7 @@ namespace ISOBMFF
             HVCC( void );
             
             void ReadData(IParser *parser, BinaryStream &stream) override;
+            void WriteData( BoxSink & sink ) const override;
             void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
             
             virtual std::vector< std::shared_ptr< DisplayableObject > >  GetDisplayableObjects( void )    const override;
@@ -136,6 +138,20 @@ namespace ISOBMFF
             
             std::vector< std::shared_ptr< Array > > GetArrays( void ) const;
             void                                    AddArray( std::shared_ptr< Array > array );
+            
+            /*!
+             * @function    GetParameterSets
+             * @abstract    Gets the NAL units of the arrays in Annex-B form.
+             * @result      The VPS, SPS, PPS and SEI NAL units, in array
+             *              order, each preceded by a 4-byte start code.
+             * @discussion  Arrays and their NAL units can still be modified
+             *              once added, so the data is built again on each
+             *              call. The same data is returned while the NAL
+             *              units are unchanged. It is never modified: it can
+             *              be shared by every consumer of the track, on any
+             *              thread.
+             */
+            std::shared_ptr< const std::vector< uint8_t > > GetParameterSets( void ) const;
     };
 }
 
@@ -50,6 +50,7 @@ namespace ISOBMFF
             IINF( void );
             
             void ReadData(IParser *parser, BinaryStream &stream) override;
+            void WriteData( BoxSink & sink ) const override;
             void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
             
             void                                   AddEntry( std::shared_ptr< INFE > entry );
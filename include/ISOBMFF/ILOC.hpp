@@ -37,6 +37,7 @@
 #include <ISOBMFF/DisplayableObjectContainer.hpp>
 #include <cstdint>
 #include <vector>
+#include <utility>
 
 namespace ISOBMFF
 {
@@ -49,6 +50,7 @@ namespace ISOBMFF
             ILOC( void );
             
             void ReadData(IParser *parser, BinaryStream &stream) override;
+            void WriteData( BoxSink & sink ) const override;
             void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
             
             virtual std::vector< std::shared_ptr< DisplayableObject > >  GetDisplayableObjects( void )    const override;
@@ -73,6 +75,8 @@ namespace ISOBMFF
                     Item( void );
                     Item( BinaryStream & stream, const ILOC & iloc );
                     
+                    void Write( BoxSink & sink, const ILOC & iloc ) const;
+                    
                     std::string GetName( void ) const override;
                     
                     uint32_t GetItemID( void )             const;
@@ -99,6 +103,8 @@ namespace ISOBMFF
                             Extent( void );
                             Extent( BinaryStream & stream, const ILOC & iloc );
                             
+                            void Write( BoxSink & sink, const ILOC & iloc ) const;
+                            
                             std::string GetName( void ) const override;
                             
                             uint64_t GetIndex( void )  const;
@@ -118,6 +124,8 @@ namespace ISOBMFF
             
             std::vector< std::shared_ptr< Item > > GetItems( void )           const;
             std::shared_ptr< Item >                GetItem( uint32_t itemID ) const;
+            
+            std::vector< std::pair< uint64_t, uint64_t > > GetItemDataRanges( uint32_t itemID, const Box * idat, uint64_t fileSize ) const ISOBMFF_NOEXCEPT( false );
             void                                   AddItem( std::shared_ptr< Item > item );
     };
 }
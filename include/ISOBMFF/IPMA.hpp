@@ -50,6 +50,7 @@ namespace ISOBMFF
             IPMA( void );
             
             void ReadData(IParser *parser, BinaryStream &stream) override;
+            void WriteData( BoxSink & sink ) const override;
             void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
             
             std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
@@ -64,6 +65,8 @@ namespace ISOBMFF
                     Entry( void );
                     Entry( BinaryStream & stream, const IPMA & ipma );
                     
+                    void Write( BoxSink & sink, const IPMA & ipma ) const;
+                    
                     std::string GetName( void ) const override;
                     
                     uint32_t GetItemID( void ) const;
@@ -83,6 +86,8 @@ namespace ISOBMFF
                             Association( void );
                             Association( BinaryStream & stream, const IPMA & ipma );
                             
+                            void Write( BoxSink & sink, const IPMA & ipma ) const;
+                            
                             std::string GetName( void ) const override;
                             
                             bool     GetEssential( void )     const;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include <ISOBMFF/Box.hpp>
 
 namespace ISOBMFF {
@@ -26,13 +27,32 @@ namespace ISOBMFF {
         /*!
          * @enum        Options
          * @abstract    Parser options.
-         * @constant    SkipMDATData    Do not keep data found in MDAT boxes.
+         * @constant    SkipMDATData        Do not keep data found in MDAT boxes.
+         * @constant    SkipLargeBoxData    Do not read unregistered or
+         *                                  payload-only boxes larger than
+         *                                  the parser's skip threshold.
+         * @constant    StopAfterMETA       Only read the top-level ftyp and
+         *                                  meta boxes, and stop after meta.
+         *                                  Other top-level boxes are only
+         *                                  located, never read. Parsing
+         *                                  throws if there is no meta box.
+         * @constant    StopAfterMOOV       Only read the stsd boxes of the
+         *                                  top-level moov box, and stop
+         *                                  after moov. The trak, mdia, minf
+         *                                  and stbl boxes leading to them
+         *                                  only hold their stsd, other
+         *                                  boxes are only located, never
+         *                                  read. Parsing throws if there
+         *                                  is no moov box.
          */
         enum Options: uint64_t
         {
             SkipMDATData            = 0x1u << 0u,
             SkipNotRequiredBoxes    = 0x1u << 1u,
-            ShowBoxContentDebug     = 0x1u << 2u
+            ShowBoxContentDebug     = 0x1u << 2u,
+            SkipLargeBoxData        = 0x1u << 3u,
+            StopAfterMETA           = 0x1u << 4u,
+            StopAfterMOOV           = 0x1u << 5u
         };
 
         virtual ~IParser() {}
@@ -45,6 +65,23 @@ namespace ISOBMFF {
          */
         virtual std::shared_ptr< ISOBMFF::Box > CreateBox( const std::string & type ) const = 0;
 
+        /*!
+         * @function    ShouldSkipBoxData
+         * @abstract    Decides whether a box's data should be skipped instead of read.
+         * @param       type    The box type (four character string).
+         * @param       length  The length of the box data, excluding the header.
+         * @result      true if the data should be skipped, otherwise false.
+         * @discussion  Called before the box data is copied out of the
+         *              stream. Skipped boxes only record the offset and
+         *              length of their data. The default reads every box.
+         */
+        virtual bool ShouldSkipBoxData( const std::string & type, uint64_t length ) const
+        {
+            ( void )type;
+            ( void )length;
+            
+            return false;
+        }
 
         /*!
          * @function    GetPreferredStringType
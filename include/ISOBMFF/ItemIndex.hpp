@@ -0,0 +1,117 @@
+/*!
+ * @header      ItemIndex.hpp
+ */
+
+#ifndef ISOBMFF_ITEM_INDEX_HPP
+#define ISOBMFF_ITEM_INDEX_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/Box.hpp>
+#include <ISOBMFF/ILOC.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    class META;
+    class INFE;
+    class ISPE;
+    class COLR;
+    class PIXI;
+    class IROT;
+    class HVCC;
+    
+    /*!
+     * @class       ItemIndex
+     * @abstract    Immutable index of the items of a HEIF meta box.
+     * @discussion  Joins iinf, iloc, ipma/ipco, pitm and iref once, so that
+     *              an item's info, location, properties and references are
+     *              found with a single hash lookup. The index holds the
+     *              boxes it points to: the returned pointers stay valid for
+     *              the lifetime of the index, and lookups never touch
+     *              reference counts.
+     */
+    class ISOBMFF_EXPORT ItemIndex: public XS::PIMPL::Object< ItemIndex >
+    {
+        public:
+            
+            using XS::PIMPL::Object< ItemIndex >::impl;
+            
+            /*!
+             * @struct      Property
+             * @abstract    A property associated with an item in ipma.
+             */
+            struct Property
+            {
+                const Box * box;
+                bool        essential;
+            };
+            
+            /*!
+             * @struct      Item
+             * @abstract    Everything known about an item.
+             * @discussion  Pointers are nullptr when the item has no such
+             *              box or property. The typed properties are the
+             *              first of their type in ipma order.
+             */
+            struct Item
+            {
+                uint32_t                itemID   = 0;
+                const INFE            * info     = nullptr;
+                const ILOC::Item      * location = nullptr;
+                std::vector< Property > properties;
+                const ISPE            * ispe     = nullptr;
+                const COLR            * colr     = nullptr;
+                const PIXI            * pixi     = nullptr;
+                const IROT            * irot     = nullptr;
+                const HVCC            * hvcc     = nullptr;
+                
+                /* References from this item (iref) */
+                std::vector< uint32_t > dimg;           /* Derived image inputs, e.g. grid tiles, in order */
+                std::vector< uint32_t > thmb;           /* Images this item is a thumbnail of */
+                std::vector< uint32_t > cdsc;           /* Items this item describes */
+                
+                /* References to this item */
+                std::vector< uint32_t > thumbnails;     /* Items with a thmb reference to this item */
+                std::vector< uint32_t > descriptions;   /* Items with a cdsc reference to this item, e.g. Exif */
+            };
+            
+            /*!
+             * @function    ItemIndex
+             * @abstract    Creates an empty index.
+             */
+            ItemIndex( void );
+            
+            /*!
+             * @function    ItemIndex
+             * @abstract    Indexes the items of a meta box.
+             * @param       meta    The meta box.
+             */
+            ItemIndex( const META & meta );
+            
+            /*!
+             * @function    GetItem
+             * @abstract    Gets an item by ID.
+             * @param       itemID  The item ID.
+             * @result      The item, or nullptr if the meta box has no such item.
+             */
+            const Item * GetItem( uint32_t itemID ) const;
+            
+            /*!
+             * @function    GetPrimaryItem
+             * @abstract    Gets the item designated by pitm.
+             * @result      The primary item, or nullptr.
+             */
+            const Item * GetPrimaryItem( void ) const;
+            
+            /*!
+             * @function    GetItems
+             * @abstract    Gets all items, in iinf order.
+             * @result      The items.
+             */
+            const std::vector< Item > & GetItems( void ) const;
+    };
+}
+
+#endif /* ISOBMFF_ITEM_INDEX_HPP */
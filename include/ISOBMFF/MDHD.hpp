@@ -0,0 +1,55 @@
+/*!
+ * @header      MDHD.hpp
+ */
+
+#ifndef ISOBMFF_MDHD_HPP
+#define ISOBMFF_MDHD_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <string>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       MDHD
+     * @abstract    Media header box.
+     * @discussion  Gives the timescale of the track media: the sample
+     *              durations of stts and trun, and the decode times of
+     *              tfdt, are in units of this timescale.
+     */
+    class ISOBMFF_EXPORT MDHD: public FullBox, public XS::PIMPL::Object< MDHD >
+    {
+        public:
+            
+            using XS::PIMPL::Object< MDHD >::impl;
+            
+            MDHD( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            uint64_t    GetCreationTime( void )     const;
+            uint64_t    GetModificationTime( void ) const;
+            uint32_t    GetTimescale( void )        const;
+            uint64_t    GetDuration( void )         const;
+            std::string GetLanguage( void )         const;
+            
+            void SetCreationTime( uint64_t value );
+            void SetModificationTime( uint64_t value );
+            void SetTimescale( uint32_t value );
+            void SetDuration( uint64_t value );
+            
+            /*!
+             * @function    SetLanguage
+             * @abstract    Sets the ISO 639-2/T language code, e.g. "und".
+             */
+            void SetLanguage( const std::string & value );
+    };
+}
+
+#endif /* ISOBMFF_MDHD_HPP */
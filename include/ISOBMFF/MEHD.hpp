@@ -0,0 +1,40 @@
+/*!
+ * @header      MEHD.hpp
+ */
+
+#ifndef ISOBMFF_MEHD_HPP
+#define ISOBMFF_MEHD_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       MEHD
+     * @abstract    Movie extends header box.
+     * @discussion  Duration of the whole fragmented movie, in the mvhd
+     *              timescale, as the mvhd duration only covers the samples
+     *              of the moov box.
+     */
+    class ISOBMFF_EXPORT MEHD: public FullBox, public XS::PIMPL::Object< MEHD >
+    {
+        public:
+            
+            using XS::PIMPL::Object< MEHD >::impl;
+            
+            MEHD( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            uint64_t GetFragmentDuration( void ) const;
+            void     SetFragmentDuration( uint64_t value );
+    };
+}
+
+#endif /* ISOBMFF_MEHD_HPP */
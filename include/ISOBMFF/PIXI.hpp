@@ -51,6 +51,7 @@ namespace ISOBMFF
             PIXI( void );
             
             void ReadData(IParser *parser, BinaryStream &stream) override;
+            void WriteData( BoxSink & sink ) const override;
             void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
             
             virtual std::vector< std::shared_ptr< DisplayableObject > >  GetDisplayableObjects( void )    const override;
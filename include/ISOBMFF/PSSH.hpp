@@ -0,0 +1,43 @@
+#pragma once
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /**
+     * aligned(8) class ProtectionSystemSpecificHeaderBox
+     * extends FullBox('pssh', version, flags=0) {
+     * unsigned int(8)[16] SystemID;
+     * if (version > 0) {
+     * unsigned int(32) KID_count;
+     * {
+     * unsigned int(8)[16] KID;
+     * } [KID_count];
+     * }
+     * unsigned int(32) DataSize;
+     * unsigned int(8)[DataSize] Data;
+     * }
+     */
+    class ISOBMFF_EXPORT PSSH: public FullBox, public XS::PIMPL::Object< PSSH >
+    {
+    public:
+        using XS::PIMPL::Object< PSSH >::impl;
+
+        PSSH();
+
+        void               ReadData(IParser *parser, BinaryStream &stream) override;
+        void               WriteData(BoxSink &sink) const override;
+        KeyValueStringList GetDisplayableProperties() const override;
+        void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
+
+        const std::vector<uint8_t>& GetSystemID() const;
+        uint32_t GetKIDCount() const;
+        // 16 bytes per KID, GetKIDCount() KIDs
+        const std::vector<uint8_t>& GetKIDs() const;
+        const std::vector<uint8_t>& GetSystemData() const;
+    };
+}
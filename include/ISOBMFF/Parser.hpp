@@ -37,6 +37,8 @@
 #include <functional>
 #include <memory>
 #include <cstdint>
+#include <vector>
+#include <utility>
 #include <ISOBMFF/Box.hpp>
 #include <ISOBMFF/File.hpp>
 #include <ISOBMFF/IParser.hpp>
@@ -117,6 +119,37 @@ namespace ISOBMFF
              */
             std::shared_ptr< Box > CreateBox( const std::string & type ) const override;
             
+            /*!
+             * @function    ShouldSkipBoxData
+             * @abstract    Decides whether a box's data should be skipped instead of read.
+             * @param       type    The box type (four character string).
+             * @param       length  The length of the box data, excluding the header.
+             * @result      true if the data should be skipped, otherwise false.
+             * @discussion  MDAT data is skipped with the SkipMDATData option.
+             *              With the SkipLargeBoxData option, unregistered
+             *              boxes and payload-only boxes (mdat, free, skip,
+             *              wide, idat) larger than the skip threshold are
+             *              skipped as well.
+             * @see         GetSkipThreshold
+             */
+            bool ShouldSkipBoxData( const std::string & type, uint64_t length ) const override;
+            
+            /*!
+             * @function    GetSkipThreshold
+             * @abstract    Gets the data length above which boxes may be skipped.
+             * @result      The skip threshold, in bytes.
+             * @see         ShouldSkipBoxData
+             */
+            uint64_t GetSkipThreshold( void ) const;
+            
+            /*!
+             * @function    SetSkipThreshold
+             * @abstract    Sets the data length above which boxes may be skipped.
+             * @param       value   The skip threshold, in bytes.
+             * @see         ShouldSkipBoxData
+             */
+            void SetSkipThreshold( uint64_t value );
+            
             /*!
              * @function    Parse
              * @abstract    Parses a file.
@@ -132,6 +165,39 @@ namespace ISOBMFF
              */
             std::shared_ptr< File > GetFile( void ) const;
             
+            /*!
+             * @function    GetPath
+             * @abstract    Gets the path of the last parsed file.
+             * @result      The file's path.
+             */
+            std::string GetPath( void ) const;
+            
+            /*!
+             * @function    GetItemDataRanges
+             * @abstract    Gets the location of an item's data in the parsed file.
+             * @param       itemID  The item ID.
+             * @result      The absolute (offset, length) ranges of the item data, in order.
+             * @discussion  Resolves the extents of the item in the file-level
+             *              meta box, for construction methods 0 (file
+             *              offsets) and 1 (idat). The ranges can be used as
+             *              spans over a mapped file without reading it.
+             *              Throws for unknown items and other construction
+             *              methods.
+             */
+            std::vector< std::pair< uint64_t, uint64_t > > GetItemDataRanges( uint32_t itemID ) const ISOBMFF_NOEXCEPT( false );
+            
+            /*!
+             * @function    GetItemData
+             * @abstract    Reads an item's data from the parsed file.
+             * @param       itemID  The item ID.
+             * @result      The item data, with multiple extents concatenated.
+             * @discussion  Only the ranges of the item are read, so this works
+             *              with files parsed with the SkipMDATData and
+             *              SkipLargeBoxData options.
+             * @see         GetItemDataRanges
+             */
+            std::vector< uint8_t > GetItemData( uint32_t itemID ) const ISOBMFF_NOEXCEPT( false );
+            
             /*!
              * @function    GetPreferredStringType
              * @abstract    Gets the preferred string type used in the parser.
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /**
+     * aligned(8) class SampleAuxiliaryInformationOffsetsBox
+     * extends FullBox('saio', version, flags) {
+     * if (flags & 1) {
+     * unsigned int(32) aux_info_type;
+     * unsigned int(32) aux_info_type_parameter;
+     * }
+     * unsigned int(32) entry_count;
+     * if ( version == 0 ) {
+     * unsigned int(32) offset[ entry_count ];
+     * }
+     * else {
+     * unsigned int(64) offset[ entry_count ];
+     * }
+     * }
+     */
+    class ISOBMFF_EXPORT SAIO: public FullBox, public XS::PIMPL::Object< SAIO >
+    {
+    public:
+        using XS::PIMPL::Object< SAIO >::impl;
+
+        SAIO();
+
+        void               ReadData(IParser *parser, BinaryStream &stream) override;
+        void               WriteData(BoxSink &sink) const override;
+        KeyValueStringList GetDisplayableProperties() const override;
+        void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
+
+        uint32_t GetAuxInfoType() const;
+        uint32_t GetAuxInfoTypeParameter() const;
+        // In a traf, relative to the same base as the trun data offsets; in a stbl, file offsets
+        const std::vector<uint64_t>& GetOffsets() const;
+        void SetOffsets(const std::vector<uint64_t> &offsets);
+        // Whether an offset needs version 1, with 64-bit offsets
+        bool NeedsLargeOffsets() const;
+    };
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /**
+     * aligned(8) class SampleAuxiliaryInformationSizesBox
+     * extends FullBox('saiz', version = 0, flags) {
+     * if (flags & 1) {
+     * unsigned int(32) aux_info_type;
+     * unsigned int(32) aux_info_type_parameter;
+     * }
+     * unsigned int(8) default_sample_info_size;
+     * unsigned int(32) sample_count;
+     * if (default_sample_info_size == 0) {
+     * unsigned int(8) sample_info_size[ sample_count ];
+     * }
+     * }
+     */
+    class ISOBMFF_EXPORT SAIZ: public FullBox, public XS::PIMPL::Object< SAIZ >
+    {
+    public:
+        using XS::PIMPL::Object< SAIZ >::impl;
+
+        SAIZ();
+
+        void               ReadData(IParser *parser, BinaryStream &stream) override;
+        void               WriteData(BoxSink &sink) const override;
+        KeyValueStringList GetDisplayableProperties() const override;
+        void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
+
+        // 0 when the box has no type, meaning the scheme type of the track
+        uint32_t GetAuxInfoType() const;
+        uint32_t GetAuxInfoTypeParameter() const;
+        uint8_t  GetDefaultSampleInfoSize() const;
+        uint32_t GetSampleCount() const;
+        uint8_t  GetSampleInfoSize( uint32_t index ) const;
+    };
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /**
+     * aligned(8) class SampleEncryptionBox
+     * extends FullBox('senc', version=0, flags) {
+     * unsigned int(32) sample_count;
+     * {
+     * unsigned int(Per_Sample_IV_Size*8) InitializationVector;
+     * if (flags & 0x000002) {
+     * unsigned int(16) subsample_count;
+     * {
+     * unsigned int(16) BytesOfClearData;
+     * unsigned int(32) BytesOfProtectedData;
+     * } [ subsample_count ]
+     * }
+     * }[ sample_count ]
+     * }
+     *
+     * Per_Sample_IV_Size comes from the track's tenc box. The payload is decoded once for each IV size
+     * it parses exactly with (8, 16 or 0 bytes); until SetIVSize is called the first one is used.
+     * GetSample with an explicit IV size does not change the box and can be called from several threads.
+     * IVs and subsample tables are stored as flat arrays shared by all samples.
+     */
+    class ISOBMFF_EXPORT SENC: public FullBox, public XS::PIMPL::Object< SENC >
+    {
+    public:
+        using XS::PIMPL::Object< SENC >::impl;
+
+        static constexpr uint32_t UseSubsampleEncryption = 0x2;
+
+        // Views into the box storage, valid while the box is alive and not read again
+        struct Sample {
+            const uint8_t  *iv{nullptr};
+            uint8_t         ivSize{0};
+            uint32_t        subsampleCount{0};
+            const uint16_t *clearBytes{nullptr};        // [subsampleCount]
+            const uint32_t *protectedBytes{nullptr};    // [subsampleCount]
+        };
+
+        SENC();
+
+        void               ReadData(IParser *parser, BinaryStream &stream) override;
+        void               WriteData(BoxSink &sink) const override;
+        KeyValueStringList GetDisplayableProperties() const override;
+        void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
+
+        uint32_t GetSampleCount() const;
+        uint8_t  GetIVSize() const;
+        bool     hasSubsamples() const;
+        Sample   GetSample( uint32_t index ) const;
+
+        // Sample decoded with the IV size from tenc. Empty if the payload does not parse with that size.
+        Sample   GetSample( uint32_t index, uint8_t ivSize ) const;
+
+        // Selects the IV size used by GetSample( index ). Returns false if the payload does not match it.
+        bool SetIVSize( uint8_t ivSize );
+    };
+}
@@ -28,6 +28,7 @@ namespace ISOBMFF
         SIDX();
 
         void               ReadData(IParser *parser, BinaryStream &stream) override;
+        void               WriteData(BoxSink &sink) const override;
         KeyValueStringList GetDisplayableProperties() const override;
         void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
 
@@ -0,0 +1,64 @@
+/*!
+ * @header      STCO.hpp
+ */
+
+#ifndef ISOBMFF_STCO_HPP
+#define ISOBMFF_STCO_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       STCO
+     * @abstract    Chunk offset box, with 32-bit (stco) or 64-bit (co64)
+     *              offsets.
+     * @discussion  Offsets are absolute file offsets, kept as 64-bit
+     *              values for both box types.
+     */
+    class ISOBMFF_EXPORT STCO: public FullBox, public XS::PIMPL::Object< STCO >
+    {
+        public:
+            
+            using XS::PIMPL::Object< STCO >::impl;
+            
+            STCO( const std::string & name = "stco" );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            
+            /*!
+             * @function    WriteData
+             * @abstract    Writes the offsets with the size of the box type.
+             * @discussion  Throws a std::runtime_error if an stco offset
+             *              does not fit in 32 bits: see NeedsLargeOffsets.
+             */
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            const std::vector< uint64_t > & GetChunkOffsets( void ) const;
+            
+            void AddChunkOffset( uint64_t value );
+            void ClearChunkOffsets( void );
+            
+            /*!
+             * @function    AddToChunkOffsets
+             * @abstract    Shifts every chunk offset, e.g. when the data
+             *              they point to moves in the file.
+             */
+            void AddToChunkOffsets( int64_t delta );
+            
+            /*!
+             * @function    NeedsLargeOffsets
+             * @abstract    Whether an offset does not fit in 32 bits.
+             */
+            bool NeedsLargeOffsets( void ) const;
+    };
+}
+
+#endif /* ISOBMFF_STCO_HPP */
@@ -0,0 +1,56 @@
+/*!
+ * @header      STSC.hpp
+ */
+
+#ifndef ISOBMFF_STSC_HPP
+#define ISOBMFF_STSC_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       STSC
+     * @abstract    Sample to chunk box.
+     * @discussion  Each entry gives the number of samples per chunk, and
+     *              their sample description, from its first chunk (1-based)
+     *              up to the first chunk of the next entry.
+     */
+    class ISOBMFF_EXPORT STSC: public FullBox, public XS::PIMPL::Object< STSC >
+    {
+        public:
+            
+            struct Entry
+            {
+                uint32_t firstChunk;
+                uint32_t samplesPerChunk;
+                uint32_t sampleDescriptionIndex;
+            };
+            
+            using XS::PIMPL::Object< STSC >::impl;
+            
+            STSC( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            const std::vector< Entry > & GetEntries( void ) const;
+            
+            /*!
+             * @function    AddChunk
+             * @abstract    Describes the next chunk.
+             * @discussion  Only adds an entry when the number of samples or
+             *              the sample description changes.
+             */
+            void AddChunk( uint32_t chunk, uint32_t samplesPerChunk, uint32_t sampleDescriptionIndex );
+            void ClearEntries( void );
+    };
+}
+
+#endif /* ISOBMFF_STSC_HPP */
@@ -36,6 +36,8 @@
 #include <ISOBMFF/FullBox.hpp>
 #include <ISOBMFF/Container.hpp>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 namespace ISOBMFF
 {
@@ -48,10 +50,21 @@ namespace ISOBMFF
             STSD( void );
             
             void ReadData(IParser *parser, BinaryStream &stream) override;
+            void WriteData( BoxSink & sink ) const override;
             void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
             
             void                                  AddBox( std::shared_ptr< Box > box ) override;
             std::vector< std::shared_ptr< Box > > GetBoxes( void ) const override;
+            
+            /*!
+             * @function    GetCodecs
+             * @abstract    Gets the RFC 6381 codecs strings of the sample entries.
+             * @result      One string per typed sample entry, in stsd order,
+             *              e.g. for an HLS or DASH manifest.
+             * @discussion  Parsers with the StopAfterMOOV option only read
+             *              the stsd boxes of a file, for their codecs.
+             */
+            std::vector< std::string > GetCodecs( void ) const;
     };
 }
 
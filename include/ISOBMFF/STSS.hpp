@@ -0,0 +1,43 @@
+/*!
+ * @header      STSS.hpp
+ */
+
+#ifndef ISOBMFF_STSS_HPP
+#define ISOBMFF_STSS_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       STSS
+     * @abstract    Sync sample box.
+     * @discussion  Lists the 1-based numbers of the sync samples, in
+     *              increasing order. Every sample is a sync sample when
+     *              a track has no stss box.
+     */
+    class ISOBMFF_EXPORT STSS: public FullBox, public XS::PIMPL::Object< STSS >
+    {
+        public:
+            
+            using XS::PIMPL::Object< STSS >::impl;
+            
+            STSS( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            const std::vector< uint32_t > & GetSampleNumbers( void ) const;
+            
+            void AddSampleNumber( uint32_t value );
+            void ClearSampleNumbers( void );
+    };
+}
+
+#endif /* ISOBMFF_STSS_HPP */
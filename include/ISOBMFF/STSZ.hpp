@@ -0,0 +1,72 @@
+/*!
+ * @header      STSZ.hpp
+ */
+
+#ifndef ISOBMFF_STSZ_HPP
+#define ISOBMFF_STSZ_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       STSZ
+     * @abstract    Sample size box (stsz), or compact sample size box (stz2).
+     * @discussion  Either every sample has the same size, or sizes are
+     *              listed per sample. For stz2 the per-sample sizes are 4,
+     *              8 or 16 bits.
+     */
+    class ISOBMFF_EXPORT STSZ: public FullBox, public XS::PIMPL::Object< STSZ >
+    {
+        public:
+            
+            using XS::PIMPL::Object< STSZ >::impl;
+            
+            STSZ( const std::string & name = "stsz" );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            /*!
+             * @function    GetSampleSize
+             * @abstract    Gets the size of every sample.
+             * @result      The common sample size, or 0 when sizes are
+             *              listed per sample.
+             */
+            uint32_t GetSampleSize( void )  const;
+            uint32_t GetSampleCount( void ) const;
+            
+            /*!
+             * @function    GetSampleSizeAt
+             * @abstract    Gets the size of a sample.
+             * @param       index   The 0-based sample index.
+             */
+            uint32_t GetSampleSizeAt( uint32_t index ) const;
+            
+            const std::vector< uint32_t > & GetEntrySizes( void ) const;
+            
+            /*!
+             * @function    SetSampleSize
+             * @abstract    Sets a common size for count samples.
+             * @discussion  Discards the per-sample sizes.
+             */
+            void SetSampleSize( uint32_t size, uint32_t count );
+            
+            /*!
+             * @function    AddEntrySize
+             * @abstract    Appends the size of a sample.
+             * @discussion  Clears a common sample size.
+             */
+            void AddEntrySize( uint32_t value );
+            void ClearEntrySizes( void );
+    };
+}
+
+#endif /* ISOBMFF_STSZ_HPP */
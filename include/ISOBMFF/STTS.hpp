@@ -0,0 +1,56 @@
+/*!
+ * @header      STTS.hpp
+ */
+
+#ifndef ISOBMFF_STTS_HPP
+#define ISOBMFF_STTS_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       STTS
+     * @abstract    Decoding time to sample box.
+     * @discussion  Run-length table of sample durations. Entries are plain
+     *              structs rather than displayable objects, as sample
+     *              tables of long tracks have millions of them.
+     */
+    class ISOBMFF_EXPORT STTS: public FullBox, public XS::PIMPL::Object< STTS >
+    {
+        public:
+            
+            struct Entry
+            {
+                uint32_t sampleCount;
+                uint32_t sampleDelta;
+            };
+            
+            using XS::PIMPL::Object< STTS >::impl;
+            
+            STTS( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            const std::vector< Entry > & GetEntries( void ) const;
+            
+            /*!
+             * @function    AddEntry
+             * @abstract    Adds a run of samples with the same duration.
+             * @discussion  Merged into the last entry when the delta is the
+             *              same, so adding one sample at a time keeps the
+             *              table run-length encoded.
+             */
+            void AddEntry( uint32_t sampleCount, uint32_t sampleDelta );
+            void ClearEntries( void );
+    };
+}
+
+#endif /* ISOBMFF_STTS_HPP */
@@ -0,0 +1,83 @@
+/*!
+ * @header      SampleEntry.hpp
+ */
+
+#ifndef ISOBMFF_SAMPLE_ENTRY_HPP
+#define ISOBMFF_SAMPLE_ENTRY_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/ContainerBox.hpp>
+#include <cstdint>
+#include <string>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       SampleEntry
+     * @abstract    Base class of the sample entries of an stsd box.
+     * @discussion  A sample entry starts with fixed fields, which depend on
+     *              the kind of track, followed by child boxes such as the
+     *              decoder configuration. The RFC 6381 codecs string is
+     *              derived once, when the entry is read.
+     */
+    class ISOBMFF_EXPORT SampleEntry: public ContainerBox, public XS::PIMPL::Object< SampleEntry >
+    {
+        public:
+            
+            using XS::PIMPL::Object< SampleEntry >::impl;
+            
+            SampleEntry( const std::string & name );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            uint16_t GetDataReferenceIndex( void ) const;
+            void     SetDataReferenceIndex( uint16_t value );
+            
+            /*!
+             * @function    GetCodingName
+             * @abstract    Gets the coding name of the samples.
+             * @result      The box type, or for protected entries (encv,
+             *              enca) the original format from sinf/frma.
+             */
+            std::string GetCodingName( void ) const;
+            
+            /*!
+             * @function    GetCodecs
+             * @abstract    Gets the RFC 6381 codecs parameter of the entry.
+             * @result      The codecs string, e.g. avc1.64001F, or the
+             *              coding name when it has no more parameters.
+             * @discussion  Computed when the entry is read, so this is a
+             *              plain accessor.
+             */
+            const std::string & GetCodecs( void ) const;
+        
+        protected:
+            
+            /*!
+             * @function    ReadFields
+             * @abstract    Reads the fields between the data reference index
+             *              and the child boxes.
+             */
+            virtual void ReadFields( IParser * parser, BinaryStream & stream );
+            
+            /*!
+             * @function    WriteFields
+             * @abstract    Writes the fields read by ReadFields.
+             */
+            virtual void WriteFields( BoxSink & sink ) const;
+            
+            /*!
+             * @function    MakeCodecs
+             * @abstract    Derives the codecs string, after the child boxes
+             *              are read.
+             */
+            virtual std::string MakeCodecs( void ) const;
+    };
+}
+
+#endif /* ISOBMFF_SAMPLE_ENTRY_HPP */
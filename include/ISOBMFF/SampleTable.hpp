@@ -0,0 +1,100 @@
+/*!
+ * @header      SampleTable.hpp
+ */
+
+#ifndef ISOBMFF_SAMPLE_TABLE_HPP
+#define ISOBMFF_SAMPLE_TABLE_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/ContainerBox.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ISOBMFF
+{
+    class STSD;
+    
+    /*!
+     * @class       SampleTable
+     * @abstract    Per-sample view of the sample table of a progressive track.
+     * @discussion  Expands the run-length tables of stbl (stts, ctts, stss,
+     *              stsz/stz2, stsc and stco/co64) into one record per
+     *              sample, so that samples can be located and timed by
+     *              index. Throws a std::runtime_error if a table is missing
+     *              or the tables disagree on the number of samples.
+     */
+    class ISOBMFF_EXPORT SampleTable: public XS::PIMPL::Object< SampleTable >
+    {
+        public:
+            
+            using XS::PIMPL::Object< SampleTable >::impl;
+            
+            /*!
+             * @struct      Sample
+             * @abstract    Location and timing of a sample.
+             * @discussion  Times are in the media timescale (mdhd). The
+             *              offset is absolute in the source file.
+             */
+            struct Sample
+            {
+                uint64_t offset;
+                uint32_t size;
+                uint64_t decodeTime;
+                uint32_t duration;
+                int32_t  compositionOffset;
+                uint32_t descriptionIndex;
+                bool     sync;
+            };
+            
+            /*!
+             * @function    SampleTable
+             * @abstract    Creates an empty table.
+             */
+            SampleTable( void );
+            
+            /*!
+             * @function    SampleTable
+             * @abstract    Expands the sample table of a track.
+             * @param       trak    The trak box.
+             */
+            SampleTable( const ContainerBox & trak );
+            
+            uint32_t    GetTrackID( void )     const;
+            uint32_t    GetTimescale( void )   const;
+            std::string GetHandlerType( void ) const;
+            
+            /*!
+             * @function    GetDuration
+             * @abstract    Gets the sum of the sample durations.
+             * @result      The duration, in the media timescale.
+             */
+            uint64_t GetDuration( void ) const;
+            
+            /*!
+             * @function    HasSyncSamples
+             * @abstract    Tests whether the track has a sync sample table.
+             * @result      True if stss is present. Without it, every
+             *              sample is a sync sample.
+             */
+            bool HasSyncSamples( void ) const;
+            
+            /*!
+             * @function    HasCompositionOffsets
+             * @abstract    Tests whether the track has a ctts box.
+             */
+            bool HasCompositionOffsets( void ) const;
+            
+            /*!
+             * @function    GetSampleDescriptions
+             * @abstract    Gets the stsd box of the track.
+             */
+            std::shared_ptr< STSD > GetSampleDescriptions( void ) const;
+            
+            const std::vector< Sample > & GetSamples( void ) const;
+    };
+}
+
+#endif /* ISOBMFF_SAMPLE_TABLE_HPP */
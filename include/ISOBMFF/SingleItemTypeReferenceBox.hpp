@@ -47,6 +47,7 @@ namespace ISOBMFF
             SingleItemTypeReferenceBox( const std::string & name );
             
             void                                                 ReadData(IParser *parser, BinaryStream &stream) override;
+            void                                                 WriteData( BoxSink & sink ) const override;
             std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
             
             uint32_t                GetFromItemID( void ) const;
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace ISOBMFF
+{
+    /**
+     * aligned(8) class TrackEncryptionBox
+     * extends FullBox('tenc', version, flags=0) {
+     * unsigned int(8) reserved = 0;
+     * if (version==0) {
+     * unsigned int(8) reserved = 0;
+     * } else { // version is 1 or greater
+     * unsigned int(4) default_crypt_byte_block;
+     * unsigned int(4) default_skip_byte_block;
+     * }
+     * unsigned int(8) default_isProtected;
+     * unsigned int(8) default_Per_Sample_IV_Size;
+     * unsigned int(8)[16] default_KID;
+     * if (default_isProtected ==1 && default_Per_Sample_IV_Size == 0) {
+     * unsigned int(8) default_constant_IV_size;
+     * unsigned int(8)[default_constant_IV_size] default_constant_IV;
+     * }
+     * }
+     */
+    class ISOBMFF_EXPORT TENC: public FullBox, public XS::PIMPL::Object< TENC >
+    {
+    public:
+        using XS::PIMPL::Object< TENC >::impl;
+
+        TENC();
+
+        void               ReadData(IParser *parser, BinaryStream &stream) override;
+        void               WriteData(BoxSink &sink) const override;
+        KeyValueStringList GetDisplayableProperties() const override;
+        void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
+
+        // Pattern encryption (cbcs, cens): 0 for both when the whole protected range is encrypted
+        uint8_t GetDefaultCryptByteBlock() const;
+        uint8_t GetDefaultSkipByteBlock() const;
+        bool    IsProtected() const;
+        uint8_t GetDefaultPerSampleIVSize() const;
+        const std::vector<uint8_t>& GetDefaultKID() const;
+        // Used by all samples when GetDefaultPerSampleIVSize() is 0
+        const std::vector<uint8_t>& GetDefaultConstantIV() const;
+    };
+}
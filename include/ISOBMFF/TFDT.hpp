@@ -0,0 +1,36 @@
+#pragma once
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+
+namespace ISOBMFF
+{
+    /**
+     * aligned(8) class TrackFragmentBaseMediaDecodeTimeBox
+     * extends FullBox('tfdt', version, 0) {
+     * if (version==1) {
+     * unsigned int(64) baseMediaDecodeTime;
+     * } else { // version==0
+     * unsigned int(32) baseMediaDecodeTime;
+     * }
+     * }
+     */
+    class ISOBMFF_EXPORT TFDT: public FullBox, public XS::PIMPL::Object< TFDT >
+    {
+    public:
+        using XS::PIMPL::Object< TFDT >::impl;
+
+        TFDT();
+
+        void               ReadData(IParser *parser, BinaryStream &stream) override;
+        void               WriteData(BoxSink &sink) const override;
+        KeyValueStringList GetDisplayableProperties() const override;
+        void WriteDescription( std::ostream & os, std::size_t indentLevel ) const override;
+
+        uint64_t GetBaseMediaDecodeTime() const;
+
+        void SetBaseMediaDecodeTime( uint64_t value );
+    };
+}
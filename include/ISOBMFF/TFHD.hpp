@@ -27,6 +27,7 @@ namespace ISOBMFF {
         TFHD();
 
         void ReadData(IParser *parser, BinaryStream &stream) override;
+        void WriteData(BoxSink &sink) const override;
 
         KeyValueStringList GetDisplayableProperties() const override;
 
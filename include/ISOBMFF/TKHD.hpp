@@ -48,6 +48,7 @@ namespace ISOBMFF
             TKHD( void );
             
             void                                                 ReadData(IParser *parser, BinaryStream &stream) override;
+            void                                                 WriteData( BoxSink & sink ) const override;
             std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
             
             uint64_t GetCreationTime( void )     const;
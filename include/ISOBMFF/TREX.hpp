@@ -0,0 +1,48 @@
+/*!
+ * @header      TREX.hpp
+ */
+
+#ifndef ISOBMFF_TREX_HPP
+#define ISOBMFF_TREX_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/FullBox.hpp>
+#include <cstdint>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       TREX
+     * @abstract    Track extends box.
+     * @discussion  Defaults for the samples of a track in movie fragments,
+     *              used when tfhd and trun do not override them.
+     */
+    class ISOBMFF_EXPORT TREX: public FullBox, public XS::PIMPL::Object< TREX >
+    {
+        public:
+            
+            using XS::PIMPL::Object< TREX >::impl;
+            
+            TREX( void );
+            
+            void ReadData( IParser * parser, BinaryStream & stream ) override;
+            void WriteData( BoxSink & sink ) const override;
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            uint32_t GetTrackID( void )                       const;
+            uint32_t GetDefaultSampleDescriptionIndex( void ) const;
+            uint32_t GetDefaultSampleDuration( void )         const;
+            uint32_t GetDefaultSampleSize( void )             const;
+            uint32_t GetDefaultSampleFlags( void )            const;
+            
+            void SetTrackID( uint32_t value );
+            void SetDefaultSampleDescriptionIndex( uint32_t value );
+            void SetDefaultSampleDuration( uint32_t value );
+            void SetDefaultSampleSize( uint32_t value );
+            void SetDefaultSampleFlags( uint32_t value );
+    };
+}
+
+#endif /* ISOBMFF_TREX_HPP */
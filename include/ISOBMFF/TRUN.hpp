@@ -42,6 +42,7 @@ namespace ISOBMFF {
         TRUN();
 
         void ReadData(IParser *parser, BinaryStream &stream) override;
+        void WriteData(BoxSink &sink) const override;
 
         KeyValueStringList GetDisplayableProperties() const override;
 
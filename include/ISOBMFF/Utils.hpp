@@ -101,6 +101,40 @@ namespace ISOBMFF
          */
         ISOBMFF_EXPORT std::string ToHexString( uint64_t u );
         
+        /*!
+         * @function    ToHexString
+         * @abstract    Returns an hexadecimal string representation of a byte array.
+         * @param       v   The bytes, e.g. a key ID or an IV.
+         * @result      The hexadecimal string representation of the bytes.
+         * @discussion  Result string will be prefixed by `0x`, with two
+         *              uppercase digits per byte.
+         */
+        ISOBMFF_EXPORT std::string ToHexString( const std::vector< uint8_t > & v );
+        
+        /*!
+         * @function    FourCC
+         * @abstract    Packs a four-character code into a 32-bits unsigned integer.
+         * @param       s   The four characters, e.g. a box type.
+         * @result      The characters as a big-endian integer, as stored in box headers.
+         * @discussion  Allows box types to be compared and switched on as
+         *              integers. Usable in constant expressions.
+         */
+        constexpr uint32_t FourCC( const char * s )
+        {
+            return ( static_cast< uint32_t >( static_cast< uint8_t >( s[ 0 ] ) ) << 24 )
+                 | ( static_cast< uint32_t >( static_cast< uint8_t >( s[ 1 ] ) ) << 16 )
+                 | ( static_cast< uint32_t >( static_cast< uint8_t >( s[ 2 ] ) ) <<  8 )
+                 |   static_cast< uint32_t >( static_cast< uint8_t >( s[ 3 ] ) );
+        }
+        
+        /*!
+         * @function    FourCCToString
+         * @abstract    Returns the four characters of a packed four-character code.
+         * @param       fourcc  The packed four-character code.
+         * @result      A four characters string.
+         */
+        ISOBMFF_EXPORT std::string FourCCToString( uint32_t fourcc );
+        
         /*!
          * @function        ToString
          * @abstract        Returns a string representation of a vector of values.
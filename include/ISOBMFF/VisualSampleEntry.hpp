@@ -0,0 +1,57 @@
+/*!
+ * @header      VisualSampleEntry.hpp
+ */
+
+#ifndef ISOBMFF_VISUAL_SAMPLE_ENTRY_HPP
+#define ISOBMFF_VISUAL_SAMPLE_ENTRY_HPP
+
+#include <XS/PIMPL/Object.hpp>
+#include <ISOBMFF/Macros.hpp>
+#include <ISOBMFF/SampleEntry.hpp>
+#include <cstdint>
+#include <string>
+
+namespace ISOBMFF
+{
+    /*!
+     * @class       VisualSampleEntry
+     * @abstract    Sample entry of video tracks (avc1, avc3, hvc1, hev1, encv).
+     * @discussion  The codecs string carries the profile and level from the
+     *              avcC or hvcC box, following RFC 6381 and ISO/IEC 14496-15
+     *              Annex E.
+     */
+    class ISOBMFF_EXPORT VisualSampleEntry: public SampleEntry, public XS::PIMPL::Object< VisualSampleEntry >
+    {
+        public:
+            
+            using XS::PIMPL::Object< VisualSampleEntry >::impl;
+            
+            VisualSampleEntry( const std::string & name );
+            
+            virtual std::vector< std::pair< std::string, std::string > > GetDisplayableProperties( void ) const override;
+            
+            uint16_t    GetWidth( void )                const;
+            uint16_t    GetHeight( void )               const;
+            double      GetHorizontalResolution( void ) const;
+            double      GetVerticalResolution( void )   const;
+            uint16_t    GetFrameCount( void )           const;
+            std::string GetCompressorName( void )       const;
+            uint16_t    GetDepth( void )                const;
+            
+            void SetWidth( uint16_t value );
+            void SetHeight( uint16_t value );
+            void SetHorizontalResolution( double value );
+            void SetVerticalResolution( double value );
+            void SetFrameCount( uint16_t value );
+            void SetCompressorName( const std::string & value );
+            void SetDepth( uint16_t value );
+        
+        protected:
+            
+            void        ReadFields( IParser * parser, BinaryStream & stream ) override;
+            void        WriteFields( BoxSink & sink ) const override;
+            std::string MakeCodecs( void ) const override;
+    };
+}
+
+#endif /* ISOBMFF_VISUAL_SAMPLE_ENTRY_HPP */
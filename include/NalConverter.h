@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ISOBMFF/AVCC.hpp"
+#include "ISOBMFF/HVCC.hpp"
+
+// Converts H.264/HEVC samples between the length-prefixed form of MP4 (NAL units preceded by their size in
+// lengthSize big-endian bytes, from avcC/hvcC) and Annex-B (NAL units preceded by 00 00 00 01 start codes).
+// Conversions work in place: data holds size bytes in a buffer of capacity bytes, and the converted size is returned.
+// With 4-byte length fields and 4-byte start codes the sizes match, and only the prefixes are rewritten.
+// A converter keeps scratch space between calls: it is not thread-safe, use one per stream.
+class NalConverter {
+public:
+    // Throws std::runtime_error unless lengthSize is 1, 2 or 4.
+    explicit NalConverter(size_t lengthSize = 4);
+    // Takes the length size and the parameter sets of the decoder configuration.
+    explicit NalConverter(const ISOBMFF::AVCC &avcc);
+    explicit NalConverter(const ISOBMFF::HVCC &hvcc);
+    ~NalConverter();
+
+    NalConverter(const NalConverter&) = delete;
+    NalConverter& operator=(const NalConverter&) = delete;
+
+    size_t lengthSize() const;
+
+    // Annex-B parameter sets of the avcC/hvcC, shared with the box rather than copied. Empty for a plain length size.
+    const std::shared_ptr<const std::vector<uint8_t>> &parameterSets() const;
+
+    // Sizes of the converted forms. Throw std::runtime_error for malformed data, like the conversions.
+    size_t annexBSize(const uint8_t *data, size_t size);
+    size_t lengthPrefixedSize(const uint8_t *data, size_t size);
+
+    // Length-prefixed to Annex-B. Throws if a NAL unit overruns the data or capacity is too small.
+    size_t toAnnexB(uint8_t *data, size_t size, size_t capacity);
+    size_t toAnnexB(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity);
+
+    // Like toAnnexB() to dst, with the parameter sets first, as decoders need them before a keyframe.
+    size_t toAnnexBWithParameterSets(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity);
+
+    // Annex-B to length-prefixed. 3 and 4-byte start codes are accepted and trailing zero bytes dropped.
+    // Throws if the data does not start with a start code, a NAL unit is too large for the length size,
+    // or capacity is too small. In place, capacity may have to exceed both sizes when start code sizes are mixed.
+    size_t toLengthPrefixed(uint8_t *data, size_t size, size_t capacity);
+    size_t toLengthPrefixed(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity);
+
+    // Finds the next 00 00 01 sequence in [begin, end), with SSE2/AVX2 when the CPU has them. Returns end if none.
+    static const uint8_t *findStartCode(const uint8_t *begin, const uint8_t *end);
+
+    // The start code scanners findStartCode() chooses from, so that they can be compared with each other.
+    enum class Scanner { Scalar, Sse2, Avx2 };
+    static bool isSupported(Scanner scanner);
+    // Throws std::runtime_error if the build or the CPU does not support the scanner.
+    static const uint8_t *findStartCode(const uint8_t *begin, const uint8_t *end, Scanner scanner);
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_impl;
+};
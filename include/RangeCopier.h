@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+// Copies byte ranges of a source file to the current position of an output descriptor, in the kernel when
+// possible: copy_file_range(), then sendfile() when the descriptors do not support it (e.g. a pipe, or another
+// filesystem on older kernels), then pread()/write() as a last resort or outside Linux. The method that worked
+// is kept for the following copies. Adjacent ranges queued with add() are copied together.
+// Descriptors are not closed. Not thread-safe.
+class RangeCopier {
+public:
+    RangeCopier();
+    ~RangeCopier();
+
+    RangeCopier(const RangeCopier&) = delete;
+    RangeCopier& operator=(const RangeCopier&) = delete;
+
+    // Copies length bytes at offset in in to out. Retries EINTR and short copies, throws std::runtime_error on
+    // errors, and if the source ends before the range.
+    void copy(int in, uint64_t offset, uint64_t length, int out);
+
+    // Queues a range, copying the pending one first unless the new range follows it in the same source.
+    void add(int in, uint64_t offset, uint64_t length, int out);
+    // Copies the pending range.
+    void flush();
+
+    uint64_t bytesCopied() const;
+    uint64_t copyCalls() const;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_impl;
+};
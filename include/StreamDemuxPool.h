@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "FMP4StreamParser.h"
+
+// Demuxes many pushed fMP4 streams on a fixed work-stealing thread pool.
+// Data for any stream can be pushed from any thread. Each stream is parsed by one worker at a time,
+// in push order, so the callbacks of a stream never run concurrently and see its boxes in order.
+class StreamDemuxPool {
+public:
+    using StreamId = uint64_t;
+    using ConfigureCallback     = std::function<void(FMP4StreamParser&)>;
+    using ErrorCallback         = std::function<void(StreamId id, const std::exception &error)>;
+    using BackpressureCallback  = std::function<void(StreamId id, bool backpressure)>;
+
+    struct StreamStats {
+        size_t   queuedChunks{0};   // Pushed but not parsed yet
+        size_t   queuedBytes{0};
+        uint64_t parsedChunks{0};
+        uint64_t parsedBytes{0};
+        std::chrono::microseconds lastParseTime{0};   // Time spent in parse() for the last chunk
+        std::chrono::microseconds maxParseTime{0};
+        std::chrono::microseconds lastLatency{0};     // From push() until the chunk was parsed
+        std::chrono::microseconds maxLatency{0};
+        bool                      backpressure{false};   // The last chunk went over the parser buffer limit or budget
+        FMP4StreamParser::Stats   parser;
+    };
+
+    explicit StreamDemuxPool(size_t threadCount = std::thread::hardware_concurrency());
+
+    // Parses all queued data, then stops the workers.
+    ~StreamDemuxPool();
+
+    StreamDemuxPool(const StreamDemuxPool&) = delete;
+    StreamDemuxPool& operator=(const StreamDemuxPool&) = delete;
+
+    // Creates a stream. configure runs before any data is parsed: register the parser callbacks there.
+    StreamId addStream(const ConfigureCallback &configure);
+
+    // Queues data for the stream. Thread-safe.
+    // Returns false if the stream is unknown, ended or was removed after an error; the data is dropped then.
+    bool push(StreamId id, const uint8_t *data, size_t size);
+    bool push(StreamId id, std::vector<uint8_t> &&data);
+
+    // Ends the stream once its queued data is parsed. The stream is removed afterwards.
+    bool endStream(StreamId id);
+
+    // Called on the worker when parsing a stream throws. The stream is removed and its queued data dropped.
+    // Set before adding streams.
+    void onError(const ErrorCallback &callback);
+
+    // Called on the worker when parsing a chunk starts or stops reporting backpressure, see
+    // FMP4StreamParser::setBufferLimit and setSharedBudget. Producers should hold back the stream's data
+    // until it stops. Set before adding streams.
+    void onBackpressure(const BackpressureCallback &callback);
+
+    // Blocks until all data pushed so far is parsed.
+    void waitIdle();
+
+    // Throws std::runtime_error for unknown streams.
+    StreamStats getStreamStats(StreamId id) const;
+    size_t streamCount() const;
+    size_t threadCount() const;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_impl;
+};
@@ -0,0 +1,159 @@
+#include "ADTSWriter.h"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    constexpr size_t HeaderSize = 7;
+    constexpr size_t MaxFrameSize = 0x1FFF - HeaderSize;
+}
+
+struct ADTSWriter::Private {
+    int fd;
+    std::array<uint8_t, HeaderSize> header{};
+    size_t batchSize{4 << 20};
+
+    // Headers and payloads of the queued frames, as they go out
+    std::vector<uint8_t> batch;
+    size_t pendingFrames{0};
+
+    uint64_t framesWritten{0};
+    uint64_t bytesWritten{0};
+    uint64_t writeCalls{0};
+
+    Private(int fd, uint8_t audioObjectType, uint8_t samplingFrequencyIndex, uint8_t channelConfiguration) : fd(fd) {
+        if (audioObjectType < 1 || audioObjectType > 4) {
+            throw std::runtime_error("ADTS cannot carry audio object type " + std::to_string(audioObjectType));
+        }
+        if (samplingFrequencyIndex > 12) {
+            throw std::runtime_error("ADTS cannot carry sampling frequency index " + std::to_string(samplingFrequencyIndex));
+        }
+        if (channelConfiguration > 7) {
+            throw std::runtime_error("ADTS cannot carry channel configuration " + std::to_string(channelConfiguration));
+        }
+        // Sync word, MPEG-4, no CRC; buffer fullness 0x7FF (VBR), one raw data block. The length goes in bytes 3 to 5.
+        header[0] = 0xFF;
+        header[1] = 0xF1;
+        header[2] = static_cast<uint8_t>(((audioObjectType - 1) << 6) | (samplingFrequencyIndex << 2) | (channelConfiguration >> 2));
+        header[3] = static_cast<uint8_t>((channelConfiguration & 0x03) << 6);
+        header[4] = 0x00;
+        header[5] = 0x1F;
+        header[6] = 0xFC;
+    }
+
+    void fill(size_t size, uint8_t *out) const {
+        if (size > MaxFrameSize) {
+            throw std::runtime_error("AAC frame of " + std::to_string(size) + " bytes is too large for ADTS");
+        }
+        const size_t length = size + HeaderSize;
+        std::memcpy(out, header.data(), HeaderSize);
+        out[3] |= static_cast<uint8_t>(length >> 11);
+        out[4] = static_cast<uint8_t>(length >> 3);
+        out[5] |= static_cast<uint8_t>((length & 0x07) << 5);
+    }
+
+    void queue(const uint8_t *data, size_t size) {
+        std::array<uint8_t, HeaderSize> frameHeader;
+        fill(size, frameHeader.data());
+        if (batch.empty()) {
+            batch.reserve(batchSize);
+        }
+        batch.insert(batch.end(), frameHeader.begin(), frameHeader.end());
+        batch.insert(batch.end(), data, data + size);
+        ++pendingFrames;
+        if (batch.size() >= batchSize) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (pendingFrames == 0) {
+            return;
+        }
+        const uint8_t *p = batch.data();
+        size_t left = batch.size();
+        while (left > 0) {
+            ssize_t written = ::write(fd, p, left);
+            ++writeCalls;
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // The stream is broken past a partial frame anyway: drop the queue rather than write frames twice
+                const int error = errno;
+                clear();
+                throw std::runtime_error(std::string("ADTS write failed: ") + std::strerror(error));
+            }
+            p += written;
+            left -= static_cast<size_t>(written);
+        }
+        framesWritten += pendingFrames;
+        bytesWritten += batch.size();
+        clear();
+    }
+
+    void clear() {
+        batch.clear();
+        pendingFrames = 0;
+    }
+};
+
+ADTSWriter::ADTSWriter(int fd, const ISOBMFF::ESDS &esds) {
+    if (!esds.HasAudioSpecificConfig()) {
+        throw std::runtime_error("esds has no MPEG-4 AudioSpecificConfig");
+    }
+    m_impl = std::make_unique<Private>(fd, esds.GetCoreAudioObjectType(), esds.GetSamplingFrequencyIndex(),
+                                       esds.GetChannelConfiguration());
+}
+
+ADTSWriter::ADTSWriter(int fd, uint8_t audioObjectType, uint8_t samplingFrequencyIndex, uint8_t channelConfiguration)
+    : m_impl(std::make_unique<Private>(fd, audioObjectType, samplingFrequencyIndex, channelConfiguration)) {
+}
+
+ADTSWriter::~ADTSWriter() {
+    try {
+        m_impl->flush();
+    } catch (const std::exception &) {
+    }
+}
+
+void ADTSWriter::header(size_t size, uint8_t out[7]) const {
+    m_impl->fill(size, out);
+}
+
+void ADTSWriter::write(const std::vector<Frame> &frames) {
+    for (const auto &frame : frames) {
+        m_impl->queue(frame.data.data(), frame.data.size());
+    }
+}
+
+void ADTSWriter::write(const Frame &frame) {
+    m_impl->queue(frame.data.data(), frame.data.size());
+}
+
+void ADTSWriter::write(const uint8_t *data, size_t size) {
+    m_impl->queue(data, size);
+}
+
+void ADTSWriter::flush() {
+    m_impl->flush();
+}
+
+void ADTSWriter::setBatchSize(size_t bytes) {
+    m_impl->batchSize = bytes;
+}
+
+uint64_t ADTSWriter::framesWritten() const {
+    return m_impl->framesWritten;
+}
+
+uint64_t ADTSWriter::bytesWritten() const {
+    return m_impl->bytesWritten;
+}
+
+uint64_t ADTSWriter::writeCalls() const {
+    return m_impl->writeCalls;
+}
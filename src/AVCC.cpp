@@ -0,0 +1,369 @@
+/*!
+ * @file        AVCC.cpp
+ */
+
+#include <ISOBMFF/AVCC.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/Utils.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::AVCC >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        void BuildParameterSets( void );
+        
+        uint8_t                                         _configurationVersion;
+        uint8_t                                         _avcProfileIndication;
+        uint8_t                                         _profileCompatibility;
+        uint8_t                                         _avcLevelIndication;
+        uint8_t                                         _lengthSizeMinusOne;
+        bool                                            _hasHighProfileFields;
+        uint8_t                                         _chromaFormat;
+        uint8_t                                         _bitDepthLumaMinus8;
+        uint8_t                                         _bitDepthChromaMinus8;
+        std::vector< std::vector< uint8_t > >           _sps;
+        std::vector< std::vector< uint8_t > >           _pps;
+        std::vector< std::vector< uint8_t > >           _spsExt;
+        std::shared_ptr< const std::vector< uint8_t > > _parameterSets;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::AVCC
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    static std::vector< uint8_t > ReadParameterSet( BinaryStream & stream )
+    {
+        std::vector< uint8_t > data;
+        uint16_t               size;
+        
+        size = stream.ReadBigEndianUInt16();
+        
+        if( size > 0 )
+        {
+            data.resize( size );
+            stream.Read( &( data[ 0 ] ), size );
+        }
+        
+        return data;
+    }
+    
+    static void WriteParameterSet( BoxSink & sink, const std::vector< uint8_t > & data )
+    {
+        sink.WriteBigEndianUInt16( static_cast< uint16_t >( data.size() ) );
+        sink.Write( data );
+    }
+    
+    AVCC::AVCC( void ): Box( "avcC" )
+    {}
+    
+    void AVCC::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint8_t count;
+        uint8_t profile;
+        
+        ( void )parser;
+        
+        this->impl->_sps.clear();
+        this->impl->_pps.clear();
+        this->impl->_spsExt.clear();
+        
+        this->SetConfigurationVersion( stream.ReadUInt8() );
+        this->SetAVCProfileIndication( stream.ReadUInt8() );
+        this->SetProfileCompatibility( stream.ReadUInt8() );
+        this->SetAVCLevelIndication( stream.ReadUInt8() );
+        this->SetLengthSizeMinusOne( stream.ReadUInt8() & 0x03 );
+        
+        count = stream.ReadUInt8() & 0x1F;
+        
+        for( uint8_t i = 0; i < count; i++ )
+        {
+            this->impl->_sps.push_back( ReadParameterSet( stream ) );
+        }
+        
+        count = stream.ReadUInt8();
+        
+        for( uint8_t i = 0; i < count; i++ )
+        {
+            this->impl->_pps.push_back( ReadParameterSet( stream ) );
+        }
+        
+        profile = this->GetAVCProfileIndication();
+        
+        this->impl->_hasHighProfileFields = false;
+        
+        if( ( profile == 100 || profile == 110 || profile == 122 || profile == 144 ) && stream.GetBytesAvailable() >= 4 )
+        {
+            this->impl->_hasHighProfileFields = true;
+            
+            this->SetChromaFormat( stream.ReadUInt8() & 0x03 );
+            this->SetBitDepthLumaMinus8( stream.ReadUInt8() & 0x07 );
+            this->SetBitDepthChromaMinus8( stream.ReadUInt8() & 0x07 );
+            
+            count = stream.ReadUInt8();
+            
+            for( uint8_t i = 0; i < count; i++ )
+            {
+                this->impl->_spsExt.push_back( ReadParameterSet( stream ) );
+            }
+        }
+        
+        this->impl->BuildParameterSets();
+    }
+    
+    void AVCC::WriteData( BoxSink & sink ) const
+    {
+        sink.WriteUInt8( this->GetConfigurationVersion() );
+        sink.WriteUInt8( this->GetAVCProfileIndication() );
+        sink.WriteUInt8( this->GetProfileCompatibility() );
+        sink.WriteUInt8( this->GetAVCLevelIndication() );
+        sink.WriteUInt8( static_cast< uint8_t >( 0xFC | this->GetLengthSizeMinusOne() ) );
+        sink.WriteUInt8( static_cast< uint8_t >( 0xE0 | this->impl->_sps.size() ) );
+        
+        for( const auto & sps: this->impl->_sps )
+        {
+            WriteParameterSet( sink, sps );
+        }
+        
+        sink.WriteUInt8( static_cast< uint8_t >( this->impl->_pps.size() ) );
+        
+        for( const auto & pps: this->impl->_pps )
+        {
+            WriteParameterSet( sink, pps );
+        }
+        
+        if( this->HasHighProfileFields() )
+        {
+            sink.WriteUInt8( static_cast< uint8_t >( 0xFC | this->GetChromaFormat() ) );
+            sink.WriteUInt8( static_cast< uint8_t >( 0xF8 | this->GetBitDepthLumaMinus8() ) );
+            sink.WriteUInt8( static_cast< uint8_t >( 0xF8 | this->GetBitDepthChromaMinus8() ) );
+            sink.WriteUInt8( static_cast< uint8_t >( this->impl->_spsExt.size() ) );
+            
+            for( const auto & ext: this->impl->_spsExt )
+            {
+                WriteParameterSet( sink, ext );
+            }
+        }
+    }
+    
+    void AVCC::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
+    {
+        Box::WriteDescription( os, indentLevel );
+    }
+    
+    std::vector< std::pair< std::string, std::string > > AVCC::GetDisplayableProperties( void ) const
+    {
+        auto props( Box::GetDisplayableProperties() );
+        
+        props.push_back( { "Configuration version",  std::to_string( this->GetConfigurationVersion() ) } );
+        props.push_back( { "AVC profile indication", std::to_string( this->GetAVCProfileIndication() ) } );
+        props.push_back( { "Profile compatibility",  Utils::ToHexString( this->GetProfileCompatibility() ) } );
+        props.push_back( { "AVC level indication",   std::to_string( this->GetAVCLevelIndication() ) } );
+        props.push_back( { "Length size minus one",  std::to_string( this->GetLengthSizeMinusOne() ) } );
+        
+        if( this->HasHighProfileFields() )
+        {
+            props.push_back( { "Chroma format",            std::to_string( this->GetChromaFormat() ) } );
+            props.push_back( { "Bit depth luma minus 8",   std::to_string( this->GetBitDepthLumaMinus8() ) } );
+            props.push_back( { "Bit depth chroma minus 8", std::to_string( this->GetBitDepthChromaMinus8() ) } );
+        }
+        
+        for( const auto & sps: this->GetSequenceParameterSets() )
+        {
+            props.push_back( { "SPS", Utils::ToHexString( sps ) } );
+        }
+        
+        for( const auto & pps: this->GetPictureParameterSets() )
+        {
+            props.push_back( { "PPS", Utils::ToHexString( pps ) } );
+        }
+        
+        for( const auto & ext: this->GetSequenceParameterSetExtensions() )
+        {
+            props.push_back( { "SPS extension", Utils::ToHexString( ext ) } );
+        }
+        
+        return props;
+    }
+    
+    uint8_t AVCC::GetConfigurationVersion( void ) const
+    {
+        return this->impl->_configurationVersion;
+    }
+    
+    uint8_t AVCC::GetAVCProfileIndication( void ) const
+    {
+        return this->impl->_avcProfileIndication;
+    }
+    
+    uint8_t AVCC::GetProfileCompatibility( void ) const
+    {
+        return this->impl->_profileCompatibility;
+    }
+    
+    uint8_t AVCC::GetAVCLevelIndication( void ) const
+    {
+        return this->impl->_avcLevelIndication;
+    }
+    
+    uint8_t AVCC::GetLengthSizeMinusOne( void ) const
+    {
+        return this->impl->_lengthSizeMinusOne;
+    }
+    
+    bool AVCC::HasHighProfileFields( void ) const
+    {
+        return this->impl->_hasHighProfileFields;
+    }
+    
+    uint8_t AVCC::GetChromaFormat( void ) const
+    {
+        return this->impl->_chromaFormat;
+    }
+    
+    uint8_t AVCC::GetBitDepthLumaMinus8( void ) const
+    {
+        return this->impl->_bitDepthLumaMinus8;
+    }
+    
+    uint8_t AVCC::GetBitDepthChromaMinus8( void ) const
+    {
+        return this->impl->_bitDepthChromaMinus8;
+    }
+    
+    void AVCC::SetConfigurationVersion( uint8_t value )
+    {
+        this->impl->_configurationVersion = value;
+    }
+    
+    void AVCC::SetAVCProfileIndication( uint8_t value )
+    {
+        this->impl->_avcProfileIndication = value;
+    }
+    
+    void AVCC::SetProfileCompatibility( uint8_t value )
+    {
+        this->impl->_profileCompatibility = value;
+    }
+    
+    void AVCC::SetAVCLevelIndication( uint8_t value )
+    {
+        this->impl->_avcLevelIndication = value;
+    }
+    
+    void AVCC::SetLengthSizeMinusOne( uint8_t value )
+    {
+        this->impl->_lengthSizeMinusOne = value;
+    }
+    
+    void AVCC::SetChromaFormat( uint8_t value )
+    {
+        this->impl->_hasHighProfileFields = true;
+        this->impl->_chromaFormat         = value;
+    }
+    
+    void AVCC::SetBitDepthLumaMinus8( uint8_t value )
+    {
+        this->impl->_hasHighProfileFields = true;
+        this->impl->_bitDepthLumaMinus8   = value;
+    }
+    
+    void AVCC::SetBitDepthChromaMinus8( uint8_t value )
+    {
+        this->impl->_hasHighProfileFields = true;
+        this->impl->_bitDepthChromaMinus8 = value;
+    }
+    
+    const std::vector< std::vector< uint8_t > > & AVCC::GetSequenceParameterSets( void ) const
+    {
+        return this->impl->_sps;
+    }
+    
+    const std::vector< std::vector< uint8_t > > & AVCC::GetPictureParameterSets( void ) const
+    {
+        return this->impl->_pps;
+    }
+    
+    const std::vector< std::vector< uint8_t > > & AVCC::GetSequenceParameterSetExtensions( void ) const
+    {
+        return this->impl->_spsExt;
+    }
+    
+    void AVCC::AddSequenceParameterSet( const std::vector< uint8_t > & value )
+    {
+        this->impl->_sps.push_back( value );
+        this->impl->BuildParameterSets();
+    }
+    
+    void AVCC::AddPictureParameterSet( const std::vector< uint8_t > & value )
+    {
+        this->impl->_pps.push_back( value );
+        this->impl->BuildParameterSets();
+    }
+    
+    void AVCC::AddSequenceParameterSetExtension( const std::vector< uint8_t > & value )
+    {
+        this->impl->_spsExt.push_back( value );
+        this->impl->BuildParameterSets();
+    }
+    
+    std::shared_ptr< const std::vector< uint8_t > > AVCC::GetParameterSets( void ) const
+    {
+        return this->impl->_parameterSets;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::AVCC >::IMPL::IMPL( void ):
+    _configurationVersion( 0 ),
+    _avcProfileIndication( 0 ),
+    _profileCompatibility( 0 ),
+    _avcLevelIndication( 0 ),
+    _lengthSizeMinusOne( 0 ),
+    _hasHighProfileFields( false ),
+    _chromaFormat( 0 ),
+    _bitDepthLumaMinus8( 0 ),
+    _bitDepthChromaMinus8( 0 ),
+    _parameterSets( std::make_shared< const std::vector< uint8_t > >() )
+{}
+
+XS::PIMPL::Object< ISOBMFF::AVCC >::IMPL::IMPL( const IMPL & o ):
+    _configurationVersion( o._configurationVersion ),
+    _avcProfileIndication( o._avcProfileIndication ),
+    _profileCompatibility( o._profileCompatibility ),
+    _avcLevelIndication( o._avcLevelIndication ),
+    _lengthSizeMinusOne( o._lengthSizeMinusOne ),
+    _hasHighProfileFields( o._hasHighProfileFields ),
+    _chromaFormat( o._chromaFormat ),
+    _bitDepthLumaMinus8( o._bitDepthLumaMinus8 ),
+    _bitDepthChromaMinus8( o._bitDepthChromaMinus8 ),
+    _sps( o._sps ),
+    _pps( o._pps ),
+    _spsExt( o._spsExt ),
+    _parameterSets( o._parameterSets )
+{}
+
+XS::PIMPL::Object< ISOBMFF::AVCC >::IMPL::~IMPL( void )
+{}
+
+void XS::PIMPL::Object< ISOBMFF::AVCC >::IMPL::BuildParameterSets( void )
+{
+    std::vector< uint8_t > data;
+    
+    for( const auto * list: { &( this->_sps ), &( this->_pps ), &( this->_spsExt ) } )
+    {
+        for( const auto & unit: *( list ) )
+        {
+            data.insert( data.end(), { 0, 0, 0, 1 } );
+            data.insert( data.end(), unit.begin(), unit.end() );
+        }
+    }
+    
+    /* Replaced, never modified: holders of the previous data keep a consistent copy */
+    this->_parameterSets = std::make_shared< const std::vector< uint8_t > >( std::move( data ) );
+}
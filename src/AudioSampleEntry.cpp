@@ -0,0 +1,231 @@
+/*!
+ * @file        AudioSampleEntry.cpp
+ */
+
+#include <ISOBMFF/AudioSampleEntry.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/ESDS.hpp>
+#include <cstdio>
+#include <cstring>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::AudioSampleEntry >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint16_t               _version;
+        uint16_t               _channelCount;
+        uint16_t               _sampleSize;
+        double                 _sampleRate;
+        uint8_t                _revisionAndVendor[ 6 ];
+        uint32_t               _compressionAndPacketSize;
+        std::vector< uint8_t > _extension;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::AudioSampleEntry
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    AudioSampleEntry::AudioSampleEntry( const std::string & name ): SampleEntry( name )
+    {}
+    
+    void AudioSampleEntry::ReadFields( IParser * parser, BinaryStream & stream )
+    {
+        uint64_t u64;
+        double   rate;
+        
+        ( void )parser;
+        
+        this->SetVersion( stream.ReadBigEndianUInt16() );
+        
+        /* Revision level and vendor, kept as is to be written back */
+        stream.Read( this->impl->_revisionAndVendor, sizeof( this->impl->_revisionAndVendor ) );
+        
+        this->SetChannelCount( stream.ReadBigEndianUInt16() );
+        this->SetSampleSize( stream.ReadBigEndianUInt16() );
+        
+        /* Compression ID and packet size */
+        this->impl->_compressionAndPacketSize = stream.ReadBigEndianUInt32();
+        
+        this->SetSampleRate( stream.ReadBigEndianFixedPoint( 16, 16 ) );
+        
+        this->impl->_extension.clear();
+        
+        if( this->GetVersion() == 1 )
+        {
+            /* Samples per packet, bytes per packet, bytes per frame and bytes per sample */
+            this->impl->_extension.resize( 16 );
+            stream.Read( &( this->impl->_extension[ 0 ] ), this->impl->_extension.size() );
+        }
+        else if( this->GetVersion() == 2 )
+        {
+            /* Size of struct, then the actual rate as a 64-bit float */
+            stream.ReadBigEndianUInt32();
+            
+            u64 = stream.ReadBigEndianUInt64();
+            
+            memcpy( &rate, &u64, sizeof( rate ) );
+            
+            this->SetSampleRate( rate );
+            this->SetChannelCount( static_cast< uint16_t >( stream.ReadBigEndianUInt32() ) );
+            
+            /* 0x7F000000, bits per channel, format specific flags, bytes per packet and frames per packet */
+            this->impl->_extension.resize( 20 );
+            stream.Read( &( this->impl->_extension[ 0 ] ), this->impl->_extension.size() );
+        }
+    }
+    
+    void AudioSampleEntry::WriteFields( BoxSink & sink ) const
+    {
+        std::vector< uint8_t > extension( this->impl->_extension );
+        uint64_t               u64;
+        double                 rate;
+        
+        sink.WriteBigEndianUInt16( this->GetVersion() );
+        sink.Write( this->impl->_revisionAndVendor, sizeof( this->impl->_revisionAndVendor ) );
+        
+        if( this->GetVersion() == 2 )
+        {
+            /* The version 0 fields have fixed values, the actual ones follow */
+            sink.WriteBigEndianUInt16( 3 );
+            sink.WriteBigEndianUInt16( 16 );
+            sink.WriteBigEndianUInt32( 0xFFFE0000 );
+            sink.WriteBigEndianFixedPoint( 1, 16, 16 );
+            sink.WriteBigEndianUInt32( 72 );
+            
+            rate = this->GetSampleRate();
+            
+            memcpy( &u64, &rate, sizeof( u64 ) );
+            
+            extension.resize( 20 );
+            
+            sink.WriteBigEndianUInt64( u64 );
+            sink.WriteBigEndianUInt32( this->GetChannelCount() );
+            sink.Write( extension );
+            
+            return;
+        }
+        
+        sink.WriteBigEndianUInt16( this->GetChannelCount() );
+        sink.WriteBigEndianUInt16( this->GetSampleSize() );
+        sink.WriteBigEndianUInt32( this->impl->_compressionAndPacketSize );
+        sink.WriteBigEndianFixedPoint( this->GetSampleRate(), 16, 16 );
+        
+        if( this->GetVersion() == 1 )
+        {
+            extension.resize( 16 );
+            sink.Write( extension );
+        }
+    }
+    
+    std::string AudioSampleEntry::MakeCodecs( void ) const
+    {
+        std::string             name( this->GetCodingName() );
+        std::shared_ptr< ESDS > esds;
+        char                    s[ 16 ];
+        
+        if( name != "mp4a" )
+        {
+            return name;
+        }
+        
+        esds = this->GetTypedBox< ESDS >( "esds" );
+        
+        if( esds == nullptr || esds->GetObjectTypeIndication() == 0 )
+        {
+            return name;
+        }
+        
+        if( esds->HasAudioSpecificConfig() )
+        {
+            snprintf( s, sizeof( s ), ".%X.%u", static_cast< unsigned int >( esds->GetObjectTypeIndication() ), static_cast< unsigned int >( esds->GetAudioObjectType() ) );
+        }
+        else
+        {
+            snprintf( s, sizeof( s ), ".%X", static_cast< unsigned int >( esds->GetObjectTypeIndication() ) );
+        }
+        
+        return name + s;
+    }
+    
+    std::vector< std::pair< std::string, std::string > > AudioSampleEntry::GetDisplayableProperties( void ) const
+    {
+        auto props( SampleEntry::GetDisplayableProperties() );
+        
+        props.push_back( { "Version",       std::to_string( this->GetVersion() ) } );
+        props.push_back( { "Channel count", std::to_string( this->GetChannelCount() ) } );
+        props.push_back( { "Sample size",   std::to_string( this->GetSampleSize() ) } );
+        props.push_back( { "Sample rate",   std::to_string( this->GetSampleRate() ) } );
+        
+        return props;
+    }
+    
+    uint16_t AudioSampleEntry::GetVersion( void ) const
+    {
+        return this->impl->_version;
+    }
+    
+    uint16_t AudioSampleEntry::GetChannelCount( void ) const
+    {
+        return this->impl->_channelCount;
+    }
+    
+    uint16_t AudioSampleEntry::GetSampleSize( void ) const
+    {
+        return this->impl->_sampleSize;
+    }
+    
+    double AudioSampleEntry::GetSampleRate( void ) const
+    {
+        return this->impl->_sampleRate;
+    }
+    
+    void AudioSampleEntry::SetVersion( uint16_t value )
+    {
+        this->impl->_version = value;
+    }
+    
+    void AudioSampleEntry::SetChannelCount( uint16_t value )
+    {
+        this->impl->_channelCount = value;
+    }
+    
+    void AudioSampleEntry::SetSampleSize( uint16_t value )
+    {
+        this->impl->_sampleSize = value;
+    }
+    
+    void AudioSampleEntry::SetSampleRate( double value )
+    {
+        this->impl->_sampleRate = value;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::AudioSampleEntry >::IMPL::IMPL( void ):
+    _version( 0 ),
+    _channelCount( 2 ),
+    _sampleSize( 16 ),
+    _sampleRate( 0 ),
+    _revisionAndVendor{ 0, 0, 0, 0, 0, 0 },
+    _compressionAndPacketSize( 0 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::AudioSampleEntry >::IMPL::IMPL( const IMPL & o ):
+    _version( o._version ),
+    _channelCount( o._channelCount ),
+    _sampleSize( o._sampleSize ),
+    _sampleRate( o._sampleRate ),
+    _compressionAndPacketSize( o._compressionAndPacketSize ),
+    _extension( o._extension )
+{
+    memcpy( this->_revisionAndVendor, o._revisionAndVendor, sizeof( this->_revisionAndVendor ) );
+}
+
+XS::PIMPL::Object< ISOBMFF::AudioSampleEntry >::IMPL::~IMPL( void )
+{}
@@ -30,8 +30,10 @@
 
 #include <ISOBMFF/BinaryStream.hpp>
 #include <fstream>
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 
 #ifdef _WIN32
 #include <ISOBMFF/WIN32.hpp>
@@ -48,9 +50,20 @@ class XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL
         IMPL( const IMPL & o );
         ~IMPL( void );
         
+        bool IsView( void ) const;
+        
         std::vector< uint8_t > _bytes;
         mutable std::ifstream  _stream;
         std::string            _path;
+        
+        /*
+         * Memory-backed streams read through a cursor. The data is either
+         * owned (_bytes) or a view on memory owned by someone else.
+         */
+        const uint8_t        * _data;
+        uint64_t               _size;
+        uint64_t               _pos;
+        uint64_t               _offset;     /* Absolute offset of _data[ 0 ] */
 };
 
 #define XS_PIMPL_CLASS ISOBMFF::BinaryStream
@@ -67,11 +80,63 @@ namespace ISOBMFF
 	BinaryStream::BinaryStream( const std::vector< uint8_t > & bytes ): XS::PIMPL::Object< BinaryStream >( bytes )
 	{}
     
-    BinaryStream::BinaryStream( BinaryStream & stream, uint64_t length ): BinaryStream( std::vector< uint8_t >( static_cast< size_t >( length ) ) )
+    BinaryStream::BinaryStream( const uint8_t * bytes, uint64_t length, uint64_t offset )
+    {
+        this->impl->_bytes.assign( bytes, bytes + length );
+        
+        this->impl->_data   = this->impl->_bytes.data();
+        this->impl->_size   = length;
+        this->impl->_offset = offset;
+    }
+    
+    BinaryStream::BinaryStream( BinaryStream & stream, uint64_t length )
     {
-        if( length > 0 )
+        this->SetSubStream( stream, length );
+    }
+    
+    void BinaryStream::SetView( const uint8_t * bytes, uint64_t length, uint64_t offset )
+    {
+        if( this->impl->_stream.is_open() )
         {
-            stream.Read( &( this->impl->_bytes[ 0 ] ), length );
+            this->impl->_stream.close();
+        }
+        
+        /* Owned storage is released, not only emptied */
+        std::vector< uint8_t >().swap( this->impl->_bytes );
+        
+        this->impl->_data   = bytes;
+        this->impl->_size   = length;
+        this->impl->_pos    = 0;
+        this->impl->_offset = offset;
+    }
+    
+    void BinaryStream::SetSubStream( BinaryStream & stream, uint64_t length )
+    {
+        uint64_t offset;
+        
+        offset = stream.GetOffset();
+        
+        if( stream.impl->_stream.is_open() )
+        {
+            /* Reuses the capacity of previous contents */
+            this->impl->_bytes.resize( static_cast< size_t >( length ) );
+            
+            if( length > 0 )
+            {
+                stream.Read( &( this->impl->_bytes[ 0 ] ), length );
+            }
+            
+            this->impl->_data   = this->impl->_bytes.data();
+            this->impl->_size   = length;
+            this->impl->_pos    = 0;
+            this->impl->_offset = offset;
+        }
+        else
+        {
+            length = std::min( length, stream.GetBytesAvailable() );
+            
+            this->SetView( stream.impl->_data + stream.impl->_pos, length, offset );
+            stream.DeleteBytes( length );
         }
     }
     
@@ -96,8 +161,39 @@ namespace ISOBMFF
         }
         else
         {
-            return this->impl->_bytes.size() > 0;
+            return this->impl->_pos < this->impl->_size;
+        }
+    }
+    
+    uint64_t BinaryStream::GetBytesAvailable( void ) const
+    {
+        if( this->impl->_stream.is_open() )
+        {
+            std::streampos cur;
+            std::streampos end;
+            
+            cur = this->impl->_stream.tellg();
+            
+            this->impl->_stream.seekg( 0, std::ios::end );
+            
+            end = this->impl->_stream.tellg();
+            
+            this->impl->_stream.seekg( cur, std::ios::beg );
+            
+            return ( cur < end ) ? static_cast< uint64_t >( end - cur ) : 0;
+        }
+        
+        return this->impl->_size - this->impl->_pos;
+    }
+    
+    uint64_t BinaryStream::GetOffset( void ) const
+    {
+        if( this->impl->_stream.is_open() )
+        {
+            return static_cast< uint64_t >( this->impl->_stream.tellg() );
         }
+        
+        return this->impl->_offset + this->impl->_pos;
     }
     
     uint8_t BinaryStream::ReadUInt8( void )
@@ -470,17 +566,25 @@ namespace ISOBMFF
     
     Matrix BinaryStream::ReadMatrix( void )
     {
+        uint32_t values[ 9 ];
+        
+        /* Not as constructor arguments, which may be evaluated in any order */
+        for( uint32_t & value: values )
+        {
+            value = this->ReadBigEndianUInt32();
+        }
+        
         return Matrix
         (
-            this->ReadBigEndianUInt32(),
-            this->ReadBigEndianUInt32(),
-            this->ReadBigEndianUInt32(),
-            this->ReadBigEndianUInt32(),
-            this->ReadBigEndianUInt32(),
-            this->ReadBigEndianUInt32(),
-            this->ReadBigEndianUInt32(),
-            this->ReadBigEndianUInt32(),
-            this->ReadBigEndianUInt32()
+            values[ 0 ],
+            values[ 1 ],
+            values[ 2 ],
+            values[ 3 ],
+            values[ 4 ],
+            values[ 5 ],
+            values[ 6 ],
+            values[ 7 ],
+            values[ 8 ]
         );
     }
     
@@ -488,6 +592,13 @@ namespace ISOBMFF
     {
         std::vector< uint8_t > v;
         
+        this->ReadAllData( v );
+        
+        return v;
+    }
+    
+    void BinaryStream::ReadAllData( std::vector< uint8_t > & data )
+    {
         if( this->impl->_stream.is_open() )
         {
             {
@@ -498,19 +609,31 @@ namespace ISOBMFF
                 
                 this->impl->_stream.seekg( 0, std::ios::end );
                 
-                length = this->impl->_stream.tellg();
-                v      = std::vector< uint8_t >( static_cast< std::size_t >( length ) );
+                length = this->impl->_stream.tellg() - cur;
+                
+                data.resize( static_cast< std::size_t >( length ) );
                 
                 this->impl->_stream.seekg( cur, std::ios::beg );
-                this->impl->_stream.read( reinterpret_cast< char * >( &( v[ 0 ] ) ), length );
+                this->impl->_stream.read( reinterpret_cast< char * >( data.data() ), length );
             }
         }
+        else if( this->impl->IsView() == false && this->impl->_pos == 0 )
+        {
+            /* Owned data that was not read yet is handed over without a copy */
+            swap( data, this->impl->_bytes );
+            
+            this->impl->_bytes.clear();
+            
+            this->impl->_offset += this->impl->_size;
+            this->impl->_data    = this->impl->_bytes.data();
+            this->impl->_size    = 0;
+        }
         else
         {
-            swap( v, this->impl->_bytes );
+            data.assign( this->impl->_data + this->impl->_pos, this->impl->_data + this->impl->_size );
+            
+            this->impl->_pos = this->impl->_size;
         }
-        
-        return v;
     }
     
     void BinaryStream::Read( uint8_t * buf, uint64_t length )
@@ -521,8 +644,22 @@ namespace ISOBMFF
         }
         else
         {
-            memcpy( static_cast< void * >( buf ), static_cast< const void * >( &( this->impl->_bytes[ 0 ] ) ), static_cast< size_t >( length ) );
-            this->DeleteBytes( length );
+            uint64_t available;
+            
+            /* Reading past the end yields zeros, like a failed file read leaves the buffer untouched */
+            available = std::min( length, this->impl->_size - this->impl->_pos );
+            
+            if( available > 0 )
+            {
+                memcpy( static_cast< void * >( buf ), static_cast< const void * >( this->impl->_data + this->impl->_pos ), static_cast< size_t >( available ) );
+            }
+            
+            if( available < length )
+            {
+                memset( static_cast< void * >( buf + available ), 0, static_cast< size_t >( length - available ) );
+            }
+            
+            this->impl->_pos += available;
         }
     }
     
@@ -542,7 +679,7 @@ namespace ISOBMFF
         }
         else
         {
-            memcpy( static_cast< void * >( buf ), static_cast< const void * >( &( this->impl->_bytes[ static_cast< size_t >( pos ) ] ) ), static_cast< size_t >( length ) );
+            memcpy( static_cast< void * >( buf ), static_cast< const void * >( this->impl->_data + this->impl->_pos + pos ), static_cast< size_t >( length ) );
         }
     }
     
@@ -554,16 +691,24 @@ namespace ISOBMFF
         }
         else
         {
-            std::vector< uint8_t >( this->impl->_bytes.begin() + static_cast< std::vector< uint8_t >::difference_type >( length ), this->impl->_bytes.end() ).swap( this->impl->_bytes );
+            this->impl->_pos += std::min( length, this->impl->_size - this->impl->_pos );
         }
     }
 }
 
-XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::IMPL( void )
+XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::IMPL( void ):
+    _data( nullptr ),
+    _size( 0 ),
+    _pos( 0 ),
+    _offset( 0 )
 {}
 
 XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::IMPL( const std::string & path ):
-    _path( path )
+    _path( path ),
+    _data( nullptr ),
+    _size( 0 ),
+    _pos( 0 ),
+    _offset( 0 )
 {
 	#ifdef _WIN32
 	this->_stream.open( ISOBMFF::StringToWideString( path ), std::ios::binary );
@@ -573,12 +718,20 @@ XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::IMPL( const std::string & path
 }
 
 XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::IMPL( const std::vector< uint8_t > & bytes ):
-    _bytes( bytes )
+    _bytes( bytes ),
+    _data( _bytes.data() ),
+    _size( _bytes.size() ),
+    _pos( 0 ),
+    _offset( 0 )
 {}
 
 XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::IMPL( const IMPL & o ):
     _bytes( o._bytes ),
-    _path( o._path )
+    _path( o._path ),
+    _data( o.IsView() ? o._data : _bytes.data() ),
+    _size( o._size ),
+    _pos( o._pos ),
+    _offset( o._offset )
 {
     std::ifstream::pos_type pos;
     
@@ -601,6 +754,11 @@ XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::IMPL( const IMPL & o ):
     }
 }
 
+bool XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::IsView( void ) const
+{
+    return this->_data != this->_bytes.data();
+}
+
 XS::PIMPL::Object< ISOBMFF::BinaryStream >::IMPL::~IMPL( void )
 {
     if( this->_stream.is_open() )
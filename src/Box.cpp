@@ -29,9 +29,11 @@
  */
 
 #include <ISOBMFF/Box.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/Utils.hpp>
 #include <ISOBMFF/DisplayableObjectContainer.hpp>
 #include <ISOBMFF/IParser.hpp>
+#include <stdexcept>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::Box >::IMPL
@@ -45,6 +47,9 @@ class XS::PIMPL::Object< ISOBMFF::Box >::IMPL
         std::string            _name;
         std::vector< uint8_t > _data;
         bool                   _hasData;
+        uint64_t               _dataOffset;
+        uint64_t               _dataLength;
+        bool                   _dataSkipped;
 };
 
 #define XS_PIMPL_CLASS ISOBMFF::Box
@@ -64,7 +69,7 @@ namespace ISOBMFF
     {
         ( void )parser;
         
-        this->impl->_data    = stream.ReadAllData();
+        stream.ReadAllData( this->impl->_data );
         this->impl->_hasData = true;
     }
     
@@ -73,21 +78,83 @@ namespace ISOBMFF
         return this->impl->_data;
     }
     
+    void Box::Write( BoxSink & sink ) const
+    {
+        std::size_t box;
+        
+        box = sink.BeginBox( this->GetName() );
+        
+        this->WriteData( sink );
+        sink.EndBox( box );
+    }
+    
+    void Box::WriteData( BoxSink & sink ) const
+    {
+        if( this->IsDataSkipped() )
+        {
+            throw std::runtime_error( "Cannot write box " + this->GetName() + ": its data was skipped while parsing" );
+        }
+        
+        sink.Reference( this->impl->_data.data(), this->impl->_data.size() );
+    }
+    
+    std::vector< uint8_t > & Box::GetMutableData( void )
+    {
+        return this->impl->_data;
+    }
+    
+    uint64_t Box::GetDataOffset( void ) const
+    {
+        return this->impl->_dataOffset;
+    }
+    
+    uint64_t Box::GetDataLength( void ) const
+    {
+        return this->impl->_dataLength;
+    }
+    
+    bool Box::IsDataSkipped( void ) const
+    {
+        return this->impl->_dataSkipped;
+    }
+    
+    void Box::SetDataLocation( uint64_t offset, uint64_t length, bool skipped )
+    {
+        this->impl->_dataOffset  = offset;
+        this->impl->_dataLength  = length;
+        this->impl->_dataSkipped = skipped;
+    }
+    
     std::vector< std::pair< std::string, std::string > > Box::GetDisplayableProperties( void ) const
     {
+        if( this->IsDataSkipped() )
+        {
+            return
+            {
+                { "Skipped data offset", std::to_string( this->GetDataOffset() ) },
+                { "Skipped data length", std::to_string( this->GetDataLength() ) }
+            };
+        }
+        
         return {};
     }
 }
 
 XS::PIMPL::Object< ISOBMFF::Box >::IMPL::IMPL( const std::string & name ):
     _name( name ),
-    _hasData( false )
+    _hasData( false ),
+    _dataOffset( 0 ),
+    _dataLength( 0 ),
+    _dataSkipped( false )
 {}
 
 XS::PIMPL::Object< ISOBMFF::Box >::IMPL::IMPL( const IMPL & o ):
     _name( o._name ),
     _data( o._data ),
-    _hasData( o._hasData )
+    _hasData( o._hasData ),
+    _dataOffset( o._dataOffset ),
+    _dataLength( o._dataLength ),
+    _dataSkipped( o._dataSkipped )
 {}
 
 XS::PIMPL::Object< ISOBMFF::Box >::IMPL::~IMPL( void )
@@ -0,0 +1,411 @@
+/*!
+ * @file        BoxSink.cpp
+ */
+
+#include <ISOBMFF/BoxSink.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::BoxSink >::IMPL
+{
+    public:
+        
+        /* Either external data, or a range of the buffer when data is NULL */
+        struct Segment
+        {
+            const uint8_t * data;
+            uint64_t        offset;
+            uint64_t        length;
+            uint64_t        start;
+            bool            header;
+        };
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint8_t * Append( uint64_t length );
+        
+        std::vector< uint8_t > _buffer;
+        std::vector< Segment > _segments;
+        uint64_t               _size;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::BoxSink
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    /* Referenced blocks below this size are cheaper to copy */
+    static const uint64_t MinReferenceLength = 64;
+    
+    BoxSink::BoxSink( void )
+    {}
+    
+    void BoxSink::WriteUInt8( uint8_t value )
+    {
+        *( this->impl->Append( 1 ) ) = value;
+    }
+    
+    void BoxSink::WriteBigEndianUInt16( uint16_t value )
+    {
+        uint8_t * p( this->impl->Append( 2 ) );
+        
+        p[ 0 ] = static_cast< uint8_t >( value >> 8 );
+        p[ 1 ] = static_cast< uint8_t >( value );
+    }
+    
+    void BoxSink::WriteBigEndianUInt24( uint32_t value )
+    {
+        uint8_t * p( this->impl->Append( 3 ) );
+        
+        p[ 0 ] = static_cast< uint8_t >( value >> 16 );
+        p[ 1 ] = static_cast< uint8_t >( value >> 8 );
+        p[ 2 ] = static_cast< uint8_t >( value );
+    }
+    
+    void BoxSink::WriteBigEndianUInt32( uint32_t value )
+    {
+        uint8_t * p( this->impl->Append( 4 ) );
+        
+        p[ 0 ] = static_cast< uint8_t >( value >> 24 );
+        p[ 1 ] = static_cast< uint8_t >( value >> 16 );
+        p[ 2 ] = static_cast< uint8_t >( value >> 8 );
+        p[ 3 ] = static_cast< uint8_t >( value );
+    }
+    
+    void BoxSink::WriteBigEndianUInt64( uint64_t value )
+    {
+        this->WriteBigEndianUInt32( static_cast< uint32_t >( value >> 32 ) );
+        this->WriteBigEndianUInt32( static_cast< uint32_t >( value ) );
+    }
+    
+    void BoxSink::WriteBigEndianFixedPoint( double value, unsigned int integerLength, unsigned int fractionalLength )
+    {
+        double n;
+        
+        n = std::round( value * std::pow( 2, fractionalLength ) );
+        
+        if( integerLength + fractionalLength == 16 )
+        {
+            this->WriteBigEndianUInt16( static_cast< uint16_t >( static_cast< int32_t >( n ) ) );
+        }
+        else
+        {
+            this->WriteBigEndianUInt32( static_cast< uint32_t >( static_cast< int64_t >( n ) ) );
+        }
+    }
+    
+    void BoxSink::WriteFourCC( const std::string & value )
+    {
+        uint8_t * p( this->impl->Append( 4 ) );
+        
+        for( std::size_t i = 0; i < 4; i++ )
+        {
+            p[ i ] = ( i < value.size() ) ? static_cast< uint8_t >( value[ i ] ) : ' ';
+        }
+    }
+    
+    void BoxSink::WriteNULLTerminatedString( const std::string & value )
+    {
+        /* Strings read by BinaryStream keep their terminator */
+        this->Write( reinterpret_cast< const uint8_t * >( value.data() ), value.size() );
+        
+        if( value.empty() || value.back() != 0 )
+        {
+            this->WriteUInt8( 0 );
+        }
+    }
+    
+    void BoxSink::WritePascalString( const std::string & value )
+    {
+        std::size_t length( std::min< std::size_t >( value.size(), 255 ) );
+        
+        this->WriteUInt8( static_cast< uint8_t >( length ) );
+        this->Write( reinterpret_cast< const uint8_t * >( value.data() ), length );
+    }
+    
+    void BoxSink::WriteMatrix( const Matrix & value )
+    {
+        this->WriteBigEndianUInt32( value.GetA() );
+        this->WriteBigEndianUInt32( value.GetB() );
+        this->WriteBigEndianUInt32( value.GetU() );
+        this->WriteBigEndianUInt32( value.GetC() );
+        this->WriteBigEndianUInt32( value.GetD() );
+        this->WriteBigEndianUInt32( value.GetV() );
+        this->WriteBigEndianUInt32( value.GetX() );
+        this->WriteBigEndianUInt32( value.GetY() );
+        this->WriteBigEndianUInt32( value.GetW() );
+    }
+    
+    void BoxSink::Write( const uint8_t * data, uint64_t length )
+    {
+        if( length > 0 )
+        {
+            memcpy( this->impl->Append( length ), data, static_cast< std::size_t >( length ) );
+        }
+    }
+    
+    void BoxSink::Write( const std::vector< uint8_t > & data )
+    {
+        this->Write( data.data(), data.size() );
+    }
+    
+    void BoxSink::Reference( const uint8_t * data, uint64_t length )
+    {
+        if( length < MinReferenceLength )
+        {
+            this->Write( data, length );
+            
+            return;
+        }
+        
+        this->impl->_segments.push_back( { data, 0, length, 0, false } );
+        
+        this->impl->_size += length;
+    }
+    
+    std::size_t BoxSink::BeginBox( const std::string & name )
+    {
+        std::size_t offset( this->impl->_buffer.size() );
+        
+        /* Room for a 64-bit size, decided by EndBox */
+        this->impl->_buffer.resize( offset + 16 );
+        this->impl->_segments.push_back( { nullptr, offset, 8, this->impl->_size, true } );
+        
+        this->impl->_size += 8;
+        
+        for( std::size_t i = 0; i < 4; i++ )
+        {
+            this->impl->_buffer[ offset + 4 + i ] = ( i < name.size() ) ? static_cast< uint8_t >( name[ i ] ) : ' ';
+        }
+        
+        return this->impl->_segments.size() - 1;
+    }
+    
+    void BoxSink::EndBox( std::size_t box )
+    {
+        auto   & segment( this->impl->_segments.at( box ) );
+        uint8_t * p;
+        uint64_t  size;
+        
+        if( segment.header == false )
+        {
+            throw std::runtime_error( "Invalid box handle" );
+        }
+        
+        p    = &( this->impl->_buffer[ static_cast< std::size_t >( segment.offset ) ] );
+        size = this->impl->_size - segment.start;
+        
+        if( size > UINT32_MAX )
+        {
+            size                 += 8;
+            segment.length        = 16;
+            this->impl->_size    += 8;
+            
+            p[ 0 ] = 0;
+            p[ 1 ] = 0;
+            p[ 2 ] = 0;
+            p[ 3 ] = 1;
+            
+            for( std::size_t i = 0; i < 8; i++ )
+            {
+                p[ 8 + i ] = static_cast< uint8_t >( size >> ( ( 7 - i ) * 8 ) );
+            }
+        }
+        else
+        {
+            for( std::size_t i = 0; i < 4; i++ )
+            {
+                p[ i ] = static_cast< uint8_t >( size >> ( ( 3 - i ) * 8 ) );
+            }
+        }
+        
+        segment.header = false;
+    }
+    
+    uint64_t BoxSink::GetSize( void ) const
+    {
+        return this->impl->_size;
+    }
+    
+    std::vector< std::pair< const uint8_t *, uint64_t > > BoxSink::GetSegments( void ) const
+    {
+        std::vector< std::pair< const uint8_t *, uint64_t > > segments;
+        
+        segments.reserve( this->impl->_segments.size() );
+        
+        for( const auto & segment: this->impl->_segments )
+        {
+            if( segment.data != nullptr )
+            {
+                segments.push_back( { segment.data, segment.length } );
+            }
+            else
+            {
+                segments.push_back( { this->impl->_buffer.data() + segment.offset, segment.length } );
+            }
+        }
+        
+        return segments;
+    }
+    
+    std::vector< uint8_t > BoxSink::GetBytes( void ) const
+    {
+        std::vector< uint8_t > bytes;
+        
+        bytes.reserve( static_cast< std::size_t >( this->impl->_size ) );
+        
+        for( const auto & segment: this->GetSegments() )
+        {
+            bytes.insert( bytes.end(), segment.first, segment.first + segment.second );
+        }
+        
+        return bytes;
+    }
+    
+    void BoxSink::WriteTo( int fd ) const
+    {
+        auto segments( this->GetSegments() );
+        
+        #ifdef _WIN32
+        
+        for( const auto & segment: segments )
+        {
+            const uint8_t * p( segment.first );
+            uint64_t        left( segment.second );
+            
+            while( left > 0 )
+            {
+                int written = _write( fd, p, static_cast< unsigned int >( std::min< uint64_t >( left, INT_MAX ) ) );
+                
+                if( written < 0 )
+                {
+                    throw std::runtime_error( std::string( "Write failed: " ) + strerror( errno ) );
+                }
+                
+                p    += written;
+                left -= static_cast< uint64_t >( written );
+            }
+        }
+        
+        #else
+        
+        std::vector< struct iovec > iovecs;
+        std::size_t                 first;
+        ssize_t                     written;
+        uint64_t                    done;
+        
+        for( const auto & segment: segments )
+        {
+            if( segment.second > 0 )
+            {
+                iovecs.push_back( { const_cast< uint8_t * >( segment.first ), static_cast< std::size_t >( segment.second ) } );
+            }
+        }
+        
+        first = 0;
+        
+        while( first < iovecs.size() )
+        {
+            written = writev( fd, &( iovecs[ first ] ), static_cast< int >( std::min< std::size_t >( iovecs.size() - first, IOV_MAX ) ) );
+            
+            if( written < 0 )
+            {
+                if( errno == EINTR )
+                {
+                    continue;
+                }
+                
+                throw std::runtime_error( std::string( "Write failed: " ) + strerror( errno ) );
+            }
+            
+            /* Skips the complete segments, then resumes a partial one */
+            done = static_cast< uint64_t >( written );
+            
+            while( first < iovecs.size() && done >= iovecs[ first ].iov_len )
+            {
+                done -= iovecs[ first ].iov_len;
+                first++;
+            }
+            
+            if( first < iovecs.size() )
+            {
+                iovecs[ first ].iov_base  = static_cast< uint8_t * >( iovecs[ first ].iov_base ) + done;
+                iovecs[ first ].iov_len  -= static_cast< std::size_t >( done );
+            }
+        }
+        
+        #endif
+    }
+    
+    void BoxSink::WriteTo( std::ostream & os ) const
+    {
+        for( const auto & segment: this->GetSegments() )
+        {
+            os.write( reinterpret_cast< const char * >( segment.first ), static_cast< std::streamsize >( segment.second ) );
+        }
+        
+        if( os.fail() )
+        {
+            throw std::runtime_error( "Write failed" );
+        }
+    }
+    
+    void BoxSink::Clear( void )
+    {
+        this->impl->_buffer.clear();
+        this->impl->_segments.clear();
+        
+        this->impl->_size = 0;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::BoxSink >::IMPL::IMPL( void ):
+    _size( 0 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::BoxSink >::IMPL::IMPL( const IMPL & o ):
+    _buffer( o._buffer ),
+    _segments( o._segments ),
+    _size( o._size )
+{}
+
+XS::PIMPL::Object< ISOBMFF::BoxSink >::IMPL::~IMPL( void )
+{}
+
+uint8_t * XS::PIMPL::Object< ISOBMFF::BoxSink >::IMPL::Append( uint64_t length )
+{
+    std::size_t offset( this->_buffer.size() );
+    
+    /* Extends the last segment when it is the end of the buffer, and not a box header */
+    if
+    (
+           this->_segments.empty()
+        || this->_segments.back().data != nullptr
+        || this->_segments.back().header
+        || this->_segments.back().offset + this->_segments.back().length != offset
+    )
+    {
+        this->_segments.push_back( { nullptr, offset, 0, 0, false } );
+    }
+    
+    this->_buffer.resize( offset + static_cast< std::size_t >( length ) );
+    
+    this->_segments.back().length += length;
+    this->_size                   += length;
+    
+    return &( this->_buffer[ offset ] );
+}
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/COLR.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <sstream>
 #include <iomanip>
 
@@ -63,9 +64,9 @@ namespace ISOBMFF
         
         if( this->GetColourType() == "nclx" )
         {
-            this->SetColourPrimaries( stream.ReadUInt16() );
-            this->SetTransferCharacteristics( stream.ReadUInt16() );
-            this->SetMatrixCoefficients( stream.ReadUInt16() );
+            this->SetColourPrimaries( stream.ReadBigEndianUInt16() );
+            this->SetTransferCharacteristics( stream.ReadBigEndianUInt16() );
+            this->SetMatrixCoefficients( stream.ReadBigEndianUInt16() );
             this->SetFullRangeFlag( ( stream.ReadUInt8() & 0x80 ) != 0 );
         }
         else if( this->GetColourType() == "rICC" || this->GetColourType() == "prof" )
@@ -78,6 +79,27 @@ namespace ISOBMFF
         }
     }
     
+    void COLR::WriteData( BoxSink & sink ) const
+    {
+        sink.WriteFourCC( this->GetColourType() );
+        
+        if( this->GetColourType() == "nclx" )
+        {
+            sink.WriteBigEndianUInt16( this->GetColourPrimaries() );
+            sink.WriteBigEndianUInt16( this->GetTransferCharacteristics() );
+            sink.WriteBigEndianUInt16( this->GetMatrixCoefficients() );
+            sink.WriteUInt8( ( this->GetFullRangeFlag() ) ? 0x80 : 0x00 );
+        }
+        else if( this->GetColourType() == "rICC" || this->GetColourType() == "prof" )
+        {
+            sink.Write( this->GetICCProfile() );
+        }
+        else
+        {
+            Box::WriteData( sink );
+        }
+    }
+    
     std::vector< std::pair< std::string, std::string > > COLR::GetDisplayableProperties( void ) const
     {
         auto props( Box::GetDisplayableProperties() );
@@ -0,0 +1,110 @@
+/*!
+ * @file        CTTS.cpp
+ */
+
+#include <ISOBMFF/CTTS.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::CTTS >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        std::vector< ISOBMFF::CTTS::Entry > _entries;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::CTTS
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    CTTS::CTTS( void ): FullBox( "ctts" )
+    {}
+    
+    void CTTS::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint32_t count;
+        
+        FullBox::ReadData( parser, stream );
+        
+        count = stream.ReadBigEndianUInt32();
+        
+        if( static_cast< uint64_t >( count ) * 8 > stream.GetBytesAvailable() )
+        {
+            throw std::runtime_error( "ctts entry count exceeds the box size" );
+        }
+        
+        this->impl->_entries.resize( count );
+        
+        for( auto & entry: this->impl->_entries )
+        {
+            entry.sampleCount  = stream.ReadBigEndianUInt32();
+            entry.sampleOffset = static_cast< int32_t >( stream.ReadBigEndianUInt32() );
+        }
+    }
+    
+    void CTTS::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->impl->_entries.size() ) );
+        
+        for( const auto & entry: this->impl->_entries )
+        {
+            sink.WriteBigEndianUInt32( entry.sampleCount );
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( entry.sampleOffset ) );
+        }
+    }
+    
+    std::vector< std::pair< std::string, std::string > > CTTS::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Entries", std::to_string( this->impl->_entries.size() ) } );
+        
+        return props;
+    }
+    
+    const std::vector< CTTS::Entry > & CTTS::GetEntries( void ) const
+    {
+        return this->impl->_entries;
+    }
+    
+    void CTTS::AddEntry( uint32_t sampleCount, int32_t sampleOffset )
+    {
+        if( sampleOffset < 0 )
+        {
+            this->SetVersion( 1 );
+        }
+        
+        if( this->impl->_entries.empty() == false && this->impl->_entries.back().sampleOffset == sampleOffset )
+        {
+            this->impl->_entries.back().sampleCount += sampleCount;
+        }
+        else
+        {
+            this->impl->_entries.push_back( { sampleCount, sampleOffset } );
+        }
+    }
+    
+    void CTTS::ClearEntries( void )
+    {
+        this->impl->_entries.clear();
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::CTTS >::IMPL::IMPL( void )
+{}
+
+XS::PIMPL::Object< ISOBMFF::CTTS >::IMPL::IMPL( const IMPL & o ):
+    _entries( o._entries )
+{}
+
+XS::PIMPL::Object< ISOBMFF::CTTS >::IMPL::~IMPL( void )
+{}
@@ -0,0 +1,611 @@
+#include "CencDecryptor.h"
+#include "ISOBMFF/TENC.hpp"
+#include "ISOBMFF/ContainerBox.hpp"
+#include <ISOBMFF/Utils.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CENC_AESNI 1
+#include <wmmintrin.h>
+#include <emmintrin.h>
+#else
+#define CENC_AESNI 0
+#endif
+
+using ISOBMFF::Utils::FourCC;
+
+namespace {
+    constexpr uint32_t CENC_Scheme = FourCC("cenc");
+    constexpr uint32_t CBCS_Scheme = FourCC("cbcs");
+
+    constexpr size_t BlockSize = 16;
+    constexpr size_t Rounds = 10;
+
+    // Fragments with less sample data are decrypted on the calling thread only
+    constexpr size_t ParallelThreshold = 256 * 1024;
+
+    struct Pattern {
+        uint8_t crypt{0};
+        uint8_t skip{0};
+    };
+
+    inline uint32_t load32(const uint8_t *p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+             | (static_cast<uint32_t>(p[2]) << 8)  |  static_cast<uint32_t>(p[3]);
+    }
+
+    inline void store32(uint8_t *p, uint32_t v) {
+        p[0] = static_cast<uint8_t>(v >> 24);
+        p[1] = static_cast<uint8_t>(v >> 16);
+        p[2] = static_cast<uint8_t>(v >> 8);
+        p[3] = static_cast<uint8_t>(v);
+    }
+
+    inline uint32_t rotr8(uint32_t v) {
+        return (v >> 8) | (v << 24);
+    }
+
+    inline uint8_t mul(uint8_t a, uint8_t b) {
+        uint8_t r = 0;
+        while (b) {
+            if (b & 1) {
+                r ^= a;
+            }
+            a = static_cast<uint8_t>((a << 1) ^ ((a & 0x80) ? 0x1B : 0));
+            b >>= 1;
+        }
+        return r;
+    }
+
+    // S-boxes and round tables, built once. Te/Td hold a column of (Inv)MixColumns applied to the
+    // (inverse) S-box output; the other three columns are byte rotations of it.
+    struct AesTables {
+        uint8_t  sbox[256];
+        uint8_t  invSbox[256];
+        uint32_t te[256];
+        uint32_t td[256];
+
+        AesTables() {
+            uint8_t p = 1, q = 1;
+            do {
+                p = static_cast<uint8_t>(p ^ (p << 1) ^ ((p & 0x80) ? 0x1B : 0));
+                q ^= q << 1;
+                q ^= q << 2;
+                q ^= q << 4;
+                if (q & 0x80) {
+                    q ^= 0x09;
+                }
+                uint8_t x = static_cast<uint8_t>(q ^ rotl(q, 1) ^ rotl(q, 2) ^ rotl(q, 3) ^ rotl(q, 4));
+                sbox[p] = x ^ 0x63;
+            } while (p != 1);
+            sbox[0] = 0x63;
+
+            for (int i = 0; i < 256; ++i) {
+                invSbox[sbox[i]] = static_cast<uint8_t>(i);
+            }
+            for (int i = 0; i < 256; ++i) {
+                uint8_t s = sbox[i];
+                te[i] = (static_cast<uint32_t>(mul(s, 2)) << 24) | (static_cast<uint32_t>(s) << 16)
+                      | (static_cast<uint32_t>(s) << 8) | mul(s, 3);
+                uint8_t is = invSbox[i];
+                td[i] = (static_cast<uint32_t>(mul(is, 14)) << 24) | (static_cast<uint32_t>(mul(is, 9)) << 16)
+                      | (static_cast<uint32_t>(mul(is, 13)) << 8) | mul(is, 11);
+            }
+        }
+
+        static uint8_t rotl(uint8_t v, int n) {
+            return static_cast<uint8_t>((v << n) | (v >> (8 - n)));
+        }
+    };
+
+    const AesTables &tables() {
+        static const AesTables t;
+        return t;
+    }
+
+    // AES-128 round keys. enc holds the key schedule as bytes, dec the schedule of the equivalent
+    // inverse cipher (reversed, with InvMixColumns applied to the middle rounds).
+    struct AesKey {
+        alignas(16) uint8_t enc[Rounds + 1][BlockSize];
+        alignas(16) uint8_t dec[Rounds + 1][BlockSize];
+        uint32_t encWords[4 * (Rounds + 1)];
+        uint32_t decWords[4 * (Rounds + 1)];
+    };
+
+    void expandKey(const uint8_t *key, AesKey &k) {
+        const auto &t = tables();
+        uint32_t *w = k.encWords;
+        for (int i = 0; i < 4; ++i) {
+            w[i] = load32(key + 4 * i);
+        }
+        uint8_t rcon = 1;
+        for (size_t i = 4; i < 4 * (Rounds + 1); ++i) {
+            uint32_t temp = w[i - 1];
+            if (i % 4 == 0) {
+                temp = (static_cast<uint32_t>(t.sbox[(temp >> 16) & 0xFF]) << 24)
+                     | (static_cast<uint32_t>(t.sbox[(temp >> 8) & 0xFF]) << 16)
+                     | (static_cast<uint32_t>(t.sbox[temp & 0xFF]) << 8)
+                     |  static_cast<uint32_t>(t.sbox[temp >> 24]);
+                temp ^= static_cast<uint32_t>(rcon) << 24;
+                rcon = mul(rcon, 2);
+            }
+            w[i] = w[i - 4] ^ temp;
+        }
+
+        for (size_t r = 0; r <= Rounds; ++r) {
+            for (size_t c = 0; c < 4; ++c) {
+                uint32_t word = w[4 * (Rounds - r) + c];
+                if (r != 0 && r != Rounds) {
+                    word = t.td[t.sbox[word >> 24]] ^ rotr8(t.td[t.sbox[(word >> 16) & 0xFF]])
+                         ^ rotr8(rotr8(t.td[t.sbox[(word >> 8) & 0xFF]])) ^ rotr8(rotr8(rotr8(t.td[t.sbox[word & 0xFF]])));
+                }
+                k.decWords[4 * r + c] = word;
+            }
+        }
+
+        for (size_t r = 0; r <= Rounds; ++r) {
+            for (size_t c = 0; c < 4; ++c) {
+                store32(k.enc[r] + 4 * c, k.encWords[4 * r + c]);
+                store32(k.dec[r] + 4 * c, k.decWords[4 * r + c]);
+            }
+        }
+    }
+
+    void encryptBlockPortable(const AesKey &k, const uint8_t *in, uint8_t *out) {
+        const auto &t = tables();
+        const uint32_t *rk = k.encWords;
+        uint32_t s0 = load32(in) ^ rk[0], s1 = load32(in + 4) ^ rk[1];
+        uint32_t s2 = load32(in + 8) ^ rk[2], s3 = load32(in + 12) ^ rk[3];
+        for (size_t r = 1; r < Rounds; ++r) {
+            rk += 4;
+            uint32_t t0 = t.te[s0 >> 24] ^ rotr8(t.te[(s1 >> 16) & 0xFF]) ^ rotr8(rotr8(t.te[(s2 >> 8) & 0xFF])) ^ rotr8(rotr8(rotr8(t.te[s3 & 0xFF]))) ^ rk[0];
+            uint32_t t1 = t.te[s1 >> 24] ^ rotr8(t.te[(s2 >> 16) & 0xFF]) ^ rotr8(rotr8(t.te[(s3 >> 8) & 0xFF])) ^ rotr8(rotr8(rotr8(t.te[s0 & 0xFF]))) ^ rk[1];
+            uint32_t t2 = t.te[s2 >> 24] ^ rotr8(t.te[(s3 >> 16) & 0xFF]) ^ rotr8(rotr8(t.te[(s0 >> 8) & 0xFF])) ^ rotr8(rotr8(rotr8(t.te[s1 & 0xFF]))) ^ rk[2];
+            uint32_t t3 = t.te[s3 >> 24] ^ rotr8(t.te[(s0 >> 16) & 0xFF]) ^ rotr8(rotr8(t.te[(s1 >> 8) & 0xFF])) ^ rotr8(rotr8(rotr8(t.te[s2 & 0xFF]))) ^ rk[3];
+            s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+        }
+        rk += 4;
+        auto last = [&t](uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+            return (static_cast<uint32_t>(t.sbox[a >> 24]) << 24) | (static_cast<uint32_t>(t.sbox[(b >> 16) & 0xFF]) << 16)
+                 | (static_cast<uint32_t>(t.sbox[(c >> 8) & 0xFF]) << 8) | t.sbox[d & 0xFF];
+        };
+        store32(out,      last(s0, s1, s2, s3) ^ rk[0]);
+        store32(out + 4,  last(s1, s2, s3, s0) ^ rk[1]);
+        store32(out + 8,  last(s2, s3, s0, s1) ^ rk[2]);
+        store32(out + 12, last(s3, s0, s1, s2) ^ rk[3]);
+    }
+
+    void decryptBlockPortable(const AesKey &k, const uint8_t *in, uint8_t *out) {
+        const auto &t = tables();
+        const uint32_t *rk = k.decWords;
+        uint32_t s0 = load32(in) ^ rk[0], s1 = load32(in + 4) ^ rk[1];
+        uint32_t s2 = load32(in + 8) ^ rk[2], s3 = load32(in + 12) ^ rk[3];
+        for (size_t r = 1; r < Rounds; ++r) {
+            rk += 4;
+            uint32_t t0 = t.td[s0 >> 24] ^ rotr8(t.td[(s3 >> 16) & 0xFF]) ^ rotr8(rotr8(t.td[(s2 >> 8) & 0xFF])) ^ rotr8(rotr8(rotr8(t.td[s1 & 0xFF]))) ^ rk[0];
+            uint32_t t1 = t.td[s1 >> 24] ^ rotr8(t.td[(s0 >> 16) & 0xFF]) ^ rotr8(rotr8(t.td[(s3 >> 8) & 0xFF])) ^ rotr8(rotr8(rotr8(t.td[s2 & 0xFF]))) ^ rk[1];
+            uint32_t t2 = t.td[s2 >> 24] ^ rotr8(t.td[(s1 >> 16) & 0xFF]) ^ rotr8(rotr8(t.td[(s0 >> 8) & 0xFF])) ^ rotr8(rotr8(rotr8(t.td[s3 & 0xFF]))) ^ rk[2];
+            uint32_t t3 = t.td[s3 >> 24] ^ rotr8(t.td[(s2 >> 16) & 0xFF]) ^ rotr8(rotr8(t.td[(s1 >> 8) & 0xFF])) ^ rotr8(rotr8(rotr8(t.td[s0 & 0xFF]))) ^ rk[3];
+            s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+        }
+        rk += 4;
+        auto last = [&t](uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+            return (static_cast<uint32_t>(t.invSbox[a >> 24]) << 24) | (static_cast<uint32_t>(t.invSbox[(b >> 16) & 0xFF]) << 16)
+                 | (static_cast<uint32_t>(t.invSbox[(c >> 8) & 0xFF]) << 8) | t.invSbox[d & 0xFF];
+        };
+        store32(out,      last(s0, s3, s2, s1) ^ rk[0]);
+        store32(out + 4,  last(s1, s0, s3, s2) ^ rk[1]);
+        store32(out + 8,  last(s2, s1, s0, s3) ^ rk[2]);
+        store32(out + 12, last(s3, s2, s1, s0) ^ rk[3]);
+    }
+
+    inline void xorBlock(uint8_t *data, const uint8_t *mask, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            data[i] ^= mask[i];
+        }
+    }
+
+    // Increments the block counter, the low 64 bits of the counter block
+    inline void incrementCounter(uint8_t *counter) {
+        for (int i = 15; i >= 8; --i) {
+            if (++counter[i] != 0) {
+                break;
+            }
+        }
+    }
+
+    // XORs `blocks` whole blocks of keystream into data and advances the counter
+    void ctrBlocksPortable(const AesKey &k, uint8_t *counter, uint8_t *data, size_t blocks) {
+        uint8_t keystream[BlockSize];
+        for (size_t b = 0; b < blocks; ++b, data += BlockSize) {
+            encryptBlockPortable(k, counter, keystream);
+            xorBlock(data, keystream, BlockSize);
+            incrementCounter(counter);
+        }
+    }
+
+    // Decrypts `blocks` whole blocks in place. iv is the previous ciphertext block and is updated.
+    void cbcBlocksPortable(const AesKey &k, uint8_t *iv, uint8_t *data, size_t blocks) {
+        uint8_t cipher[BlockSize];
+        for (size_t b = 0; b < blocks; ++b, data += BlockSize) {
+            std::memcpy(cipher, data, BlockSize);
+            decryptBlockPortable(k, data, data);
+            xorBlock(data, iv, BlockSize);
+            std::memcpy(iv, cipher, BlockSize);
+        }
+    }
+
+#if CENC_AESNI
+    // Lanes blocks are kept in flight: the AES instructions are pipelined, a single block chain is latency bound.
+    constexpr size_t Lanes = 8;
+
+    __attribute__((target("aes,sse2")))
+    void ctrBlocksAesNI(const AesKey &k, uint8_t *counter, uint8_t *data, size_t blocks) {
+        __m128i rk[Rounds + 1];
+        for (size_t r = 0; r <= Rounds; ++r) {
+            rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k.enc[r]));
+        }
+        // Counter blocks are built in registers: the IV half as is, the block counter byte swapped
+        uint64_t nonce;
+        std::memcpy(&nonce, counter, sizeof(nonce));
+        uint64_t blockCounter = (static_cast<uint64_t>(load32(counter + 8)) << 32) | load32(counter + 12);
+        while (blocks > 0) {
+            size_t n = std::min<size_t>(blocks, Lanes);
+            __m128i s[Lanes];
+            for (size_t i = 0; i < n; ++i) {
+                __m128i block = _mm_set_epi64x(static_cast<long long>(__builtin_bswap64(blockCounter++)), static_cast<long long>(nonce));
+                s[i] = _mm_xor_si128(block, rk[0]);
+            }
+            for (size_t r = 1; r < Rounds; ++r) {
+                for (size_t i = 0; i < n; ++i) {
+                    s[i] = _mm_aesenc_si128(s[i], rk[r]);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                s[i] = _mm_aesenclast_si128(s[i], rk[Rounds]);
+                auto p = reinterpret_cast<__m128i*>(data + i * BlockSize);
+                _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), s[i]));
+            }
+            data += n * BlockSize;
+            blocks -= n;
+        }
+        store32(counter + 8, static_cast<uint32_t>(blockCounter >> 32));
+        store32(counter + 12, static_cast<uint32_t>(blockCounter));
+    }
+
+    __attribute__((target("aes,sse2")))
+    void cbcBlocksAesNI(const AesKey &k, uint8_t *iv, uint8_t *data, size_t blocks) {
+        __m128i rk[Rounds + 1];
+        for (size_t r = 0; r <= Rounds; ++r) {
+            rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k.dec[r]));
+        }
+        __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+        while (blocks > 0) {
+            size_t n = std::min<size_t>(blocks, Lanes);
+            __m128i c[Lanes], s[Lanes];
+            for (size_t i = 0; i < n; ++i) {
+                c[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * BlockSize));
+                s[i] = _mm_xor_si128(c[i], rk[0]);
+            }
+            for (size_t r = 1; r < Rounds; ++r) {
+                for (size_t i = 0; i < n; ++i) {
+                    s[i] = _mm_aesdec_si128(s[i], rk[r]);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                s[i] = _mm_xor_si128(_mm_aesdeclast_si128(s[i], rk[Rounds]), previous);
+                previous = c[i];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i * BlockSize), s[i]);
+            }
+            data += n * BlockSize;
+            blocks -= n;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), previous);
+    }
+#endif
+}
+
+
+struct CencDecryptor::Private {
+    using BlocksFunction = void (*)(const AesKey&, uint8_t*, uint8_t*, size_t);
+
+    Private(uint32_t scheme, const uint8_t *key, size_t threadCount) : m_scheme(scheme) {
+        expandKey(key, m_key);
+#if CENC_AESNI
+        if (hasHardwareAes()) {
+            m_ctrBlocks = ctrBlocksAesNI;
+            m_cbcBlocks = cbcBlocksAesNI;
+        }
+#endif
+        for (size_t i = 1; i < threadCount; ++i) {
+            m_threads.emplace_back([this]() { run(); });
+        }
+    }
+
+    ~Private() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    static bool hasHardwareAes() {
+#if CENC_AESNI
+        static const bool supported = __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    struct Job {
+        uint8_t                 *data;
+        size_t                  size;
+        ISOBMFF::SENC::Sample   encryption;
+    };
+
+    size_t decrypt(const Fragment &fragment, const ISOBMFF::TENC *tenc) {
+        if (!fragment.moof || !fragment.mdat) {
+            return 0;
+        }
+        Pattern pattern = m_pattern;
+        if (tenc) {
+            if (!tenc->IsProtected()) {
+                return 0;
+            }
+            pattern.crypt = tenc->GetDefaultCryptByteBlock();
+            pattern.skip = tenc->GetDefaultSkipByteBlock();
+        }
+
+        // Samples of trafs without a senc box are clear
+        auto samples = fragment.getSampleInfo(tenc);
+        bool hasEncryption = false;
+        for (const auto &sample : samples) {
+            hasEncryption = hasEncryption || sample.hasEncryption;
+        }
+        if (!hasEncryption) {
+            if (tenc) {
+                throw std::runtime_error("Protected fragment without senc box");
+            }
+            return 0;
+        }
+        // mdat payloads that were passed through are not kept in the fragment
+        if (fragment.mdat->IsDataSkipped()) {
+            return 0;
+        }
+
+        auto &data = fragment.mdat->GetMutableData();
+        const uint64_t dataOffset = fragment.mdat->GetDataOffset();
+        m_jobs.clear();
+        uint64_t total = 0;
+        for (const auto &sample : samples) {
+            if (!sample.hasEncryption) {
+                continue;
+            }
+            if (sample.offset < dataOffset || sample.offset - dataOffset > data.size()
+                || sample.size > data.size() - (sample.offset - dataOffset)) {
+                throw std::runtime_error("Encrypted sample outside the mdat box");
+            }
+            // Without a tenc, a constant IV is unknown and the senc has no IVs either
+            const auto &encryption = sample.encryption;
+            if (encryption.iv == nullptr) {
+                throw std::runtime_error("Encrypted sample without IV");
+            }
+            uint64_t mapped = 0;
+            for (uint32_t i = 0; i < encryption.subsampleCount; ++i) {
+                mapped += encryption.clearBytes[i] + static_cast<uint64_t>(encryption.protectedBytes[i]);
+            }
+            if (mapped > sample.size) {
+                throw std::runtime_error("senc subsamples exceed the sample size");
+            }
+            m_jobs.push_back({data.data() + (sample.offset - dataOffset), sample.size, encryption});
+            total += sample.size;
+        }
+
+        if (m_threads.empty() || m_jobs.size() < 2 || total < ParallelThreshold) {
+            for (const auto &job : m_jobs) {
+                decryptSample(job.data, job.size, job.encryption, pattern);
+            }
+        } else {
+            runParallel(pattern);
+        }
+        return m_jobs.size();
+    }
+
+    void decryptSample(uint8_t *data, size_t size, const ISOBMFF::SENC::Sample &encryption, const Pattern &pattern) const {
+        if (encryption.iv == nullptr) {
+            return;
+        }
+        alignas(16) uint8_t iv[BlockSize] = {};
+        std::memcpy(iv, encryption.iv, std::min<size_t>(encryption.ivSize, BlockSize));
+
+        if (m_scheme == CENC_Scheme) {
+            // The keystream runs on across the protected ranges of a sample
+            CtrState ctr(iv);
+            if (encryption.subsampleCount == 0) {
+                applyCtr(ctr, data, size);
+                return;
+            }
+            for (uint32_t i = 0; i < encryption.subsampleCount; ++i) {
+                data += encryption.clearBytes[i];
+                applyCtr(ctr, data, encryption.protectedBytes[i]);
+                data += encryption.protectedBytes[i];
+            }
+            return;
+        }
+
+        // cbcs: every protected range starts over from the sample IV
+        if (encryption.subsampleCount == 0) {
+            applyCbcPattern(iv, pattern, data, size);
+            return;
+        }
+        for (uint32_t i = 0; i < encryption.subsampleCount; ++i) {
+            data += encryption.clearBytes[i];
+            applyCbcPattern(iv, pattern, data, encryption.protectedBytes[i]);
+            data += encryption.protectedBytes[i];
+        }
+    }
+
+    const uint32_t  m_scheme;
+    Pattern         m_pattern;
+
+private:
+    struct CtrState {
+        explicit CtrState(const uint8_t *iv) {
+            std::memcpy(counter, iv, BlockSize);
+        }
+        alignas(16) uint8_t counter[BlockSize];
+        uint8_t             keystream[BlockSize];
+        size_t              used{BlockSize};    // Bytes of keystream consumed
+    };
+
+    void applyCtr(CtrState &ctr, uint8_t *data, size_t size) const {
+        size_t leftover = std::min(size, BlockSize - ctr.used);
+        xorBlock(data, ctr.keystream + ctr.used, leftover);
+        ctr.used += leftover;
+        data += leftover;
+        size -= leftover;
+
+        size_t blocks = size / BlockSize;
+        m_ctrBlocks(m_key, ctr.counter, data, blocks);
+        data += blocks * BlockSize;
+        size -= blocks * BlockSize;
+
+        if (size > 0) {
+            std::memset(ctr.keystream, 0, BlockSize);
+            m_ctrBlocks(m_key, ctr.counter, ctr.keystream, 1);
+            xorBlock(data, ctr.keystream, size);
+            ctr.used = size;
+        }
+    }
+
+    // Decrypts `crypt` blocks then leaves `skip` blocks, repeatedly. A trailing partial block stays clear.
+    void applyCbcPattern(const uint8_t *sampleIV, const Pattern &pattern, uint8_t *data, size_t size) const {
+        alignas(16) uint8_t chain[BlockSize];
+        std::memcpy(chain, sampleIV, BlockSize);
+        size_t blocks = size / BlockSize;
+        if (pattern.crypt == 0 && pattern.skip == 0) {
+            m_cbcBlocks(m_key, chain, data, blocks);
+            return;
+        }
+        while (blocks > 0) {
+            size_t crypt = std::min<size_t>(blocks, pattern.crypt);
+            m_cbcBlocks(m_key, chain, data, crypt);
+            size_t advance = std::min<size_t>(blocks, crypt + pattern.skip);
+            data += advance * BlockSize;
+            blocks -= advance;
+        }
+    }
+
+    void runParallel(const Pattern &pattern) {
+        std::function<void()> task = [this, &pattern]() {
+            for (;;) {
+                size_t index = m_next.fetch_add(1);
+                if (index >= m_jobs.size()) {
+                    return;
+                }
+                const auto &job = m_jobs[index];
+                decryptSample(job.data, job.size, job.encryption, pattern);
+            }
+        };
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_next = 0;
+            m_task = &task;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+        task();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_busy == 0; });
+        // Workers waking up late find no task
+        m_task = nullptr;
+    }
+
+    void run() {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void()> *task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this, seen]() { return m_stop || m_generation != seen; });
+                if (m_stop) {
+                    return;
+                }
+                seen = m_generation;
+                task = m_task;
+                if (!task) {
+                    continue;
+                }
+                ++m_busy;
+            }
+            (*task)();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_busy;
+            }
+            m_done.notify_one();
+        }
+    }
+
+    AesKey          m_key;
+    BlocksFunction  m_ctrBlocks{ctrBlocksPortable};
+    BlocksFunction  m_cbcBlocks{cbcBlocksPortable};
+    std::vector<Job> m_jobs;
+
+    // Worker threads of runParallel()
+    std::vector<std::thread>        m_threads;
+    std::mutex                      m_mutex;
+    std::condition_variable         m_wake;
+    std::condition_variable         m_done;
+    const std::function<void()>     *m_task{nullptr};
+    std::atomic<size_t>             m_next{0};
+    size_t                          m_busy{0};
+    uint64_t                        m_generation{0};
+    bool                            m_stop{false};
+};
+
+constexpr size_t CencDecryptor::KeySize;
+
+
+CencDecryptor::CencDecryptor(uint32_t scheme, const uint8_t *key, size_t keySize, size_t threadCount) {
+    if (scheme != CENC_Scheme && scheme != CBCS_Scheme) {
+        throw std::runtime_error("Unsupported protection scheme " + ISOBMFF::Utils::FourCCToString(scheme));
+    }
+    if (keySize != KeySize) {
+        throw std::runtime_error("Unsupported key size " + std::to_string(keySize));
+    }
+    m_impl = std::make_unique<Private>(scheme, key, threadCount);
+}
+
+CencDecryptor::~CencDecryptor() = default;
+
+void CencDecryptor::setPattern(uint8_t cryptByteBlock, uint8_t skipByteBlock) {
+    m_impl->m_pattern.crypt = cryptByteBlock;
+    m_impl->m_pattern.skip = skipByteBlock;
+}
+
+size_t CencDecryptor::decrypt(const Fragment &fragment, const ISOBMFF::TENC *tenc) {
+    return m_impl->decrypt(fragment, tenc);
+}
+
+void CencDecryptor::decryptSample(uint8_t *data, size_t size, const ISOBMFF::SENC::Sample &encryption) const {
+    m_impl->decryptSample(data, size, encryption, m_impl->m_pattern);
+}
+
+bool CencDecryptor::hasHardwareAes() {
+    return Private::hasHardwareAes();
+}
@@ -0,0 +1,462 @@
+#include "Clipper.h"
+#include "RangeCopier.h"
+#include "ISOBMFF/Parser.hpp"
+#include "ISOBMFF/File.hpp"
+#include "ISOBMFF/Boxes.h"
+#include "ISOBMFF/BoxSink.hpp"
+#include "ISOBMFF/SampleTable.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+    // value * to / from, without overflowing for large values
+    uint64_t rescale(uint64_t value, uint32_t from, uint32_t to) {
+        if (from == to || from == 0) {
+            return value;
+        }
+        return value / from * to + value % from * to / from;
+    }
+
+    int64_t compositionTime(const ISOBMFF::SampleTable::Sample &sample) {
+        return static_cast<int64_t>(sample.decodeTime) + sample.compositionOffset;
+    }
+}
+
+struct Clipper::Private {
+    struct Track {
+        std::shared_ptr<ISOBMFF::ContainerBox> trak;
+        ISOBMFF::SampleTable table;
+        // Samples [first, last) of the clip
+        size_t first{0};
+        size_t last{0};
+        double keyframeTime{0};
+        // Edit list of the clip, in the movie timescale, and media time in the clip media timeline
+        uint64_t emptyDuration{0};
+        uint64_t segmentDuration{0};
+        int64_t mediaTime{0};
+
+        std::shared_ptr<ISOBMFF::STSC> stsc{std::make_shared<ISOBMFF::STSC>()};
+        // Chunk offsets in the output mdat payload
+        std::vector<uint64_t> chunkOffsets;
+
+        uint64_t mediaDuration() const {
+            const auto &samples = table.GetSamples();
+            return samples[last - 1].decodeTime + samples[last - 1].duration - samples[first].decodeTime;
+        }
+    };
+
+    // Contiguous samples of a track in the source file, copied and indexed as one chunk
+    struct Chunk {
+        uint64_t offset;
+        uint64_t length;
+        uint32_t samples;
+        uint32_t descriptionIndex;
+    };
+
+    std::string path;
+    ISOBMFF::Parser parser;
+    std::shared_ptr<ISOBMFF::FTYP> ftyp;
+    std::shared_ptr<ISOBMFF::ContainerBox> moov;
+    uint32_t movieTimescale{0};
+    std::vector<Track> tracks;
+    double keyframe{0};
+    // Chunks of all tracks, in output order
+    std::vector<Chunk> chunks;
+    uint64_t payload{0};
+    uint64_t samples{0};
+    RangeCopier copier;
+
+    Private(const std::string &path, double start, double end) : path(path) {
+        if (!(start >= 0 && end > start)) {
+            throw std::runtime_error("Invalid time range");
+        }
+        parser.AddOption(ISOBMFF::Parser::Options::SkipMDATData);
+        parser.Parse(path);
+
+        ftyp = parser.GetFile()->GetTypedBox<ISOBMFF::FTYP>("ftyp");
+        moov = parser.GetFile()->GetTypedBox<ISOBMFF::ContainerBox>("moov");
+        if (!moov) {
+            throw std::runtime_error("No moov box in " + path);
+        }
+        if (moov->GetBox("mvex")) {
+            throw std::runtime_error(path + " is fragmented");
+        }
+        auto mvhd = moov->GetTypedBox<ISOBMFF::MVHD>("mvhd");
+        if (!mvhd) {
+            throw std::runtime_error("No mvhd box in " + path);
+        }
+        movieTimescale = mvhd->GetTimescale();
+
+        for (const auto &box : moov->Container::GetBoxes("trak")) {
+            Track track;
+            track.trak = std::static_pointer_cast<ISOBMFF::ContainerBox>(box);
+            track.table = ISOBMFF::SampleTable(*track.trak);
+            // Tracks without samples in the range are left out
+            if (select(track, start, end)) {
+                checkTrack(track);
+                tracks.push_back(std::move(track));
+            }
+        }
+        if (tracks.empty()) {
+            throw std::runtime_error("No samples between " + std::to_string(start) + " and " + std::to_string(end) + " s");
+        }
+        keyframe = tracks.front().keyframeTime;
+        for (const auto &track : tracks) {
+            if (track.table.HasSyncSamples()) {
+                keyframe = track.keyframeTime;
+                break;
+            }
+        }
+
+        plan();
+    }
+
+    // The clip rebuilds the sample tables below. Per-sample boxes it does not slice (saiz, saio, senc, sbgp, sgpd,
+    // sdtp, subs, ...) would no longer match the samples: such tracks are refused rather than having them dropped.
+    static void checkTrack(const Track &track) {
+        static const char *const rebuilt[] = {"stsd", "stts", "ctts", "cslg", "stss", "stsc", "stsz", "stz2",
+                                              "stco", "co64"};
+        auto mdia = track.trak->GetTypedBox<ISOBMFF::ContainerBox>("mdia");
+        auto minf = mdia ? mdia->GetTypedBox<ISOBMFF::ContainerBox>("minf") : nullptr;
+        auto stbl = minf ? minf->GetTypedBox<ISOBMFF::ContainerBox>("stbl") : nullptr;
+        if (!stbl) {
+            return;
+        }
+        for (const auto &box : stbl->GetBoxes()) {
+            const std::string name = box->GetName();
+            if (std::find(std::begin(rebuilt), std::end(rebuilt), name) == std::end(rebuilt)) {
+                throw std::runtime_error("Track " + std::to_string(track.table.GetTrackID()) + " has a " + name +
+                                         " box, which cannot be clipped");
+            }
+        }
+    }
+
+    // Composition time of presentation time 0: media time of the first edit, minus the empty edits before it
+    int64_t presentationOffset(const Track &track) const {
+        auto edts = track.trak->GetTypedBox<ISOBMFF::ContainerBox>("edts");
+        auto elst = edts ? edts->GetTypedBox<ISOBMFF::ELST>("elst") : nullptr;
+        if (!elst) {
+            return 0;
+        }
+        uint64_t empty = 0;
+        for (const auto &entry : elst->GetEntries()) {
+            if (entry.mediaTime >= 0) {
+                return entry.mediaTime - static_cast<int64_t>(rescale(empty, movieTimescale, track.table.GetTimescale()));
+            }
+            empty += entry.segmentDuration;
+        }
+        return 0;
+    }
+
+    // Selects the samples from the last sync sample presented at or before start to the last one decoded before
+    // end, and the edits presenting exactly [start, end). Returns false if nothing of the track is presented.
+    bool select(Track &track, double start, double end) const {
+        const auto &samples = track.table.GetSamples();
+        const uint32_t timescale = track.table.GetTimescale();
+        const int64_t offset = presentationOffset(track);
+        const int64_t from = std::llround(start * timescale) + offset;
+        const int64_t to = std::llround(end * timescale) + offset;
+
+        // The first sync sample when the range starts before it
+        size_t first = samples.size();
+        for (size_t i = 0; i < samples.size(); i++) {
+            if (!samples[i].sync) {
+                continue;
+            }
+            if (first != samples.size() && compositionTime(samples[i]) > from) {
+                break;
+            }
+            first = i;
+        }
+        if (first == samples.size()) {
+            return false;
+        }
+
+        size_t last = first;
+        int64_t mediaEnd = std::numeric_limits<int64_t>::min();
+        while (last < samples.size() && static_cast<int64_t>(samples[last].decodeTime) < to) {
+            mediaEnd = std::max(mediaEnd, compositionTime(samples[last]) + samples[last].duration);
+            last++;
+        }
+        const int64_t mediaStart = std::max(from, compositionTime(samples[first]));
+        if (last == first || mediaEnd <= mediaStart) {
+            return false;
+        }
+
+        // The clip media timeline starts at the decoding time of the first sample
+        track.first = first;
+        track.last = last;
+        track.keyframeTime = static_cast<double>(compositionTime(samples[first]) - offset) / timescale;
+        track.emptyDuration = rescale(static_cast<uint64_t>(mediaStart - from), timescale, movieTimescale);
+        track.segmentDuration = rescale(static_cast<uint64_t>(std::min(to, mediaEnd) - mediaStart), timescale,
+                                        movieTimescale);
+        track.mediaTime = std::max<int64_t>(0, mediaStart - static_cast<int64_t>(samples[first].decodeTime));
+        return true;
+    }
+
+    // Chunks of all tracks in source order, keeping the order of each track: adjacent chunks are copied together
+    void plan() {
+        std::vector<std::vector<Chunk>> trackChunks(tracks.size());
+        for (size_t t = 0; t < tracks.size(); t++) {
+            const auto &table = tracks[t].table.GetSamples();
+            auto &list = trackChunks[t];
+            for (size_t i = tracks[t].first; i < tracks[t].last; i++) {
+                const auto &sample = table[i];
+                if (!list.empty() && list.back().offset + list.back().length == sample.offset
+                    && list.back().descriptionIndex == sample.descriptionIndex) {
+                    list.back().length += sample.size;
+                    list.back().samples++;
+                } else {
+                    list.push_back({sample.offset, sample.size, 1, sample.descriptionIndex});
+                }
+            }
+            samples += tracks[t].last - tracks[t].first;
+        }
+
+        std::vector<size_t> next(tracks.size(), 0);
+        for (;;) {
+            size_t pick = tracks.size();
+            for (size_t t = 0; t < tracks.size(); t++) {
+                if (next[t] < trackChunks[t].size()
+                    && (pick == tracks.size() || trackChunks[t][next[t]].offset < trackChunks[pick][next[pick]].offset)) {
+                    pick = t;
+                }
+            }
+            if (pick == tracks.size()) {
+                break;
+            }
+            const Chunk &chunk = trackChunks[pick][next[pick]++];
+            Track &track = tracks[pick];
+            track.chunkOffsets.push_back(payload);
+            track.stsc->AddChunk(static_cast<uint32_t>(track.chunkOffsets.size()), chunk.samples, chunk.descriptionIndex);
+            payload += chunk.length;
+            chunks.push_back(chunk);
+        }
+    }
+
+    void write(int out) {
+        ISOBMFF::FTYP defaultFtyp;
+        defaultFtyp.SetMajorBrand("isom");
+        defaultFtyp.SetMinorVersion(512);
+        defaultFtyp.SetCompatibleBrands({"isom", "iso2", "mp41"});
+        const ISOBMFF::FTYP &brands = ftyp ? *ftyp : defaultFtyp;
+
+        // Chunk offsets do not change the moov size, only stco or co64 does
+        const uint64_t mdatHeader = payload + 8 > std::numeric_limits<uint32_t>::max() ? 16 : 8;
+        uint64_t lastChunk = 0;
+        for (const auto &track : tracks) {
+            if (!track.chunkOffsets.empty()) {
+                lastChunk = std::max(lastChunk, track.chunkOffsets.back());
+            }
+        }
+
+        std::vector<std::shared_ptr<ISOBMFF::STCO>> stcos;
+        ISOBMFF::BoxSink sink;
+        brands.Write(sink);
+        auto result = buildMoov(stcos, false);
+        result->Write(sink);
+        uint64_t base = sink.GetSize() + mdatHeader;
+        if (base + lastChunk > std::numeric_limits<uint32_t>::max()) {
+            stcos.clear();
+            sink.Clear();
+            brands.Write(sink);
+            result = buildMoov(stcos, true);
+            result->Write(sink);
+            base = sink.GetSize() + mdatHeader;
+        }
+        for (const auto &stco : stcos) {
+            stco->AddToChunkOffsets(static_cast<int64_t>(base));
+        }
+
+        sink.Clear();
+        brands.Write(sink);
+        result->Write(sink);
+        if (mdatHeader == 16) {
+            sink.WriteBigEndianUInt32(1);
+            sink.WriteFourCC("mdat");
+            sink.WriteBigEndianUInt64(payload + 16);
+        } else {
+            sink.WriteBigEndianUInt32(static_cast<uint32_t>(payload + 8));
+            sink.WriteFourCC("mdat");
+        }
+        sink.WriteTo(out);
+
+        int in = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) {
+            throw std::runtime_error("Cannot open " + path + ": " + strerror(errno));
+        }
+        try {
+            for (const auto &chunk : chunks) {
+                copier.add(in, chunk.offset, chunk.length, out);
+            }
+            copier.flush();
+        } catch (...) {
+            close(in);
+            throw;
+        }
+        close(in);
+    }
+
+    std::shared_ptr<ISOBMFF::ContainerBox> buildStbl(const Track &track, const ISOBMFF::ContainerBox &source,
+                                                     std::vector<std::shared_ptr<ISOBMFF::STCO>> &stcos,
+                                                     bool largeOffsets) const {
+        const auto &samples = track.table.GetSamples();
+        auto stbl = std::make_shared<ISOBMFF::ContainerBox>("stbl");
+        auto stsd = source.GetBox("stsd");
+        if (!stsd) {
+            throw std::runtime_error("Track " + std::to_string(track.table.GetTrackID()) + " has no stsd box");
+        }
+        stbl->AddBox(stsd);
+
+        auto stts = std::make_shared<ISOBMFF::STTS>();
+        auto ctts = std::make_shared<ISOBMFF::CTTS>();
+        auto stss = std::make_shared<ISOBMFF::STSS>();
+        auto stsz = std::make_shared<ISOBMFF::STSZ>();
+        bool sameSize = true;
+        for (size_t i = track.first; i < track.last; i++) {
+            stts->AddEntry(1, samples[i].duration);
+            ctts->AddEntry(1, samples[i].compositionOffset);
+            if (samples[i].sync) {
+                stss->AddSampleNumber(static_cast<uint32_t>(i - track.first + 1));
+            }
+            sameSize = sameSize && samples[i].size == samples[track.first].size;
+        }
+        if (sameSize) {
+            stsz->SetSampleSize(samples[track.first].size, static_cast<uint32_t>(track.last - track.first));
+        } else {
+            for (size_t i = track.first; i < track.last; i++) {
+                stsz->AddEntrySize(samples[i].size);
+            }
+        }
+
+        stbl->AddBox(stts);
+        if (track.table.HasCompositionOffsets()) {
+            stbl->AddBox(ctts);
+        }
+        if (track.table.HasSyncSamples()) {
+            stbl->AddBox(stss);
+        }
+        stbl->AddBox(track.stsc);
+        stbl->AddBox(stsz);
+
+        auto stco = std::make_shared<ISOBMFF::STCO>(largeOffsets ? "co64" : "stco");
+        for (uint64_t offset : track.chunkOffsets) {
+            stco->AddChunkOffset(offset);
+        }
+        stbl->AddBox(stco);
+        stcos.push_back(stco);
+        return stbl;
+    }
+
+    std::shared_ptr<ISOBMFF::ContainerBox> buildEdts(const Track &track) const {
+        auto edits = std::make_shared<ISOBMFF::ELST>();
+        if (track.emptyDuration > 0) {
+            edits->AddEntry(track.emptyDuration, -1);
+        }
+        edits->AddEntry(track.segmentDuration, track.mediaTime);
+        auto result = std::make_shared<ISOBMFF::ContainerBox>("edts");
+        result->AddBox(edits);
+        return result;
+    }
+
+    std::shared_ptr<ISOBMFF::ContainerBox> buildMoov(std::vector<std::shared_ptr<ISOBMFF::STCO>> &stcos,
+                                                     bool largeOffsets) const {
+        auto result = std::make_shared<ISOBMFF::ContainerBox>("moov");
+        std::shared_ptr<ISOBMFF::MVHD> mvhd;
+        uint64_t movieDuration = 0;
+
+        for (const auto &box : moov->GetBoxes()) {
+            if (box->GetName() == "mvhd") {
+                mvhd = std::make_shared<ISOBMFF::MVHD>(*std::static_pointer_cast<ISOBMFF::MVHD>(box));
+                result->AddBox(mvhd);
+            } else if (box->GetName() == "trak") {
+                auto track = std::find_if(tracks.begin(), tracks.end(), [&](const Track &t) { return t.trak == box; });
+                if (track != tracks.end()) {
+                    const uint64_t duration = track->emptyDuration + track->segmentDuration;
+                    movieDuration = std::max(movieDuration, duration);
+                    result->AddBox(buildTrak(*track, duration, stcos, largeOffsets));
+                }
+            } else {
+                result->AddBox(box);
+            }
+        }
+
+        mvhd->SetDuration(movieDuration);
+        mvhd->SetVersion(movieDuration > std::numeric_limits<uint32_t>::max() ? 1 : mvhd->GetVersion());
+        return result;
+    }
+
+    std::shared_ptr<ISOBMFF::ContainerBox> buildTrak(const Track &track, uint64_t duration,
+                                                     std::vector<std::shared_ptr<ISOBMFF::STCO>> &stcos,
+                                                     bool largeOffsets) const {
+        auto trak = std::make_shared<ISOBMFF::ContainerBox>("trak");
+        for (const auto &box : track.trak->GetBoxes()) {
+            if (box->GetName() == "tkhd") {
+                auto tkhd = std::make_shared<ISOBMFF::TKHD>(*std::static_pointer_cast<ISOBMFF::TKHD>(box));
+                tkhd->SetDuration(duration);
+                tkhd->SetVersion(duration > std::numeric_limits<uint32_t>::max() ? 1 : tkhd->GetVersion());
+                trak->AddBox(tkhd);
+                trak->AddBox(buildEdts(track));
+            } else if (box->GetName() == "mdia") {
+                auto mdia = std::make_shared<ISOBMFF::ContainerBox>("mdia");
+                for (const auto &child : std::static_pointer_cast<ISOBMFF::ContainerBox>(box)->GetBoxes()) {
+                    if (child->GetName() == "mdhd") {
+                        auto mdhd = std::make_shared<ISOBMFF::MDHD>(*std::static_pointer_cast<ISOBMFF::MDHD>(child));
+                        mdhd->SetDuration(track.mediaDuration());
+                        mdhd->SetVersion(track.mediaDuration() > std::numeric_limits<uint32_t>::max() ? 1 : mdhd->GetVersion());
+                        mdia->AddBox(mdhd);
+                    } else if (child->GetName() == "minf") {
+                        auto minf = std::make_shared<ISOBMFF::ContainerBox>("minf");
+                        for (const auto &grandChild : std::static_pointer_cast<ISOBMFF::ContainerBox>(child)->GetBoxes()) {
+                            if (grandChild->GetName() == "stbl") {
+                                const auto &source = static_cast<const ISOBMFF::ContainerBox &>(*grandChild);
+                                minf->AddBox(buildStbl(track, source, stcos, largeOffsets));
+                            } else {
+                                minf->AddBox(grandChild);
+                            }
+                        }
+                        mdia->AddBox(minf);
+                    } else {
+                        mdia->AddBox(child);
+                    }
+                }
+                trak->AddBox(mdia);
+            } else if (box->GetName() != "edts") {
+                trak->AddBox(box);
+            }
+        }
+        return trak;
+    }
+};
+
+Clipper::Clipper(const std::string &path, double start, double end) : m_impl(new Private(path, start, end)) {
+}
+
+Clipper::~Clipper() = default;
+
+void Clipper::write(int fd) {
+    m_impl->write(fd);
+}
+
+double Clipper::keyframeTime() const {
+    return m_impl->keyframe;
+}
+
+uint64_t Clipper::sampleCount() const {
+    return m_impl->samples;
+}
+
+uint64_t Clipper::bytesCopied() const {
+    return m_impl->copier.bytesCopied();
+}
+
+uint64_t Clipper::copyCalls() const {
+    return m_impl->copier.copyCalls();
+}
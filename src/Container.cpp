@@ -63,6 +63,14 @@ namespace ISOBMFF
         Container::WriteBoxes( this->GetBoxes(), os, indentLevel );
     }
     
+    void Container::WriteBoxes( BoxSink & sink ) const
+    {
+        for( const auto & box: this->GetBoxes() )
+        {
+            box->Write( sink );
+        }
+    }
+    
     std::vector< std::shared_ptr< Box > > Container::GetBoxes( const std::string & name ) const
     {
         std::vector< std::shared_ptr< Box > > boxes;
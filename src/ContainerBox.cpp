@@ -30,6 +30,7 @@
 
 #include <ISOBMFF/ContainerBox.hpp>
 #include <ISOBMFF/IParser.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::ContainerBox >::IMPL
@@ -41,6 +42,7 @@ class XS::PIMPL::Object< ISOBMFF::ContainerBox >::IMPL
         ~IMPL( void );
 
         std::vector< std::shared_ptr< ISOBMFF::Box > > _boxes;
+        ISOBMFF::BinaryStream                          _content;    /* Child box data, a view on memory-backed streams */
 };
 
 #define XS_PIMPL_CLASS ISOBMFF::ContainerBox
@@ -53,53 +55,70 @@ namespace ISOBMFF
 
     void ContainerBox::ReadData(IParser *parser, BinaryStream &stream)
     {
+        uint64_t               offset;
         uint64_t               length;
+        uint64_t               headerLength;
         std::string            name;
         std::shared_ptr< Box > box;
-        BinaryStream           content;
+        BinaryStream         & content = this->impl->_content;
 
         this->impl->_boxes.clear();
 
         while( stream.HasBytesAvailable() )
         {
-            ( void )parser;
-
-            length   = stream.ReadBigEndianUInt32();
-            name     = stream.ReadFourCC();
+            offset       = stream.GetOffset();
+            length       = stream.ReadBigEndianUInt32();
+            name         = stream.ReadFourCC();
+            headerLength = 8;
 
             if( length == 1 )
             {
-                length  = stream.ReadBigEndianUInt64();
-
-                if( name == "mdat" && parser->HasOption( ISOBMFF::IParser::Options::SkipMDATData ) )
-                {
-                    stream.DeleteBytes( length - 16 );
-                }
-                else
-                {
-                    content = BinaryStream( stream, length - 16 );
-                }
+                length       = stream.ReadBigEndianUInt64();
+                headerLength = 16;
             }
-            else
+            else if( length == 0 )
             {
-                if( name == "mdat" && parser->HasOption( ISOBMFF::IParser::Options::SkipMDATData ) )
-                {
-                    stream.DeleteBytes( length - 8 );
-                }
-                else
-                {
-                    content = BinaryStream( stream, length - 8 );
-                }
+                /* The last box in a stream may extend to the end of it */
+                length = headerLength + stream.GetBytesAvailable();
             }
 
-            box = parser->CreateBox( name );
+            /*
+             * Skipped boxes are never copied out of the stream: only their
+             * location is recorded, and file-backed streams simply seek.
+             */
+            if( parser->ShouldSkipBoxData( name, length - headerLength ) )
+            {
+                stream.DeleteBytes( length - headerLength );
+
+                box = std::make_shared< Box >( name );
+
+                box->SetDataLocation( offset + headerLength, length - headerLength, true );
+                this->AddBox( box );
+
+                continue;
+            }
+
+            content.SetSubStream( stream, length - headerLength );
+            box     = parser->CreateBox( name );
             
             if( box != nullptr )
             {
+                box->SetDataLocation( offset + headerLength, length - headerLength );
                 box->ReadData( parser, content );
                 this->AddBox( box );
             }
         }
+        
+        /*
+         * Children of file-backed streams were copied, and keep their own
+         * data: the copy is not kept for the lifetime of the container.
+         */
+        content.SetView( nullptr, 0 );
+    }
+    
+    void ContainerBox::WriteData( BoxSink & sink ) const
+    {
+        Container::WriteBoxes( sink );
     }
     
     void ContainerBox::AddBox( std::shared_ptr< Box > box )
@@ -115,6 +134,21 @@ namespace ISOBMFF
         return this->impl->_boxes;
     }
     
+    bool ContainerBox::ReplaceBox( const std::shared_ptr< Box > & box, std::shared_ptr< Box > replacement )
+    {
+        for( auto & child: this->impl->_boxes )
+        {
+            if( child == box )
+            {
+                child = replacement;
+                
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
     void ContainerBox::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         Box::WriteDescription( os, indentLevel );
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/DREF.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/ContainerBox.hpp>
 
 template<>
@@ -62,6 +63,15 @@ namespace ISOBMFF
         this->impl->_boxes = container.GetBoxes();
     }
     
+    void DREF::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->impl->_boxes.size() ) );
+        
+        Container::WriteBoxes( sink );
+    }
+    
     void DREF::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         FullBox::WriteDescription( os, indentLevel );
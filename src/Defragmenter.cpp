@@ -0,0 +1,535 @@
+#include "Defragmenter.h"
+#include "RangeCopier.h"
+#include "ISOBMFF/Parser.hpp"
+#include "ISOBMFF/File.hpp"
+#include "ISOBMFF/Boxes.h"
+#include "ISOBMFF/BoxSink.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+    constexpr uint32_t SampleIsNonSync = 0x10000;
+    constexpr uint32_t DefaultBaseIsMoof = 0x020000;
+
+    // value * to / from, without overflowing for large values
+    uint64_t rescale(uint64_t value, uint32_t from, uint32_t to) {
+        if (from == to || from == 0) {
+            return value;
+        }
+        return value / from * to + value % from * to / from;
+    }
+}
+
+struct Defragmenter::Private {
+    struct Track {
+        std::shared_ptr<ISOBMFF::ContainerBox> trak;
+        uint32_t trackID{0};
+        uint32_t timescale{0};
+        // trex defaults
+        uint32_t sampleDescriptionIndex{1};
+        uint32_t sampleDuration{0};
+        uint32_t sampleSize{0};
+        uint32_t sampleFlags{0};
+
+        bool started{false};
+        uint64_t firstDecodeTime{0};
+        uint64_t nextDecodeTime{0};
+        // Duration of the last sample, only added to stts once the following gap is known
+        uint64_t lastDuration{0};
+        uint32_t sampleCount{0};
+        bool allSync{true};
+        bool hasCompositionOffsets{false};
+
+        std::shared_ptr<ISOBMFF::STTS> stts{std::make_shared<ISOBMFF::STTS>()};
+        std::shared_ptr<ISOBMFF::CTTS> ctts{std::make_shared<ISOBMFF::CTTS>()};
+        std::shared_ptr<ISOBMFF::STSS> stss{std::make_shared<ISOBMFF::STSS>()};
+        std::shared_ptr<ISOBMFF::STSC> stsc{std::make_shared<ISOBMFF::STSC>()};
+        std::vector<uint32_t> sizes;
+        // Chunk offsets in the output mdat payload
+        std::vector<uint64_t> chunkOffsets;
+
+        uint64_t mediaDuration() const {
+            return nextDecodeTime - firstDecodeTime;
+        }
+    };
+
+    // Bytes of a source file, in output order
+    struct Run {
+        size_t file;
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    std::vector<std::string> paths;
+    std::shared_ptr<ISOBMFF::ContainerBox> moov;
+    uint32_t movieTimescale{0};
+    std::vector<Track> tracks;
+    std::vector<Run> runs;
+    uint64_t payload{0};
+    uint32_t fragments{0};
+    uint64_t samples{0};
+    RangeCopier copier;
+
+    explicit Private(const std::vector<std::string> &paths) : paths(paths) {
+        if (paths.empty()) {
+            throw std::runtime_error("No input file");
+        }
+        for (size_t i = 0; i < paths.size(); i++) {
+            // One file per input: only the samples are kept, not the boxes of every fragment. Media segments may
+            // start with styp or directly with moof
+            ISOBMFF::Parser parser;
+            parser.AddOption(ISOBMFF::Parser::Options::SkipMDATData);
+            parser.Parse(paths[i]);
+
+            // Top-level boxes are contiguous: a box starts where the previous one ends
+            uint64_t start = 0;
+            for (const auto &box : parser.GetFile()->GetBoxes()) {
+                if (box->GetName() == "moov" && !moov) {
+                    readMoov(std::static_pointer_cast<ISOBMFF::ContainerBox>(box));
+                } else if (box->GetName() == "moof") {
+                    if (!moov) {
+                        throw std::runtime_error("No moov box before the first moof in " + paths[i]);
+                    }
+                    readMoof(static_cast<const ISOBMFF::ContainerBox &>(*box), i, start);
+                }
+                start = box->GetDataOffset() + box->GetDataLength();
+            }
+        }
+        if (!moov) {
+            throw std::runtime_error("No moov box in " + paths.front());
+        }
+        for (auto &track : tracks) {
+            if (track.sampleCount > 0) {
+                track.stts->AddEntry(1, static_cast<uint32_t>(track.lastDuration));
+            }
+        }
+    }
+
+    void readMoov(const std::shared_ptr<ISOBMFF::ContainerBox> &box) {
+        moov = box;
+        auto mvhd = moov->GetTypedBox<ISOBMFF::MVHD>("mvhd");
+        if (!mvhd) {
+            throw std::runtime_error("No mvhd box");
+        }
+        movieTimescale = mvhd->GetTimescale();
+
+        for (const auto &trakBox : moov->Container::GetBoxes("trak")) {
+            Track track;
+            track.trak = std::static_pointer_cast<ISOBMFF::ContainerBox>(trakBox);
+            auto tkhd = track.trak->GetTypedBox<ISOBMFF::TKHD>("tkhd");
+            auto mdia = track.trak->GetTypedBox<ISOBMFF::ContainerBox>("mdia");
+            auto mdhd = mdia ? mdia->GetTypedBox<ISOBMFF::MDHD>("mdhd") : nullptr;
+            if (!tkhd || !mdhd) {
+                throw std::runtime_error("trak box has no tkhd or mdhd box");
+            }
+            track.trackID = tkhd->GetTrackID();
+            track.timescale = mdhd->GetTimescale();
+            tracks.push_back(std::move(track));
+        }
+
+        auto mvex = moov->GetTypedBox<ISOBMFF::ContainerBox>("mvex");
+        if (mvex) {
+            for (const auto &trexBox : mvex->Container::GetBoxes("trex")) {
+                auto trex = std::static_pointer_cast<ISOBMFF::TREX>(trexBox);
+                Track *track = findTrack(trex->GetTrackID());
+                if (track) {
+                    track->sampleDescriptionIndex = trex->GetDefaultSampleDescriptionIndex();
+                    track->sampleDuration = trex->GetDefaultSampleDuration();
+                    track->sampleSize = trex->GetDefaultSampleSize();
+                    track->sampleFlags = trex->GetDefaultSampleFlags();
+                }
+            }
+        }
+    }
+
+    Track *findTrack(uint32_t trackID) {
+        for (auto &track : tracks) {
+            if (track.trackID == trackID) {
+                return &track;
+            }
+        }
+        return nullptr;
+    }
+
+    void readMoof(const ISOBMFF::ContainerBox &moof, size_t file, uint64_t moofStart) {
+        fragments++;
+        uint64_t previousEnd = moofStart;
+        bool firstTraf = true;
+
+        for (const auto &trafBox : moof.Container::GetBoxes("traf")) {
+            const auto &traf = static_cast<const ISOBMFF::ContainerBox &>(*trafBox);
+            auto tfhd = traf.GetTypedBox<ISOBMFF::TFHD>("tfhd");
+            if (!tfhd) {
+                throw std::runtime_error("traf box without tfhd box in " + paths[file]);
+            }
+            if (traf.GetBox("senc") || traf.GetBox("saiz")) {
+                throw std::runtime_error("Encrypted fragments are not supported: " + paths[file]);
+            }
+            Track *track = findTrack(tfhd->GetTrackID());
+            if (!track) {
+                throw std::runtime_error("Fragment of unknown track " + std::to_string(tfhd->GetTrackID()) + " in " +
+                                         paths[file]);
+            }
+
+            // The data of a traf starts at its base offset, or the moof for the first one, or where the previous ends
+            uint64_t base = previousEnd;
+            if (tfhd->hasBaseDataOffset()) {
+                base = tfhd->GetBaseDataOffset();
+            } else if ((tfhd->GetFlags() & DefaultBaseIsMoof) || firstTraf) {
+                base = moofStart;
+            }
+            firstTraf = false;
+
+            const uint32_t descriptionIndex = tfhd->hasSampleDescriptionIndex() ? tfhd->GetSampleDescriptionIndex()
+                                                                                : track->sampleDescriptionIndex;
+            const uint32_t defaultDuration = tfhd->hasDefaultSampleDuration() ? tfhd->GetDefaultSampleDuration()
+                                                                              : track->sampleDuration;
+            const uint32_t defaultSize = tfhd->hasDefaultSampleSize() ? tfhd->GetDefaultSampleSize() : track->sampleSize;
+            const uint32_t defaultFlags = tfhd->hasDefaultSampleFlags() ? tfhd->GetDefaultSampleFlags()
+                                                                        : track->sampleFlags;
+
+            auto tfdt = traf.GetTypedBox<ISOBMFF::TFDT>("tfdt");
+            if (tfdt) {
+                const uint64_t time = tfdt->GetBaseMediaDecodeTime();
+                if (!track->started) {
+                    track->started = true;
+                    track->firstDecodeTime = time;
+                    track->nextDecodeTime = time;
+                } else if (time > track->nextDecodeTime && track->sampleCount > 0) {
+                    track->lastDuration += time - track->nextDecodeTime;
+                    track->nextDecodeTime = time;
+                }
+            }
+            track->started = true;
+
+            uint64_t position = base;
+            for (const auto &trunBox : traf.Container::GetBoxes("trun")) {
+                const auto &trun = static_cast<const ISOBMFF::TRUN &>(*trunBox);
+                const auto &entries = trun.getSampleEntries();
+                if (trun.hasDataOffset()) {
+                    position = base + static_cast<int32_t>(trun.GetDataOffset());
+                }
+                if (entries.empty()) {
+                    continue;
+                }
+
+                uint64_t length = 0;
+                for (size_t i = 0; i < entries.size(); i++) {
+                    const auto &entry = entries[i];
+                    uint32_t flags = defaultFlags;
+                    if (i == 0 && trun.hasFirstSampleFlags()) {
+                        flags = trun.GetFirstSampleFlags();
+                    } else if (trun.hasSampleFlags()) {
+                        flags = entry.sample_flags;
+                    }
+                    const uint32_t size = trun.hasSampleSize() ? entry.sample_size : defaultSize;
+                    addSample(*track,
+                              trun.hasSampleDuration() ? entry.sample_duration : defaultDuration,
+                              size,
+                              trun.hasSampleCTO() ? static_cast<int32_t>(entry.sample_composition_time_offset) : 0,
+                              (flags & SampleIsNonSync) == 0);
+                    length += size;
+                }
+
+                track->chunkOffsets.push_back(payload);
+                track->stsc->AddChunk(static_cast<uint32_t>(track->chunkOffsets.size()),
+                                      static_cast<uint32_t>(entries.size()), descriptionIndex);
+                runs.push_back({file, position, length});
+                payload += length;
+                position += length;
+            }
+            previousEnd = position;
+        }
+    }
+
+    void addSample(Track &track, uint32_t duration, uint32_t size, int32_t compositionOffset, bool sync) {
+        if (track.sampleCount == std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("Too many samples in track " + std::to_string(track.trackID));
+        }
+        if (track.sampleCount > 0) {
+            if (track.lastDuration > std::numeric_limits<uint32_t>::max()) {
+                throw std::runtime_error("Decoding time gap too large in track " + std::to_string(track.trackID));
+            }
+            track.stts->AddEntry(1, static_cast<uint32_t>(track.lastDuration));
+        }
+        track.lastDuration = duration;
+        track.nextDecodeTime += duration;
+        track.ctts->AddEntry(1, compositionOffset);
+        track.hasCompositionOffsets |= compositionOffset != 0;
+        track.sampleCount++;
+        if (sync) {
+            track.stss->AddSampleNumber(track.sampleCount);
+        } else {
+            track.allSync = false;
+        }
+        track.sizes.push_back(size);
+        samples++;
+    }
+
+    std::shared_ptr<ISOBMFF::ContainerBox> buildStbl(const Track &track, const ISOBMFF::ContainerBox &source,
+                                                     std::vector<std::shared_ptr<ISOBMFF::STCO>> &stcos,
+                                                     bool largeOffsets) const {
+        auto stbl = std::make_shared<ISOBMFF::ContainerBox>("stbl");
+        auto stsd = source.GetBox("stsd");
+        if (!stsd) {
+            throw std::runtime_error("Track " + std::to_string(track.trackID) + " has no stsd box");
+        }
+        stbl->AddBox(stsd);
+        stbl->AddBox(track.stts);
+        if (track.hasCompositionOffsets) {
+            stbl->AddBox(track.ctts);
+        }
+        if (!track.allSync) {
+            stbl->AddBox(track.stss);
+        }
+        stbl->AddBox(track.stsc);
+
+        auto stsz = std::make_shared<ISOBMFF::STSZ>();
+        bool sameSize = !track.sizes.empty();
+        for (uint32_t size : track.sizes) {
+            sameSize = sameSize && size == track.sizes.front();
+        }
+        if (sameSize) {
+            stsz->SetSampleSize(track.sizes.front(), track.sampleCount);
+        } else {
+            for (uint32_t size : track.sizes) {
+                stsz->AddEntrySize(size);
+            }
+        }
+        stbl->AddBox(stsz);
+
+        auto stco = std::make_shared<ISOBMFF::STCO>(largeOffsets ? "co64" : "stco");
+        for (uint64_t offset : track.chunkOffsets) {
+            stco->AddChunkOffset(offset);
+        }
+        stbl->AddBox(stco);
+        stcos.push_back(stco);
+        return stbl;
+    }
+
+    // Empty edit for tracks starting after the first one, then the media from the original first edit
+    std::shared_ptr<ISOBMFF::ContainerBox> buildEdts(const Track &track, uint64_t delay, uint64_t &duration) const {
+        int64_t mediaTime = 0;
+        auto edts = track.trak->GetTypedBox<ISOBMFF::ContainerBox>("edts");
+        auto elst = edts ? edts->GetTypedBox<ISOBMFF::ELST>("elst") : nullptr;
+        if (elst) {
+            for (const auto &entry : elst->GetEntries()) {
+                if (entry.mediaTime >= 0) {
+                    mediaTime = entry.mediaTime;
+                    break;
+                }
+            }
+        }
+
+        const uint64_t media = track.mediaDuration();
+        const uint64_t presented = rescale(media > static_cast<uint64_t>(mediaTime) ? media - mediaTime : 0,
+                                           track.timescale, movieTimescale);
+        duration = delay + presented;
+        if (delay == 0 && mediaTime == 0) {
+            return nullptr;
+        }
+
+        auto edits = std::make_shared<ISOBMFF::ELST>();
+        if (delay > 0) {
+            edits->AddEntry(delay, -1);
+        }
+        edits->AddEntry(presented, mediaTime);
+        auto result = std::make_shared<ISOBMFF::ContainerBox>("edts");
+        result->AddBox(edits);
+        return result;
+    }
+
+    std::shared_ptr<ISOBMFF::ContainerBox> buildMoov(std::vector<std::shared_ptr<ISOBMFF::STCO>> &stcos,
+                                                     bool largeOffsets) const {
+        // Tracks keep their relative start times: the earliest starts at 0
+        uint64_t start = std::numeric_limits<uint64_t>::max();
+        for (const auto &track : tracks) {
+            if (track.sampleCount > 0) {
+                start = std::min(start, rescale(track.firstDecodeTime, track.timescale, movieTimescale));
+            }
+        }
+
+        auto result = std::make_shared<ISOBMFF::ContainerBox>("moov");
+        std::shared_ptr<ISOBMFF::MVHD> mvhd;
+        uint64_t movieDuration = 0;
+        size_t t = 0;
+
+        for (const auto &box : moov->GetBoxes()) {
+            if (box->GetName() == "mvhd") {
+                mvhd = std::make_shared<ISOBMFF::MVHD>(*std::static_pointer_cast<ISOBMFF::MVHD>(box));
+                result->AddBox(mvhd);
+            } else if (box->GetName() == "trak") {
+                const Track &track = tracks[t++];
+                uint64_t delay = 0;
+                if (track.sampleCount > 0) {
+                    delay = rescale(track.firstDecodeTime, track.timescale, movieTimescale) - start;
+                }
+                uint64_t duration = 0;
+                auto edts = buildEdts(track, delay, duration);
+                movieDuration = std::max(movieDuration, duration);
+                result->AddBox(buildTrak(track, edts, duration, stcos, largeOffsets));
+            } else if (box->GetName() != "mvex") {
+                result->AddBox(box);
+            }
+        }
+
+        mvhd->SetDuration(movieDuration);
+        mvhd->SetVersion(movieDuration > std::numeric_limits<uint32_t>::max() ? 1 : mvhd->GetVersion());
+        return result;
+    }
+
+    std::shared_ptr<ISOBMFF::ContainerBox> buildTrak(const Track &track,
+                                                     const std::shared_ptr<ISOBMFF::ContainerBox> &edts,
+                                                     uint64_t duration,
+                                                     std::vector<std::shared_ptr<ISOBMFF::STCO>> &stcos,
+                                                     bool largeOffsets) const {
+        auto trak = std::make_shared<ISOBMFF::ContainerBox>("trak");
+        for (const auto &box : track.trak->GetBoxes()) {
+            if (box->GetName() == "tkhd") {
+                auto tkhd = std::make_shared<ISOBMFF::TKHD>(*std::static_pointer_cast<ISOBMFF::TKHD>(box));
+                tkhd->SetDuration(duration);
+                tkhd->SetVersion(duration > std::numeric_limits<uint32_t>::max() ? 1 : tkhd->GetVersion());
+                trak->AddBox(tkhd);
+                if (edts) {
+                    trak->AddBox(edts);
+                }
+            } else if (box->GetName() == "mdia") {
+                auto mdia = std::make_shared<ISOBMFF::ContainerBox>("mdia");
+                for (const auto &child : std::static_pointer_cast<ISOBMFF::ContainerBox>(box)->GetBoxes()) {
+                    if (child->GetName() == "mdhd") {
+                        auto mdhd = std::make_shared<ISOBMFF::MDHD>(*std::static_pointer_cast<ISOBMFF::MDHD>(child));
+                        mdhd->SetDuration(track.mediaDuration());
+                        mdhd->SetVersion(track.mediaDuration() > std::numeric_limits<uint32_t>::max() ? 1 : mdhd->GetVersion());
+                        mdia->AddBox(mdhd);
+                    } else if (child->GetName() == "minf") {
+                        auto minf = std::make_shared<ISOBMFF::ContainerBox>("minf");
+                        for (const auto &grandChild : std::static_pointer_cast<ISOBMFF::ContainerBox>(child)->GetBoxes()) {
+                            if (grandChild->GetName() == "stbl") {
+                                const auto &source = static_cast<const ISOBMFF::ContainerBox &>(*grandChild);
+                                minf->AddBox(buildStbl(track, source, stcos, largeOffsets));
+                            } else {
+                                minf->AddBox(grandChild);
+                            }
+                        }
+                        mdia->AddBox(minf);
+                    } else {
+                        mdia->AddBox(child);
+                    }
+                }
+                trak->AddBox(mdia);
+            } else if (box->GetName() != "edts") {
+                trak->AddBox(box);
+            }
+        }
+        return trak;
+    }
+
+    void write(int out) {
+        ISOBMFF::FTYP ftyp;
+        ftyp.SetMajorBrand("isom");
+        ftyp.SetMinorVersion(512);
+        ftyp.SetCompatibleBrands({"isom", "iso2", "mp41"});
+
+        // Chunk offsets do not change the moov size, only stco or co64 does
+        const uint64_t mdatHeader = payload + 8 > std::numeric_limits<uint32_t>::max() ? 16 : 8;
+        uint64_t lastChunk = 0;
+        for (const auto &track : tracks) {
+            if (!track.chunkOffsets.empty()) {
+                lastChunk = std::max(lastChunk, track.chunkOffsets.back());
+            }
+        }
+
+        std::vector<std::shared_ptr<ISOBMFF::STCO>> stcos;
+        ISOBMFF::BoxSink sink;
+        ftyp.Write(sink);
+        auto result = buildMoov(stcos, false);
+        result->Write(sink);
+        uint64_t base = sink.GetSize() + mdatHeader;
+        if (base + lastChunk > std::numeric_limits<uint32_t>::max()) {
+            stcos.clear();
+            sink.Clear();
+            ftyp.Write(sink);
+            result = buildMoov(stcos, true);
+            result->Write(sink);
+            base = sink.GetSize() + mdatHeader;
+        }
+        for (const auto &stco : stcos) {
+            stco->AddToChunkOffsets(static_cast<int64_t>(base));
+        }
+
+        sink.Clear();
+        ftyp.Write(sink);
+        result->Write(sink);
+        if (mdatHeader == 16) {
+            sink.WriteBigEndianUInt32(1);
+            sink.WriteFourCC("mdat");
+            sink.WriteBigEndianUInt64(payload + 16);
+        } else {
+            sink.WriteBigEndianUInt32(static_cast<uint32_t>(payload + 8));
+            sink.WriteFourCC("mdat");
+        }
+        sink.WriteTo(out);
+
+        // Runs are in source order: each file is opened once
+        int in = -1;
+        size_t file = 0;
+        try {
+            for (const auto &run : runs) {
+                if (in < 0 || run.file != file) {
+                    copier.flush();
+                    if (in >= 0) {
+                        close(in);
+                    }
+                    file = run.file;
+                    in = open(paths[file].c_str(), O_RDONLY | O_CLOEXEC);
+                    if (in < 0) {
+                        throw std::runtime_error("Cannot open " + paths[file] + ": " + strerror(errno));
+                    }
+                }
+                copier.add(in, run.offset, run.length, out);
+            }
+            copier.flush();
+        } catch (...) {
+            if (in >= 0) {
+                close(in);
+            }
+            throw;
+        }
+        if (in >= 0) {
+            close(in);
+        }
+    }
+};
+
+Defragmenter::Defragmenter(const std::string &path) : Defragmenter(std::vector<std::string>{path}) {
+}
+
+Defragmenter::Defragmenter(const std::vector<std::string> &paths) : m_impl(new Private(paths)) {
+}
+
+Defragmenter::~Defragmenter() = default;
+
+void Defragmenter::write(int fd) {
+    m_impl->write(fd);
+}
+
+uint32_t Defragmenter::fragmentCount() const {
+    return m_impl->fragments;
+}
+
+uint64_t Defragmenter::sampleCount() const {
+    return m_impl->samples;
+}
+
+uint64_t Defragmenter::bytesCopied() const {
+    return m_impl->copier.bytesCopied();
+}
+
+uint64_t Defragmenter::copyCalls() const {
+    return m_impl->copier.copyCalls();
+}
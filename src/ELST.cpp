@@ -0,0 +1,145 @@
+/*!
+ * @file        ELST.cpp
+ */
+
+#include <ISOBMFF/ELST.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <limits>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::ELST >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        std::vector< ISOBMFF::ELST::Entry > _entries;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::ELST
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    ELST::ELST( void ): FullBox( "elst" )
+    {}
+    
+    void ELST::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint32_t count;
+        Entry    entry;
+        
+        FullBox::ReadData( parser, stream );
+        
+        this->impl->_entries.clear();
+        
+        count = stream.ReadBigEndianUInt32();
+        
+        if( static_cast< uint64_t >( count ) * ( ( this->GetVersion() == 1 ) ? 20 : 12 ) > stream.GetBytesAvailable() )
+        {
+            throw std::runtime_error( "elst entry count exceeds the box size" );
+        }
+        
+        for( uint32_t i = 0; i < count; i++ )
+        {
+            if( this->GetVersion() == 1 )
+            {
+                entry.segmentDuration = stream.ReadBigEndianUInt64();
+                entry.mediaTime       = static_cast< int64_t >( stream.ReadBigEndianUInt64() );
+            }
+            else
+            {
+                entry.segmentDuration = stream.ReadBigEndianUInt32();
+                entry.mediaTime       = static_cast< int32_t >( stream.ReadBigEndianUInt32() );
+            }
+            
+            entry.mediaRateInteger  = static_cast< int16_t >( stream.ReadBigEndianUInt16() );
+            entry.mediaRateFraction = static_cast< int16_t >( stream.ReadBigEndianUInt16() );
+            
+            this->impl->_entries.push_back( entry );
+        }
+    }
+    
+    void ELST::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->impl->_entries.size() ) );
+        
+        for( const auto & entry: this->impl->_entries )
+        {
+            if( this->GetVersion() == 1 )
+            {
+                sink.WriteBigEndianUInt64( entry.segmentDuration );
+                sink.WriteBigEndianUInt64( static_cast< uint64_t >( entry.mediaTime ) );
+            }
+            else
+            {
+                sink.WriteBigEndianUInt32( static_cast< uint32_t >( entry.segmentDuration ) );
+                sink.WriteBigEndianUInt32( static_cast< uint32_t >( entry.mediaTime ) );
+            }
+            
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( entry.mediaRateInteger ) );
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( entry.mediaRateFraction ) );
+        }
+    }
+    
+    std::vector< std::pair< std::string, std::string > > ELST::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Entries", std::to_string( this->impl->_entries.size() ) } );
+        
+        for( const auto & entry: this->impl->_entries )
+        {
+            props.push_back( { "Segment duration", std::to_string( entry.segmentDuration ) } );
+            props.push_back( { "Media time",       std::to_string( entry.mediaTime ) } );
+        }
+        
+        return props;
+    }
+    
+    const std::vector< ELST::Entry > & ELST::GetEntries( void ) const
+    {
+        return this->impl->_entries;
+    }
+    
+    void ELST::AddEntry( uint64_t segmentDuration, int64_t mediaTime )
+    {
+        this->AddEntry( { segmentDuration, mediaTime, 1, 0 } );
+    }
+    
+    void ELST::AddEntry( const Entry & entry )
+    {
+        if( entry.segmentDuration > std::numeric_limits< uint32_t >::max() )
+        {
+            this->SetVersion( 1 );
+        }
+        
+        if( entry.mediaTime > std::numeric_limits< int32_t >::max() || entry.mediaTime < std::numeric_limits< int32_t >::min() )
+        {
+            this->SetVersion( 1 );
+        }
+        
+        this->impl->_entries.push_back( entry );
+    }
+    
+    void ELST::ClearEntries( void )
+    {
+        this->impl->_entries.clear();
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::ELST >::IMPL::IMPL( void )
+{}
+
+XS::PIMPL::Object< ISOBMFF::ELST >::IMPL::IMPL( const IMPL & o ):
+    _entries( o._entries )
+{}
+
+XS::PIMPL::Object< ISOBMFF::ELST >::IMPL::~IMPL( void )
+{}
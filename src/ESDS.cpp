@@ -0,0 +1,438 @@
+/*!
+ * @file        ESDS.cpp
+ */
+
+#include <ISOBMFF/ESDS.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/Utils.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::ESDS >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        void ReadAudioSpecificConfig( void );
+        
+        uint16_t               _esID;
+        uint8_t                _objectTypeIndication;
+        uint8_t                _streamType;
+        uint32_t               _bufferSizeDB;
+        uint32_t               _maxBitrate;
+        uint32_t               _avgBitrate;
+        std::vector< uint8_t > _decoderSpecificInfo;
+        bool                   _hasAudioSpecificConfig;
+        uint8_t                _audioObjectType;
+        uint8_t                _coreAudioObjectType;
+        uint8_t                _samplingFrequencyIndex;
+        uint32_t               _samplingFrequency;
+        uint8_t                _channelConfiguration;
+        unsigned int           _descriptorSizeLength;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::ESDS
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    static const uint32_t SamplingFrequencies[ 13 ] =
+    {
+        96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350
+    };
+    
+    /* Descriptor sizes are 1 to 4 bytes of 7 bits, the high bit telling another byte follows */
+    static uint32_t ReadDescriptorSize( BinaryStream & stream, unsigned int * length = nullptr )
+    {
+        uint32_t     size;
+        uint8_t      u8;
+        unsigned int i;
+        
+        size = 0;
+        
+        for( i = 0; i < 4; i++ )
+        {
+            u8   = stream.ReadUInt8();
+            size = ( size << 7 ) | ( u8 & 0x7F );
+            
+            if( ( u8 & 0x80 ) == 0 )
+            {
+                break;
+            }
+        }
+        
+        if( length != nullptr )
+        {
+            *( length ) = ( i < 4 ) ? i + 1 : 4;
+        }
+        
+        return size;
+    }
+    
+    /* Padded to at least length bytes, as many encoders always use 4 */
+    static uint32_t GetDescriptorSizeLength( uint32_t size, unsigned int length )
+    {
+        unsigned int needed;
+        
+        for( needed = 1; needed < 4 && ( size >> ( 7 * needed ) ) != 0; needed++ )
+        {}
+        
+        return ( needed > length ) ? needed : length;
+    }
+    
+    static void WriteDescriptorHeader( BoxSink & sink, uint8_t tag, uint32_t size, unsigned int length )
+    {
+        length = GetDescriptorSizeLength( size, length );
+        
+        sink.WriteUInt8( tag );
+        
+        for( unsigned int i = length; i > 0; i-- )
+        {
+            sink.WriteUInt8( static_cast< uint8_t >( ( ( size >> ( 7 * ( i - 1 ) ) ) & 0x7F ) | ( ( i > 1 ) ? 0x80 : 0x00 ) ) );
+        }
+    }
+    
+    ESDS::ESDS( void ): FullBox( "esds" )
+    {}
+    
+    void ESDS::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint8_t  flags;
+        uint32_t u32;
+        uint32_t size;
+        
+        FullBox::ReadData( parser, stream );
+        
+        this->impl->_esID                 = 0;
+        this->impl->_objectTypeIndication = 0;
+        this->impl->_streamType           = 0;
+        this->impl->_bufferSizeDB         = 0;
+        this->impl->_maxBitrate           = 0;
+        this->impl->_avgBitrate           = 0;
+        this->impl->_descriptorSizeLength = 0;
+        
+        this->impl->_decoderSpecificInfo.clear();
+        this->impl->ReadAudioSpecificConfig();
+        
+        if( stream.HasBytesAvailable() == false || stream.ReadUInt8() != 0x03 )
+        {
+            return;
+        }
+        
+        ReadDescriptorSize( stream, &( this->impl->_descriptorSizeLength ) );
+        
+        this->impl->_esID = stream.ReadBigEndianUInt16();
+        
+        flags = stream.ReadUInt8();
+        
+        if( flags & 0x80 )
+        {
+            /* dependsOn_ES_ID */
+            stream.ReadBigEndianUInt16();
+        }
+        
+        if( flags & 0x40 )
+        {
+            /* URL string */
+            size = stream.ReadUInt8();
+            
+            for( uint32_t i = 0; i < size; i++ )
+            {
+                stream.ReadUInt8();
+            }
+        }
+        
+        if( flags & 0x20 )
+        {
+            /* OCR_ES_Id */
+            stream.ReadBigEndianUInt16();
+        }
+        
+        if( stream.HasBytesAvailable() == false || stream.ReadUInt8() != 0x04 )
+        {
+            return;
+        }
+        
+        ReadDescriptorSize( stream );
+        
+        this->impl->_objectTypeIndication = stream.ReadUInt8();
+        this->impl->_streamType           = stream.ReadUInt8() >> 2;
+        
+        u32 = stream.ReadBigEndianUInt16();
+        
+        this->impl->_bufferSizeDB         = ( u32 << 8 ) | stream.ReadUInt8();
+        this->impl->_maxBitrate           = stream.ReadBigEndianUInt32();
+        this->impl->_avgBitrate           = stream.ReadBigEndianUInt32();
+        
+        if( stream.HasBytesAvailable() == false || stream.ReadUInt8() != 0x05 )
+        {
+            return;
+        }
+        
+        size = ReadDescriptorSize( stream );
+        
+        if( size > stream.GetBytesAvailable() )
+        {
+            throw std::runtime_error( "Invalid decoder specific info size in esds" );
+        }
+        
+        if( size > 0 )
+        {
+            this->impl->_decoderSpecificInfo.resize( size );
+            stream.Read( &( this->impl->_decoderSpecificInfo[ 0 ] ), size );
+        }
+        
+        this->impl->ReadAudioSpecificConfig();
+    }
+    
+    void ESDS::WriteData( BoxSink & sink ) const
+    {
+        unsigned int                   length;
+        uint32_t                       dsiSize;
+        uint32_t                       dcdSize;
+        uint32_t                       esSize;
+        const std::vector< uint8_t > & dsi( this->impl->_decoderSpecificInfo );
+        
+        FullBox::WriteData( sink );
+        
+        length = this->impl->_descriptorSizeLength;
+        
+        if( length == 0 )
+        {
+            return;
+        }
+        
+        /* Written back as ES, decoder config, decoder specific info and SL descriptors only */
+        dsiSize = static_cast< uint32_t >( dsi.size() );
+        dcdSize = 13;
+        
+        if( dsiSize > 0 )
+        {
+            dcdSize += 1 + GetDescriptorSizeLength( dsiSize, length ) + dsiSize;
+        }
+        
+        esSize = 3 + 1 + GetDescriptorSizeLength( dcdSize, length ) + dcdSize + 1 + GetDescriptorSizeLength( 1, length ) + 1;
+        
+        WriteDescriptorHeader( sink, 0x03, esSize, length );
+        sink.WriteBigEndianUInt16( this->GetESID() );
+        sink.WriteUInt8( 0 );
+        
+        WriteDescriptorHeader( sink, 0x04, dcdSize, length );
+        sink.WriteUInt8( this->GetObjectTypeIndication() );
+        sink.WriteUInt8( static_cast< uint8_t >( ( this->GetStreamType() << 2 ) | 0x01 ) );
+        sink.WriteBigEndianUInt24( this->GetBufferSizeDB() );
+        sink.WriteBigEndianUInt32( this->GetMaxBitrate() );
+        sink.WriteBigEndianUInt32( this->GetAvgBitrate() );
+        
+        if( dsiSize > 0 )
+        {
+            WriteDescriptorHeader( sink, 0x05, dsiSize, length );
+            sink.Write( dsi );
+        }
+        
+        WriteDescriptorHeader( sink, 0x06, 1, length );
+        sink.WriteUInt8( 0x02 );
+    }
+    
+    std::vector< std::pair< std::string, std::string > > ESDS::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "ES ID",                    std::to_string( this->GetESID() ) } );
+        props.push_back( { "Object type indication",   Utils::ToHexString( this->GetObjectTypeIndication() ) } );
+        props.push_back( { "Stream type",              std::to_string( this->GetStreamType() ) } );
+        props.push_back( { "Buffer size DB",           std::to_string( this->GetBufferSizeDB() ) } );
+        props.push_back( { "Max bitrate",              std::to_string( this->GetMaxBitrate() ) } );
+        props.push_back( { "Avg bitrate",              std::to_string( this->GetAvgBitrate() ) } );
+        props.push_back( { "Decoder specific info",    Utils::ToHexString( this->GetDecoderSpecificInfo() ) } );
+        
+        if( this->HasAudioSpecificConfig() )
+        {
+            props.push_back( { "Audio object type",        std::to_string( this->GetAudioObjectType() ) } );
+            props.push_back( { "Core audio object type",   std::to_string( this->GetCoreAudioObjectType() ) } );
+            props.push_back( { "Sampling frequency",       std::to_string( this->GetSamplingFrequency() ) } );
+            props.push_back( { "Channel configuration",    std::to_string( this->GetChannelConfiguration() ) } );
+        }
+        
+        return props;
+    }
+    
+    uint16_t ESDS::GetESID( void ) const
+    {
+        return this->impl->_esID;
+    }
+    
+    uint8_t ESDS::GetObjectTypeIndication( void ) const
+    {
+        return this->impl->_objectTypeIndication;
+    }
+    
+    uint8_t ESDS::GetStreamType( void ) const
+    {
+        return this->impl->_streamType;
+    }
+    
+    uint32_t ESDS::GetBufferSizeDB( void ) const
+    {
+        return this->impl->_bufferSizeDB;
+    }
+    
+    uint32_t ESDS::GetMaxBitrate( void ) const
+    {
+        return this->impl->_maxBitrate;
+    }
+    
+    uint32_t ESDS::GetAvgBitrate( void ) const
+    {
+        return this->impl->_avgBitrate;
+    }
+    
+    const std::vector< uint8_t > & ESDS::GetDecoderSpecificInfo( void ) const
+    {
+        return this->impl->_decoderSpecificInfo;
+    }
+    
+    bool ESDS::HasAudioSpecificConfig( void ) const
+    {
+        return this->impl->_hasAudioSpecificConfig;
+    }
+    
+    uint8_t ESDS::GetAudioObjectType( void ) const
+    {
+        return this->impl->_audioObjectType;
+    }
+    
+    uint8_t ESDS::GetCoreAudioObjectType( void ) const
+    {
+        return this->impl->_coreAudioObjectType;
+    }
+    
+    uint8_t ESDS::GetSamplingFrequencyIndex( void ) const
+    {
+        return this->impl->_samplingFrequencyIndex;
+    }
+    
+    uint32_t ESDS::GetSamplingFrequency( void ) const
+    {
+        return this->impl->_samplingFrequency;
+    }
+    
+    uint8_t ESDS::GetChannelConfiguration( void ) const
+    {
+        return this->impl->_channelConfiguration;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::ESDS >::IMPL::IMPL( void ):
+    _esID( 0 ),
+    _objectTypeIndication( 0 ),
+    _streamType( 0 ),
+    _bufferSizeDB( 0 ),
+    _maxBitrate( 0 ),
+    _avgBitrate( 0 ),
+    _hasAudioSpecificConfig( false ),
+    _audioObjectType( 0 ),
+    _coreAudioObjectType( 0 ),
+    _samplingFrequencyIndex( 0 ),
+    _samplingFrequency( 0 ),
+    _channelConfiguration( 0 ),
+    _descriptorSizeLength( 0 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::ESDS >::IMPL::IMPL( const IMPL & o ):
+    _esID( o._esID ),
+    _objectTypeIndication( o._objectTypeIndication ),
+    _streamType( o._streamType ),
+    _bufferSizeDB( o._bufferSizeDB ),
+    _maxBitrate( o._maxBitrate ),
+    _avgBitrate( o._avgBitrate ),
+    _decoderSpecificInfo( o._decoderSpecificInfo ),
+    _hasAudioSpecificConfig( o._hasAudioSpecificConfig ),
+    _audioObjectType( o._audioObjectType ),
+    _coreAudioObjectType( o._coreAudioObjectType ),
+    _samplingFrequencyIndex( o._samplingFrequencyIndex ),
+    _samplingFrequency( o._samplingFrequency ),
+    _channelConfiguration( o._channelConfiguration ),
+    _descriptorSizeLength( o._descriptorSizeLength )
+{}
+
+XS::PIMPL::Object< ISOBMFF::ESDS >::IMPL::~IMPL( void )
+{}
+
+void XS::PIMPL::Object< ISOBMFF::ESDS >::IMPL::ReadAudioSpecificConfig( void )
+{
+    const std::vector< uint8_t > & data( this->_decoderSpecificInfo );
+    size_t                         bit;
+    uint32_t                       index;
+    
+    /* Big-endian bit reader over the decoder specific info, 0 past the end */
+    auto bits = [ & ]( unsigned int count ) -> uint32_t
+    {
+        uint32_t value;
+        
+        value = 0;
+        
+        for( unsigned int i = 0; i < count; i++, bit++ )
+        {
+            value <<= 1;
+            
+            if( bit / 8 < data.size() )
+            {
+                value |= ( data[ bit / 8 ] >> ( 7 - ( bit % 8 ) ) ) & 1;
+            }
+        }
+        
+        return value;
+    };
+    
+    auto objectType = [ & ]( void ) -> uint8_t
+    {
+        uint32_t type;
+        
+        type = bits( 5 );
+        
+        return static_cast< uint8_t >( ( type == 31 ) ? 32 + bits( 6 ) : type );
+    };
+    
+    bit                           = 0;
+    this->_hasAudioSpecificConfig = false;
+    this->_audioObjectType        = 0;
+    this->_coreAudioObjectType    = 0;
+    this->_samplingFrequencyIndex = 0;
+    this->_samplingFrequency      = 0;
+    this->_channelConfiguration   = 0;
+    
+    if( this->_objectTypeIndication != 0x40 || data.size() < 2 )
+    {
+        return;
+    }
+    
+    this->_hasAudioSpecificConfig = true;
+    this->_audioObjectType        = objectType();
+    this->_coreAudioObjectType    = this->_audioObjectType;
+    this->_samplingFrequencyIndex = static_cast< uint8_t >( bits( 4 ) );
+    this->_samplingFrequency      = ( this->_samplingFrequencyIndex == 0x0F ) ? bits( 24 ) : 0;
+    
+    if( this->_samplingFrequencyIndex < 13 )
+    {
+        this->_samplingFrequency = ISOBMFF::SamplingFrequencies[ this->_samplingFrequencyIndex ];
+    }
+    
+    this->_channelConfiguration = static_cast< uint8_t >( bits( 4 ) );
+    
+    /* Explicit SBR (5) or PS (29): extension frequency, then the core object type */
+    if( this->_audioObjectType == 5 || this->_audioObjectType == 29 )
+    {
+        index = bits( 4 );
+        
+        if( index == 0x0F )
+        {
+            bits( 24 );
+        }
+        
+        this->_coreAudioObjectType = objectType();
+    }
+}
@@ -6,11 +6,36 @@
 #include <iterator>
 #include <deque>
 #include <array>
-#include <ISOBMFF/File.hpp>
+#include <ISOBMFF/Utils.hpp>
 #include <fstream>
 #include <unordered_map>
+#include <stdexcept>
+#include <cstdint>
 
 
+using ISOBMFF::Utils::FourCC;
+
+namespace {
+    constexpr uint32_t FTYP_Type = FourCC("ftyp");
+    constexpr uint32_t STYP_Type = FourCC("styp");
+    constexpr uint32_t SIDX_Type = FourCC("sidx");
+    constexpr uint32_t PRFT_Type = FourCC("prft");
+    constexpr uint32_t EMSG_Type = FourCC("emsg");
+    constexpr uint32_t MOOF_Type = FourCC("moof");
+    constexpr uint32_t MDAT_Type = FourCC("mdat");
+
+    constexpr uint32_t DefaultBaseIsMoof = 0x020000;
+
+    inline uint32_t readBigEndian32(const uint8_t *p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+             | (static_cast<uint32_t>(p[2]) << 8)  |  static_cast<uint32_t>(p[3]);
+    }
+
+    inline uint64_t readBigEndian64(const uint8_t *p) {
+        return (static_cast<uint64_t>(readBigEndian32(p)) << 32) | readBigEndian32(p + 4);
+    }
+}
+
 bool Fragment::isComplete() const {
     return sidx && moof && mdat;
 }
@@ -19,66 +44,234 @@ void Fragment::clear() {
     sidx.reset();
     moof.reset();
     mdat.reset();
+    moofOffset = 0;
+    leadingBoxes.clear();
 }
 
-void AddFragmentBox(Fragment &frag, const std::shared_ptr<ISOBMFF::Box> &box) {
-    auto name = box->GetName();
-    if(name == "moof") {
-        frag.moof = std::static_pointer_cast<ISOBMFF::ContainerBox>(box);
-    } else if (name == "sidx") {
-        frag.sidx = std::static_pointer_cast<ISOBMFF::SIDX>(box);
-    } else if (name == "mdat") {
-        frag.mdat = std::static_pointer_cast<ISOBMFF::ContainerBox>(box);
+void AddFragmentBox(Fragment &frag, uint32_t type, const std::shared_ptr<ISOBMFF::Box> &box) {
+    switch (type) {
+        case MOOF_Type:
+            frag.moof = std::static_pointer_cast<ISOBMFF::ContainerBox>(box);
+            break;
+        case SIDX_Type:
+            frag.sidx = std::static_pointer_cast<ISOBMFF::SIDX>(box);
+            break;
+        case MDAT_Type:
+            frag.mdat = std::static_pointer_cast<ISOBMFF::ContainerBox>(box);
+            break;
+        case STYP_Type:
+        case PRFT_Type:
+        case EMSG_Type:
+            frag.leadingBoxes.push_back(box);
+            break;
+        default:
+            break;
     }
 }
 
+std::vector<SampleInfo> Fragment::getSampleInfo(const ISOBMFF::TENC *tenc) const {
+    // The senc box is shared with other readers of the fragment: the IV size is passed, never set on it
+    const uint8_t *constantIV = nullptr;
+    uint8_t constantIVSize = 0;
+    bool useTencIVSize = false;
+    if (tenc && tenc->IsProtected()) {
+        useTencIVSize = true;
+        if (tenc->GetDefaultPerSampleIVSize() == 0 && !tenc->GetDefaultConstantIV().empty()) {
+            constantIV = tenc->GetDefaultConstantIV().data();
+            constantIVSize = static_cast<uint8_t>(tenc->GetDefaultConstantIV().size());
+        }
+    }
+
+    std::vector<SampleInfo> samples;
+    uint64_t previousEnd = moofOffset;
+    bool firstTraf = true;
+    for(const auto &trafBox : moof->Container::GetBoxes("traf")) {
+        auto traf = (ISOBMFF::ContainerBox*)trafBox.get();
+        auto tfhd = (ISOBMFF::TFHD*)traf->GetBox("tfhd").get();
+        auto tfdt = (ISOBMFF::TFDT*)traf->GetBox("tfdt").get();
+        auto senc = (ISOBMFF::SENC*)traf->GetBox("senc").get();
+        if (!tfhd) {
+            throw std::runtime_error("traf box without tfhd box");
+        }
+
+        // The data of a traf starts at its base offset, or the moof for the first one, or where the previous ends
+        uint64_t base = previousEnd;
+        if (tfhd->hasBaseDataOffset()) {
+            base = tfhd->GetBaseDataOffset();
+        } else if ((tfhd->GetFlags() & DefaultBaseIsMoof) || firstTraf) {
+            base = moofOffset;
+        }
+        firstTraf = false;
+
+        int64_t curPts = 0;
+        if (tfdt) {
+            curPts = tfdt->GetBaseMediaDecodeTime();
+        } else if (sidx) {
+            curPts = sidx->GetEarliestPTS();
+        }
+        uint32_t index = 0;
+        uint64_t position = base;
+        for(const auto &box : traf->Container::GetBoxes("trun")) {
+            auto trun = (ISOBMFF::TRUN*)box.get();
+            if (trun->hasDataOffset()) {
+                position = base + static_cast<int32_t>(trun->GetDataOffset());
+            }
+            samples.reserve(samples.size() + trun->GetSampleCount());
+            for(const auto &sample : trun->getSampleEntries()) {
+                SampleInfo info;
+                info.pts = curPts;
+                info.size = trun->hasSampleSize() ? sample.sample_size : tfhd->GetDefaultSampleSize();
+                info.offset = position;
+                info.trackID = tfhd->GetTrackID();
+                if (senc) {
+                    info.hasEncryption = true;
+                    info.encryption = useTencIVSize ? senc->GetSample(index, tenc->GetDefaultPerSampleIVSize())
+                                                    : senc->GetSample(index);
+                    if (constantIV) {
+                        info.encryption.iv = constantIV;
+                        info.encryption.ivSize = constantIVSize;
+                    }
+                }
+                samples.emplace_back(info);
+                ++index;
+                position += info.size;
+                curPts += trun->hasSampleDuration() ? sample.sample_duration : tfhd->GetDefaultSampleDuration();
+            }
+        }
+        previousEnd = position;
+    }
+    return samples;
+}
+
 std::vector<Frame> Fragment::getFrames() const {
-    auto traf = (ISOBMFF::ContainerBox*)moof->GetBox("traf").get();
-    auto tfhd = (ISOBMFF::TFHD*)traf->GetBox("tfhd").get();
-    auto trun = (ISOBMFF::TRUN*)traf->GetBox("trun").get();
-    auto data = mdat->GetData();
+    // mdat payloads that were passed through are not kept in the fragment
+    if (mdat->IsDataSkipped()) {
+        return {};
+    }
+    const auto &data = mdat->GetMutableData();
+    const uint64_t dataOffset = mdat->GetDataOffset();
 
-    size_t ofs = 0;
-    uint64_t curPts = sidx->GetEarliestPTS();
     std::vector<Frame> frames;
-    frames.reserve(trun->GetSampleCount());
-    for(const auto &sample : trun->getSampleEntries()) {
+    for(const auto &sample : getSampleInfo()) {
+        if (sample.offset < dataOffset || sample.offset - dataOffset > data.size()
+            || sample.size > data.size() - (sample.offset - dataOffset)) {
+            throw std::runtime_error("Sample data outside the mdat box");
+        }
+        auto begin = data.begin() + static_cast<ptrdiff_t>(sample.offset - dataOffset);
         Frame frame;
-        frame.data = { data.begin() + ofs, data.begin() + ofs + sample.sample_size };
-        frame.pts = curPts ;
+        frame.data = { begin, begin + sample.size };
+        frame.pts = sample.pts;
         frames.emplace_back(frame);
-        curPts += tfhd->GetDefaultSampleDuration();
-        ofs += sample.sample_size;
     }
     return frames;
 }
 
 
+FMP4BufferBudget::FMP4BufferBudget(size_t limit) : m_limit(limit) {
+}
+
+size_t FMP4BufferBudget::acquire(size_t maxBytes) {
+    size_t used = m_used.load();
+    size_t granted;
+    do {
+        granted = used < m_limit ? std::min(maxBytes, m_limit - used) : 0;
+        if (granted == 0) {
+            return 0;
+        }
+    } while (!m_used.compare_exchange_weak(used, used + granted));
+
+    size_t highWaterMark = m_highWaterMark.load();
+    while (used + granted > highWaterMark && !m_highWaterMark.compare_exchange_weak(highWaterMark, used + granted)) {
+    }
+    return granted;
+}
+
+void FMP4BufferBudget::release(size_t bytes) {
+    m_used -= bytes;
+}
+
+size_t FMP4BufferBudget::limit() const {
+    return m_limit;
+}
+
+size_t FMP4BufferBudget::used() const {
+    return m_used;
+}
+
+size_t FMP4BufferBudget::highWaterMark() const {
+    return m_highWaterMark;
+}
+
+
 struct FMP4StreamParser::Private : public ISOBMFF::IParser {
     static constexpr size_t DefaultBufferSize = 1024 * 70; // preallocate 20kb.
     enum ParseState : uint8_t {
-        Parse_SIDX = 0u,
-        Parse_MOOF,
-        Parse_MDAT,
-        Parse_Done
+        Parse_Box = 0u,
+        Parse_PassThrough   // Payload of the current box is forwarded/dropped as it arrives
     };
 
     Private() {
         m_inBuffer.reserve(DefaultBufferSize);
         registerBoxes();
-        m_root = std::make_shared<ISOBMFF::File>();
     }
 
     ~Private() override {
         m_input = nullptr;
+        if (m_sharedBudget) {
+            m_sharedBudget->release(m_chargedBytes);
+        }
     }
 
     void setInputStream(std::istream *input) {
         m_input = input;
     }
 
-    void readAll() {
+    FMP4StreamParser::ParseStatus readAll() {
+        return continueParsing();
+    }
+
+    FMP4StreamParser::ParseStatus feed(const uint8_t *data, size_t size) {
+        m_inBuffer.insert(m_inBuffer.end(), data, data + size);
+        m_stats.bytesRead += size;
+        m_stats.highWaterMark = std::max(m_stats.highWaterMark, heldBytes());
+        // Pushed data is charged as it arrives, like data read from an input stream
+        if (m_sharedBudget) {
+            chargeSharedBudget(0);
+        }
         continueParsing();
+        if (m_sharedBudget) {
+            chargeSharedBudget(0);
+        }
+        // Pushed data cannot be refused: ask the producer to slow down instead
+        if (heldBytes() > m_bufferLimit || (m_sharedBudget && m_chargedBytes < heldBytes())) {
+            ++m_stats.backpressureCount;
+            return FMP4StreamParser::ParseStatus::Backpressure;
+        }
+        return FMP4StreamParser::ParseStatus::Ok;
+    }
+
+    void setEndOfStream() {
+        m_endOfStream = true;
+        continueParsing();
+    }
+
+    void setBufferLimit(size_t bytes) {
+        m_bufferLimit = bytes;
+    }
+
+    void setSharedBudget(const std::shared_ptr<FMP4BufferBudget> &budget) {
+        if (m_sharedBudget) {
+            m_sharedBudget->release(m_chargedBytes);
+        }
+        m_sharedBudget = budget;
+        m_chargedBytes = 0;
+    }
+
+    FMP4StreamParser::Stats getStats() const {
+        FMP4StreamParser::Stats stats = m_stats;
+        stats.bufferedBytes = m_inBuffer.size();
+        stats.outstandingBytes = m_outstandingBytes;
+        return stats;
     }
 
     /*
@@ -87,19 +280,31 @@ struct FMP4StreamParser::Private : public ISOBMFF::IParser {
      *
      */
 
+    // Creates the boxes nested in the top-level box being parsed
     std::shared_ptr<ISOBMFF::Box> CreateBox(const std::string &type) const override {
-        auto registeredBox = m_registeredBoxes.find(type);
-        if (registeredBox != m_registeredBoxes.end()) {
-            return registeredBox->second();
+        if (type.size() != 4) {
+            return std::make_shared<ISOBMFF::Box>( type );
+        }
+        uint32_t fourCC = FourCC(type.c_str());
+        auto box = createBox(fourCC);
+        if (m_notifyChildren) {
+            size_t index = findSlot(fourCC);
+            if (index != NoSlot && !m_slots[index].parsed.empty()) {
+                m_nestedBoxes.push_back({index, box.get()});
+            }
         }
-        return std::make_shared<ISOBMFF::Box>( type );
+        return box;
+    }
+
+    bool ShouldSkipBoxData(const std::string &type, uint64_t /*length*/) const override {
+        return type == "mdat" && (m_options & ISOBMFF::IParser::Options::SkipMDATData) != 0;
     }
 
     ISOBMFF::IParser::StringType GetPreferredStringType() const override {
         return ISOBMFF::IParser::StringType::NULLTerminated;
     }
 
-    void SetPreferredStringType(ISOBMFF::IParser::StringType value) override{
+    void SetPreferredStringType(ISOBMFF::IParser::StringType /*value*/) override{
 
     }
 
@@ -111,11 +316,11 @@ struct FMP4StreamParser::Private : public ISOBMFF::IParser {
         m_options = value;
     }
 
-    void AddOption(ISOBMFF::IParser::Options option) override {
+    void AddOption(ISOBMFF::IParser::Options /*option*/) override {
 
     }
 
-    void RemoveOption(ISOBMFF::IParser::Options option) override {
+    void RemoveOption(ISOBMFF::IParser::Options /*option*/) override {
 
     }
 
@@ -123,63 +328,228 @@ struct FMP4StreamParser::Private : public ISOBMFF::IParser {
         return (m_options & static_cast<uint64_t>(option)) != 0;
     }
 
-    const void* GetInfo(const std::string &key) override {
+    const void* GetInfo(const std::string &/*key*/) override {
         return nullptr;
     }
 
-    void SetInfo(const std::string &key, void *value) override {
+    void SetInfo(const std::string &/*key*/, void */*value*/) override {
 
     }
 
     bool eos() const {
-        return m_input && m_input->eof();
+        return m_endOfStream || (m_input && m_input->eof());
     }
 
     void onParsedBox(const std::string &boxName, const FMP4StreamParser::ParsedTopLevelBoxCallback &callback) {
-        m_callbacks.insert(std::make_pair(boxName, callback));
+        on(toFourCC(boxName), [callback](const ISOBMFF::Box &box) {
+            callback(&box);
+        });
     }
 
     void onSkippedBox(const std::string &boxName, const FMP4StreamParser::SkippedTopLevelBoxCallback &callback) {
-        m_callbacksSkippedBox.insert(std::make_pair(boxName, callback));
+        // The name is built once here instead of for every skipped box
+        onSkipped(toFourCC(boxName), [callback, boxName](uint32_t, uint64_t) {
+            callback(boxName);
+        });
+    }
+
+    void on(uint32_t type, const FMP4StreamParser::BoxCallback &callback) {
+        BoxSlot &boxSlot = slot(type);
+        boxSlot.parsed.push_back(callback);
+        if (!boxSlot.topLevel) {
+            m_notifyChildren = true;
+        }
+    }
+
+    void onSkipped(uint32_t type, const FMP4StreamParser::SkippedBoxCallback &callback) {
+        slot(type).skipped.push_back(callback);
     }
 
     void onFragment(const FragmentCallback &fragmentCB) {
         m_fragmentCallback = fragmentCB;
     }
 
+    void onMdatData(const FMP4StreamParser::MdatDataCallback &callback) {
+        m_mdatDataCallback = callback;
+    }
+
+    void setMdatPassThroughThreshold(uint64_t bytes) {
+        m_mdatPassThroughThreshold = bytes;
+    }
+
+    void setChunkedMode(bool enabled) {
+        m_chunkedMode = enabled;
+    }
+
+    void onSamples(const FMP4StreamParser::SamplesCallback &callback, size_t batchSize) {
+        m_samplesCallback = callback;
+        m_sampleBatchSize = std::max<size_t>(batchSize, 1);
+    }
+
+    void setBoxAction(const std::string &type, FMP4StreamParser::BoxAction action) {
+        BoxSlot &boxSlot = slot(toFourCC(type));
+        boxSlot.action = action;
+        boxSlot.topLevel = true;
+    }
+
+    void onPassThroughData(const FMP4StreamParser::PassThroughDataCallback &callback) {
+        m_passThroughDataCallback = callback;
+    }
+
+    void setBoxRecycling(bool enabled) {
+        m_recycleBoxes = enabled;
+        if (!enabled) {
+            m_boxPool.clear();
+        }
+    }
+
 private:
     using BoxFactoryFunc = std::function<std::shared_ptr<ISOBMFF::Box>(void)>;
 
     std::istream*           m_input{nullptr};
+    bool                    m_endOfStream{false};   // Set for pushed input
     Fragment                m_currentFramgment;
     std::deque<Frame>       m_frames;
     std::vector<uint8_t>    m_inBuffer;
-    ParseState              m_state{ParseState::Parse_SIDX};
+    ParseState              m_state{ParseState::Parse_Box};
     uint64_t                m_options{IParser::Options::ShowBoxContentDebug | IParser::Options::SkipNotRequiredBoxes};
     size_t                  m_writeIndex{0};
-    std::unordered_map<std::string, BoxFactoryFunc> m_registeredBoxes;
+    std::unordered_map<uint32_t, BoxFactoryFunc> m_registeredBoxes;
     std::unordered_map< std::string, void * >       m_info;
-    std::shared_ptr<ISOBMFF::File>        m_root;
-    std::unordered_map<std::string, FMP4StreamParser::ParsedTopLevelBoxCallback>    m_callbacks;
-    std::unordered_map<std::string, FMP4StreamParser::SkippedTopLevelBoxCallback>   m_callbacksSkippedBox;
+    uint64_t                m_inputOffset{0};   // Stream position of m_inBuffer[0]
+
+    // Everything known about a box type: its top-level action and its subscribers. Types are resolved to a
+    // slot once per box, then callbacks are called directly. Few entries: a linear scan beats hashing.
+    struct BoxSlot {
+        BoxSlot(uint32_t boxType, FMP4StreamParser::BoxAction boxAction, bool isTopLevel)
+            : type(boxType), action(boxAction), topLevel(isTopLevel) {}
+
+        uint32_t                                            type;
+        FMP4StreamParser::BoxAction                         action;
+        bool                                                topLevel;   // Action set by default or setBoxAction
+        std::vector<FMP4StreamParser::BoxCallback>          parsed;
+        std::vector<FMP4StreamParser::SkippedBoxCallback>   skipped;
+    };
+    static constexpr size_t NoSlot = SIZE_MAX;
+    // Top-level box types without a slot are skipped
+    std::vector<BoxSlot>    m_slots{
+        {FTYP_Type, FMP4StreamParser::BoxAction::Parse, true},
+        {STYP_Type, FMP4StreamParser::BoxAction::Parse, true},
+        {SIDX_Type, FMP4StreamParser::BoxAction::Parse, true},
+        {PRFT_Type, FMP4StreamParser::BoxAction::Parse, true},
+        {EMSG_Type, FMP4StreamParser::BoxAction::Parse, true},
+        {MOOF_Type, FMP4StreamParser::BoxAction::Parse, true},
+        {MDAT_Type, FMP4StreamParser::BoxAction::Parse, true}
+    };
+    bool                    m_notifyChildren{false};    // Some callbacks are for nested box types
+    // Nested boxes with callbacks in the top-level box being parsed, in stream order: their slot is resolved
+    // when they are created, and they are owned by the top-level box
+    struct NestedBox {
+        size_t              slot;
+        const ISOBMFF::Box *box;
+    };
+    mutable std::vector<NestedBox>  m_nestedBoxes;
+    FMP4StreamParser::PassThroughDataCallback                                       m_passThroughDataCallback;
     FMP4StreamParser::FragmentCallback                                              m_fragmentCallback;
+    FMP4StreamParser::MdatDataCallback                                              m_mdatDataCallback;
+    uint64_t                m_mdatPassThroughThreshold{UINT64_MAX};
+    FMP4StreamParser::SamplesCallback                                               m_samplesCallback;
+    size_t                  m_sampleBatchSize{1};
+    bool                    m_chunkedMode{false};
+
+    // Box recycling: every box created, by type
+    struct PooledBoxes {
+        uint32_t                                    type;
+        std::vector<std::shared_ptr<ISOBMFF::Box>>  boxes;
+    };
+    bool                                    m_recycleBoxes{false};
+    mutable std::vector<PooledBoxes>        m_boxPool;
+    ISOBMFF::BinaryStream                   m_payload;  // View on the payload of the box being parsed
+
+    // Memory budget: unparsed input plus mdat data of delivered fragments still referenced by callers
+    struct OutstandingData {
+        std::weak_ptr<ISOBMFF::Box> box;
+        size_t                      size;
+    };
+    size_t                              m_bufferLimit{SIZE_MAX};
+    std::shared_ptr<FMP4BufferBudget>   m_sharedBudget;
+    size_t                              m_chargedBytes{0};  // Currently reserved in m_sharedBudget
+    std::vector<OutstandingData>        m_outstanding;
+    size_t                              m_outstandingBytes{0};
+    FMP4StreamParser::Stats             m_stats;
+
+    // Sample splitting of passed-through mdat payloads
+    std::vector<SampleInfo> m_samples;
+    size_t                  m_sampleIndex{0};
+    Frame                   m_sampleFrame;
+    std::vector<Frame>      m_sampleBatch;
 
     struct BoxHeader {
-        uint32_t boxSize    {0};
-        char     boxId[4]   {0};
+        uint64_t boxSize    {0};    // Including the header. 0 if the box runs to the end of the stream.
+        uint32_t headerSize {8};
+        uint32_t type       {0};
     };
 
-    void notifyParsedBox(const ISOBMFF::Box *box) {
-        const auto &callbackPair = m_callbacks.find(box->GetName());
-        if (callbackPair != m_callbacks.end()) {
-            callbackPair->second(box);
+    enum PassThroughMode : uint8_t {
+        PassThrough_Drop = 0u,  // Skipped box
+        PassThrough_Forward,    // Payload goes to onPassThroughData
+        PassThrough_Mdat        // Payload goes to onMdatData and the sample splitter, then completes the fragment
+    };
+
+    struct PassThrough {
+        BoxHeader       header;
+        uint64_t        remaining {0};
+        bool            toEOS     {false};
+        PassThroughMode mode      {PassThrough_Drop};
+        size_t          slot      {NoSlot};
+    };
+    PassThrough             m_passThrough;
+
+    static uint32_t toFourCC(const std::string &type) {
+        if (type.size() != 4) {
+            throw std::runtime_error("Box name should be 4 characters long");
         }
+        return FourCC(type.c_str());
     }
-    void notifySkippeddBox(const BoxHeader &header) {
-        std::string name(header.boxId, 4);
-        const auto &callbackPair = m_callbacksSkippedBox.find(name);
-        if (callbackPair != m_callbacksSkippedBox.end()) {
-            callbackPair->second(name);
+
+    size_t findSlot(uint32_t type) const {
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            if (m_slots[i].type == type) {
+                return i;
+            }
+        }
+        return NoSlot;
+    }
+
+    BoxSlot &slot(uint32_t type) {
+        size_t index = findSlot(type);
+        if (index == NoSlot) {
+            m_slots.emplace_back(type, FMP4StreamParser::BoxAction::Skip, false);
+            return m_slots.back();
+        }
+        return m_slots[index];
+    }
+
+    // Top-level box first, then the boxes nested in it, in stream order
+    void notifyParsedBox(size_t slot, const ISOBMFF::Box &box) {
+        if (slot != NoSlot) {
+            for (const auto &callback : m_slots[slot].parsed) {
+                callback(box);
+            }
+        }
+        for (const auto &nested : m_nestedBoxes) {
+            for (const auto &callback : m_slots[nested.slot].parsed) {
+                callback(*nested.box);
+            }
+        }
+        m_nestedBoxes.clear();
+    }
+
+    void notifySkippeddBox(size_t slot, const BoxHeader &header) {
+        if (slot != NoSlot) {
+            for (const auto &callback : m_slots[slot].skipped) {
+                callback(header.type, header.boxSize);
+            }
         }
     }
 
@@ -187,89 +557,366 @@ private:
         if (m_fragmentCallback) {
             m_fragmentCallback(frag);
         }
+        // Callers holding on to the fragment keep its mdat data alive: keep it charged until released
+        size_t size = static_cast<size_t>(frag.mdat->GetDataLength());
+        if (size > 0) {
+            m_outstanding.push_back({frag.mdat, size});
+            m_outstandingBytes += size;
+        }
     }
 
     bool readBox() {
-        static const std::vector<std::string> requiredBoxes = { "ftyp", "sidx", "moof", "mdat" };
-
         BoxHeader header;
-        for(auto &boxId : requiredBoxes) {
-            if (canReadBox(boxId, header)) {
-                std::vector<uint8_t> boxData = {m_inBuffer.begin(), m_inBuffer.begin() + header.boxSize};
-                std::string name(header.boxId, 4);
-                if (name == "mdat") {
-                    int i = 0;
-                }
-                ISOBMFF::BinaryStream boxStream(boxData);
-                auto box = CreateBox(name);
-                m_root->ReadData(this, boxStream);
-                AddFragmentBox(m_currentFramgment, m_root->GetBoxes().back());
-                m_inBuffer.erase(m_inBuffer.begin(), m_inBuffer.begin() + header.boxSize);
-                notifyParsedBox(m_root->GetBoxes().back().get());
+        if (!readBoxHeader(header)) {
+            return false;
+        }
+        size_t slot = findSlot(header.type);
+        switch (slot != NoSlot ? m_slots[slot].action : FMP4StreamParser::BoxAction::Skip) {
+            case FMP4StreamParser::BoxAction::Skip:
+                beginPassThrough(header, PassThrough_Drop, slot);
                 return true;
+            case FMP4StreamParser::BoxAction::PassThrough:
+                beginPassThrough(header, header.type == MDAT_Type ? PassThrough_Mdat : PassThrough_Forward, slot);
+                return true;
+            case FMP4StreamParser::BoxAction::Parse:
+                break;
+        }
+        if (header.type == MDAT_Type && shouldPassThroughMdat(header)) {
+            beginPassThrough(header, PassThrough_Mdat, slot);
+            return true;
+        }
+        if (header.boxSize == 0) {
+            if (!eos()) {
+                return false;
             }
+            header.boxSize = m_inBuffer.size();
         }
-        ;
-        return skipUnkownBox(header) && !m_inBuffer.empty();
+        if (header.boxSize > m_bufferLimit) {
+            throw std::runtime_error("Box " + ISOBMFF::Utils::FourCCToString(header.type) + " does not fit in the parser buffer limit");
+        }
+        if (header.boxSize > m_inBuffer.size()) {
+            return false;
+        }
+
+        // The header is decoded already: only the payload goes through the box parser
+        auto box = createBox(header.type);
+        uint64_t dataOffset = m_inputOffset + header.headerSize;
+        uint64_t dataLength = header.boxSize - header.headerSize;
+        if (header.type == MDAT_Type && HasOption(ISOBMFF::IParser::Options::SkipMDATData)) {
+            box->GetMutableData().clear();
+            box->SetDataLocation(dataOffset, dataLength, true);
+        } else {
+            m_payload.SetView(m_inBuffer.data() + header.headerSize, dataLength, dataOffset);
+            box->SetDataLocation(dataOffset, dataLength);
+            m_nestedBoxes.clear();
+            box->ReadData(this, m_payload);
+        }
+        consumeInput(static_cast<size_t>(header.boxSize));
+        if (header.type == MOOF_Type) {
+            m_currentFramgment.moofOffset = dataOffset - header.headerSize;
+        }
+        AddFragmentBox(m_currentFramgment, header.type, box);
+        notifyParsedBox(slot, *box);
+        return true;
     }
 
-    // Returns false if not enough bytes available to skip the full box
-    bool skipUnkownBox(const BoxHeader &header) {
-        if (m_inBuffer.size() > header.boxSize) {
-            m_inBuffer.erase(m_inBuffer.begin(), m_inBuffer.begin() + header.boxSize);
-            notifySkippeddBox(header);
+    void consumeInput(size_t count) {
+        m_inBuffer.erase(m_inBuffer.begin(), m_inBuffer.begin() + count);
+        m_inputOffset += count;
+    }
+
+    bool shouldPassThroughMdat(const BoxHeader &header) const {
+        return header.boxSize == 0 || header.boxSize - header.headerSize > m_mdatPassThroughThreshold
+            || header.boxSize > m_bufferLimit
+            || (m_samplesCallback && m_currentFramgment.moof);
+    }
+
+    // Consumes the box header and forwards or drops the payload as it arrives.
+    void beginPassThrough(const BoxHeader &header, PassThroughMode mode, size_t slot) {
+        m_passThrough.header    = header;
+        m_passThrough.slot      = slot;
+        m_passThrough.toEOS     = header.boxSize == 0;
+        m_passThrough.remaining = m_passThrough.toEOS ? 0 : header.boxSize - header.headerSize;
+        m_passThrough.mode      = mode;
+        consumeInput(header.headerSize);
+        m_state = ParseState::Parse_PassThrough;
+
+        m_samples.clear();
+        m_sampleIndex = 0;
+        if (mode == PassThrough_Mdat && m_samplesCallback && m_currentFramgment.moof) {
+            // The payload is read once, front to back: samples are completed in data order
+            m_samples = m_currentFramgment.getSampleInfo();
+            std::stable_sort(m_samples.begin(), m_samples.end(),
+                             [](const SampleInfo &a, const SampleInfo &b) { return a.offset < b.offset; });
+        }
+    }
+
+    // Returns false if more input is needed to make progress
+    bool continuePassThrough() {
+        size_t count = m_inBuffer.size();
+        if (!m_passThrough.toEOS && m_passThrough.remaining < count) {
+            count = static_cast<size_t>(m_passThrough.remaining);
+        }
+        if (count > 0) {
+            if (m_passThrough.mode == PassThrough_Mdat) {
+                if (m_mdatDataCallback) {
+                    m_mdatDataCallback(m_inBuffer.data(), count);
+                }
+                splitSamples(m_inBuffer.data(), count);
+            } else if (m_passThrough.mode == PassThrough_Forward && m_passThroughDataCallback) {
+                m_passThroughDataCallback(m_passThrough.header.type, m_inBuffer.data(), count);
+            }
+            consumeInput(count);
+            if (!m_passThrough.toEOS) {
+                m_passThrough.remaining -= count;
+            }
+        }
+        if (m_passThrough.toEOS ? eos() : m_passThrough.remaining == 0) {
+            endPassThrough();
             return true;
         }
         return false;
     }
 
-    bool canReadBox(const std::string &boxId, BoxHeader &header) {
-        return isBox(boxId, header) && header.boxSize <= m_inBuffer.size();
+    void endPassThrough() {
+        m_state = ParseState::Parse_Box;
+        if (m_passThrough.mode == PassThrough_Drop) {
+            notifySkippeddBox(m_passThrough.slot, m_passThrough.header);
+            return;
+        }
+        if (m_passThrough.mode == PassThrough_Forward) {
+            return;
+        }
+        flushSamples();
+        if (m_sampleIndex < m_samples.size()) {
+            throw std::runtime_error("Sample data outside the mdat box");
+        }
+        // The payload was not kept: a recycled mdat must not expose the data of an earlier fragment
+        auto mdat = createBox(MDAT_Type);
+        mdat->GetMutableData().clear();
+        mdat->SetDataLocation(0, 0, true);
+        AddFragmentBox(m_currentFramgment, MDAT_Type, mdat);
+        notifyParsedBox(m_passThrough.slot, *mdat);
+        extractFrames(m_currentFramgment);
+    }
+
+    // Completes samples from mdat payload bytes, which start at m_inputOffset in the stream.
+    // At most one incomplete sample is buffered; bytes between samples are skipped.
+    void splitSamples(const uint8_t *data, size_t size) {
+        uint64_t position = m_inputOffset;
+        while (m_sampleIndex < m_samples.size()) {
+            const auto &sample = m_samples[m_sampleIndex];
+            if (m_sampleFrame.data.empty()) {
+                if (sample.offset < position) {
+                    throw std::runtime_error("Sample data outside the mdat box or overlapping another sample");
+                }
+                if (sample.offset - position > size) {
+                    break;
+                }
+                size_t gap = static_cast<size_t>(sample.offset - position);
+                data += gap;
+                size -= gap;
+                position += gap;
+            }
+            size_t missing = sample.size - m_sampleFrame.data.size();
+            if (missing > 0 && size == 0) {
+                break;
+            }
+            size_t count = std::min(missing, size);
+            if (m_sampleFrame.data.empty()) {
+                m_sampleFrame.data.reserve(sample.size);
+            }
+            m_sampleFrame.data.insert(m_sampleFrame.data.end(), data, data + count);
+            data += count;
+            size -= count;
+            position += count;
+            if (m_sampleFrame.data.size() == sample.size) {
+                m_sampleFrame.pts = sample.pts;
+                m_sampleBatch.emplace_back(std::move(m_sampleFrame));
+                m_sampleFrame = Frame();
+                ++m_sampleIndex;
+                if (m_sampleBatch.size() >= m_sampleBatchSize) {
+                    flushSamples();
+                }
+            }
+        }
+    }
+
+    void flushSamples() {
+        if (!m_sampleBatch.empty()) {
+            m_samplesCallback(m_sampleBatch);
+            m_sampleBatch.clear();
+        }
+        m_sampleFrame.data.clear();
     }
 
     void extractFrames(const Fragment &fragment) {
-        if (fragment.isComplete()) {
+        // CMAF chunks are not indexed by a sidx: every moof+mdat pair is delivered on its own
+        if (m_chunkedMode ? fragment.moof && fragment.mdat : fragment.isComplete()) {
             notifyFragment(fragment);
             m_currentFramgment.clear();
         }
     }
 
-    void continueParsing() {
-        BoxHeader header;
-        auto bytesRead = readInputStream();
-        while(readBox()) {
-            extractFrames(m_currentFramgment);
+    FMP4StreamParser::ParseStatus continueParsing() {
+        bool budgetExhausted = readInputStream();
+        for (;;) {
+            if (m_state == ParseState::Parse_PassThrough) {
+                if (!continuePassThrough()) {
+                    break;
+                }
+            } else if (readBox()) {
+                extractFrames(m_currentFramgment);
+            } else {
+                break;
+            }
         }
+        updateCharge();
+        if (budgetExhausted) {
+            ++m_stats.backpressureCount;
+            return FMP4StreamParser::ParseStatus::Backpressure;
+        }
+        return FMP4StreamParser::ParseStatus::Ok;
+    }
+
+    void releaseConsumedFragments() {
+        // Recycled boxes stay referenced by the pool
+        long poolReferences = m_recycleBoxes ? 1 : 0;
+        auto consumed = std::remove_if(m_outstanding.begin(), m_outstanding.end(), [&](const OutstandingData &data) {
+            if (data.box.use_count() > poolReferences) {
+                return false;
+            }
+            m_outstandingBytes -= data.size;
+            return true;
+        });
+        m_outstanding.erase(consumed, m_outstanding.end());
+    }
+
+    size_t heldBytes() const {
+        return m_inBuffer.size() + m_outstandingBytes;
     }
 
-    // Reads until input stream has no more data currently available or is EOF
-    std::streamsize readInputStream() {
-        static char readBuf[8192];
-        size_t totalBytesRead = 0;
+    // Returns unused shared budget once buffered or delivered data has been consumed
+    void updateCharge() {
+        releaseConsumedFragments();
+        if (m_sharedBudget && m_chargedBytes > heldBytes()) {
+            m_sharedBudget->release(m_chargedBytes - heldBytes());
+            m_chargedBytes = heldBytes();
+        }
+    }
+
+    // Reserves the held bytes not charged yet, then up to extra more bytes, in the shared budget. Only what
+    // was granted is recorded. Returns the part of extra that was granted.
+    size_t chargeSharedBudget(size_t extra) {
+        size_t uncharged = heldBytes() > m_chargedBytes ? heldBytes() - m_chargedBytes : 0;
+        size_t granted = m_sharedBudget->acquire(uncharged + extra);
+        m_chargedBytes += granted;
+        return granted > uncharged ? granted - uncharged : 0;
+    }
+
+    // Reads until input stream has no more data currently available, is EOF, or the budget is exhausted.
+    // Returns true if reading stopped because of the budget.
+    bool readInputStream() {
+        static constexpr size_t ReadChunkSize = 8192;
+        updateCharge();
+        if (!m_input) {
+            return false;
+        }
+        size_t allowance = m_bufferLimit > heldBytes() ? m_bufferLimit - heldBytes() : 0;
+        if (m_sharedBudget) {
+            allowance = chargeSharedBudget(allowance);
+        }
+
         std::streamsize bytesRead = 0;
+        std::streamsize request = 0;
         do {
-            m_input->read(readBuf, sizeof(readBuf));
+            request = static_cast<std::streamsize>(std::min(allowance, ReadChunkSize));
+            if (request == 0) {
+                break;
+            }
+            // Read straight into this parser's buffer: no storage is shared between instances
+            size_t offset = m_inBuffer.size();
+            m_inBuffer.resize(offset + static_cast<size_t>(request));
+            m_input->read(reinterpret_cast<char *>(m_inBuffer.data() + offset), request);
             bytesRead = m_input->gcount();
-            totalBytesRead += bytesRead;
-            m_inBuffer.insert(m_inBuffer.end(), (uint8_t *)readBuf, (uint8_t *)readBuf + bytesRead);
-        } while (bytesRead == sizeof(readBuf));
-        return totalBytesRead;
+            m_inBuffer.resize(offset + static_cast<size_t>(bytesRead));
+            allowance -= static_cast<size_t>(bytesRead);
+            m_stats.bytesRead += static_cast<uint64_t>(bytesRead);
+        } while (bytesRead == request);
+
+        m_stats.highWaterMark = std::max(m_stats.highWaterMark, heldBytes());
+        if (m_sharedBudget) {
+            m_sharedBudget->release(allowance);
+            m_chargedBytes -= allowance;
+        }
+        return request == 0 && !m_input->eof();
     }
 
-    bool isBox(const std::string &boxId, BoxHeader &header) const {
-        if (m_inBuffer.size() < sizeof(BoxHeader)) {
+    // Decodes a 32-bit, 64-bit (size == 1) or open-ended (size == 0) box header in place
+    bool readBoxHeader(BoxHeader &header) const {
+        if (m_inBuffer.size() < 8) {
             return false;
         }
-        size_t bsizs = sizeof(BoxHeader);
-        std::vector<uint8_t> boxSyncWord(m_inBuffer.begin(), m_inBuffer.begin() + sizeof(BoxHeader));
-        ISOBMFF::BinaryStream bstream(boxSyncWord);
-        header.boxSize = bstream.ReadBigEndianUInt32();
-        std::copy_n(m_inBuffer.data() + sizeof(uint32_t), sizeof(header.boxId), header.boxId);
-        return std::string(header.boxId, sizeof(header.boxId)) == boxId;
+        const uint8_t *data = m_inBuffer.data();
+        header.boxSize = readBigEndian32(data);
+        header.type = readBigEndian32(data + 4);
+        header.headerSize = 8;
+        if (header.boxSize == 1) {
+            if (m_inBuffer.size() < 16) {
+                return false;
+            }
+            header.boxSize = readBigEndian64(data + 8);
+            header.headerSize = 16;
+        }
+        if (header.boxSize != 0 && header.boxSize < header.headerSize) {
+            throw std::runtime_error("Invalid box size for box " + ISOBMFF::Utils::FourCCToString(header.type));
+        }
+        return true;
+    }
+
+    // Boxes whose ReadData resets every field, so that reading into a used instance gives a fresh box: the
+    // top-level and moof boxes of a fragment, and unregistered boxes, read as raw data. Other box types, such as
+    // those of moov, are read once per stream and always created.
+    bool isRecyclable(uint32_t type) const {
+        static const uint32_t audited[] = {
+            FTYP_Type, SIDX_Type, MOOF_Type, MDAT_Type, FourCC("mfhd"), FourCC("traf"), FourCC("tfhd"),
+            FourCC("tfdt"), FourCC("trun"), FourCC("senc"), FourCC("saiz"), FourCC("saio"), FourCC("pssh")
+        };
+        return std::find(std::begin(audited), std::end(audited), type) != std::end(audited)
+            || m_registeredBoxes.find(type) == m_registeredBoxes.end();
+    }
+
+    std::shared_ptr<ISOBMFF::Box> createBox(uint32_t type) const {
+        if (!m_recycleBoxes || !isRecyclable(type)) {
+            return newBox(type);
+        }
+        auto pool = std::find_if(m_boxPool.begin(), m_boxPool.end(), [type](const PooledBoxes &pooled) {
+            return pooled.type == type;
+        });
+        if (pool == m_boxPool.end()) {
+            m_boxPool.push_back({type, {}});
+            pool = m_boxPool.end() - 1;
+        }
+        // Only the pool references a box once callers released it and its parent was read again
+        for (const auto &box : pool->boxes) {
+            if (box.use_count() == 1) {
+                return box;
+            }
+        }
+        pool->boxes.push_back(newBox(type));
+        return pool->boxes.back();
+    }
+
+    std::shared_ptr<ISOBMFF::Box> newBox(uint32_t type) const {
+        auto registeredBox = m_registeredBoxes.find(type);
+        if (registeredBox != m_registeredBoxes.end()) {
+            return registeredBox->second();
+        }
+        return std::make_shared<ISOBMFF::Box>( ISOBMFF::Utils::FourCCToString(type) );
     }
 
     template<class BoxType = ISOBMFF::ContainerBox>
-    void createBoxType(std::shared_ptr<BoxType> &instance, const std::string &name) {
+    void createBoxType(std::shared_ptr<BoxType> &instance, const std::string &/*name*/) {
         instance = std::make_shared<BoxType>();
     }
     template<class BoxType = ISOBMFF::ContainerBox>
@@ -277,7 +924,7 @@ private:
         if( type.size() != 4 ) {
             throw std::runtime_error( "Box name should be 4 characters long" );
         }
-        m_registeredBoxes.insert( std::make_pair(type, [this, type]() -> std::shared_ptr< ISOBMFF::Box > {
+        m_registeredBoxes.insert( std::make_pair(FourCC(type.c_str()), [this, type]() -> std::shared_ptr< ISOBMFF::Box > {
             std::shared_ptr<BoxType> inst;
             createBoxType(inst, type);
             return std::static_pointer_cast<ISOBMFF::Box>(inst);
@@ -305,6 +952,7 @@ private:
         registerBox<INFE>( "infe" );
         registerBox<IROT>( "irot" );
         registerBox<HVCC>( "hvcC" );
+        registerBox<AVCC>( "avcC" );
         registerBox<DIMG>( "dimg" );
         registerBox<THMB>( "thmb" );
         registerBox<CDSC>( "cdsc" );
@@ -314,11 +962,37 @@ private:
         registerBox<PIXI>( "pixi" );
         registerBox<IPCO>( "ipco" );
         registerBox<STSD>( "stsd" );
+        registerBox<VisualSampleEntry>( "avc1" );
+        registerBox<VisualSampleEntry>( "avc3" );
+        registerBox<VisualSampleEntry>( "hvc1" );
+        registerBox<VisualSampleEntry>( "hev1" );
+        registerBox<VisualSampleEntry>( "encv" );
+        registerBox<AudioSampleEntry>( "mp4a" );
+        registerBox<AudioSampleEntry>( "enca" );
+        registerBox<ESDS>( "esds" );
         registerBox<SIDX>( "sidx" );
         registerBox<FRMA>( "frma" );
         registerBox<SCHM>( "schm" );
         registerBox<TRUN>( "trun" );
         registerBox<TFHD>( "tfhd" );
+        registerBox<TFDT>( "tfdt" );
+        registerBox<TENC>( "tenc" );
+        registerBox<PSSH>( "pssh" );
+        registerBox<SENC>( "senc" );
+        registerBox<SAIZ>( "saiz" );
+        registerBox<SAIO>( "saio" );
+        registerBox<MDHD>( "mdhd" );
+        registerBox<STTS>( "stts" );
+        registerBox<CTTS>( "ctts" );
+        registerBox<STSS>( "stss" );
+        registerBox<STSZ>( "stsz" );
+        registerBox<STSZ>( "stz2" );
+        registerBox<STSC>( "stsc" );
+        registerBox<STCO>( "stco" );
+        registerBox<STCO>( "co64" );
+        registerBox<MEHD>( "mehd" );
+        registerBox<TREX>( "trex" );
+        registerBox<ELST>( "elst" );
 
         // Container boxes
         registerBox( "moov" );
@@ -347,6 +1021,8 @@ private:
     }
 };
 
+constexpr size_t FMP4StreamParser::Private::NoSlot;
+
 template<>
 void FMP4StreamParser::Private::createBoxType(std::shared_ptr<ISOBMFF::ContainerBox> &instance, const std::string &name) {
     instance = std::make_shared<ISOBMFF::ContainerBox>(name);
@@ -355,6 +1031,22 @@ template<>
 void FMP4StreamParser::Private::createBoxType(std::shared_ptr<ISOBMFF::Box> &instance, const std::string &name) {
     instance = std::make_shared<ISOBMFF::Box>(name);
 }
+template<>
+void FMP4StreamParser::Private::createBoxType(std::shared_ptr<ISOBMFF::VisualSampleEntry> &instance, const std::string &name) {
+    instance = std::make_shared<ISOBMFF::VisualSampleEntry>(name);
+}
+template<>
+void FMP4StreamParser::Private::createBoxType(std::shared_ptr<ISOBMFF::AudioSampleEntry> &instance, const std::string &name) {
+    instance = std::make_shared<ISOBMFF::AudioSampleEntry>(name);
+}
+template<>
+void FMP4StreamParser::Private::createBoxType(std::shared_ptr<ISOBMFF::STSZ> &instance, const std::string &name) {
+    instance = std::make_shared<ISOBMFF::STSZ>(name);
+}
+template<>
+void FMP4StreamParser::Private::createBoxType(std::shared_ptr<ISOBMFF::STCO> &instance, const std::string &name) {
+    instance = std::make_shared<ISOBMFF::STCO>(name);
+}
 
 
 FMP4StreamParser::FMP4StreamParser() {
@@ -367,10 +1059,18 @@ void FMP4StreamParser::setInputStream(std::istream *input) {
     m_impl->setInputStream(input);
 }
 
-void FMP4StreamParser::parse() {
+FMP4StreamParser::ParseStatus FMP4StreamParser::parse() {
     return m_impl->readAll();
 }
 
+FMP4StreamParser::ParseStatus FMP4StreamParser::parse(const uint8_t *data, size_t size) {
+    return m_impl->feed(data, size);
+}
+
+void FMP4StreamParser::setEndOfStream() {
+    m_impl->setEndOfStream();
+}
+
 bool FMP4StreamParser::isEOS() const {
     return m_impl->eos();
 }
@@ -387,4 +1087,50 @@ void FMP4StreamParser::onFragment(const FragmentCallback &fragmentCB) {
     m_impl->onFragment(fragmentCB);
 }
 
+void FMP4StreamParser::onMdatData(const MdatDataCallback &callback) {
+    m_impl->onMdatData(callback);
+}
+
+void FMP4StreamParser::setMdatPassThroughThreshold(uint64_t bytes) {
+    m_impl->setMdatPassThroughThreshold(bytes);
+}
+
+void FMP4StreamParser::setBufferLimit(size_t bytes) {
+    m_impl->setBufferLimit(bytes);
+}
+
+void FMP4StreamParser::setSharedBudget(const std::shared_ptr<FMP4BufferBudget> &budget) {
+    m_impl->setSharedBudget(budget);
+}
+
+FMP4StreamParser::Stats FMP4StreamParser::getStats() const {
+    return m_impl->getStats();
+}
+
+void FMP4StreamParser::setChunkedMode(bool enabled) {
+    m_impl->setChunkedMode(enabled);
+}
+
+void FMP4StreamParser::onSamples(const SamplesCallback &callback, size_t batchSize) {
+    m_impl->onSamples(callback, batchSize);
+}
+
+void FMP4StreamParser::setBoxAction(const std::string &type, BoxAction action) {
+    m_impl->setBoxAction(type, action);
+}
 
+void FMP4StreamParser::onPassThroughData(const PassThroughDataCallback &callback) {
+    m_impl->onPassThroughData(callback);
+}
+
+void FMP4StreamParser::on(uint32_t type, const BoxCallback &callback) {
+    m_impl->on(type, callback);
+}
+
+void FMP4StreamParser::onSkipped(uint32_t type, const SkippedBoxCallback &callback) {
+    m_impl->onSkipped(type, callback);
+}
+
+void FMP4StreamParser::setBoxRecycling(bool enabled) {
+    m_impl->setBoxRecycling(enabled);
+}
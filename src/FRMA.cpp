@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/FRMA.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/IParser.hpp>
 #include <ISOBMFF/Utils.hpp>
 
@@ -59,6 +60,11 @@ namespace ISOBMFF
         this->SetDataFormat( stream.ReadFourCC() );
     }
     
+    void FRMA::WriteData( BoxSink & sink ) const
+    {
+        sink.WriteFourCC( this->GetDataFormat() );
+    }
+    
     std::vector< std::pair< std::string, std::string > > FRMA::GetDisplayableProperties( void ) const
     {
         auto props( Box::GetDisplayableProperties() );
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/FTYP.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/IParser.hpp>
 #include <ISOBMFF/Utils.hpp>
 
@@ -59,6 +60,9 @@ namespace ISOBMFF
         this->SetMajorBrand( stream.ReadFourCC() );
         this->SetMinorVersion( stream.ReadBigEndianUInt32() );
         
+        /* Instances may be reused: brands of a previous read must not stay */
+        this->impl->_compatibleBrands.clear();
+        
         while( stream.HasBytesAvailable() )
         {
             this->AddCompatibleBrand( stream.ReadFourCC() );
@@ -74,6 +78,17 @@ namespace ISOBMFF
         }
     }
     
+    void FTYP::WriteData( BoxSink & sink ) const
+    {
+        sink.WriteFourCC( this->GetMajorBrand() );
+        sink.WriteBigEndianUInt32( this->GetMinorVersion() );
+        
+        for( const auto & brand: this->GetCompatibleBrands() )
+        {
+            sink.WriteFourCC( brand );
+        }
+    }
+    
     std::vector< std::pair< std::string, std::string > > FTYP::GetDisplayableProperties( void ) const
     {
         auto props( Box::GetDisplayableProperties() );
@@ -0,0 +1,320 @@
+#include "Faststart.h"
+#include "RangeCopier.h"
+#include "ISOBMFF/Parser.hpp"
+#include "ISOBMFF/File.hpp"
+#include "ISOBMFF/ContainerBox.hpp"
+#include "ISOBMFF/STCO.hpp"
+#include "ISOBMFF/SAIO.hpp"
+#include "ISOBMFF/META.hpp"
+#include "ISOBMFF/ILOC.hpp"
+#include "ISOBMFF/BoxSink.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+#include <vector>
+
+struct Faststart::Private {
+    // A top-level box of the source file
+    struct Span {
+        uint64_t start;
+        uint64_t length;
+        // Position in the output
+        uint64_t destination;
+    };
+
+    // A chunk offset table, with the offsets of the source file
+    struct Table {
+        std::shared_ptr<ISOBMFF::ContainerBox> stbl;
+        std::shared_ptr<ISOBMFF::STCO> stco;
+        std::vector<uint64_t> offsets;
+    };
+
+    // A stbl saio box, whose offsets locate the sample auxiliary information (CENC IVs) in the file
+    struct AuxTable {
+        std::shared_ptr<ISOBMFF::SAIO> saio;
+        std::vector<uint64_t> offsets;
+    };
+
+    std::string path;
+    std::vector<Span> spans;
+    size_t moovIndex{0};
+    // Boxes before this index stay before moov
+    size_t firstMdat{0};
+    std::shared_ptr<ISOBMFF::ContainerBox> moov;
+    std::vector<Table> tables;
+    std::vector<AuxTable> auxTables;
+    bool faststart{false};
+    uint32_t promoted{0};
+    uint64_t moovSize{0};
+    RangeCopier copier;
+
+    explicit Private(const std::string &path) : path(path) {
+        ISOBMFF::Parser parser;
+        // Boxes other than moov are copied from the file: large free or unknown boxes are not read either
+        parser.AddOption(ISOBMFF::Parser::Options::SkipMDATData);
+        parser.AddOption(ISOBMFF::Parser::Options::SkipLargeBoxData);
+        parser.Parse(path);
+
+        // Top-level boxes are contiguous: a box starts where the previous one ends
+        uint64_t start = 0;
+        firstMdat = std::numeric_limits<size_t>::max();
+        for (const auto &box : parser.GetFile()->GetBoxes()) {
+            const uint64_t end = box->GetDataOffset() + box->GetDataLength();
+            if (box->GetName() == "moov" && !moov) {
+                moov = std::static_pointer_cast<ISOBMFF::ContainerBox>(box);
+                moovIndex = spans.size();
+            } else if (box->GetName() == "mdat" && firstMdat == std::numeric_limits<size_t>::max()) {
+                firstMdat = spans.size();
+            }
+            spans.push_back({start, end - start, start});
+            start = end;
+        }
+        if (!moov) {
+            throw std::runtime_error("No moov box in " + path);
+        }
+        if (moov->GetBox("mvex") != nullptr) {
+            throw std::runtime_error("Fragmented files are not supported");
+        }
+        faststart = moovIndex < firstMdat;
+        if (faststart) {
+            moovSize = spans[moovIndex].length;
+            return;
+        }
+
+        // Also catches large unknown boxes in moov, whose data was not read
+        if (!writesBack(spans[moovIndex])) {
+            throw std::runtime_error("moov box cannot be written back unchanged");
+        }
+        // Item extents are not patched: the meta boxes outside moov are copied unchanged
+        for (const auto &box : parser.GetFile()->GetBoxes()) {
+            if (box->GetName() == "meta") {
+                checkItems(*box);
+            }
+        }
+        checkItems(*moov);
+
+        for (const auto &trakBox : moov->Container::GetBoxes("trak")) {
+            auto trak = std::static_pointer_cast<ISOBMFF::ContainerBox>(trakBox);
+            auto mdia = trak->GetTypedBox<ISOBMFF::ContainerBox>("mdia");
+            auto minf = mdia != nullptr ? mdia->GetTypedBox<ISOBMFF::ContainerBox>("minf") : nullptr;
+            auto stbl = minf != nullptr ? minf->GetTypedBox<ISOBMFF::ContainerBox>("stbl") : nullptr;
+            std::shared_ptr<ISOBMFF::STCO> stco;
+            if (stbl != nullptr) {
+                stco = stbl->GetTypedBox<ISOBMFF::STCO>(stbl->GetBox("co64") != nullptr ? "co64" : "stco");
+            }
+            if (stco == nullptr) {
+                throw std::runtime_error("trak box has no stco or co64 box");
+            }
+            tables.push_back({stbl, stco, stco->GetChunkOffsets()});
+            for (const auto &saioBox : stbl->Container::GetBoxes("saio")) {
+                auto saio = std::static_pointer_cast<ISOBMFF::SAIO>(saioBox);
+                auxTables.push_back({saio, saio->GetOffsets()});
+            }
+        }
+        plan();
+    }
+
+    // Throws if a meta box in box, or box itself, has items stored at file offsets, which would move
+    static void checkItems(const ISOBMFF::Box &box) {
+        auto meta = dynamic_cast<const ISOBMFF::META *>(&box);
+        if (meta != nullptr) {
+            auto iloc = meta->GetTypedBox<ISOBMFF::ILOC>("iloc");
+            if (iloc != nullptr) {
+                for (const auto &item : iloc->GetItems()) {
+                    if (item->GetConstructionMethod() == 0 && item->GetDataReferenceIndex() == 0
+                        && !item->GetExtents().empty()) {
+                        throw std::runtime_error("Items stored at file offsets are not supported (item " +
+                                                 std::to_string(item->GetItemID()) + ")");
+                    }
+                }
+            }
+            return;
+        }
+        auto container = dynamic_cast<const ISOBMFF::Container *>(&box);
+        if (container != nullptr) {
+            for (const auto &child : container->GetBoxes()) {
+                checkItems(*child);
+            }
+        }
+    }
+
+    // Whether moov, written as parsed, matches its bytes in the source file
+    bool writesBack(const Span &span) const {
+        ISOBMFF::BoxSink sink;
+        moov->Write(sink);
+        if (sink.GetSize() != span.length) {
+            return false;
+        }
+        int in = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) {
+            throw std::runtime_error("Cannot open " + path + ": " + strerror(errno));
+        }
+        std::vector<uint8_t> source;
+        uint64_t offset = span.start;
+        bool same = true;
+        for (const auto &segment : sink.GetSegments()) {
+            source.resize(static_cast<size_t>(segment.second));
+            size_t done = 0;
+            while (done < source.size()) {
+                ssize_t n = pread(in, source.data() + done, source.size() - done, static_cast<off_t>(offset + done));
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    const int error = n < 0 ? errno : EIO;
+                    close(in);
+                    throw std::runtime_error("Cannot read " + path + ": " + strerror(error));
+                }
+                done += static_cast<size_t>(n);
+            }
+            if (!source.empty() && std::memcmp(source.data(), segment.first, source.size()) != 0) {
+                same = false;
+                break;
+            }
+            offset += segment.second;
+        }
+        close(in);
+        return same;
+    }
+
+    // Places the boxes for the current moov size, and patches the chunk offsets. Returns false when an stco
+    // table had to be promoted to co64, which changes the moov size.
+    bool place() {
+        ISOBMFF::BoxSink sink;
+        moov->Write(sink);
+        moovSize = sink.GetSize();
+
+        uint64_t position = 0;
+        for (size_t i = 0; i < firstMdat; i++) {
+            if (i != moovIndex) {
+                spans[i].destination = position;
+                position += spans[i].length;
+            }
+        }
+        position += moovSize;
+        for (size_t i = firstMdat; i < spans.size(); i++) {
+            if (i != moovIndex) {
+                spans[i].destination = position;
+                position += spans[i].length;
+            }
+        }
+
+        bool stable = true;
+        for (auto &table : tables) {
+            table.stco->ClearChunkOffsets();
+            for (uint64_t offset : table.offsets) {
+                table.stco->AddChunkOffset(destination(offset, "Chunk offset"));
+            }
+            if (table.stco->GetName() == "stco" && table.stco->NeedsLargeOffsets()) {
+                // Filled, so that the next pass measures its final size
+                auto co64 = std::make_shared<ISOBMFF::STCO>("co64");
+                for (uint64_t offset : table.stco->GetChunkOffsets()) {
+                    co64->AddChunkOffset(offset);
+                }
+                table.stbl->ReplaceBox(table.stco, co64);
+                table.stco = co64;
+                promoted++;
+                stable = false;
+            }
+        }
+        for (auto &table : auxTables) {
+            std::vector<uint64_t> offsets;
+            offsets.reserve(table.offsets.size());
+            for (uint64_t offset : table.offsets) {
+                offsets.push_back(destination(offset, "saio offset"));
+            }
+            table.saio->SetOffsets(offsets);
+            if (table.saio->GetVersion() == 0 && table.saio->NeedsLargeOffsets()) {
+                table.saio->SetVersion(1);
+                stable = false;
+            }
+        }
+        return stable;
+    }
+
+    void plan() {
+        // Promotions only make moov larger: this ends once every table that needs it is a co64 table
+        while (!place()) {
+        }
+    }
+
+    // Position in the output of a byte of the source file, outside of moov
+    uint64_t destination(uint64_t offset, const char *what) const {
+        auto span = std::upper_bound(spans.begin(), spans.end(), offset,
+                                     [](uint64_t value, const Span &s) { return value < s.start; });
+        if (span == spans.begin() || static_cast<size_t>(span - spans.begin()) - 1 == moovIndex
+            || offset >= (span - 1)->start + (span - 1)->length) {
+            throw std::runtime_error(std::string(what) + " " + std::to_string(offset) + " is outside of the media data");
+        }
+        --span;
+        return span->destination + (offset - span->start);
+    }
+
+    void write(int out) {
+        int in = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) {
+            throw std::runtime_error("Cannot open " + path + ": " + strerror(errno));
+        }
+        try {
+            if (faststart) {
+                copier.copy(in, 0, spans.back().start + spans.back().length, out);
+            } else {
+                // Adjacent boxes are copied together
+                for (size_t i = 0; i < firstMdat; i++) {
+                    if (i != moovIndex) {
+                        copier.add(in, spans[i].start, spans[i].length, out);
+                    }
+                }
+                copier.flush();
+
+                ISOBMFF::BoxSink sink;
+                moov->Write(sink);
+                sink.WriteTo(out);
+
+                for (size_t i = firstMdat; i < spans.size(); i++) {
+                    if (i != moovIndex) {
+                        copier.add(in, spans[i].start, spans[i].length, out);
+                    }
+                }
+                copier.flush();
+            }
+        } catch (...) {
+            close(in);
+            throw;
+        }
+        close(in);
+    }
+};
+
+Faststart::Faststart(const std::string &path) : m_impl(new Private(path)) {
+}
+
+Faststart::~Faststart() = default;
+
+void Faststart::write(int fd) {
+    m_impl->write(fd);
+}
+
+bool Faststart::isFaststart() const {
+    return m_impl->faststart;
+}
+
+uint32_t Faststart::promotedTables() const {
+    return m_impl->promoted;
+}
+
+uint64_t Faststart::moovSize() const {
+    return m_impl->moovSize;
+}
+
+uint64_t Faststart::bytesCopied() const {
+    return m_impl->copier.bytesCopied();
+}
+
+uint64_t Faststart::copyCalls() const {
+    return m_impl->copier.copyCalls();
+}
@@ -52,6 +52,11 @@ namespace ISOBMFF
     {
         return "ISOBMFF::File";
     }
+    
+    void File::Write( BoxSink & sink ) const
+    {
+        Container::WriteBoxes( sink );
+    }
 }
 
 XS::PIMPL::Object< ISOBMFF::File >::IMPL::IMPL( void )
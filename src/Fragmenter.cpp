@@ -0,0 +1,459 @@
+#include "Fragmenter.h"
+#include "RangeCopier.h"
+#include "ISOBMFF/Parser.hpp"
+#include "ISOBMFF/File.hpp"
+#include "ISOBMFF/Boxes.h"
+#include "ISOBMFF/BoxSink.hpp"
+#include "ISOBMFF/SampleTable.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    // trun sample flags: depends on others and non-sync, or depends on no other sample
+    constexpr uint32_t NonSyncSampleFlags = 0x01010000;
+    constexpr uint32_t SyncSampleFlags = 0x02000000;
+    constexpr uint32_t DefaultBaseIsMoof = 0x020000;
+
+    // value * to / from, without overflowing for large values
+    uint64_t rescale(uint64_t value, uint32_t from, uint32_t to) {
+        if (from == to || from == 0) {
+            return value;
+        }
+        return value / from * to + value % from * to / from;
+    }
+}
+
+struct Fragmenter::Private {
+    struct Track {
+        std::shared_ptr<ISOBMFF::ContainerBox> trak;
+        ISOBMFF::SampleTable table;
+    };
+
+    struct Fragment {
+        // Samples [first, second) of each track
+        std::vector<std::pair<size_t, size_t>> samples;
+        uint64_t size{0};
+        uint64_t duration{0};
+    };
+
+    Options options;
+    int fd{-1};
+    ISOBMFF::Parser parser;
+    std::shared_ptr<ISOBMFF::ContainerBox> moov;
+    std::vector<Track> tracks;
+    size_t reference{0};
+    uint64_t movieDuration{0};
+    std::vector<Fragment> fragments;
+
+    RangeCopier copier;
+
+    Private(const std::string &path, const Options &options) : options(options) {
+        parser.AddOption(ISOBMFF::Parser::Options::SkipMDATData);
+        parser.Parse(path);
+
+        moov = parser.GetFile()->GetTypedBox<ISOBMFF::ContainerBox>("moov");
+        if (!moov) {
+            throw std::runtime_error("No moov box in " + path);
+        }
+        if (moov->GetBox("mvex")) {
+            throw std::runtime_error(path + " is already fragmented");
+        }
+        auto mvhd = moov->GetTypedBox<ISOBMFF::MVHD>("mvhd");
+        if (!mvhd) {
+            throw std::runtime_error("No mvhd box in " + path);
+        }
+        movieDuration = mvhd->GetDuration();
+
+        for (const auto &box : moov->Container::GetBoxes("trak")) {
+            auto trak = std::static_pointer_cast<ISOBMFF::ContainerBox>(box);
+            ISOBMFF::SampleTable table(*trak);
+            if (options.trackID == 0 || table.GetTrackID() == options.trackID) {
+                checkTrack(*trak, table);
+                tracks.push_back({trak, std::move(table)});
+            }
+        }
+        if (tracks.empty()) {
+            throw std::runtime_error(options.trackID == 0 ? "No track in " + path
+                                                          : "No track " + std::to_string(options.trackID) + " in " + path);
+        }
+        for (size_t i = 0; i < tracks.size(); i++) {
+            if (tracks[i].table.HasSyncSamples()) {
+                reference = i;
+                break;
+            }
+        }
+
+        plan();
+
+        fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path + ": " + strerror(errno));
+        }
+    }
+
+    // The fragments only carry sample timing, sizes and sync flags: protected tracks, whose senc, saiz and saio
+    // boxes would have to be rebuilt per traf, and sample groups are refused rather than dropped
+    static void checkTrack(const ISOBMFF::ContainerBox &trak, const ISOBMFF::SampleTable &table) {
+        const std::string track = "Track " + std::to_string(table.GetTrackID());
+        auto stsd = table.GetSampleDescriptions();
+        if (stsd) {
+            for (const auto &entry : stsd->GetBoxes()) {
+                auto container = std::dynamic_pointer_cast<ISOBMFF::Container>(entry);
+                if (entry->GetName().compare(0, 3, "enc") == 0 || (container && container->GetBox("sinf"))) {
+                    throw std::runtime_error(track + " is encrypted: protected tracks are not supported");
+                }
+            }
+        }
+        auto mdia = trak.GetTypedBox<ISOBMFF::ContainerBox>("mdia");
+        auto minf = mdia ? mdia->GetTypedBox<ISOBMFF::ContainerBox>("minf") : nullptr;
+        auto stbl = minf ? minf->GetTypedBox<ISOBMFF::ContainerBox>("stbl") : nullptr;
+        if (stbl) {
+            for (const char *name : {"senc", "saiz", "saio"}) {
+                if (stbl->GetBox(name)) {
+                    throw std::runtime_error(track + " has sample auxiliary information: protected tracks are not supported");
+                }
+            }
+            for (const char *name : {"sbgp", "sgpd"}) {
+                if (stbl->GetBox(name)) {
+                    throw std::runtime_error(track + " has sample groups, which are not supported");
+                }
+            }
+        }
+    }
+
+    ~Private() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    // Cuts the reference track at sync samples, then the other tracks at the same decoding times
+    void plan() {
+        const auto &table = tracks[reference].table;
+        const auto &samples = table.GetSamples();
+        const uint64_t target = static_cast<uint64_t>(options.fragmentDuration * table.GetTimescale());
+
+        std::vector<size_t> starts;
+        for (size_t i = 0; i < samples.size(); i++) {
+            if (starts.empty() || (samples[i].sync && samples[i].decodeTime - samples[starts.back()].decodeTime >= target)) {
+                starts.push_back(i);
+            }
+        }
+
+        std::vector<size_t> cursors(tracks.size(), 0);
+        for (size_t k = 0; k < starts.size(); k++) {
+            const bool last = k + 1 == starts.size();
+            const uint64_t end = last ? 0 : samples[starts[k + 1]].decodeTime;
+
+            Fragment fragment;
+            for (size_t t = 0; t < tracks.size(); t++) {
+                const auto &trackSamples = tracks[t].table.GetSamples();
+                const uint32_t timescale = tracks[t].table.GetTimescale();
+                size_t cursor = cursors[t];
+                if (last) {
+                    cursor = trackSamples.size();
+                } else if (t == reference) {
+                    cursor = starts[k + 1];
+                } else {
+                    while (cursor < trackSamples.size() &&
+                           rescale(trackSamples[cursor].decodeTime, timescale, table.GetTimescale()) < end) {
+                        cursor++;
+                    }
+                }
+                fragment.samples.emplace_back(cursors[t], cursor);
+                cursors[t] = cursor;
+            }
+            for (size_t i = fragment.samples[reference].first; i < fragment.samples[reference].second; i++) {
+                fragment.duration += samples[i].duration;
+            }
+            fragments.push_back(std::move(fragment));
+        }
+
+        for (size_t k = 0; k < fragments.size(); k++) {
+            ISOBMFF::BoxSink sink;
+            uint64_t payload = 0;
+            buildMoof(k, payload)->Write(sink);
+            fragments[k].size = sink.GetSize() + mdatHeaderSize(payload) + payload;
+        }
+    }
+
+    static uint64_t mdatHeaderSize(uint64_t payload) {
+        return payload + 8 > std::numeric_limits<uint32_t>::max() ? 16 : 8;
+    }
+
+    // moof of a fragment, with data offsets relative to the moof (default-base-is-moof)
+    std::shared_ptr<ISOBMFF::ContainerBox> buildMoof(size_t k, uint64_t &payload) const {
+        const Fragment &fragment = fragments[k];
+        auto moof = std::make_shared<ISOBMFF::ContainerBox>("moof");
+        std::vector<std::pair<std::shared_ptr<ISOBMFF::TRUN>, uint64_t>> runs;
+
+        auto mfhd = std::make_shared<ISOBMFF::MFHD>();
+        mfhd->SetSequenceNumber(static_cast<uint32_t>(k + 1));
+        moof->AddBox(mfhd);
+
+        payload = 0;
+        for (size_t t = 0; t < tracks.size(); t++) {
+            const auto &table = tracks[t].table;
+            const auto &samples = table.GetSamples();
+            const size_t first = fragment.samples[t].first;
+            const size_t end = fragment.samples[t].second;
+            if (first == end) {
+                continue;
+            }
+
+            auto traf = std::make_shared<ISOBMFF::ContainerBox>("traf");
+            auto tfhd = std::make_shared<ISOBMFF::TFHD>();
+            tfhd->SetFlags(DefaultBaseIsMoof);
+            tfhd->SetTrackID(table.GetTrackID());
+            if (samples[first].descriptionIndex != 1) {
+                tfhd->SetFlags(tfhd->GetFlags() | 0x2);
+                tfhd->SetSampleDescriptionIndex(samples[first].descriptionIndex);
+            }
+            traf->AddBox(tfhd);
+
+            auto tfdt = std::make_shared<ISOBMFF::TFDT>();
+            tfdt->SetVersion(1);
+            tfdt->SetBaseMediaDecodeTime(samples[first].decodeTime);
+            traf->AddBox(tfdt);
+
+            auto trun = std::make_shared<ISOBMFF::TRUN>();
+            uint32_t flags = 0x1 | 0x100 | 0x200;
+            if (table.HasSyncSamples()) {
+                flags |= 0x400;
+            }
+            if (table.HasCompositionOffsets()) {
+                flags |= 0x800;
+            }
+            for (size_t i = first; i < end; i++) {
+                const auto &sample = samples[i];
+                if (sample.descriptionIndex != samples[first].descriptionIndex) {
+                    throw std::runtime_error("Track " + std::to_string(table.GetTrackID()) +
+                                             " changes sample description within a fragment");
+                }
+                ISOBMFF::TRUN::SampleEntry entry;
+                entry.sample_duration = sample.duration;
+                entry.sample_size = sample.size;
+                entry.sample_flags = sample.sync ? SyncSampleFlags : NonSyncSampleFlags;
+                entry.sample_composition_time_offset = static_cast<uint32_t>(sample.compositionOffset);
+                if (sample.compositionOffset < 0) {
+                    trun->SetVersion(1);
+                }
+                trun->AddSampleEntry(entry);
+            }
+            trun->SetFlags(flags);
+            trun->SetSampleCount(static_cast<uint32_t>(end - first));
+            traf->AddBox(trun);
+            moof->AddBox(traf);
+
+            runs.emplace_back(trun, payload);
+            for (size_t i = first; i < end; i++) {
+                payload += samples[i].size;
+            }
+        }
+
+        // Offsets do not change the moof size: measure it once they are all present
+        ISOBMFF::BoxSink sink;
+        moof->Write(sink);
+        const uint64_t base = sink.GetSize() + mdatHeaderSize(payload);
+        for (const auto &run : runs) {
+            if (base + run.second > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+                throw std::runtime_error("Fragment " + std::to_string(k + 1) + " is too large for trun data offsets");
+            }
+            run.first->SetDataOffset(static_cast<uint32_t>(base + run.second));
+        }
+        return moof;
+    }
+
+    // trak with empty sample tables and zero durations, the samples being in the fragments
+    std::shared_ptr<ISOBMFF::ContainerBox> buildTrak(const Track &track) const {
+        auto trak = std::make_shared<ISOBMFF::ContainerBox>("trak");
+        for (const auto &box : track.trak->GetBoxes()) {
+            if (box->GetName() == "tkhd") {
+                auto tkhd = std::make_shared<ISOBMFF::TKHD>(*std::static_pointer_cast<ISOBMFF::TKHD>(box));
+                tkhd->SetDuration(0);
+                trak->AddBox(tkhd);
+            } else if (box->GetName() == "mdia") {
+                trak->AddBox(buildMdia(*std::static_pointer_cast<ISOBMFF::ContainerBox>(box), track));
+            } else {
+                trak->AddBox(box);
+            }
+        }
+        return trak;
+    }
+
+    std::shared_ptr<ISOBMFF::ContainerBox> buildMdia(const ISOBMFF::ContainerBox &source, const Track &track) const {
+        auto mdia = std::make_shared<ISOBMFF::ContainerBox>("mdia");
+        for (const auto &box : source.GetBoxes()) {
+            if (box->GetName() == "mdhd") {
+                auto mdhd = std::make_shared<ISOBMFF::MDHD>(*std::static_pointer_cast<ISOBMFF::MDHD>(box));
+                mdhd->SetDuration(0);
+                mdia->AddBox(mdhd);
+            } else if (box->GetName() == "minf") {
+                auto minf = std::make_shared<ISOBMFF::ContainerBox>("minf");
+                for (const auto &child : std::static_pointer_cast<ISOBMFF::ContainerBox>(box)->GetBoxes()) {
+                    minf->AddBox(child->GetName() == "stbl" ? buildStbl(track) : child);
+                }
+                mdia->AddBox(minf);
+            } else {
+                mdia->AddBox(box);
+            }
+        }
+        return mdia;
+    }
+
+    static std::shared_ptr<ISOBMFF::ContainerBox> buildStbl(const Track &track) {
+        auto stbl = std::make_shared<ISOBMFF::ContainerBox>("stbl");
+        auto stsd = track.table.GetSampleDescriptions();
+        if (!stsd) {
+            throw std::runtime_error("Track " + std::to_string(track.table.GetTrackID()) + " has no stsd box");
+        }
+        stbl->AddBox(stsd);
+        stbl->AddBox(std::make_shared<ISOBMFF::STTS>());
+        stbl->AddBox(std::make_shared<ISOBMFF::STSC>());
+        stbl->AddBox(std::make_shared<ISOBMFF::STSZ>());
+        stbl->AddBox(std::make_shared<ISOBMFF::STCO>());
+        return stbl;
+    }
+
+    void writeInitSegment(int out) const {
+        ISOBMFF::BoxSink sink;
+
+        ISOBMFF::FTYP ftyp;
+        ftyp.SetMajorBrand("iso6");
+        ftyp.SetMinorVersion(0);
+        ftyp.SetCompatibleBrands({"iso6", "mp41", "dash"});
+        ftyp.Write(sink);
+
+        ISOBMFF::ContainerBox init("moov");
+        bool tracksAdded = false;
+        for (const auto &box : moov->GetBoxes()) {
+            if (box->GetName() == "mvhd") {
+                auto mvhd = std::make_shared<ISOBMFF::MVHD>(*std::static_pointer_cast<ISOBMFF::MVHD>(box));
+                mvhd->SetDuration(0);
+                init.AddBox(mvhd);
+            } else if (box->GetName() == "trak") {
+                // Selected tracks, in their original order, where the first trak was
+                if (!tracksAdded) {
+                    for (const auto &track : tracks) {
+                        init.AddBox(buildTrak(track));
+                    }
+                    tracksAdded = true;
+                }
+            } else {
+                init.AddBox(box);
+            }
+        }
+
+        auto mvex = std::make_shared<ISOBMFF::ContainerBox>("mvex");
+        auto mehd = std::make_shared<ISOBMFF::MEHD>();
+        mehd->SetFragmentDuration(movieDuration);
+        mvex->AddBox(mehd);
+        for (const auto &track : tracks) {
+            auto trex = std::make_shared<ISOBMFF::TREX>();
+            trex->SetTrackID(track.table.GetTrackID());
+            mvex->AddBox(trex);
+        }
+        init.AddBox(mvex);
+        init.Write(sink);
+
+        sink.WriteTo(out);
+    }
+
+    void writeSidx(int out) const {
+        const auto &table = tracks[reference].table;
+        const auto &first = table.GetSamples().front();
+
+        ISOBMFF::SIDX sidx;
+        sidx.SetVersion(1);
+        sidx.SetReferenceID(table.GetTrackID());
+        sidx.SetTimescale(table.GetTimescale());
+        sidx.SetEarliestPTS(first.compositionOffset < 0 && static_cast<uint64_t>(-first.compositionOffset) > first.decodeTime
+                                ? 0 : first.decodeTime + first.compositionOffset);
+        sidx.SetFirstOffset(0);
+        for (const auto &fragment : fragments) {
+            if (fragment.size >= (1u << 31) || fragment.duration > std::numeric_limits<uint32_t>::max()) {
+                throw std::runtime_error("Fragment too large for sidx");
+            }
+            ISOBMFF::SIDX::ReferenceEntry entry{};
+            entry.reference_type = 0;
+            entry.reference_size = static_cast<uint32_t>(fragment.size);
+            entry.subsegment_duration = static_cast<uint32_t>(fragment.duration);
+            entry.starts_with_SAP = 1;
+            entry.SAP_type = 1;
+            entry.SAP_delta_time = 0;
+            sidx.AddReferenceEntry(entry);
+        }
+
+        ISOBMFF::BoxSink sink;
+        sidx.Write(sink);
+        sink.WriteTo(out);
+    }
+
+    void writeFragment(size_t k, int out) {
+        ISOBMFF::BoxSink sink;
+        uint64_t payload = 0;
+        buildMoof(k, payload)->Write(sink);
+
+        if (mdatHeaderSize(payload) == 16) {
+            sink.WriteBigEndianUInt32(1);
+            sink.WriteFourCC("mdat");
+            sink.WriteBigEndianUInt64(payload + 16);
+        } else {
+            sink.WriteBigEndianUInt32(static_cast<uint32_t>(payload + 8));
+            sink.WriteFourCC("mdat");
+        }
+        sink.WriteTo(out);
+
+        // Payloads in trun order, adjacent samples copied together
+        for (size_t t = 0; t < tracks.size(); t++) {
+            const auto &samples = tracks[t].table.GetSamples();
+            for (size_t i = fragments[k].samples[t].first; i < fragments[k].samples[t].second; i++) {
+                copier.add(fd, samples[i].offset, samples[i].size, out);
+            }
+        }
+        copier.flush();
+    }
+};
+
+Fragmenter::Fragmenter(const std::string &path) : Fragmenter(path, Options()) {
+}
+
+Fragmenter::Fragmenter(const std::string &path, const Options &options) : m_impl(new Private(path, options)) {
+}
+
+Fragmenter::~Fragmenter() = default;
+
+void Fragmenter::write(int fd) {
+    writeInitSegment(fd);
+    writeMediaSegments(fd);
+}
+
+void Fragmenter::writeInitSegment(int fd) {
+    m_impl->writeInitSegment(fd);
+}
+
+void Fragmenter::writeMediaSegments(int fd) {
+    if (m_impl->options.sidx && !m_impl->fragments.empty()) {
+        m_impl->writeSidx(fd);
+    }
+    for (size_t k = 0; k < m_impl->fragments.size(); k++) {
+        m_impl->writeFragment(k, fd);
+    }
+}
+
+uint32_t Fragmenter::fragmentCount() const {
+    return static_cast<uint32_t>(m_impl->fragments.size());
+}
+
+uint64_t Fragmenter::bytesCopied() const {
+    return m_impl->copier.bytesCopied();
+}
+
+uint64_t Fragmenter::copyCalls() const {
+    return m_impl->copier.copyCalls();
+}
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/FullBox.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/Utils.hpp>
 #include <ISOBMFF/IParser.hpp>
 
@@ -65,6 +66,11 @@ namespace ISOBMFF
         this->SetFlags( vf & 0x00FFFFFF );
     }
     
+    void FullBox::WriteData( BoxSink & sink ) const
+    {
+        sink.WriteBigEndianUInt32( ( static_cast< uint32_t >( this->GetVersion() ) << 24 ) | ( this->GetFlags() & 0x00FFFFFF ) );
+    }
+    
     std::vector< std::pair< std::string, std::string > > FullBox::GetDisplayableProperties( void ) const
     {
         auto props( Box::GetDisplayableProperties() );
@@ -0,0 +1,515 @@
+/*!
+ * @file        GridPlan.cpp
+ */
+
+#include <ISOBMFF/GridPlan.hpp>
+#include <ISOBMFF/Parser.hpp>
+#include <ISOBMFF/File.hpp>
+#include <ISOBMFF/META.hpp>
+#include <ISOBMFF/INFE.hpp>
+#include <ISOBMFF/ISPE.hpp>
+#include <ISOBMFF/HVCC.hpp>
+#include <ISOBMFF/ImageGrid.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <NalConverter.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::GridPlan >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        void   Plan( const ISOBMFF::Parser & parser, const ISOBMFF::ItemIndex & index, uint32_t itemID );
+        void   Open( std::ifstream & in ) const;
+        size_t AssembleTile( std::ifstream & in, std::unique_ptr< NalConverter > & converter, size_t index, uint8_t * buffer, size_t size ) const;
+        
+        uint32_t                                                       _itemID;
+        uint32_t                                                       _rows;
+        uint32_t                                                       _columns;
+        uint64_t                                                       _outputWidth;
+        uint64_t                                                       _outputHeight;
+        std::vector< ISOBMFF::GridPlan::Tile >                         _tiles;
+        std::string                                                    _path;
+        
+        /* Annex-B parameter sets of each tile, shared with its hvcC */
+        std::vector< std::shared_ptr< const std::vector< uint8_t > > > _headers;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::GridPlan
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace
+{
+    /*
+     * Worker threads shared by all plans. They are started on first use,
+     * as many as the largest request so far, and kept until exit, so that
+     * assembling grid after grid does not start threads each time.
+     */
+    class TilePool
+    {
+        public:
+            
+            static TilePool & Shared( void )
+            {
+                static TilePool pool;
+                
+                return pool;
+            }
+            
+            ~TilePool( void )
+            {
+                {
+                    std::lock_guard< std::mutex > lock( this->_mutex );
+                    
+                    this->_stop = true;
+                }
+                
+                this->_wake.notify_all();
+                
+                for( auto & thread: this->_threads )
+                {
+                    thread.join();
+                }
+            }
+            
+            /* Queues count runs of the task, for count different workers at most */
+            void Post( const std::function< void( void ) > & task, size_t count )
+            {
+                {
+                    std::lock_guard< std::mutex > lock( this->_mutex );
+                    
+                    while( this->_threads.size() < count )
+                    {
+                        this->_threads.emplace_back( [ this ]( void ) { this->Run(); } );
+                    }
+                    
+                    this->_tasks.insert( this->_tasks.end(), count, task );
+                }
+                
+                this->_wake.notify_all();
+            }
+            
+        private:
+            
+            TilePool( void ): _stop( false )
+            {}
+            
+            void Run( void )
+            {
+                for( ;; )
+                {
+                    std::function< void( void ) > task;
+                    
+                    {
+                        std::unique_lock< std::mutex > lock( this->_mutex );
+                        
+                        this->_wake.wait( lock, [ this ]( void ) { return this->_stop || this->_tasks.empty() == false; } );
+                        
+                        if( this->_tasks.empty() )
+                        {
+                            return;
+                        }
+                        
+                        task = std::move( this->_tasks.front() );
+                        
+                        this->_tasks.pop_front();
+                    }
+                    
+                    task();
+                }
+            }
+            
+            std::mutex                                  _mutex;
+            std::condition_variable                     _wake;
+            std::deque< std::function< void( void ) > > _tasks;
+            std::vector< std::thread >                  _threads;
+            bool                                        _stop;
+    };
+}
+
+namespace ISOBMFF
+{
+    static std::shared_ptr< META > GetMeta( const Parser & parser )
+    {
+        std::shared_ptr< META > meta;
+        
+        if( parser.GetFile() != nullptr )
+        {
+            meta = parser.GetFile()->GetTypedBox< META >( "meta" );
+        }
+        
+        if( meta == nullptr )
+        {
+            throw std::runtime_error( "No meta box in file: " + parser.GetPath() );
+        }
+        
+        return meta;
+    }
+    
+    GridPlan::GridPlan( const Parser & parser ) ISOBMFF_NOEXCEPT( false )
+    {
+        ItemIndex    index( *( GetMeta( parser ) ) );
+        const auto * primary = index.GetPrimaryItem();
+        
+        if( primary == nullptr )
+        {
+            throw std::runtime_error( "No primary item in file: " + parser.GetPath() );
+        }
+        
+        this->impl->Plan( parser, index, primary->itemID );
+    }
+    
+    GridPlan::GridPlan( const Parser & parser, uint32_t itemID ) ISOBMFF_NOEXCEPT( false )
+    {
+        ItemIndex index( *( GetMeta( parser ) ) );
+        
+        this->impl->Plan( parser, index, itemID );
+    }
+    
+    uint32_t GridPlan::GetItemID( void ) const
+    {
+        return this->impl->_itemID;
+    }
+    
+    uint32_t GridPlan::GetRows( void ) const
+    {
+        return this->impl->_rows;
+    }
+    
+    uint32_t GridPlan::GetColumns( void ) const
+    {
+        return this->impl->_columns;
+    }
+    
+    uint64_t GridPlan::GetOutputWidth( void ) const
+    {
+        return this->impl->_outputWidth;
+    }
+    
+    uint64_t GridPlan::GetOutputHeight( void ) const
+    {
+        return this->impl->_outputHeight;
+    }
+    
+    const std::vector< GridPlan::Tile > & GridPlan::GetTiles( void ) const
+    {
+        return this->impl->_tiles;
+    }
+    
+    size_t GridPlan::AssembleTile( size_t index, uint8_t * buffer, size_t size ) const ISOBMFF_NOEXCEPT( false )
+    {
+        std::ifstream                   in;
+        std::unique_ptr< NalConverter > converter;
+        
+        this->impl->Open( in );
+        
+        return this->impl->AssembleTile( in, converter, index, buffer, size );
+    }
+    
+    std::vector< size_t > GridPlan::Assemble( const std::vector< uint8_t * > & buffers, unsigned int threadCount ) const ISOBMFF_NOEXCEPT( false )
+    {
+        /* Tracks the pool runs of the work, which may start after it is done */
+        struct Batch
+        {
+            std::mutex              mutex;
+            std::condition_variable done;
+            size_t                  running = 0;
+            bool                    closed  = false;
+        };
+        
+        std::vector< size_t >      sizes;
+        std::shared_ptr< Batch >   batch;
+        std::atomic< size_t >      next( 0 );
+        std::atomic< bool >        failed( false );
+        std::exception_ptr         error;
+        std::mutex                 errorMutex;
+        
+        if( buffers.size() != this->impl->_tiles.size() )
+        {
+            throw std::runtime_error( "Grid plan needs one buffer per tile" );
+        }
+        
+        sizes.resize( buffers.size() );
+        
+        threadCount = std::max( 1u, std::min( threadCount, static_cast< unsigned int >( buffers.size() ) ) );
+        
+        auto work = [ & ]( void )
+        {
+            try
+            {
+                std::ifstream                   in;
+                std::unique_ptr< NalConverter > converter;
+                
+                this->impl->Open( in );
+                
+                for( size_t i = next++; i < buffers.size() && failed == false; i = next++ )
+                {
+                    sizes[ i ] = this->impl->AssembleTile( in, converter, i, buffers[ i ], this->impl->_tiles[ i ].bufferSize );
+                }
+            }
+            catch( ... )
+            {
+                std::lock_guard< std::mutex > lock( errorMutex );
+                
+                if( error == nullptr )
+                {
+                    error = std::current_exception();
+                }
+                
+                failed = true;
+            }
+        };
+        
+        batch = std::make_shared< Batch >();
+        
+        if( threadCount > 1 )
+        {
+            /* Runs that start once the batch is closed return without touching the work */
+            TilePool::Shared().Post
+            (
+                [ batch, &work ]( void )
+                {
+                    {
+                        std::lock_guard< std::mutex > lock( batch->mutex );
+                        
+                        if( batch->closed )
+                        {
+                            return;
+                        }
+                        
+                        batch->running++;
+                    }
+                    
+                    work();
+                    
+                    {
+                        std::lock_guard< std::mutex > lock( batch->mutex );
+                        
+                        batch->running--;
+                    }
+                    
+                    batch->done.notify_all();
+                },
+                threadCount - 1
+            );
+        }
+        
+        work();
+        
+        {
+            std::unique_lock< std::mutex > lock( batch->mutex );
+            
+            batch->closed = true;
+            
+            batch->done.wait( lock, [ & ]( void ) { return batch->running == 0; } );
+        }
+        
+        if( error != nullptr )
+        {
+            std::rethrow_exception( error );
+        }
+        
+        return sizes;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::GridPlan >::IMPL::IMPL( void ):
+    _itemID( 0 ),
+    _rows( 0 ),
+    _columns( 0 ),
+    _outputWidth( 0 ),
+    _outputHeight( 0 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::GridPlan >::IMPL::IMPL( const IMPL & o ):
+    _itemID( o._itemID ),
+    _rows( o._rows ),
+    _columns( o._columns ),
+    _outputWidth( o._outputWidth ),
+    _outputHeight( o._outputHeight ),
+    _tiles( o._tiles ),
+    _path( o._path ),
+    _headers( o._headers )
+{}
+
+XS::PIMPL::Object< ISOBMFF::GridPlan >::IMPL::~IMPL( void )
+{}
+
+void XS::PIMPL::Object< ISOBMFF::GridPlan >::IMPL::Plan( const ISOBMFF::Parser & parser, const ISOBMFF::ItemIndex & index, uint32_t itemID )
+{
+    const ISOBMFF::ItemIndex::Item * grid;
+    std::vector< uint8_t >           data;
+    
+    grid = index.GetItem( itemID );
+    
+    if( grid == nullptr || grid->info == nullptr || grid->info->GetItemType() != "grid" )
+    {
+        throw std::runtime_error( "Item " + std::to_string( itemID ) + " is not a grid" );
+    }
+    
+    /* The grid descriptor is the item data, usually in idat */
+    data = parser.GetItemData( itemID );
+    
+    {
+        ISOBMFF::BinaryStream stream( data );
+        ISOBMFF::ImageGrid    descriptor( stream );
+        
+        this->_itemID       = itemID;
+        this->_rows         = static_cast< uint32_t >( descriptor.GetRows() ) + 1;
+        this->_columns      = static_cast< uint32_t >( descriptor.GetColumns() ) + 1;
+        this->_outputWidth  = descriptor.GetOutputWidth();
+        this->_outputHeight = descriptor.GetOutputHeight();
+    }
+    
+    if( grid->dimg.size() != static_cast< size_t >( this->_rows ) * this->_columns )
+    {
+        throw std::runtime_error
+        (
+            "Grid " + std::to_string( itemID ) + " has " + std::to_string( grid->dimg.size() ) + " tiles for "
+          + std::to_string( this->_rows ) + "x" + std::to_string( this->_columns ) + " cells"
+        );
+    }
+    
+    this->_path = parser.GetPath();
+    
+    this->_tiles.clear();
+    this->_headers.clear();
+    this->_tiles.reserve( grid->dimg.size() );
+    this->_headers.reserve( grid->dimg.size() );
+    
+    for( size_t i = 0; i < grid->dimg.size(); i++ )
+    {
+        const ISOBMFF::ItemIndex::Item * item;
+        ISOBMFF::GridPlan::Tile          tile;
+        uint64_t                         maxUnits;
+        
+        item = index.GetItem( grid->dimg[ i ] );
+        
+        if( item == nullptr || item->info == nullptr || item->info->GetItemType() != "hvc1" )
+        {
+            throw std::runtime_error( "Tile item " + std::to_string( grid->dimg[ i ] ) + " is not an HEVC image" );
+        }
+        
+        if( item->hvcc == nullptr )
+        {
+            throw std::runtime_error( "Tile item " + std::to_string( item->itemID ) + " has no hvcC" );
+        }
+        
+        tile.itemID     = item->itemID;
+        tile.row        = static_cast< uint32_t >( i / this->_columns );
+        tile.column     = static_cast< uint32_t >( i % this->_columns );
+        tile.width      = ( item->ispe != nullptr ) ? item->ispe->GetDisplayWidth()  : 0;
+        tile.height     = ( item->ispe != nullptr ) ? item->ispe->GetDisplayHeight() : 0;
+        tile.ranges     = parser.GetItemDataRanges( item->itemID );
+        tile.lengthSize = static_cast< uint8_t >( item->hvcc->GetLengthSizeMinusOne() + 1 );
+        
+        if( tile.lengthSize == 3 )
+        {
+            throw std::runtime_error( "Tile item " + std::to_string( item->itemID ) + " has an invalid NAL unit length size" );
+        }
+        
+        for( const auto & range: tile.ranges )
+        {
+            tile.dataSize += range.second;
+        }
+        
+        /* Tiles usually share the same hvcC property, and so the same data */
+        this->_headers.push_back( item->hvcc->GetParameterSets() );
+        
+        /* Each NAL unit is at least its length field and one byte, and grows to a 4-byte start code */
+        maxUnits        = tile.dataSize / ( tile.lengthSize + 1u );
+        tile.bufferSize = static_cast< size_t >( this->_headers.back()->size() + tile.dataSize + maxUnits * ( 4u - tile.lengthSize ) );
+        
+        this->_tiles.push_back( tile );
+    }
+}
+
+void XS::PIMPL::Object< ISOBMFF::GridPlan >::IMPL::Open( std::ifstream & in ) const
+{
+    /* Tile data is read straight into the output buffers */
+    in.rdbuf()->pubsetbuf( nullptr, 0 );
+    in.open( this->_path, std::ios::binary );
+    
+    if( in.good() == false )
+    {
+        throw std::runtime_error( "Cannot read file: " + this->_path );
+    }
+}
+
+size_t XS::PIMPL::Object< ISOBMFF::GridPlan >::IMPL::AssembleTile( std::ifstream & in, std::unique_ptr< NalConverter > & converter, size_t index, uint8_t * buffer, size_t size ) const
+{
+    uint8_t * data;
+    uint8_t * p;
+    size_t    length;
+    
+    if( index >= this->_tiles.size() )
+    {
+        throw std::runtime_error( "Invalid tile index: " + std::to_string( index ) );
+    }
+    
+    const ISOBMFF::GridPlan::Tile & tile   = this->_tiles[ index ];
+    const std::vector< uint8_t >  & header = *( this->_headers[ index ] );
+    
+    if( buffer == nullptr || size < tile.bufferSize )
+    {
+        throw std::runtime_error( "Buffer too small for tile item " + std::to_string( tile.itemID ) );
+    }
+    
+    /*
+     * The tile data goes right after the parameter sets, and the rest of
+     * the buffer is room for every length field to grow to a start code.
+     */
+    data = buffer + header.size();
+    p    = data;
+    
+    for( const auto & range: tile.ranges )
+    {
+        in.clear();
+        in.seekg( static_cast< std::streamoff >( range.first ), std::ios::beg );
+        in.read( reinterpret_cast< char * >( p ), static_cast< std::streamsize >( range.second ) );
+        
+        if( static_cast< uint64_t >( in.gcount() ) != range.second )
+        {
+            throw std::runtime_error( "Cannot read data of tile item " + std::to_string( tile.itemID ) + " from file: " + this->_path );
+        }
+        
+        p += range.second;
+    }
+    
+    if( header.empty() == false )
+    {
+        memcpy( buffer, header.data(), header.size() );
+    }
+    
+    /* Tiles of a grid usually share their length size, and so the converter */
+    if( converter == nullptr || converter->lengthSize() != tile.lengthSize )
+    {
+        converter.reset( new NalConverter( tile.lengthSize ) );
+    }
+    
+    try
+    {
+        length = converter->toAnnexB( data, static_cast< size_t >( tile.dataSize ), tile.bufferSize - header.size() );
+    }
+    catch( const std::runtime_error & e )
+    {
+        throw std::runtime_error( "Invalid NAL units in tile item " + std::to_string( tile.itemID ) + ": " + e.what() );
+    }
+    
+    return header.size() + length;
+}
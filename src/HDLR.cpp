@@ -29,8 +29,10 @@
  */
 
 #include <ISOBMFF/HDLR.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/IParser.hpp>
 #include <cstdint>
+#include <cstring>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::HDLR >::IMPL
@@ -89,6 +91,27 @@ namespace ISOBMFF
         }
     }
     
+    void HDLR::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( this->impl->_predefined );
+        sink.WriteFourCC( this->GetHandlerType() );
+        sink.WriteBigEndianUInt32( this->impl->_reserved[ 0 ] );
+        sink.WriteBigEndianUInt32( this->impl->_reserved[ 1 ] );
+        sink.WriteBigEndianUInt32( this->impl->_reserved[ 2 ] );
+        
+        /* QuickTime handlers, as detected by ReadData, use Pascal strings */
+        if( this->impl->_predefined == 1835560050 /* mhlr */ || this->impl->_reserved[ 0 ] == 1634758764 /* appl */ )
+        {
+            sink.WritePascalString( this->GetHandlerName() );
+        }
+        else
+        {
+            sink.WriteNULLTerminatedString( this->GetHandlerName() );
+        }
+    }
+    
     std::vector< std::pair< std::string, std::string > > HDLR::GetDisplayableProperties( void ) const
     {
         auto props( FullBox::GetDisplayableProperties() );
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/HVCC.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/Utils.hpp>
 #include <ISOBMFF/IParser.hpp>
 
@@ -41,6 +42,8 @@ class XS::PIMPL::Object< ISOBMFF::HVCC >::IMPL
         IMPL( const IMPL & o );
         ~IMPL( void );
         
+        std::vector< uint8_t > BuildParameterSets( void ) const;
+        
         uint8_t                                                _configurationVersion;
         uint8_t                                                _generalProfileSpace;
         uint8_t                                                _generalTierFlag;
@@ -59,6 +62,7 @@ class XS::PIMPL::Object< ISOBMFF::HVCC >::IMPL
         uint8_t                                                _temporalIdNested;
         uint8_t                                                _lengthSizeMinusOne;
         std::vector< std::shared_ptr< ISOBMFF::HVCC::Array > > _arrays;
+        std::shared_ptr< const std::vector< uint8_t > >        _parameterSets;
 };
 
 #define XS_PIMPL_CLASS ISOBMFF::HVCC
@@ -124,9 +128,49 @@ namespace ISOBMFF
         
         count = stream.ReadUInt8();
         
+        this->impl->_arrays.clear();
+        
         for( i = 0; i < count; i++ )
         {
-            this->AddArray( std::make_shared< Array >( stream ) );
+            this->impl->_arrays.push_back( std::make_shared< Array >( stream ) );
+        }
+    }
+    
+    void HVCC::WriteData( BoxSink & sink ) const
+    {
+        uint64_t constraints;
+        
+        constraints = this->GetGeneralConstraintIndicatorFlags();
+        
+        sink.WriteUInt8( this->GetConfigurationVersion() );
+        sink.WriteUInt8( static_cast< uint8_t >( ( this->GetGeneralProfileSpace() << 6 ) | ( ( this->GetGeneralTierFlag() & 0x01 ) << 5 ) | ( this->GetGeneralProfileIDC() & 0x1F ) ) );
+        sink.WriteBigEndianUInt32( this->GetGeneralProfileCompatibilityFlags() );
+        sink.WriteBigEndianUInt16( static_cast< uint16_t >( constraints >> 32 ) );
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( constraints ) );
+        sink.WriteUInt8( this->GetGeneralLevelIDC() );
+        sink.WriteBigEndianUInt16( static_cast< uint16_t >( 0xF000 | this->GetMinSpatialSegmentationIDC() ) );
+        sink.WriteUInt8( static_cast< uint8_t >( 0xFC | this->GetParallelismType() ) );
+        sink.WriteUInt8( static_cast< uint8_t >( 0xFC | this->GetChromaFormat() ) );
+        sink.WriteUInt8( static_cast< uint8_t >( 0xF8 | this->GetBitDepthLumaMinus8() ) );
+        sink.WriteUInt8( static_cast< uint8_t >( 0xF8 | this->GetBitDepthChromaMinus8() ) );
+        sink.WriteBigEndianUInt16( this->GetAvgFrameRate() );
+        sink.WriteUInt8( static_cast< uint8_t >( ( this->GetConstantFrameRate() << 6 ) | ( this->GetNumTemporalLayers() << 3 ) | ( this->GetTemporalIdNested() << 2 ) | this->GetLengthSizeMinusOne() ) );
+        sink.WriteUInt8( static_cast< uint8_t >( this->impl->_arrays.size() ) );
+        
+        for( const auto & array: this->impl->_arrays )
+        {
+            auto units( array->GetNALUnits() );
+            
+            sink.WriteUInt8( static_cast< uint8_t >( ( ( array->GetArrayCompleteness() ) ? 0x80 : 0x00 ) | array->GetNALUnitType() ) );
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( units.size() ) );
+            
+            for( const auto & unit: units )
+            {
+                auto data( unit->GetData() );
+                
+                sink.WriteBigEndianUInt16( static_cast< uint16_t >( data.size() ) );
+                sink.Write( data );
+            }
         }
     }
     
@@ -348,6 +392,25 @@ namespace ISOBMFF
     {
         this->impl->_arrays.push_back( array );
     }
+    
+    std::shared_ptr< const std::vector< uint8_t > > HVCC::GetParameterSets( void ) const
+    {
+        std::vector< uint8_t >                          data;
+        std::shared_ptr< const std::vector< uint8_t > > parameterSets;
+        
+        data          = this->impl->BuildParameterSets();
+        parameterSets = std::atomic_load( &( this->impl->_parameterSets ) );
+        
+        /* Concurrent callers may both replace stale data, with the same bytes */
+        if( *( parameterSets ) != data )
+        {
+            parameterSets = std::make_shared< const std::vector< uint8_t > >( std::move( data ) );
+            
+            std::atomic_store( &( this->impl->_parameterSets ), parameterSets );
+        }
+        
+        return parameterSets;
+    }
 }
 
 XS::PIMPL::Object< ISOBMFF::HVCC >::IMPL::IMPL( void ):
@@ -367,7 +430,8 @@ XS::PIMPL::Object< ISOBMFF::HVCC >::IMPL::IMPL( void ):
     _constantFrameRate( 0 ),
     _numTemporalLayers( 0 ),
     _temporalIdNested( 0 ),
-    _lengthSizeMinusOne( 0 )
+    _lengthSizeMinusOne( 0 ),
+    _parameterSets( std::make_shared< const std::vector< uint8_t > >() )
 {}
 
 XS::PIMPL::Object< ISOBMFF::HVCC >::IMPL::IMPL( const IMPL & o ):
@@ -388,9 +452,28 @@ XS::PIMPL::Object< ISOBMFF::HVCC >::IMPL::IMPL( const IMPL & o ):
     _numTemporalLayers( o._numTemporalLayers ),
     _temporalIdNested( o._temporalIdNested ),
     _lengthSizeMinusOne( o._lengthSizeMinusOne ),
-    _arrays( o._arrays )
+    _arrays( o._arrays ),
+    _parameterSets( o._parameterSets )
 {}
 
 XS::PIMPL::Object< ISOBMFF::HVCC >::IMPL::~IMPL( void )
 {}
 
+std::vector< uint8_t > XS::PIMPL::Object< ISOBMFF::HVCC >::IMPL::BuildParameterSets( void ) const
+{
+    std::vector< uint8_t > data;
+    
+    for( const auto & array: this->_arrays )
+    {
+        for( const auto & unit: array->GetNALUnits() )
+        {
+            std::vector< uint8_t > bytes( unit->GetData() );
+            
+            data.insert( data.end(), { 0, 0, 0, 1 } );
+            data.insert( data.end(), bytes.begin(), bytes.end() );
+        }
+    }
+    
+    return data;
+}
+
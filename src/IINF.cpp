@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/IINF.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/ContainerBox.hpp>
 
 template<>
@@ -79,6 +80,27 @@ namespace ISOBMFF
         }
     }
     
+    void IINF::WriteData( BoxSink & sink ) const
+    {
+        auto entries( this->GetEntries() );
+        
+        FullBox::WriteData( sink );
+        
+        if( this->GetVersion() == 0 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( entries.size() ) );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( entries.size() ) );
+        }
+        
+        for( const auto & entry: entries )
+        {
+            entry->Write( sink );
+        }
+    }
+    
     void IINF::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         FullBox::WriteDescription( os, indentLevel );
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/ILOC.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::ILOC::Item::Extent >::IMPL
@@ -99,6 +100,35 @@ namespace ISOBMFF
         }
     }
     
+    void ILOC::Item::Extent::Write( BoxSink & sink, const ILOC & iloc ) const
+    {
+        std::vector< std::pair< uint8_t, uint64_t > > fields;
+        
+        if( ( iloc.GetVersion() == 1 || iloc.GetVersion() == 2 ) && iloc.GetIndexSize() > 0 )
+        {
+            fields.push_back( { iloc.GetIndexSize(), this->GetIndex() } );
+        }
+        
+        fields.push_back( { iloc.GetOffsetSize(), this->GetOffset() } );
+        fields.push_back( { iloc.GetLengthSize(), this->GetLength() } );
+        
+        for( const auto & field: fields )
+        {
+            if( field.first == 2 )
+            {
+                sink.WriteBigEndianUInt16( static_cast< uint16_t >( field.second ) );
+            }
+            else if( field.first == 4 )
+            {
+                sink.WriteBigEndianUInt32( static_cast< uint32_t >( field.second ) );
+            }
+            else if( field.first == 8 )
+            {
+                sink.WriteBigEndianUInt64( field.second );
+            }
+        }
+    }
+    
     std::string ILOC::Item::Extent::GetName( void ) const
     {
         return "Extent";
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/ILOC.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::ILOC::Item >::IMPL
@@ -100,6 +101,47 @@ namespace ISOBMFF
         }
     }
     
+    void ILOC::Item::Write( BoxSink & sink, const ILOC & iloc ) const
+    {
+        auto extents( this->GetExtents() );
+        
+        if( iloc.GetVersion() < 2 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( this->GetItemID() ) );
+        }
+        else if( iloc.GetVersion() == 2 )
+        {
+            sink.WriteBigEndianUInt32( this->GetItemID() );
+        }
+        
+        if( iloc.GetVersion() == 1 || iloc.GetVersion() == 2 )
+        {
+            sink.WriteBigEndianUInt16( this->GetConstructionMethod() & 0xF );
+        }
+        
+        sink.WriteBigEndianUInt16( this->GetDataReferenceIndex() );
+        
+        if( iloc.GetBaseOffsetSize() == 2 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( this->GetBaseOffset() ) );
+        }
+        else if( iloc.GetBaseOffsetSize() == 4 )
+        {
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetBaseOffset() ) );
+        }
+        else if( iloc.GetBaseOffsetSize() == 8 )
+        {
+            sink.WriteBigEndianUInt64( this->GetBaseOffset() );
+        }
+        
+        sink.WriteBigEndianUInt16( static_cast< uint16_t >( extents.size() ) );
+        
+        for( const auto & extent: extents )
+        {
+            extent->Write( sink, iloc );
+        }
+    }
+    
     std::string ILOC::Item::GetName( void ) const
     {
         return "Item";
@@ -29,6 +29,9 @@
  */
 
 #include <ISOBMFF/ILOC.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <stdexcept>
+#include <string>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::ILOC >::IMPL
@@ -89,6 +92,30 @@ namespace ISOBMFF
         }
     }
     
+    void ILOC::WriteData( BoxSink & sink ) const
+    {
+        auto items( this->GetItems() );
+        
+        FullBox::WriteData( sink );
+        
+        sink.WriteUInt8( static_cast< uint8_t >( ( this->GetOffsetSize() << 4 ) | ( this->GetLengthSize() & 0xF ) ) );
+        sink.WriteUInt8( static_cast< uint8_t >( ( this->GetBaseOffsetSize() << 4 ) | ( this->GetIndexSize() & 0xF ) ) );
+        
+        if( this->GetVersion() < 2 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( items.size() ) );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( items.size() ) );
+        }
+        
+        for( const auto & item: items )
+        {
+            item->Write( sink, *( this ) );
+        }
+    }
+    
     void ILOC::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         FullBox::WriteDescription( os, indentLevel );
@@ -178,6 +205,80 @@ namespace ISOBMFF
         return nullptr;
     }
     
+    std::vector< std::pair< uint64_t, uint64_t > > ILOC::GetItemDataRanges( uint32_t itemID, const Box * idat, uint64_t fileSize ) const ISOBMFF_NOEXCEPT( false )
+    {
+        std::shared_ptr< Item >                        item;
+        std::vector< std::pair< uint64_t, uint64_t > > ranges;
+        uint64_t                                       start;
+        uint64_t                                       end;
+        
+        item = this->GetItem( itemID );
+        
+        if( item == nullptr )
+        {
+            throw std::runtime_error( "Unknown item " + std::to_string( itemID ) );
+        }
+        
+        if( item->GetDataReferenceIndex() != 0 )
+        {
+            throw std::runtime_error( "Item " + std::to_string( itemID ) + " is stored in another file" );
+        }
+        
+        /*
+         * Construction method 0 addresses the file, method 1 the payload of
+         * the idat box of the same meta box. Both end up as file ranges.
+         */
+        if( item->GetConstructionMethod() == 0 )
+        {
+            start = 0;
+            end   = fileSize;
+        }
+        else if( item->GetConstructionMethod() == 1 )
+        {
+            if( idat == nullptr )
+            {
+                throw std::runtime_error( "Item " + std::to_string( itemID ) + " refers to a missing idat box" );
+            }
+            
+            start = idat->GetDataOffset();
+            end   = start + idat->GetDataLength();
+        }
+        else
+        {
+            throw std::runtime_error( "Unsupported construction method " + std::to_string( item->GetConstructionMethod() ) + " for item " + std::to_string( itemID ) );
+        }
+        
+        for( const auto & extent: item->GetExtents() )
+        {
+            uint64_t offset;
+            uint64_t length;
+            
+            length = extent->GetLength();
+            
+            /* Compared separately, as the sum of the offsets may wrap around */
+            if( item->GetBaseOffset() > end - start || extent->GetOffset() > end - start - item->GetBaseOffset() )
+            {
+                throw std::runtime_error( "Extent of item " + std::to_string( itemID ) + " is out of bounds" );
+            }
+            
+            offset = item->GetBaseOffset() + extent->GetOffset();
+            
+            /* A length of 0 means the extent runs to the end of the data */
+            if( length == 0 )
+            {
+                length = end - start - offset;
+            }
+            else if( length > end - start - offset )
+            {
+                throw std::runtime_error( "Extent of item " + std::to_string( itemID ) + " is out of bounds" );
+            }
+            
+            ranges.push_back( { start + offset, length } );
+        }
+        
+        return ranges;
+    }
+    
     void ILOC::AddItem( std::shared_ptr< Item > item )
     {
         this->impl->_items.push_back( item );
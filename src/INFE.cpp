@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/INFE.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/IParser.hpp>
 
 template<>
@@ -121,10 +122,16 @@ namespace ISOBMFF
             
             if( parser->GetPreferredStringType() == IParser::StringType::Pascal )
             {
+                this->SetItemName( stream.ReadPascalString() );
+                
                 if( this->GetItemType() == "mime" )
                 {
                     this->SetContentType( stream.ReadPascalString() );
-                    this->SetContentEncoding( stream.ReadPascalString() );
+                    
+                    if( stream.HasBytesAvailable() )
+                    {
+                        this->SetContentEncoding( stream.ReadPascalString() );
+                    }
                 }
                 else if( this->GetItemType() == "uri " )
                 {
@@ -133,10 +140,16 @@ namespace ISOBMFF
             }
             else
             {
+                this->SetItemName( stream.ReadNULLTerminatedString() );
+                
                 if( this->GetItemType() == "mime" )
                 {
                     this->SetContentType( stream.ReadNULLTerminatedString() );
-                    this->SetContentEncoding( stream.ReadNULLTerminatedString() );
+                    
+                    if( stream.HasBytesAvailable() )
+                    {
+                        this->SetContentEncoding( stream.ReadNULLTerminatedString() );
+                    }
                 }
                 else if( this->GetItemType() == "uri " )
                 {
@@ -146,6 +159,49 @@ namespace ISOBMFF
         }
     }
     
+    void INFE::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        if( this->GetVersion() == 0 || this->GetVersion() == 1 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( this->GetItemID() ) );
+            sink.WriteBigEndianUInt16( this->GetItemProtectionIndex() );
+            sink.WriteNULLTerminatedString( this->GetItemName() );
+            sink.WriteNULLTerminatedString( this->GetContentType() );
+            sink.WriteNULLTerminatedString( this->GetContentEncoding() );
+            
+            return;
+        }
+        
+        if( this->GetVersion() == 2 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( this->GetItemID() ) );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( this->GetItemID() );
+        }
+        
+        sink.WriteBigEndianUInt16( this->GetItemProtectionIndex() );
+        sink.WriteFourCC( this->GetItemType() );
+        sink.WriteNULLTerminatedString( this->GetItemName() );
+        
+        if( this->GetItemType() == "mime" )
+        {
+            sink.WriteNULLTerminatedString( this->GetContentType() );
+            
+            if( this->GetContentEncoding().empty() == false )
+            {
+                sink.WriteNULLTerminatedString( this->GetContentEncoding() );
+            }
+        }
+        else if( this->GetItemType() == "uri " )
+        {
+            sink.WriteNULLTerminatedString( this->GetItemURIType() );
+        }
+    }
+    
 	std::vector< std::pair< std::string, std::string > > INFE::GetDisplayableProperties( void ) const
     {
         auto props( FullBox::GetDisplayableProperties() );
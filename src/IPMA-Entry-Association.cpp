@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/IPMA.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::IPMA::Entry::Association >::IMPL
@@ -77,6 +78,18 @@ namespace ISOBMFF
         }
     }
     
+    void IPMA::Entry::Association::Write( BoxSink & sink, const IPMA & ipma ) const
+    {
+        if( ipma.GetFlags() & 0x01 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( ( ( this->GetEssential() ) ? 0x8000 : 0 ) | ( this->GetPropertyIndex() & 0x7FFF ) ) );
+        }
+        else
+        {
+            sink.WriteUInt8( static_cast< uint8_t >( ( ( this->GetEssential() ) ? 0x80 : 0 ) | ( this->GetPropertyIndex() & 0x7F ) ) );
+        }
+    }
+    
     std::string IPMA::Entry::Association::GetName( void ) const
     {
         return "Association";
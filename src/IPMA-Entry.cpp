@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/IPMA.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::IPMA::Entry >::IMPL
@@ -73,6 +74,27 @@ namespace ISOBMFF
         }
     }
     
+    void IPMA::Entry::Write( BoxSink & sink, const IPMA & ipma ) const
+    {
+        auto associations( this->GetAssociations() );
+        
+        if( ipma.GetVersion() < 1 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( this->GetItemID() ) );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( this->GetItemID() );
+        }
+        
+        sink.WriteUInt8( static_cast< uint8_t >( associations.size() ) );
+        
+        for( const auto & association: associations )
+        {
+            association->Write( sink, ipma );
+        }
+    }
+    
     std::string IPMA::Entry::GetName( void ) const
     {
         return "Entry";
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/IPMA.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::IPMA >::IMPL
@@ -65,6 +66,20 @@ namespace ISOBMFF
         }
     }
     
+    void IPMA::WriteData( BoxSink & sink ) const
+    {
+        auto entries( this->GetEntries() );
+        
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( entries.size() ) );
+        
+        for( const auto & entry: entries )
+        {
+            entry->Write( sink, *( this ) );
+        }
+    }
+    
     void IPMA::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         FullBox::WriteDescription( os, indentLevel );
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/IREF.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/ContainerBox.hpp>
 #include <ISOBMFF/IParser.hpp>
 
@@ -64,6 +65,12 @@ namespace ISOBMFF
         this->impl->_boxes = container.GetBoxes();
     }
     
+    void IREF::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        Container::WriteBoxes( sink );
+    }
+    
     void IREF::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         FullBox::WriteDescription( os, indentLevel );
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/IROT.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/IParser.hpp>
 
 template<>
@@ -62,6 +63,11 @@ namespace ISOBMFF
         this->SetAngle( u8 & 0x3 );
     }
     
+    void IROT::WriteData( BoxSink & sink ) const
+    {
+        sink.WriteUInt8( this->GetAngle() & 0x3 );
+    }
+    
 	std::vector< std::pair< std::string, std::string > > IROT::GetDisplayableProperties( void ) const
     {
         auto props( Box::GetDisplayableProperties() );
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/ISPE.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::ISPE >::IMPL
@@ -59,6 +60,14 @@ namespace ISOBMFF
         this->SetDisplayHeight( stream.ReadBigEndianUInt32() );
     }
     
+    void ISPE::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( this->GetDisplayWidth() );
+        sink.WriteBigEndianUInt32( this->GetDisplayHeight() );
+    }
+    
 	std::vector< std::pair< std::string, std::string > > ISPE::GetDisplayableProperties( void ) const
     {
         auto props( FullBox::GetDisplayableProperties() );
@@ -0,0 +1,258 @@
+/*!
+ * @file        ItemIndex.cpp
+ */
+
+#include <ISOBMFF/ItemIndex.hpp>
+#include <ISOBMFF/META.hpp>
+#include <ISOBMFF/IINF.hpp>
+#include <ISOBMFF/INFE.hpp>
+#include <ISOBMFF/PITM.hpp>
+#include <ISOBMFF/IPMA.hpp>
+#include <ISOBMFF/IPCO.hpp>
+#include <ISOBMFF/IREF.hpp>
+#include <ISOBMFF/SingleItemTypeReferenceBox.hpp>
+#include <ISOBMFF/ISPE.hpp>
+#include <ISOBMFF/COLR.hpp>
+#include <ISOBMFF/PIXI.hpp>
+#include <ISOBMFF/IROT.hpp>
+#include <ISOBMFF/HVCC.hpp>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::ItemIndex >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        ISOBMFF::ItemIndex::Item & GetOrAddItem( uint32_t itemID );
+        
+        std::vector< ISOBMFF::ItemIndex::Item >  _items;
+        std::unordered_map< uint32_t, size_t >   _indices;
+        size_t                                   _primary;
+        
+        /* Keep the indexed boxes alive */
+        std::vector< std::shared_ptr< ISOBMFF::Box > > _boxes;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::ItemIndex
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    ItemIndex::ItemIndex( void )
+    {}
+    
+    ItemIndex::ItemIndex( const META & meta )
+    {
+        std::shared_ptr< IINF > iinf;
+        std::shared_ptr< ILOC > iloc;
+        std::shared_ptr< PITM > pitm;
+        std::shared_ptr< IREF > iref;
+        std::shared_ptr< Box >  iprp;
+        
+        iinf = meta.GetTypedBox< IINF >( "iinf" );
+        iloc = meta.GetTypedBox< ILOC >( "iloc" );
+        pitm = meta.GetTypedBox< PITM >( "pitm" );
+        iref = meta.GetTypedBox< IREF >( "iref" );
+        iprp = meta.GetBox( "iprp" );
+        
+        if( iinf != nullptr )
+        {
+            auto entries( iinf->GetEntries() );
+            
+            this->impl->_items.reserve( entries.size() );
+            
+            for( const auto & infe: entries )
+            {
+                this->impl->GetOrAddItem( infe->GetItemID() ).info = infe.get();
+                this->impl->_boxes.push_back( infe );
+            }
+        }
+        
+        if( iloc != nullptr )
+        {
+            for( const auto & location: iloc->GetItems() )
+            {
+                this->impl->GetOrAddItem( location->GetItemID() ).location = location.get();
+            }
+            
+            this->impl->_boxes.push_back( iloc );
+        }
+        
+        if( iprp != nullptr )
+        {
+            std::shared_ptr< IPCO >               ipco;
+            std::vector< std::shared_ptr< Box > > properties;
+            
+            ipco = std::static_pointer_cast< ContainerBox >( iprp )->GetTypedBox< IPCO >( "ipco" );
+            
+            if( ipco != nullptr )
+            {
+                properties = ipco->GetBoxes();
+                
+                this->impl->_boxes.push_back( ipco );
+            }
+            
+            for( const auto & box: std::static_pointer_cast< ContainerBox >( iprp )->Container::GetBoxes( "ipma" ) )
+            {
+                for( const auto & entry: std::static_pointer_cast< IPMA >( box )->GetEntries() )
+                {
+                    Item & item = this->impl->GetOrAddItem( entry->GetItemID() );
+                    
+                    for( const auto & association: entry->GetAssociations() )
+                    {
+                        uint16_t    index;
+                        const Box * property;
+                        std::string name;
+                        
+                        index = association->GetPropertyIndex();
+                        
+                        /* Index 0 means no property */
+                        if( index == 0 || index > properties.size() )
+                        {
+                            continue;
+                        }
+                        
+                        property = properties[ index - 1 ].get();
+                        name     = property->GetName();
+                        
+                        item.properties.push_back( { property, association->GetEssential() } );
+                        
+                        if( name == "ispe" && item.ispe == nullptr )
+                        {
+                            item.ispe = static_cast< const ISPE * >( property );
+                        }
+                        else if( name == "colr" && item.colr == nullptr )
+                        {
+                            item.colr = static_cast< const COLR * >( property );
+                        }
+                        else if( name == "pixi" && item.pixi == nullptr )
+                        {
+                            item.pixi = static_cast< const PIXI * >( property );
+                        }
+                        else if( name == "irot" && item.irot == nullptr )
+                        {
+                            item.irot = static_cast< const IROT * >( property );
+                        }
+                        else if( name == "hvcC" && item.hvcc == nullptr )
+                        {
+                            item.hvcc = static_cast< const HVCC * >( property );
+                        }
+                    }
+                }
+            }
+        }
+        
+        if( iref != nullptr )
+        {
+            for( const auto & box: iref->GetBoxes() )
+            {
+                std::string                                   name;
+                std::shared_ptr< SingleItemTypeReferenceBox > reference;
+                uint32_t                                      from;
+                
+                name = box->GetName();
+                
+                if( name != "dimg" && name != "thmb" && name != "cdsc" )
+                {
+                    continue;
+                }
+                
+                reference = std::static_pointer_cast< SingleItemTypeReferenceBox >( box );
+                from      = reference->GetFromItemID();
+                
+                for( uint32_t to: reference->GetToItemIDs() )
+                {
+                    if( name == "dimg" )
+                    {
+                        this->impl->GetOrAddItem( from ).dimg.push_back( to );
+                    }
+                    else if( name == "thmb" )
+                    {
+                        this->impl->GetOrAddItem( from ).thmb.push_back( to );
+                        this->impl->GetOrAddItem( to ).thumbnails.push_back( from );
+                    }
+                    else
+                    {
+                        this->impl->GetOrAddItem( from ).cdsc.push_back( to );
+                        this->impl->GetOrAddItem( to ).descriptions.push_back( from );
+                    }
+                }
+            }
+        }
+        
+        if( pitm != nullptr )
+        {
+            auto it = this->impl->_indices.find( pitm->GetItemID() );
+            
+            if( it != this->impl->_indices.end() )
+            {
+                this->impl->_primary = it->second;
+            }
+        }
+    }
+    
+    const ItemIndex::Item * ItemIndex::GetItem( uint32_t itemID ) const
+    {
+        auto it = this->impl->_indices.find( itemID );
+        
+        if( it == this->impl->_indices.end() )
+        {
+            return nullptr;
+        }
+        
+        return &( this->impl->_items[ it->second ] );
+    }
+    
+    const ItemIndex::Item * ItemIndex::GetPrimaryItem( void ) const
+    {
+        if( this->impl->_primary >= this->impl->_items.size() )
+        {
+            return nullptr;
+        }
+        
+        return &( this->impl->_items[ this->impl->_primary ] );
+    }
+    
+    const std::vector< ItemIndex::Item > & ItemIndex::GetItems( void ) const
+    {
+        return this->impl->_items;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::ItemIndex >::IMPL::IMPL( void ):
+    _primary( SIZE_MAX )
+{}
+
+XS::PIMPL::Object< ISOBMFF::ItemIndex >::IMPL::IMPL( const IMPL & o ):
+    _items( o._items ),
+    _indices( o._indices ),
+    _primary( o._primary ),
+    _boxes( o._boxes )
+{}
+
+XS::PIMPL::Object< ISOBMFF::ItemIndex >::IMPL::~IMPL( void )
+{}
+
+ISOBMFF::ItemIndex::Item & XS::PIMPL::Object< ISOBMFF::ItemIndex >::IMPL::GetOrAddItem( uint32_t itemID )
+{
+    auto it = this->_indices.find( itemID );
+    
+    if( it != this->_indices.end() )
+    {
+        return this->_items[ it->second ];
+    }
+    
+    this->_indices[ itemID ] = this->_items.size();
+    
+    this->_items.push_back( ISOBMFF::ItemIndex::Item() );
+    
+    this->_items.back().itemID = itemID;
+    
+    return this->_items.back();
+}
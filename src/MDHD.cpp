@@ -0,0 +1,182 @@
+/*!
+ * @file        MDHD.cpp
+ */
+
+#include <ISOBMFF/MDHD.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::MDHD >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint64_t    _creationTime;
+        uint64_t    _modificationTime;
+        uint32_t    _timescale;
+        uint64_t    _duration;
+        std::string _language;
+        uint16_t    _predefined;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::MDHD
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    MDHD::MDHD( void ): FullBox( "mdhd" )
+    {}
+    
+    void MDHD::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint16_t    u16;
+        std::string language;
+        
+        FullBox::ReadData( parser, stream );
+        
+        if( this->GetVersion() == 1 )
+        {
+            this->SetCreationTime( stream.ReadBigEndianUInt64() );
+            this->SetModificationTime( stream.ReadBigEndianUInt64() );
+            this->SetTimescale( stream.ReadBigEndianUInt32() );
+            this->SetDuration( stream.ReadBigEndianUInt64() );
+        }
+        else
+        {
+            this->SetCreationTime( stream.ReadBigEndianUInt32() );
+            this->SetModificationTime( stream.ReadBigEndianUInt32() );
+            this->SetTimescale( stream.ReadBigEndianUInt32() );
+            this->SetDuration( stream.ReadBigEndianUInt32() );
+        }
+        
+        /* Padding bit, then three 5-bit letters offset by 0x60 */
+        u16 = stream.ReadBigEndianUInt16();
+        
+        language += static_cast< char >( ( ( u16 >> 10 ) & 0x1F ) + 0x60 );
+        language += static_cast< char >( ( ( u16 >>  5 ) & 0x1F ) + 0x60 );
+        language += static_cast< char >( (   u16         & 0x1F ) + 0x60 );
+        
+        this->impl->_language   = language;
+        this->impl->_predefined = stream.ReadBigEndianUInt16();
+    }
+    
+    void MDHD::WriteData( BoxSink & sink ) const
+    {
+        uint16_t u16;
+        
+        FullBox::WriteData( sink );
+        
+        if( this->GetVersion() == 1 )
+        {
+            sink.WriteBigEndianUInt64( this->GetCreationTime() );
+            sink.WriteBigEndianUInt64( this->GetModificationTime() );
+            sink.WriteBigEndianUInt32( this->GetTimescale() );
+            sink.WriteBigEndianUInt64( this->GetDuration() );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetCreationTime() ) );
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetModificationTime() ) );
+            sink.WriteBigEndianUInt32( this->GetTimescale() );
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetDuration() ) );
+        }
+        
+        u16 = 0;
+        
+        for( std::size_t i = 0; i < 3; i++ )
+        {
+            u16 = static_cast< uint16_t >( ( u16 << 5 ) | ( ( ( i < this->impl->_language.size() ) ? this->impl->_language[ i ] - 0x60 : 0 ) & 0x1F ) );
+        }
+        
+        sink.WriteBigEndianUInt16( u16 );
+        sink.WriteBigEndianUInt16( this->impl->_predefined );
+    }
+    
+    std::vector< std::pair< std::string, std::string > > MDHD::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Creation time",     std::to_string( this->GetCreationTime() ) } );
+        props.push_back( { "Modification time", std::to_string( this->GetModificationTime() ) } );
+        props.push_back( { "Timescale",         std::to_string( this->GetTimescale() ) } );
+        props.push_back( { "Duration",          std::to_string( this->GetDuration() ) } );
+        props.push_back( { "Language",          this->GetLanguage() } );
+        
+        return props;
+    }
+    
+    uint64_t MDHD::GetCreationTime( void ) const
+    {
+        return this->impl->_creationTime;
+    }
+    
+    uint64_t MDHD::GetModificationTime( void ) const
+    {
+        return this->impl->_modificationTime;
+    }
+    
+    uint32_t MDHD::GetTimescale( void ) const
+    {
+        return this->impl->_timescale;
+    }
+    
+    uint64_t MDHD::GetDuration( void ) const
+    {
+        return this->impl->_duration;
+    }
+    
+    std::string MDHD::GetLanguage( void ) const
+    {
+        return this->impl->_language;
+    }
+    
+    void MDHD::SetCreationTime( uint64_t value )
+    {
+        this->impl->_creationTime = value;
+    }
+    
+    void MDHD::SetModificationTime( uint64_t value )
+    {
+        this->impl->_modificationTime = value;
+    }
+    
+    void MDHD::SetTimescale( uint32_t value )
+    {
+        this->impl->_timescale = value;
+    }
+    
+    void MDHD::SetDuration( uint64_t value )
+    {
+        this->impl->_duration = value;
+    }
+    
+    void MDHD::SetLanguage( const std::string & value )
+    {
+        this->impl->_language = value;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::MDHD >::IMPL::IMPL( void ):
+    _creationTime( 0 ),
+    _modificationTime( 0 ),
+    _timescale( 0 ),
+    _duration( 0 ),
+    _language( "und" ),
+    _predefined( 0 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::MDHD >::IMPL::IMPL( const IMPL & o ):
+    _creationTime( o._creationTime ),
+    _modificationTime( o._modificationTime ),
+    _timescale( o._timescale ),
+    _duration( o._duration ),
+    _language( o._language ),
+    _predefined( o._predefined )
+{}
+
+XS::PIMPL::Object< ISOBMFF::MDHD >::IMPL::~IMPL( void )
+{}
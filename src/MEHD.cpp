@@ -0,0 +1,91 @@
+/*!
+ * @file        MEHD.cpp
+ */
+
+#include <ISOBMFF/MEHD.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::MEHD >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint64_t _fragmentDuration;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::MEHD
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    MEHD::MEHD( void ): FullBox( "mehd" )
+    {}
+    
+    void MEHD::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        FullBox::ReadData( parser, stream );
+        
+        if( this->GetVersion() == 1 )
+        {
+            this->SetFragmentDuration( stream.ReadBigEndianUInt64() );
+        }
+        else
+        {
+            this->SetFragmentDuration( stream.ReadBigEndianUInt32() );
+        }
+    }
+    
+    void MEHD::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        if( this->GetVersion() == 1 )
+        {
+            sink.WriteBigEndianUInt64( this->GetFragmentDuration() );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetFragmentDuration() ) );
+        }
+    }
+    
+    std::vector< std::pair< std::string, std::string > > MEHD::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Fragment duration", std::to_string( this->GetFragmentDuration() ) } );
+        
+        return props;
+    }
+    
+    uint64_t MEHD::GetFragmentDuration( void ) const
+    {
+        return this->impl->_fragmentDuration;
+    }
+    
+    void MEHD::SetFragmentDuration( uint64_t value )
+    {
+        this->impl->_fragmentDuration = value;
+        
+        if( value > 0xFFFFFFFF )
+        {
+            this->SetVersion( 1 );
+        }
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::MEHD >::IMPL::IMPL( void ):
+    _fragmentDuration( 0 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::MEHD >::IMPL::IMPL( const IMPL & o ):
+    _fragmentDuration( o._fragmentDuration )
+{}
+
+XS::PIMPL::Object< ISOBMFF::MEHD >::IMPL::~IMPL( void )
+{}
@@ -29,7 +29,9 @@
  */
 
 #include <ISOBMFF/META.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/ContainerBox.hpp>
+#include <cstring>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::META >::IMPL
@@ -71,6 +73,16 @@ namespace ISOBMFF
         this->impl->_boxes = container.GetBoxes();
     }
     
+    void META::WriteData( BoxSink & sink ) const
+    {
+        if( this->impl->_isFullBox )
+        {
+            FullBox::WriteData( sink );
+        }
+        
+        Container::WriteBoxes( sink );
+    }
+    
     void META::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         if( this->impl->_isFullBox )
@@ -1,4 +1,5 @@
 #include <ISOBMFF/MFHD.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/ContainerBox.hpp>
 
 template<>
@@ -27,6 +28,11 @@ namespace ISOBMFF{
         SetSequenceNumber( stream.ReadBigEndianUInt32() );
     }
 
+    void MFHD::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+        sink.WriteBigEndianUInt32(GetSequenceNumber());
+    }
+
     KeyValueStringList MFHD::GetDisplayableProperties() const {
         auto props = FullBox::GetDisplayableProperties();
         props.push_back( { "Sequence_Number", std::to_string( GetSequenceNumber() ) } );
@@ -29,6 +29,8 @@
  */
 
 #include <ISOBMFF/MVHD.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <cstring>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::MVHD >::IMPL
@@ -98,6 +100,40 @@ namespace ISOBMFF
         this->SetNextTrackID( stream.ReadBigEndianUInt32() );
     }
     
+    void MVHD::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        if( this->GetVersion() == 1 )
+        {
+            sink.WriteBigEndianUInt64( this->GetCreationTime() );
+            sink.WriteBigEndianUInt64( this->GetModificationTime() );
+            sink.WriteBigEndianUInt32( this->GetTimescale() );
+            sink.WriteBigEndianUInt64( this->GetDuration() );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetCreationTime() ) );
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetModificationTime() ) );
+            sink.WriteBigEndianUInt32( this->GetTimescale() );
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetDuration() ) );
+        }
+        
+        sink.WriteBigEndianUInt32( this->GetRate() );
+        sink.WriteBigEndianUInt16( this->GetVolume() );
+        sink.WriteBigEndianUInt16( this->impl->_reserved1 );
+        sink.WriteBigEndianUInt32( this->impl->_reserved2[ 0 ] );
+        sink.WriteBigEndianUInt32( this->impl->_reserved2[ 1 ] );
+        sink.WriteMatrix( this->GetMatrix() );
+        
+        for( uint32_t predefined: this->impl->_predefined )
+        {
+            sink.WriteBigEndianUInt32( predefined );
+        }
+        
+        sink.WriteBigEndianUInt32( this->GetNextTrackID() );
+    }
+    
     std::vector< std::pair< std::string, std::string > > MVHD::GetDisplayableProperties( void ) const
     {
         auto props( FullBox::GetDisplayableProperties() );
@@ -0,0 +1,384 @@
+#include "NalConverter.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NAL_SIMD 1
+#include <immintrin.h>
+#else
+#define NAL_SIMD 0
+#endif
+
+namespace {
+    constexpr size_t StartCodeSize = 4;
+
+    // Position of the first 00 00 01 in p[0, n), or n
+    using FindFunction = size_t (*)(const uint8_t *p, size_t n);
+
+    size_t findStartCodeScalar(const uint8_t *p, size_t n, size_t i) {
+        // Looks at the last byte of each candidate first: anything above 1 skips three positions
+        while (i + 2 < n) {
+            if (p[i + 2] > 1) {
+                i += 3;
+            } else if (p[i + 2] == 0) {
+                ++i;
+            } else if (p[i] == 0 && p[i + 1] == 0) {
+                return i;
+            } else {
+                i += 3;
+            }
+        }
+        return n;
+    }
+
+    size_t findStartCodePortable(const uint8_t *p, size_t n) {
+        return findStartCodeScalar(p, n, 0);
+    }
+
+#if NAL_SIMD
+    // A start code at i needs a zero at i: blocks without zero bytes are skipped with a single compare.
+    __attribute__((target("sse2")))
+    size_t findStartCodeSse2(const uint8_t *p, size_t n) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi8(1);
+        size_t i = 0;
+        for (; i + 16 + 2 <= n; i += 16) {
+            __m128i z0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), zero);
+            if (_mm_movemask_epi8(z0) == 0) {
+                continue;
+            }
+            __m128i z1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 1)), zero);
+            __m128i o2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 2)), one);
+            int mask = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(z0, z1), o2));
+            if (mask != 0) {
+                return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+            }
+        }
+        return findStartCodeScalar(p, n, i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t findStartCodeAvx2(const uint8_t *p, size_t n) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi8(1);
+        size_t i = 0;
+        for (; i + 32 + 2 <= n; i += 32) {
+            __m256i z0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), zero);
+            if (_mm256_movemask_epi8(z0) == 0) {
+                continue;
+            }
+            __m256i z1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 1)), zero);
+            __m256i o2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 2)), one);
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(z0, z1), o2)));
+            if (mask != 0) {
+                return i + static_cast<size_t>(__builtin_ctz(mask));
+            }
+        }
+        return findStartCodeScalar(p, n, i);
+    }
+#endif
+
+    // The scanner of the given kind, or nullptr if the build or the CPU does not have it
+    FindFunction findFunction(NalConverter::Scanner scanner) {
+        switch (scanner) {
+        case NalConverter::Scanner::Scalar:
+            return findStartCodePortable;
+#if NAL_SIMD
+        case NalConverter::Scanner::Sse2:
+            return __builtin_cpu_supports("sse2") ? findStartCodeSse2 : nullptr;
+        case NalConverter::Scanner::Avx2:
+            return __builtin_cpu_supports("avx2") ? findStartCodeAvx2 : nullptr;
+#endif
+        default:
+            return nullptr;
+        }
+    }
+
+    FindFunction selectFindFunction() {
+#if NAL_SIMD
+        if (__builtin_cpu_supports("avx2")) {
+            return findStartCodeAvx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return findStartCodeSse2;
+        }
+#endif
+        return findStartCodePortable;
+    }
+
+    const FindFunction scanStartCode = selectFindFunction();
+
+    struct Nal {
+        size_t offset;   // Of the payload
+        size_t size;
+    };
+
+    void writeLength(uint8_t *p, size_t lengthSize, size_t length) {
+        for (size_t i = lengthSize; i > 0; --i) {
+            p[i - 1] = static_cast<uint8_t>(length);
+            length >>= 8;
+        }
+    }
+
+    void writeStartCode(uint8_t *p) {
+        p[0] = 0;
+        p[1] = 0;
+        p[2] = 0;
+        p[3] = 1;
+    }
+}
+
+
+struct NalConverter::Private {
+    Private(size_t lengthSize, std::shared_ptr<const std::vector<uint8_t>> parameterSets)
+        : m_lengthSize(lengthSize), m_parameterSets(std::move(parameterSets)) {}
+
+    size_t m_lengthSize;
+    std::shared_ptr<const std::vector<uint8_t>> m_parameterSets;
+    std::vector<Nal> m_nals;    // Reused between calls
+
+    void parseLengthPrefixed(const uint8_t *data, size_t size) {
+        m_nals.clear();
+        size_t i = 0;
+        while (i < size) {
+            if (size - i < m_lengthSize) {
+                throw std::runtime_error("Truncated NAL unit length at offset " + std::to_string(i));
+            }
+            size_t length = 0;
+            for (size_t j = 0; j < m_lengthSize; ++j) {
+                length = (length << 8) | data[i + j];
+            }
+            i += m_lengthSize;
+            if (length > size - i) {
+                throw std::runtime_error("NAL unit of " + std::to_string(length) + " bytes overruns the sample at offset " + std::to_string(i));
+            }
+            m_nals.push_back({i, length});
+            i += length;
+        }
+    }
+
+    void parseAnnexB(const uint8_t *data, size_t size) {
+        m_nals.clear();
+        size_t start = scanStartCode(data, size);
+        for (size_t i = 0; i < start; ++i) {
+            if (data[i] != 0) {
+                throw std::runtime_error("Annex-B data does not start with a start code");
+            }
+        }
+        while (start < size) {
+            size_t payload = start + 3;
+            size_t next = payload + scanStartCode(data + payload, size - payload);
+            size_t end = next;
+            // Zero bytes before a start code are trailing_zero_8bits or the first byte of a 4-byte start code
+            while (end > payload && data[end - 1] == 0) {
+                --end;
+            }
+            if (end > payload) {
+                m_nals.push_back({payload, end - payload});
+            }
+            start = next;
+        }
+    }
+
+    size_t outputSize(size_t prefixSize) const {
+        size_t total = 0;
+        for (const auto &nal : m_nals) {
+            total += prefixSize + nal.size;
+        }
+        return total;
+    }
+
+    // Moves the parsed NAL units of data to their place in the output and writes their prefixes.
+    // A NAL unit that moves towards the front never overwrites unread data when the units are handled front
+    // to back, nor one that moves towards the back when handled back to front. When both happen, the data
+    // is first shifted back so that every unit moves towards the front.
+    size_t rewrite(uint8_t *data, size_t size, size_t capacity, size_t prefixSize, bool startCodes) {
+        size_t total = 0;
+        ptrdiff_t minDelta = 0, maxDelta = 0;
+        for (const auto &nal : m_nals) {
+            ptrdiff_t delta = static_cast<ptrdiff_t>(total + prefixSize) - static_cast<ptrdiff_t>(nal.offset);
+            minDelta = std::min(minDelta, delta);
+            maxDelta = std::max(maxDelta, delta);
+            total += prefixSize + nal.size;
+        }
+        if (total > capacity) {
+            throw std::runtime_error("Converted sample needs " + std::to_string(total) + " bytes, buffer has " + std::to_string(capacity));
+        }
+        if (maxDelta > 0 && minDelta < 0) {
+            size_t shift = static_cast<size_t>(maxDelta);
+            if (size + shift > capacity) {
+                throw std::runtime_error("In place conversion needs " + std::to_string(size + shift) + " bytes, buffer has " + std::to_string(capacity));
+            }
+            std::memmove(data + shift, data, size);
+            for (auto &nal : m_nals) {
+                nal.offset += shift;
+            }
+            maxDelta = 0;
+        }
+        auto prefix = [&](uint8_t *p, size_t length) {
+            if (startCodes) {
+                writeStartCode(p);
+            } else {
+                writeLength(p, prefixSize, length);
+            }
+        };
+        if (maxDelta <= 0) {
+            size_t out = 0;
+            for (const auto &nal : m_nals) {
+                prefix(data + out, nal.size);
+                out += prefixSize;
+                if (out != nal.offset) {
+                    std::memmove(data + out, data + nal.offset, nal.size);
+                }
+                out += nal.size;
+            }
+        } else {
+            size_t out = total;
+            for (auto it = m_nals.rbegin(); it != m_nals.rend(); ++it) {
+                out -= it->size;
+                if (out != it->offset) {
+                    std::memmove(data + out, data + it->offset, it->size);
+                }
+                out -= prefixSize;
+                prefix(data + out, it->size);
+            }
+        }
+        return total;
+    }
+
+    size_t copy(const uint8_t *src, uint8_t *dst, size_t capacity, size_t prefixSize, bool startCodes) const {
+        size_t total = outputSize(prefixSize);
+        if (total > capacity) {
+            throw std::runtime_error("Converted sample needs " + std::to_string(total) + " bytes, buffer has " + std::to_string(capacity));
+        }
+        uint8_t *out = dst;
+        for (const auto &nal : m_nals) {
+            if (startCodes) {
+                writeStartCode(out);
+            } else {
+                writeLength(out, prefixSize, nal.size);
+            }
+            std::memcpy(out + prefixSize, src + nal.offset, nal.size);
+            out += prefixSize + nal.size;
+        }
+        return total;
+    }
+
+    void checkLengths() const {
+        if (m_lengthSize >= sizeof(size_t)) {
+            return;
+        }
+        size_t limit = (static_cast<size_t>(1) << (8 * m_lengthSize)) - 1;
+        for (const auto &nal : m_nals) {
+            if (nal.size > limit) {
+                throw std::runtime_error("NAL unit of " + std::to_string(nal.size) + " bytes does not fit a " + std::to_string(m_lengthSize) + "-byte length");
+            }
+        }
+    }
+};
+
+
+NalConverter::NalConverter(size_t lengthSize) {
+    if (lengthSize != 1 && lengthSize != 2 && lengthSize != 4) {
+        throw std::runtime_error("Unsupported NAL unit length size " + std::to_string(lengthSize));
+    }
+    m_impl = std::make_unique<Private>(lengthSize, std::make_shared<const std::vector<uint8_t>>());
+}
+
+NalConverter::NalConverter(const ISOBMFF::AVCC &avcc) : NalConverter(static_cast<size_t>(avcc.GetLengthSizeMinusOne()) + 1) {
+    m_impl->m_parameterSets = avcc.GetParameterSets();
+}
+
+NalConverter::NalConverter(const ISOBMFF::HVCC &hvcc) : NalConverter(static_cast<size_t>(hvcc.GetLengthSizeMinusOne()) + 1) {
+    m_impl->m_parameterSets = hvcc.GetParameterSets();
+}
+
+NalConverter::~NalConverter() = default;
+
+size_t NalConverter::lengthSize() const {
+    return m_impl->m_lengthSize;
+}
+
+const std::shared_ptr<const std::vector<uint8_t>> &NalConverter::parameterSets() const {
+    return m_impl->m_parameterSets;
+}
+
+size_t NalConverter::annexBSize(const uint8_t *data, size_t size) {
+    m_impl->parseLengthPrefixed(data, size);
+    return m_impl->outputSize(StartCodeSize);
+}
+
+size_t NalConverter::lengthPrefixedSize(const uint8_t *data, size_t size) {
+    m_impl->parseAnnexB(data, size);
+    m_impl->checkLengths();
+    return m_impl->outputSize(m_impl->m_lengthSize);
+}
+
+size_t NalConverter::toAnnexB(uint8_t *data, size_t size, size_t capacity) {
+    if (m_impl->m_lengthSize == StartCodeSize) {
+        // Same sizes: the length fields are overwritten, the payloads stay in place
+        size_t i = 0;
+        while (i < size) {
+            if (size - i < StartCodeSize) {
+                throw std::runtime_error("Truncated NAL unit length at offset " + std::to_string(i));
+            }
+            size_t length = (static_cast<size_t>(data[i]) << 24) | (static_cast<size_t>(data[i + 1]) << 16)
+                          | (static_cast<size_t>(data[i + 2]) << 8) | data[i + 3];
+            if (length > size - i - StartCodeSize) {
+                throw std::runtime_error("NAL unit of " + std::to_string(length) + " bytes overruns the sample at offset " + std::to_string(i));
+            }
+            writeStartCode(data + i);
+            i += StartCodeSize + length;
+        }
+        return size;
+    }
+    m_impl->parseLengthPrefixed(data, size);
+    return m_impl->rewrite(data, size, capacity, StartCodeSize, true);
+}
+
+size_t NalConverter::toAnnexB(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity) {
+    m_impl->parseLengthPrefixed(src, size);
+    return m_impl->copy(src, dst, capacity, StartCodeSize, true);
+}
+
+size_t NalConverter::toAnnexBWithParameterSets(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity) {
+    const std::vector<uint8_t> &parameterSets = *m_impl->m_parameterSets;
+    if (capacity < parameterSets.size()) {
+        throw std::runtime_error("Converted sample needs more than " + std::to_string(capacity) + " bytes");
+    }
+    if (!parameterSets.empty()) {
+        std::memcpy(dst, parameterSets.data(), parameterSets.size());
+    }
+    return parameterSets.size() + toAnnexB(src, size, dst + parameterSets.size(), capacity - parameterSets.size());
+}
+
+size_t NalConverter::toLengthPrefixed(uint8_t *data, size_t size, size_t capacity) {
+    m_impl->parseAnnexB(data, size);
+    m_impl->checkLengths();
+    return m_impl->rewrite(data, size, capacity, m_impl->m_lengthSize, false);
+}
+
+size_t NalConverter::toLengthPrefixed(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity) {
+    m_impl->parseAnnexB(src, size);
+    m_impl->checkLengths();
+    return m_impl->copy(src, dst, capacity, m_impl->m_lengthSize, false);
+}
+
+const uint8_t *NalConverter::findStartCode(const uint8_t *begin, const uint8_t *end) {
+    return begin + scanStartCode(begin, static_cast<size_t>(end - begin));
+}
+
+bool NalConverter::isSupported(Scanner scanner) {
+    return findFunction(scanner) != nullptr;
+}
+
+const uint8_t *NalConverter::findStartCode(const uint8_t *begin, const uint8_t *end, Scanner scanner) {
+    FindFunction find = findFunction(scanner);
+    if (!find) {
+        throw std::runtime_error("Unsupported start code scanner " + std::to_string(static_cast<int>(scanner)));
+    }
+    return begin + find(begin, static_cast<size_t>(end - begin));
+}
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/PITM.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::PITM >::IMPL
@@ -64,6 +65,20 @@ namespace ISOBMFF
         }
     }
     
+    void PITM::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        if( this->GetVersion() == 0 )
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( this->GetItemID() ) );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( this->GetItemID() );
+        }
+    }
+    
     std::vector< std::pair< std::string, std::string > > PITM::GetDisplayableProperties( void ) const
     {
         auto props( FullBox::GetDisplayableProperties() );
@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/PIXI.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/Utils.hpp>
 
 template<>
@@ -66,6 +67,20 @@ namespace ISOBMFF
         }
     }
     
+    void PIXI::WriteData( BoxSink & sink ) const
+    {
+        auto channels( this->GetChannels() );
+        
+        FullBox::WriteData( sink );
+        
+        sink.WriteUInt8( static_cast< uint8_t >( channels.size() ) );
+        
+        for( const auto & channel: channels )
+        {
+            sink.WriteUInt8( channel->GetBitsPerChannel() );
+        }
+    }
+    
     void PIXI::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         FullBox::WriteDescription( os, indentLevel );
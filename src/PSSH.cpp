@@ -0,0 +1,92 @@
+#include <ISOBMFF/PSSH.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/Utils.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::PSSH >::IMPL
+{
+public:
+
+    IMPL()                  = default;
+    IMPL( const IMPL & o )  = default;
+    ~IMPL()                 = default;
+
+    std::vector<uint8_t> system_id;
+    std::vector<uint8_t> kids;
+    std::vector<uint8_t> data;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::PSSH
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF{
+
+    PSSH::PSSH() : FullBox("pssh") {
+
+    }
+
+    void PSSH::ReadData(IParser *parser, BinaryStream &stream) {
+        FullBox::ReadData(parser, stream);
+        impl->system_id.resize(16);
+        stream.Read(impl->system_id.data(), 16);
+        impl->kids.clear();
+        if (GetVersion() > 0) {
+            uint64_t count = stream.ReadBigEndianUInt32();
+            if (count * 16 > stream.GetBytesAvailable()) {
+                throw std::runtime_error("pssh KID count exceeds the box size");
+            }
+            impl->kids.resize(static_cast<size_t>(count * 16));
+            stream.Read(impl->kids.data(), impl->kids.size());
+        }
+        uint32_t size = stream.ReadBigEndianUInt32();
+        if (size > stream.GetBytesAvailable()) {
+            throw std::runtime_error("pssh data size exceeds the box size");
+        }
+        impl->data.resize(size);
+        stream.Read(impl->data.data(), size);
+    }
+
+    void PSSH::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+        sink.Write(impl->system_id);
+        if (GetVersion() > 0) {
+            sink.WriteBigEndianUInt32(static_cast<uint32_t>(impl->kids.size() / 16));
+            sink.Write(impl->kids);
+        }
+        sink.WriteBigEndianUInt32(static_cast<uint32_t>(impl->data.size()));
+        sink.Write(impl->data);
+    }
+
+    KeyValueStringList PSSH::GetDisplayableProperties() const {
+        auto props = FullBox::GetDisplayableProperties();
+        props.push_back( { "SystemID", Utils::ToHexString( GetSystemID() ) } );
+        for (uint32_t i = 0; i < GetKIDCount(); ++i) {
+            std::vector<uint8_t> kid(impl->kids.begin() + i * 16, impl->kids.begin() + (i + 1) * 16);
+            props.push_back( { "KID[" + std::to_string(i) + "]", Utils::ToHexString( kid ) } );
+        }
+        props.push_back( { "DataSize", std::to_string( impl->data.size() ) } );
+        return props;
+    }
+
+    void PSSH::WriteDescription(std::ostream &os, std::size_t indentLevel) const {
+        FullBox::WriteDescription( os, indentLevel );
+    }
+
+    const std::vector<uint8_t>& PSSH::GetSystemID() const {
+        return impl->system_id;
+    }
+
+    uint32_t PSSH::GetKIDCount() const {
+        return static_cast<uint32_t>(impl->kids.size() / 16);
+    }
+
+    const std::vector<uint8_t>& PSSH::GetKIDs() const {
+        return impl->kids;
+    }
+
+    const std::vector<uint8_t>& PSSH::GetSystemData() const {
+        return impl->data;
+    }
+}
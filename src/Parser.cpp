@@ -32,7 +32,10 @@
 #include <ISOBMFF/BinaryStream.hpp>
 #include <ISOBMFF/Boxes.h>
 #include <map>
+#include <fstream>
+#include <algorithm>
 #include <stdexcept>
+#include <cstring>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::Parser >::IMPL
@@ -46,18 +49,33 @@ class XS::PIMPL::Object< ISOBMFF::Parser >::IMPL
         void RegisterBox( const std::string & type, const std::function< std::shared_ptr< ISOBMFF::Box >( void ) > & createBox );
         void RegisterContainerBox( const std::string & type );
         void RegisterDefaultBoxes( void );
+        void ParseMetadata( ISOBMFF::Parser * parser, const std::string & path );
+        void ParseSampleDescriptions( ISOBMFF::Parser * parser, const std::string & path );
+        void ReadSampleDescriptions( ISOBMFF::Parser * parser, std::ifstream & in, ISOBMFF::ContainerBox & container, uint64_t offset, uint64_t end, size_t depth );
+        void Open( std::ifstream & in, const std::string & path );
+        uint64_t ReadBoxHeader( std::ifstream & in, uint64_t offset, uint64_t end, std::string & name, uint64_t & headerLength );
+        const uint8_t * Fetch( std::ifstream & in, uint64_t offset, uint64_t length );
+        
+        /* Files are read in one go up to this size by ParseMetadata and ParseSampleDescriptions */
+        static const uint64_t HeadSize = 16 * 1024;
         
         std::shared_ptr< ISOBMFF::File >                                                  _file;
         std::string                                                                       _path;
+        uint64_t                                                                          _fileSize;
         std::map< std::string, std::function< std::shared_ptr< ISOBMFF::Box >( void ) > > _types;
         ISOBMFF::Parser::StringType                                                       _stringType;
         uint64_t                                                                          _options;
+        uint64_t                                                                          _skipThreshold;
         std::map< std::string, void * >                                                   _info;
+        std::vector< uint8_t >                                                            _head;
+        std::vector< uint8_t >                                                            _extra;
 };
 
 #define XS_PIMPL_CLASS ISOBMFF::Parser
 #include <XS/PIMPL/Object-IMPL.hpp>
 
+const uint64_t XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::HeadSize;
+
 namespace ISOBMFF
 {
     Parser::Parser( void ): XS::PIMPL::Object< Parser >()
@@ -80,46 +98,112 @@ namespace ISOBMFF
     
 std::shared_ptr< Box > Parser::CreateBox( const std::string & type ) const
     {
-        for( const auto & p: this->impl->_types )
+        auto it = this->impl->_types.find( type );
+        
+        if( it != this->impl->_types.end() && it->second != nullptr )
+        {
+            return it->second();
+        }
+        
+        return std::make_shared< Box >( type );
+    }
+    
+    bool Parser::ShouldSkipBoxData( const std::string & type, uint64_t length ) const
+    {
+        static const char * const payloadBoxes[] = { "mdat", "free", "skip", "wide", "idat" };
+        
+        if( type == "mdat" && ( this->impl->_options & static_cast< uint64_t >( Options::SkipMDATData ) ) != 0 )
         {
-            if( p.first == type && p.second != nullptr )
+            return true;
+        }
+        
+        if( ( this->impl->_options & static_cast< uint64_t >( Options::SkipLargeBoxData ) ) == 0 || length <= this->impl->_skipThreshold )
+        {
+            return false;
+        }
+        
+        for( const auto payloadBox: payloadBoxes )
+        {
+            if( type == payloadBox )
             {
-                return p.second();
+                return true;
             }
         }
         
-        return std::make_shared< Box >( type );
+        return this->impl->_types.find( type ) == this->impl->_types.end();
+    }
+    
+    uint64_t Parser::GetSkipThreshold( void ) const
+    {
+        return this->impl->_skipThreshold;
+    }
+    
+    void Parser::SetSkipThreshold( uint64_t value )
+    {
+        this->impl->_skipThreshold = value;
     }
     
     void Parser::Parse( const std::string & path ) ISOBMFF_NOEXCEPT( false )
     {
-        char         n[ 4 ] = { 0, 0, 0, 0 };
+        if( this->HasOption( Options::StopAfterMETA ) )
+        {
+            this->impl->ParseMetadata( this, path );
+            
+            return;
+        }
+        
+        if( this->HasOption( Options::StopAfterMOOV ) )
+        {
+            this->impl->ParseSampleDescriptions( this, path );
+            
+            return;
+        }
+        
         BinaryStream stream( path );
+        uint8_t      header[ 16 ];
+        uint64_t     size;
         
         if( stream.HasBytesAvailable() == false )
         {
             throw std::runtime_error( std::string( "Cannot read file: " ) + path );
         }
         
-        try
+        this->impl->_fileSize = stream.GetBytesAvailable();
+        
+        /*
+         * Top-level boxes are read directly, whatever their type: media
+         * segments may start with styp or moof. Only the first box header
+         * is checked, so that other files are not read as boxes.
+         */
+        if( this->impl->_fileSize < 8 )
         {
-            stream.Get( reinterpret_cast< uint8_t * >( n ), 4, 4 );
+            throw std::runtime_error( std::string( "Not an ISO base media file: " ) + path );
         }
-        catch( ... )
-        {}
         
-        size_t count = 0;
-        while( strncmp( n, "ftyp", 4 ) != 0 && strncmp( n, "sinf", 4 ) != 0 && strncmp( n, "sidx", 4 ) != 0) {
-            if ( count % (4 * 100)) {
-                std::cout << "Pos: " << count << '\n';
-            }
-            count += 1;
-            try
+        stream.Get( header, 0, 8 );
+        
+        size = ( static_cast< uint64_t >( header[ 0 ] ) << 24 ) | ( static_cast< uint64_t >( header[ 1 ] ) << 16 )
+             | ( static_cast< uint64_t >( header[ 2 ] ) << 8 )  |   static_cast< uint64_t >( header[ 3 ] );
+        
+        if( size == 1 && this->impl->_fileSize >= 16 )
+        {
+            stream.Get( header + 8, 8, 8 );
+            
+            size = 0;
+            
+            for( size_t i = 8; i < 16; i++ )
             {
-                stream.Get( reinterpret_cast< uint8_t * >( n ), count, 4 );
+                size = ( size << 8 ) | header[ i ];
             }
-            catch( ... )
-            {}
+        }
+        else if( size == 0 )
+        {
+            size = this->impl->_fileSize;
+        }
+        
+        if( size < 8 || size > this->impl->_fileSize )
+        {
+            throw std::runtime_error( std::string( "Not an ISO base media file: " ) + path );
         }
         
         this->impl->_path = path;
@@ -136,6 +220,77 @@ std::shared_ptr< Box > Parser::CreateBox( const std::string & type ) const
         return this->impl->_file;
     }
     
+    std::string Parser::GetPath( void ) const
+    {
+        return this->impl->_path;
+    }
+    
+    std::vector< std::pair< uint64_t, uint64_t > > Parser::GetItemDataRanges( uint32_t itemID ) const ISOBMFF_NOEXCEPT( false )
+    {
+        std::shared_ptr< META > meta;
+        std::shared_ptr< ILOC > iloc;
+        
+        if( this->impl->_file != nullptr )
+        {
+            meta = this->impl->_file->GetTypedBox< META >( "meta" );
+        }
+        
+        if( meta != nullptr )
+        {
+            iloc = meta->GetTypedBox< ILOC >( "iloc" );
+        }
+        
+        if( iloc == nullptr )
+        {
+            throw std::runtime_error( "No item locations in file: " + this->impl->_path );
+        }
+        
+        return iloc->GetItemDataRanges( itemID, meta->GetBox( "idat" ).get(), this->impl->_fileSize );
+    }
+    
+    std::vector< uint8_t > Parser::GetItemData( uint32_t itemID ) const ISOBMFF_NOEXCEPT( false )
+    {
+        std::vector< std::pair< uint64_t, uint64_t > > ranges;
+        std::vector< uint8_t >                         data;
+        uint64_t                                       size;
+        
+        ranges = this->GetItemDataRanges( itemID );
+        size   = 0;
+        
+        for( const auto & range: ranges )
+        {
+            size += range.second;
+        }
+        
+        data.resize( static_cast< size_t >( size ) );
+        
+        if( size == 0 )
+        {
+            return data;
+        }
+        
+        {
+            BinaryStream stream( this->impl->_path );
+            uint8_t    * p;
+            
+            if( stream.GetBytesAvailable() != this->impl->_fileSize )
+            {
+                throw std::runtime_error( std::string( "File changed since it was parsed: " ) + this->impl->_path );
+            }
+            
+            p = &( data[ 0 ] );
+            
+            for( const auto & range: ranges )
+            {
+                stream.Get( p, range.first, range.second );
+                
+                p += range.second;
+            }
+        }
+        
+        return data;
+    }
+    
     Parser::StringType Parser::GetPreferredStringType( void ) const
     {
         return this->impl->_stringType;
@@ -195,8 +350,10 @@ std::shared_ptr< Box > Parser::CreateBox( const std::string & type ) const
 }
 
 XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::IMPL( void ):
+    _fileSize( 0 ),
     _stringType( ISOBMFF::Parser::StringType::NULLTerminated ),
-    _options( 0 )
+    _options( 0 ),
+    _skipThreshold( 1024 * 1024 )
 {
     this->RegisterDefaultBoxes();
 }
@@ -204,9 +361,11 @@ XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::IMPL( void ):
 XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::IMPL( const IMPL & o ):
     _file( o._file ),
     _path( o._path ),
+    _fileSize( o._fileSize ),
     _types( o._types ),
     _stringType( o._stringType ),
     _options( o._options ),
+    _skipThreshold( o._skipThreshold ),
     _info( o._info )
 {
     this->RegisterDefaultBoxes();
@@ -215,6 +374,224 @@ XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::IMPL( const IMPL & o ):
 XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::~IMPL( void )
 {}
 
+void XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::ParseMetadata( ISOBMFF::Parser * parser, const std::string & path )
+{
+    std::ifstream in;
+    uint64_t      offset;
+    
+    this->Open( in, path );
+    
+    offset = 0;
+    
+    while( this->_fileSize - offset >= 8 )
+    {
+        const uint8_t        * data;
+        uint64_t               length;
+        uint64_t               headerLength;
+        std::string            name;
+        std::shared_ptr< ISOBMFF::Box > box;
+        
+        length = this->ReadBoxHeader( in, offset, this->_fileSize, name, headerLength );
+        
+        if( name == "ftyp" || name == "meta" )
+        {
+            ISOBMFF::BinaryStream stream;
+            
+            data = this->Fetch( in, offset + headerLength, length - headerLength );
+            
+            stream.SetView( data, length - headerLength, offset + headerLength );
+            
+            box = parser->CreateBox( name );
+            
+            box->SetDataLocation( offset + headerLength, length - headerLength );
+            box->ReadData( parser, stream );
+        }
+        else
+        {
+            box = std::make_shared< ISOBMFF::Box >( name );
+            
+            box->SetDataLocation( offset + headerLength, length - headerLength, true );
+        }
+        
+        this->_file->AddBox( box );
+        
+        offset += length;
+        
+        if( name == "meta" )
+        {
+            return;
+        }
+    }
+    
+    throw std::runtime_error( "No meta box in file: " + path );
+}
+
+void XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::ParseSampleDescriptions( ISOBMFF::Parser * parser, const std::string & path )
+{
+    std::ifstream in;
+    
+    this->Open( in, path );
+    this->ReadSampleDescriptions( parser, in, *( this->_file ), 0, this->_fileSize, 0 );
+    
+    if( this->_file->GetBox( "moov" ) == nullptr )
+    {
+        throw std::runtime_error( "No moov box in file: " + path );
+    }
+}
+
+void XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::ReadSampleDescriptions( ISOBMFF::Parser * parser, std::ifstream & in, ISOBMFF::ContainerBox & container, uint64_t offset, uint64_t end, size_t depth )
+{
+    /* Boxes on the way to stsd, by depth: only these are read */
+    static const char * const names[] = { "moov", "trak", "mdia", "minf", "stbl", "stsd" };
+    static const size_t       stsdDepth = sizeof( names ) / sizeof( names[ 0 ] ) - 1;
+    
+    while( end - offset >= 8 )
+    {
+        uint64_t                                length;
+        uint64_t                                headerLength;
+        std::string                             name;
+        std::shared_ptr< ISOBMFF::Box >         box;
+        std::shared_ptr< ISOBMFF::ContainerBox > child;
+        
+        length = this->ReadBoxHeader( in, offset, end, name, headerLength );
+        
+        if( name == names[ depth ] )
+        {
+            box = parser->CreateBox( name );
+        }
+        
+        if( box != nullptr && depth == stsdDepth )
+        {
+            ISOBMFF::BinaryStream stream;
+            const uint8_t       * data;
+            
+            data = this->Fetch( in, offset + headerLength, length - headerLength );
+            
+            stream.SetView( data, length - headerLength, offset + headerLength );
+            box->SetDataLocation( offset + headerLength, length - headerLength );
+            box->ReadData( parser, stream );
+        }
+        else if( box != nullptr && ( child = std::dynamic_pointer_cast< ISOBMFF::ContainerBox >( box ) ) != nullptr )
+        {
+            box->SetDataLocation( offset + headerLength, length - headerLength );
+            this->ReadSampleDescriptions( parser, in, *( child ), offset + headerLength, offset + length, depth + 1 );
+        }
+        else
+        {
+            box = std::make_shared< ISOBMFF::Box >( name );
+            
+            box->SetDataLocation( offset + headerLength, length - headerLength, true );
+        }
+        
+        container.AddBox( box );
+        
+        offset += length;
+        
+        if( depth == 0 && name == "moov" )
+        {
+            return;
+        }
+    }
+}
+
+void XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::Open( std::ifstream & in, const std::string & path )
+{
+    /* Reads go straight to our buffers */
+    in.rdbuf()->pubsetbuf( nullptr, 0 );
+    in.open( path, std::ios::binary );
+    
+    if( in.good() == false )
+    {
+        throw std::runtime_error( std::string( "Cannot read file: " ) + path );
+    }
+    
+    in.seekg( 0, std::ios::end );
+    
+    this->_fileSize = static_cast< uint64_t >( in.tellg() );
+    
+    if( this->_fileSize == 0 )
+    {
+        throw std::runtime_error( std::string( "Cannot read file: " ) + path );
+    }
+    
+    in.seekg( 0, std::ios::beg );
+    
+    /* A single read of the file head usually covers ftyp and meta, or a faststart moov */
+    this->_head.resize( static_cast< size_t >( std::min( this->_fileSize, HeadSize ) ) );
+    
+    if( this->_head.empty() == false )
+    {
+        in.read( reinterpret_cast< char * >( &( this->_head[ 0 ] ) ), static_cast< std::streamsize >( this->_head.size() ) );
+    }
+    
+    this->_path = path;
+    this->_file = std::make_shared< ISOBMFF::File >();
+}
+
+uint64_t XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::ReadBoxHeader( std::ifstream & in, uint64_t offset, uint64_t end, std::string & name, uint64_t & headerLength )
+{
+    const uint8_t * header;
+    uint64_t        length;
+    
+    header       = this->Fetch( in, offset, std::min< uint64_t >( 16, end - offset ) );
+    length       = ( static_cast< uint64_t >( header[ 0 ] ) << 24 ) | ( static_cast< uint64_t >( header[ 1 ] ) << 16 )
+                 | ( static_cast< uint64_t >( header[ 2 ] ) << 8 )  |   static_cast< uint64_t >( header[ 3 ] );
+    name         = std::string( reinterpret_cast< const char * >( header + 4 ), 4 );
+    headerLength = 8;
+    
+    if( length == 1 )
+    {
+        if( end - offset < 16 )
+        {
+            throw std::runtime_error( "Truncated box header in file: " + this->_path );
+        }
+        
+        length = 0;
+        
+        for( int i = 8; i < 16; i++ )
+        {
+            length = ( length << 8 ) | header[ i ];
+        }
+        
+        headerLength = 16;
+    }
+    else if( length == 0 )
+    {
+        length = end - offset;
+    }
+    
+    if( length < headerLength || length > end - offset )
+    {
+        throw std::runtime_error( "Invalid size for box " + name + " in file: " + this->_path );
+    }
+    
+    return length;
+}
+
+const uint8_t * XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::Fetch( std::ifstream & in, uint64_t offset, uint64_t length )
+{
+    if( offset + length <= this->_head.size() )
+    {
+        return this->_head.data() + offset;
+    }
+    
+    this->_extra.resize( static_cast< size_t >( length ) );
+    
+    if( length > 0 )
+    {
+        in.clear();
+        in.seekg( static_cast< std::streamoff >( offset ), std::ios::beg );
+        in.read( reinterpret_cast< char * >( &( this->_extra[ 0 ] ) ), static_cast< std::streamsize >( length ) );
+        
+        if( static_cast< uint64_t >( in.gcount() ) != length )
+        {
+            throw std::runtime_error( "Cannot read file: " + this->_path );
+        }
+    }
+    
+    return this->_extra.data();
+}
+
 void XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::RegisterBox( const std::string & type, const std::function< std::shared_ptr< ISOBMFF::Box >( void ) > & createBox )
 {
     if( type.size() != 4 )
@@ -278,6 +655,7 @@ void XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::RegisterDefaultBoxes( void )
     this->RegisterBox( "infe", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::INFE >(); } );
     this->RegisterBox( "irot", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::IROT >(); } );
     this->RegisterBox( "hvcC", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::HVCC >(); } );
+    this->RegisterBox( "avcC", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::AVCC >(); } );
     this->RegisterBox( "dimg", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::DIMG >(); } );
     this->RegisterBox( "thmb", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::THMB >(); } );
     this->RegisterBox( "cdsc", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::CDSC >(); } );
@@ -287,8 +665,35 @@ void XS::PIMPL::Object< ISOBMFF::Parser >::IMPL::RegisterDefaultBoxes( void )
     this->RegisterBox( "pixi", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::PIXI >(); } );
     this->RegisterBox( "ipco", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::IPCO >(); } );
     this->RegisterBox( "stsd", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::STSD >(); } );
+    this->RegisterBox( "avc1", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::VisualSampleEntry >( "avc1" ); } );
+    this->RegisterBox( "avc3", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::VisualSampleEntry >( "avc3" ); } );
+    this->RegisterBox( "hvc1", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::VisualSampleEntry >( "hvc1" ); } );
+    this->RegisterBox( "hev1", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::VisualSampleEntry >( "hev1" ); } );
+    this->RegisterBox( "encv", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::VisualSampleEntry >( "encv" ); } );
+    this->RegisterBox( "mp4a", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::AudioSampleEntry >( "mp4a" ); } );
+    this->RegisterBox( "enca", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::AudioSampleEntry >( "enca" ); } );
+    this->RegisterBox( "esds", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::ESDS >(); } );
     this->RegisterBox( "sidx", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::SIDX >(); } );
     this->RegisterBox( "frma", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::FRMA >(); } );
     this->RegisterBox( "schm", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::SCHM >(); } );
     this->RegisterBox( "trun", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::TRUN >(); } );
+    this->RegisterBox( "tfhd", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::TFHD >(); } );
+    this->RegisterBox( "tfdt", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::TFDT >(); } );
+    this->RegisterBox( "tenc", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::TENC >(); } );
+    this->RegisterBox( "pssh", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::PSSH >(); } );
+    this->RegisterBox( "senc", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::SENC >(); } );
+    this->RegisterBox( "saiz", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::SAIZ >(); } );
+    this->RegisterBox( "saio", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::SAIO >(); } );
+    this->RegisterBox( "mdhd", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::MDHD >(); } );
+    this->RegisterBox( "stts", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::STTS >(); } );
+    this->RegisterBox( "ctts", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::CTTS >(); } );
+    this->RegisterBox( "stss", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::STSS >(); } );
+    this->RegisterBox( "stsz", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::STSZ >( "stsz" ); } );
+    this->RegisterBox( "stz2", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::STSZ >( "stz2" ); } );
+    this->RegisterBox( "stsc", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::STSC >(); } );
+    this->RegisterBox( "stco", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::STCO >( "stco" ); } );
+    this->RegisterBox( "co64", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::STCO >( "co64" ); } );
+    this->RegisterBox( "mehd", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::MEHD >(); } );
+    this->RegisterBox( "trex", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::TREX >(); } );
+    this->RegisterBox( "elst", [ = ]( void ) -> std::shared_ptr< ISOBMFF::Box > { return std::make_shared< ISOBMFF::ELST >(); } );
 }
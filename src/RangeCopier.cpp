@@ -0,0 +1,138 @@
+#include "RangeCopier.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+namespace {
+    // Largest copy per system call, below the 0x7ffff000 bytes Linux transfers at most
+    constexpr uint64_t MaxCopySize = 1 << 30;
+    constexpr size_t BufferSize = 1 << 20;
+
+    bool isUnsupportedCopy(int error) {
+        return error == EINVAL || error == EXDEV || error == ENOSYS || error == EOPNOTSUPP || error == EBADF;
+    }
+}
+
+struct RangeCopier::Private {
+    enum class Method { CopyFileRange, SendFile, ReadWrite };
+
+    Method method{Method::CopyFileRange};
+    std::vector<uint8_t> buffer;
+
+    int pendingIn{-1};
+    int pendingOut{-1};
+    uint64_t pendingOffset{0};
+    uint64_t pendingLength{0};
+
+    uint64_t bytesCopied{0};
+    uint64_t copyCalls{0};
+
+    void copy(int in, uint64_t offset, uint64_t length, int out) {
+        while (length > 0) {
+            const size_t size = static_cast<size_t>(std::min(length, MaxCopySize));
+            ssize_t copied;
+#ifdef __linux__
+            if (method == Method::CopyFileRange) {
+                loff_t position = static_cast<loff_t>(offset);
+                copied = copy_file_range(in, &position, out, nullptr, size, 0);
+                if (copied < 0 && isUnsupportedCopy(errno)) {
+                    method = Method::SendFile;
+                    continue;
+                }
+            } else if (method == Method::SendFile) {
+                off_t position = static_cast<off_t>(offset);
+                copied = sendfile(out, in, &position, size);
+                if (copied < 0 && (errno == EINVAL || errno == ENOSYS)) {
+                    method = Method::ReadWrite;
+                    continue;
+                }
+            } else
+#endif
+            {
+                copied = readWrite(in, offset, size, out);
+            }
+            if (copied < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Cannot copy data: ") + strerror(errno));
+            }
+            if (copied == 0) {
+                throw std::runtime_error("Range past the end of the source file");
+            }
+            offset += static_cast<uint64_t>(copied);
+            length -= static_cast<uint64_t>(copied);
+            bytesCopied += static_cast<uint64_t>(copied);
+            copyCalls++;
+        }
+    }
+
+    // One buffer of data, written completely. Returns -1 with errno set, or 0 at the end of the source.
+    ssize_t readWrite(int in, uint64_t offset, size_t size, int out) {
+        buffer.resize(BufferSize);
+        ssize_t read = pread(in, buffer.data(), std::min(size, buffer.size()), static_cast<off_t>(offset));
+        if (read <= 0) {
+            return read;
+        }
+        for (ssize_t done = 0; done < read;) {
+            ssize_t written = write(out, buffer.data() + done, static_cast<size_t>(read - done));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            done += written;
+        }
+        return read;
+    }
+};
+
+RangeCopier::RangeCopier() : m_impl(new Private) {
+}
+
+RangeCopier::~RangeCopier() = default;
+
+void RangeCopier::copy(int in, uint64_t offset, uint64_t length, int out) {
+    flush();
+    m_impl->copy(in, offset, length, out);
+}
+
+void RangeCopier::add(int in, uint64_t offset, uint64_t length, int out) {
+    if (length == 0) {
+        return;
+    }
+    if (m_impl->pendingLength > 0 && in == m_impl->pendingIn && out == m_impl->pendingOut &&
+        m_impl->pendingOffset + m_impl->pendingLength == offset) {
+        m_impl->pendingLength += length;
+        return;
+    }
+    flush();
+    m_impl->pendingIn = in;
+    m_impl->pendingOut = out;
+    m_impl->pendingOffset = offset;
+    m_impl->pendingLength = length;
+}
+
+void RangeCopier::flush() {
+    if (m_impl->pendingLength > 0) {
+        const uint64_t length = m_impl->pendingLength;
+        m_impl->pendingLength = 0;
+        m_impl->copy(m_impl->pendingIn, m_impl->pendingOffset, length, m_impl->pendingOut);
+    }
+}
+
+uint64_t RangeCopier::bytesCopied() const {
+    return m_impl->bytesCopied;
+}
+
+uint64_t RangeCopier::copyCalls() const {
+    return m_impl->copyCalls;
+}
@@ -0,0 +1,105 @@
+#include <ISOBMFF/SAIO.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::SAIO >::IMPL
+{
+public:
+
+    IMPL()                  = default;
+    IMPL( const IMPL & o )  = default;
+    ~IMPL()                 = default;
+
+    uint32_t              aux_info_type{0};
+    uint32_t              aux_info_type_parameter{0};
+    std::vector<uint64_t> offsets;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::SAIO
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF{
+
+    SAIO::SAIO() : FullBox("saio") {
+
+    }
+
+    void SAIO::ReadData(IParser *parser, BinaryStream &stream) {
+        FullBox::ReadData(parser, stream);
+        impl->aux_info_type = 0;
+        impl->aux_info_type_parameter = 0;
+        if (GetFlags() & 1) {
+            impl->aux_info_type = stream.ReadBigEndianUInt32();
+            impl->aux_info_type_parameter = stream.ReadBigEndianUInt32();
+        }
+        uint64_t count = stream.ReadBigEndianUInt32();
+        uint64_t entrySize = GetVersion() == 0 ? 4 : 8;
+        if (count * entrySize > stream.GetBytesAvailable()) {
+            throw std::runtime_error("saio entry count exceeds the box size");
+        }
+        impl->offsets.resize(static_cast<size_t>(count));
+        for (auto &offset : impl->offsets) {
+            offset = GetVersion() == 0 ? stream.ReadBigEndianUInt32() : stream.ReadBigEndianUInt64();
+        }
+    }
+
+    void SAIO::WriteData(BoxSink &sink) const {
+        if (GetVersion() == 0 && NeedsLargeOffsets()) {
+            throw std::runtime_error("Offset too large for saio version 0");
+        }
+        FullBox::WriteData(sink);
+        if (GetFlags() & 1) {
+            sink.WriteBigEndianUInt32(impl->aux_info_type);
+            sink.WriteBigEndianUInt32(impl->aux_info_type_parameter);
+        }
+        sink.WriteBigEndianUInt32(static_cast<uint32_t>(impl->offsets.size()));
+        for (uint64_t offset : impl->offsets) {
+            if (GetVersion() == 0) {
+                sink.WriteBigEndianUInt32(static_cast<uint32_t>(offset));
+            } else {
+                sink.WriteBigEndianUInt64(offset);
+            }
+        }
+    }
+
+    KeyValueStringList SAIO::GetDisplayableProperties() const {
+        auto props = FullBox::GetDisplayableProperties();
+        props.push_back( { "AuxInfoType", std::to_string( GetAuxInfoType() ) } );
+        props.push_back( { "AuxInfoTypeParameter", std::to_string( GetAuxInfoTypeParameter() ) } );
+        for (size_t i = 0; i < impl->offsets.size(); ++i) {
+            props.push_back( { "Offset[" + std::to_string(i) + "]", std::to_string( impl->offsets[i] ) } );
+        }
+        return props;
+    }
+
+    void SAIO::WriteDescription(std::ostream &os, std::size_t indentLevel) const {
+        FullBox::WriteDescription( os, indentLevel );
+    }
+
+    uint32_t SAIO::GetAuxInfoType() const {
+        return impl->aux_info_type;
+    }
+
+    uint32_t SAIO::GetAuxInfoTypeParameter() const {
+        return impl->aux_info_type_parameter;
+    }
+
+    const std::vector<uint64_t>& SAIO::GetOffsets() const {
+        return impl->offsets;
+    }
+
+    void SAIO::SetOffsets(const std::vector<uint64_t> &offsets) {
+        impl->offsets = offsets;
+    }
+
+    bool SAIO::NeedsLargeOffsets() const {
+        for (uint64_t offset : impl->offsets) {
+            if (offset > 0xFFFFFFFF) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,99 @@
+#include <ISOBMFF/SAIZ.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::SAIZ >::IMPL
+{
+public:
+
+    IMPL()                  = default;
+    IMPL( const IMPL & o )  = default;
+    ~IMPL()                 = default;
+
+    uint32_t             aux_info_type{0};
+    uint32_t             aux_info_type_parameter{0};
+    uint8_t              default_sample_info_size{0};
+    uint32_t             sample_count{0};
+    std::vector<uint8_t> sample_info_sizes;     // Empty when default_sample_info_size is set
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::SAIZ
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF{
+
+    SAIZ::SAIZ() : FullBox("saiz") {
+
+    }
+
+    void SAIZ::ReadData(IParser *parser, BinaryStream &stream) {
+        FullBox::ReadData(parser, stream);
+        impl->aux_info_type = 0;
+        impl->aux_info_type_parameter = 0;
+        if (GetFlags() & 1) {
+            impl->aux_info_type = stream.ReadBigEndianUInt32();
+            impl->aux_info_type_parameter = stream.ReadBigEndianUInt32();
+        }
+        impl->default_sample_info_size = stream.ReadUInt8();
+        impl->sample_count = stream.ReadBigEndianUInt32();
+        impl->sample_info_sizes.clear();
+        if (impl->default_sample_info_size == 0) {
+            if (impl->sample_count > stream.GetBytesAvailable()) {
+                throw std::runtime_error("saiz sample count exceeds the box size");
+            }
+            impl->sample_info_sizes.resize(impl->sample_count);
+            stream.Read(impl->sample_info_sizes.data(), impl->sample_count);
+        }
+    }
+
+    void SAIZ::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+        if (GetFlags() & 1) {
+            sink.WriteBigEndianUInt32(impl->aux_info_type);
+            sink.WriteBigEndianUInt32(impl->aux_info_type_parameter);
+        }
+        sink.WriteUInt8(impl->default_sample_info_size);
+        sink.WriteBigEndianUInt32(impl->sample_count);
+        if (impl->default_sample_info_size == 0) {
+            sink.Write(impl->sample_info_sizes);
+        }
+    }
+
+    KeyValueStringList SAIZ::GetDisplayableProperties() const {
+        auto props = FullBox::GetDisplayableProperties();
+        props.push_back( { "AuxInfoType", std::to_string( GetAuxInfoType() ) } );
+        props.push_back( { "AuxInfoTypeParameter", std::to_string( GetAuxInfoTypeParameter() ) } );
+        props.push_back( { "DefaultSampleInfoSize", std::to_string( GetDefaultSampleInfoSize() ) } );
+        props.push_back( { "SampleCount", std::to_string( GetSampleCount() ) } );
+        return props;
+    }
+
+    void SAIZ::WriteDescription(std::ostream &os, std::size_t indentLevel) const {
+        FullBox::WriteDescription( os, indentLevel );
+    }
+
+    uint32_t SAIZ::GetAuxInfoType() const {
+        return impl->aux_info_type;
+    }
+
+    uint32_t SAIZ::GetAuxInfoTypeParameter() const {
+        return impl->aux_info_type_parameter;
+    }
+
+    uint8_t SAIZ::GetDefaultSampleInfoSize() const {
+        return impl->default_sample_info_size;
+    }
+
+    uint32_t SAIZ::GetSampleCount() const {
+        return impl->sample_count;
+    }
+
+    uint8_t SAIZ::GetSampleInfoSize(uint32_t index) const {
+        if (impl->default_sample_info_size != 0) {
+            return impl->default_sample_info_size;
+        }
+        return index < impl->sample_info_sizes.size() ? impl->sample_info_sizes[index] : 0;
+    }
+}
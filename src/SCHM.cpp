@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/SCHM.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/IParser.hpp>
 #include <cstdint>
 
@@ -74,6 +75,19 @@ namespace ISOBMFF
         }
     }
     
+    void SCHM::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteFourCC( this->GetSchemeType() );
+        sink.WriteBigEndianUInt32( this->GetSchemeVersion() );
+        
+        if( this->GetFlags() & 0x000001 )
+        {
+            sink.WriteNULLTerminatedString( this->GetSchemeURI() );
+        }
+    }
+    
     std::vector< std::pair< std::string, std::string > > SCHM::GetDisplayableProperties( void ) const
     {
         auto props( FullBox::GetDisplayableProperties() );
@@ -0,0 +1,190 @@
+#include <ISOBMFF/SENC.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/Utils.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::SENC >::IMPL
+{
+public:
+
+    IMPL()                  = default;
+    IMPL( const IMPL & o )  = default;
+    ~IMPL()                 = default;
+
+    // Structure of arrays: sample i has IV ivs[i * iv_size] and subsamples [subsample_start[i], subsample_start[i + 1]).
+    // subsample_start is empty without subsample encryption.
+    struct Layout
+    {
+        uint8_t               iv_size{0};
+        std::vector<uint8_t>  ivs;
+        std::vector<uint32_t> subsample_start;
+        std::vector<uint16_t> clear_bytes;
+        std::vector<uint32_t> protected_bytes;
+    };
+
+    bool          parse( uint8_t ivSize, bool subsamples, Layout & layout ) const;
+    const Layout * find( uint8_t ivSize ) const;
+
+    uint32_t              sample_count{0};
+    std::vector<uint8_t>  samples;              // Raw sample entries
+    std::vector<Layout>   layouts;              // One per IV size the samples parse exactly with
+    size_t                current{0};           // Selected by SetIVSize, the first layout by default
+
+    const Layout * selected() const { return this->current < this->layouts.size() ? &this->layouts[ this->current ] : nullptr; }
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::SENC
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF{
+
+    constexpr uint32_t SENC::UseSubsampleEncryption;
+
+    SENC::SENC() : FullBox("senc") {
+
+    }
+
+    void SENC::ReadData(IParser *parser, BinaryStream &stream) {
+        FullBox::ReadData(parser, stream);
+        impl->sample_count = stream.ReadBigEndianUInt32();
+        stream.ReadAllData(impl->samples);
+        impl->layouts.clear();
+        impl->current = 0;
+
+        static const uint8_t ivSizes[] = { 8, 16, 0 };
+        for (uint8_t ivSize : ivSizes) {
+            XS::PIMPL::Object< SENC >::IMPL::Layout layout;
+            if (impl->parse(ivSize, hasSubsamples(), layout)) {
+                impl->layouts.emplace_back(std::move(layout));
+            }
+        }
+    }
+
+    void SENC::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+        sink.WriteBigEndianUInt32(impl->sample_count);
+        // The raw entries are kept, whatever IV size they were parsed with
+        sink.Write(impl->samples);
+    }
+
+    KeyValueStringList SENC::GetDisplayableProperties() const {
+        auto props = FullBox::GetDisplayableProperties();
+        props.push_back( { "SampleCount", std::to_string( GetSampleCount() ) } );
+        props.push_back( { "IVSize", std::to_string( GetIVSize() ) } );
+        props.push_back( { "Subsamples", std::to_string( impl->selected() ? impl->selected()->clear_bytes.size() : 0 ) } );
+        return props;
+    }
+
+    void SENC::WriteDescription(std::ostream &os, std::size_t indentLevel) const {
+        FullBox::WriteDescription( os, indentLevel );
+    }
+
+    uint32_t SENC::GetSampleCount() const {
+        return impl->sample_count;
+    }
+
+    uint8_t SENC::GetIVSize() const {
+        return impl->selected() ? impl->selected()->iv_size : 0;
+    }
+
+    bool SENC::hasSubsamples() const {
+        return (GetFlags() & UseSubsampleEncryption) != 0;
+    }
+
+    SENC::Sample SENC::GetSample(uint32_t index) const {
+        return impl->selected() ? GetSample(index, impl->selected()->iv_size) : Sample();
+    }
+
+    SENC::Sample SENC::GetSample(uint32_t index, uint8_t ivSize) const {
+        Sample sample;
+        const auto *layout = impl->find(ivSize);
+        if (!layout || index >= impl->sample_count) {
+            return sample;
+        }
+        sample.ivSize = layout->iv_size;
+        sample.iv = layout->iv_size > 0 ? layout->ivs.data() + static_cast<size_t>(index) * layout->iv_size : nullptr;
+        if (layout->subsample_start.empty()) {
+            return sample;
+        }
+        uint32_t first = layout->subsample_start[index];
+        sample.subsampleCount = layout->subsample_start[index + 1] - first;
+        if (sample.subsampleCount > 0) {
+            sample.clearBytes = layout->clear_bytes.data() + first;
+            sample.protectedBytes = layout->protected_bytes.data() + first;
+        }
+        return sample;
+    }
+
+    bool SENC::SetIVSize(uint8_t ivSize) {
+        const auto *layout = impl->find(ivSize);
+        impl->current = layout ? static_cast<size_t>(layout - impl->layouts.data()) : impl->layouts.size();
+        return layout != nullptr;
+    }
+}
+
+const XS::PIMPL::Object< ISOBMFF::SENC >::IMPL::Layout * XS::PIMPL::Object< ISOBMFF::SENC >::IMPL::find( uint8_t ivSize ) const
+{
+    for( const auto & layout: this->layouts )
+    {
+        if( layout.iv_size == ivSize )
+        {
+            return &layout;
+        }
+    }
+
+    return nullptr;
+}
+
+bool XS::PIMPL::Object< ISOBMFF::SENC >::IMPL::parse( uint8_t ivSize, bool subsamples, Layout & layout ) const
+{
+    const uint8_t *data = this->samples.data();
+    size_t         size = this->samples.size();
+    size_t         pos  = 0;
+
+    layout.iv_size = ivSize;
+
+    if( subsamples == false )
+    {
+        if( size != static_cast< size_t >( this->sample_count ) * ivSize )
+        {
+            return false;
+        }
+
+        layout.ivs.assign( data, data + size );
+
+        return true;
+    }
+
+    for( uint32_t i = 0; i < this->sample_count; ++i )
+    {
+        if( size - pos < static_cast< size_t >( ivSize ) + 2 )
+        {
+            return false;
+        }
+
+        layout.ivs.insert( layout.ivs.end(), data + pos, data + pos + ivSize );
+        layout.subsample_start.push_back( static_cast< uint32_t >( layout.clear_bytes.size() ) );
+        pos += ivSize;
+
+        size_t count = ( static_cast< size_t >( data[ pos ] ) << 8 ) | data[ pos + 1 ];
+        pos += 2;
+
+        if( ( size - pos ) / 6 < count )
+        {
+            return false;
+        }
+
+        for( size_t j = 0; j < count; ++j, pos += 6 )
+        {
+            layout.clear_bytes.push_back( static_cast< uint16_t >( ( data[ pos ] << 8 ) | data[ pos + 1 ] ) );
+            layout.protected_bytes.push_back( ( static_cast< uint32_t >( data[ pos + 2 ] ) << 24 ) | ( static_cast< uint32_t >( data[ pos + 3 ] ) << 16 )
+                                           | ( static_cast< uint32_t >( data[ pos + 4 ] ) << 8 )  |   static_cast< uint32_t >( data[ pos + 5 ] ) );
+        }
+    }
+
+    layout.subsample_start.push_back( static_cast< uint32_t >( layout.clear_bytes.size() ) );
+
+    /* A wrong IV size shows as leftover bytes */
+    return pos == size;
+}
@@ -1,4 +1,5 @@
 #include <ISOBMFF/SIDX.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/ContainerBox.hpp>
 
 template<>
@@ -60,19 +61,45 @@ namespace ISOBMFF{
         impl->reserved = stream.ReadBigEndianUInt16();
         impl->reference_count = stream.ReadBigEndianUInt16();
 
+        impl->reference_entries.clear();
         for(int i = 0; i < impl->reference_count; ++i) {
             impl->reference_entries.emplace_back(ReferenceEntry());
             ReferenceEntry& entry = impl->reference_entries.back();
 
             uint32_t tmp = stream.ReadBigEndianUInt32();
-            entry.reference_type = tmp & (uint32_t)1;
-            entry.reference_size = tmp & ~(uint32_t)1;
+            entry.reference_type = tmp >> 31;
+            entry.reference_size = tmp & 0x7FFFFFFF;
             entry.subsegment_duration = stream.ReadBigEndianUInt32();
 
             tmp = stream.ReadBigEndianUInt32();
-            entry.starts_with_SAP = tmp & (uint32_t)1;
-            entry.SAP_type = tmp & ((uint32_t)0x7 << 1u);
-            entry.SAP_delta_time = tmp & ((uint32_t)0x15 >> 4u);
+            entry.starts_with_SAP = tmp >> 31;
+            entry.SAP_type = (tmp >> 28) & 0x7;
+            entry.SAP_delta_time = tmp & 0x0FFFFFFF;
+        }
+    }
+
+    void SIDX::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+
+        sink.WriteBigEndianUInt32(impl->reference_id);
+        sink.WriteBigEndianUInt32(impl->timescale);
+
+        if (GetVersion() == 1) {
+            sink.WriteBigEndianUInt64(impl->earliest_PTS);
+            sink.WriteBigEndianUInt64(impl->first_offset);
+        }
+        else {
+            sink.WriteBigEndianUInt32(static_cast<uint32_t>(impl->earliest_PTS));
+            sink.WriteBigEndianUInt32(static_cast<uint32_t>(impl->first_offset));
+        }
+
+        sink.WriteBigEndianUInt16(impl->reserved);
+        sink.WriteBigEndianUInt16(static_cast<uint16_t>(impl->reference_entries.size()));
+
+        for (const ReferenceEntry &entry : impl->reference_entries) {
+            sink.WriteBigEndianUInt32((static_cast<uint32_t>(entry.reference_type) << 31) | entry.reference_size);
+            sink.WriteBigEndianUInt32(entry.subsegment_duration);
+            sink.WriteBigEndianUInt32((static_cast<uint32_t>(entry.starts_with_SAP) << 31) | (static_cast<uint32_t>(entry.SAP_type) << 28) | entry.SAP_delta_time);
         }
     }
 
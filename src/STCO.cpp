@@ -0,0 +1,135 @@
+/*!
+ * @file        STCO.cpp
+ */
+
+#include <ISOBMFF/STCO.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::STCO >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        std::vector< uint64_t > _chunkOffsets;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::STCO
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    STCO::STCO( const std::string & name ): FullBox( name )
+    {}
+    
+    void STCO::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint32_t count;
+        bool     large;
+        
+        FullBox::ReadData( parser, stream );
+        
+        large = this->GetName() == "co64";
+        count = stream.ReadBigEndianUInt32();
+        
+        if( static_cast< uint64_t >( count ) * ( ( large ) ? 8 : 4 ) > stream.GetBytesAvailable() )
+        {
+            throw std::runtime_error( this->GetName() + " entry count exceeds the box size" );
+        }
+        
+        this->impl->_chunkOffsets.resize( count );
+        
+        for( auto & offset: this->impl->_chunkOffsets )
+        {
+            offset = ( large ) ? stream.ReadBigEndianUInt64() : stream.ReadBigEndianUInt32();
+        }
+    }
+    
+    void STCO::WriteData( BoxSink & sink ) const
+    {
+        bool large;
+        
+        large = this->GetName() == "co64";
+        
+        if( large == false && this->NeedsLargeOffsets() )
+        {
+            throw std::runtime_error( "Chunk offset too large for stco" );
+        }
+        
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->impl->_chunkOffsets.size() ) );
+        
+        for( uint64_t offset: this->impl->_chunkOffsets )
+        {
+            if( large )
+            {
+                sink.WriteBigEndianUInt64( offset );
+            }
+            else
+            {
+                sink.WriteBigEndianUInt32( static_cast< uint32_t >( offset ) );
+            }
+        }
+    }
+    
+    std::vector< std::pair< std::string, std::string > > STCO::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Chunks", std::to_string( this->impl->_chunkOffsets.size() ) } );
+        
+        return props;
+    }
+    
+    const std::vector< uint64_t > & STCO::GetChunkOffsets( void ) const
+    {
+        return this->impl->_chunkOffsets;
+    }
+    
+    void STCO::AddChunkOffset( uint64_t value )
+    {
+        this->impl->_chunkOffsets.push_back( value );
+    }
+    
+    void STCO::ClearChunkOffsets( void )
+    {
+        this->impl->_chunkOffsets.clear();
+    }
+    
+    void STCO::AddToChunkOffsets( int64_t delta )
+    {
+        for( auto & offset: this->impl->_chunkOffsets )
+        {
+            offset = static_cast< uint64_t >( static_cast< int64_t >( offset ) + delta );
+        }
+    }
+    
+    bool STCO::NeedsLargeOffsets( void ) const
+    {
+        for( uint64_t offset: this->impl->_chunkOffsets )
+        {
+            if( offset > 0xFFFFFFFF )
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::STCO >::IMPL::IMPL( void )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STCO >::IMPL::IMPL( const IMPL & o ):
+    _chunkOffsets( o._chunkOffsets )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STCO >::IMPL::~IMPL( void )
+{}
@@ -0,0 +1,110 @@
+/*!
+ * @file        STSC.cpp
+ */
+
+#include <ISOBMFF/STSC.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::STSC >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        std::vector< ISOBMFF::STSC::Entry > _entries;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::STSC
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    STSC::STSC( void ): FullBox( "stsc" )
+    {}
+    
+    void STSC::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint32_t count;
+        
+        FullBox::ReadData( parser, stream );
+        
+        count = stream.ReadBigEndianUInt32();
+        
+        if( static_cast< uint64_t >( count ) * 12 > stream.GetBytesAvailable() )
+        {
+            throw std::runtime_error( "stsc entry count exceeds the box size" );
+        }
+        
+        this->impl->_entries.resize( count );
+        
+        for( auto & entry: this->impl->_entries )
+        {
+            entry.firstChunk             = stream.ReadBigEndianUInt32();
+            entry.samplesPerChunk        = stream.ReadBigEndianUInt32();
+            entry.sampleDescriptionIndex = stream.ReadBigEndianUInt32();
+        }
+    }
+    
+    void STSC::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->impl->_entries.size() ) );
+        
+        for( const auto & entry: this->impl->_entries )
+        {
+            sink.WriteBigEndianUInt32( entry.firstChunk );
+            sink.WriteBigEndianUInt32( entry.samplesPerChunk );
+            sink.WriteBigEndianUInt32( entry.sampleDescriptionIndex );
+        }
+    }
+    
+    std::vector< std::pair< std::string, std::string > > STSC::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Entries", std::to_string( this->impl->_entries.size() ) } );
+        
+        return props;
+    }
+    
+    const std::vector< STSC::Entry > & STSC::GetEntries( void ) const
+    {
+        return this->impl->_entries;
+    }
+    
+    void STSC::AddChunk( uint32_t chunk, uint32_t samplesPerChunk, uint32_t sampleDescriptionIndex )
+    {
+        if( this->impl->_entries.empty() == false )
+        {
+            const Entry & last( this->impl->_entries.back() );
+            
+            if( last.samplesPerChunk == samplesPerChunk && last.sampleDescriptionIndex == sampleDescriptionIndex )
+            {
+                return;
+            }
+        }
+        
+        this->impl->_entries.push_back( { chunk, samplesPerChunk, sampleDescriptionIndex } );
+    }
+    
+    void STSC::ClearEntries( void )
+    {
+        this->impl->_entries.clear();
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::STSC >::IMPL::IMPL( void )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STSC >::IMPL::IMPL( const IMPL & o ):
+    _entries( o._entries )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STSC >::IMPL::~IMPL( void )
+{}
@@ -29,7 +29,9 @@
  */
 
 #include <ISOBMFF/STSD.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/ContainerBox.hpp>
+#include <ISOBMFF/SampleEntry.hpp>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::STSD >::IMPL
@@ -62,6 +64,15 @@ namespace ISOBMFF
         this->impl->_boxes = container.GetBoxes();
     }
     
+    void STSD::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->impl->_boxes.size() ) );
+        
+        Container::WriteBoxes( sink );
+    }
+    
     void STSD::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
     {
         FullBox::WriteDescription( os, indentLevel );
@@ -80,6 +91,23 @@ namespace ISOBMFF
     {
         return this->impl->_boxes;
     }
+    
+    std::vector< std::string > STSD::GetCodecs( void ) const
+    {
+        std::vector< std::string > codecs;
+        
+        for( const auto & box: this->impl->_boxes )
+        {
+            std::shared_ptr< SampleEntry > entry( std::dynamic_pointer_cast< SampleEntry >( box ) );
+            
+            if( entry != nullptr )
+            {
+                codecs.push_back( entry->GetCodecs() );
+            }
+        }
+        
+        return codecs;
+    }
 }
 
 XS::PIMPL::Object< ISOBMFF::STSD >::IMPL::IMPL( void )
@@ -0,0 +1,96 @@
+/*!
+ * @file        STSS.cpp
+ */
+
+#include <ISOBMFF/STSS.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::STSS >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        std::vector< uint32_t > _sampleNumbers;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::STSS
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    STSS::STSS( void ): FullBox( "stss" )
+    {}
+    
+    void STSS::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint32_t count;
+        
+        FullBox::ReadData( parser, stream );
+        
+        count = stream.ReadBigEndianUInt32();
+        
+        if( static_cast< uint64_t >( count ) * 4 > stream.GetBytesAvailable() )
+        {
+            throw std::runtime_error( "stss entry count exceeds the box size" );
+        }
+        
+        this->impl->_sampleNumbers.resize( count );
+        
+        for( auto & number: this->impl->_sampleNumbers )
+        {
+            number = stream.ReadBigEndianUInt32();
+        }
+    }
+    
+    void STSS::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->impl->_sampleNumbers.size() ) );
+        
+        for( uint32_t number: this->impl->_sampleNumbers )
+        {
+            sink.WriteBigEndianUInt32( number );
+        }
+    }
+    
+    std::vector< std::pair< std::string, std::string > > STSS::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Sync samples", std::to_string( this->impl->_sampleNumbers.size() ) } );
+        
+        return props;
+    }
+    
+    const std::vector< uint32_t > & STSS::GetSampleNumbers( void ) const
+    {
+        return this->impl->_sampleNumbers;
+    }
+    
+    void STSS::AddSampleNumber( uint32_t value )
+    {
+        this->impl->_sampleNumbers.push_back( value );
+    }
+    
+    void STSS::ClearSampleNumbers( void )
+    {
+        this->impl->_sampleNumbers.clear();
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::STSS >::IMPL::IMPL( void )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STSS >::IMPL::IMPL( const IMPL & o ):
+    _sampleNumbers( o._sampleNumbers )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STSS >::IMPL::~IMPL( void )
+{}
@@ -0,0 +1,235 @@
+/*!
+ * @file        STSZ.cpp
+ */
+
+#include <ISOBMFF/STSZ.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::STSZ >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint32_t                _sampleSize;
+        uint32_t                _sampleCount;
+        uint8_t                 _fieldSize;
+        std::vector< uint32_t > _entrySizes;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::STSZ
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    STSZ::STSZ( const std::string & name ): FullBox( name )
+    {}
+    
+    void STSZ::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint32_t count;
+        uint8_t  u8;
+        
+        FullBox::ReadData( parser, stream );
+        
+        this->impl->_entrySizes.clear();
+        
+        if( this->GetName() == "stz2" )
+        {
+            /* 24 reserved bits, then the field size */
+            stream.ReadBigEndianUInt16();
+            stream.ReadUInt8();
+            
+            this->impl->_fieldSize  = stream.ReadUInt8();
+            this->impl->_sampleSize = 0;
+            
+            count = stream.ReadBigEndianUInt32();
+            
+            if( this->impl->_fieldSize != 4 && this->impl->_fieldSize != 8 && this->impl->_fieldSize != 16 )
+            {
+                throw std::runtime_error( "Invalid stz2 field size" );
+            }
+            
+            if( ( static_cast< uint64_t >( count ) * this->impl->_fieldSize + 7 ) / 8 > stream.GetBytesAvailable() )
+            {
+                throw std::runtime_error( "stz2 sample count exceeds the box size" );
+            }
+            
+            this->impl->_entrySizes.resize( count );
+            
+            for( uint32_t i = 0; i < count; i++ )
+            {
+                if( this->impl->_fieldSize == 16 )
+                {
+                    this->impl->_entrySizes[ i ] = stream.ReadBigEndianUInt16();
+                }
+                else if( this->impl->_fieldSize == 8 )
+                {
+                    this->impl->_entrySizes[ i ] = stream.ReadUInt8();
+                }
+                else
+                {
+                    u8 = stream.ReadUInt8();
+                    
+                    this->impl->_entrySizes[ i ] = u8 >> 4;
+                    
+                    if( ++i < count )
+                    {
+                        this->impl->_entrySizes[ i ] = u8 & 0x0F;
+                    }
+                }
+            }
+            
+            this->impl->_sampleCount = count;
+            
+            return;
+        }
+        
+        this->impl->_sampleSize  = stream.ReadBigEndianUInt32();
+        this->impl->_sampleCount = stream.ReadBigEndianUInt32();
+        
+        if( this->impl->_sampleSize != 0 )
+        {
+            return;
+        }
+        
+        if( static_cast< uint64_t >( this->impl->_sampleCount ) * 4 > stream.GetBytesAvailable() )
+        {
+            throw std::runtime_error( "stsz sample count exceeds the box size" );
+        }
+        
+        this->impl->_entrySizes.resize( this->impl->_sampleCount );
+        
+        for( auto & size: this->impl->_entrySizes )
+        {
+            size = stream.ReadBigEndianUInt32();
+        }
+    }
+    
+    void STSZ::WriteData( BoxSink & sink ) const
+    {
+        const std::vector< uint32_t > & sizes( this->impl->_entrySizes );
+        
+        FullBox::WriteData( sink );
+        
+        if( this->GetName() == "stz2" )
+        {
+            sink.WriteBigEndianUInt24( 0 );
+            sink.WriteUInt8( this->impl->_fieldSize );
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( sizes.size() ) );
+            
+            for( uint32_t size: sizes )
+            {
+                if( size >> this->impl->_fieldSize != 0 )
+                {
+                    throw std::runtime_error( "Sample size too large for the stz2 field size" );
+                }
+            }
+            
+            for( std::size_t i = 0; i < sizes.size(); i++ )
+            {
+                if( this->impl->_fieldSize == 16 )
+                {
+                    sink.WriteBigEndianUInt16( static_cast< uint16_t >( sizes[ i ] ) );
+                }
+                else if( this->impl->_fieldSize == 8 )
+                {
+                    sink.WriteUInt8( static_cast< uint8_t >( sizes[ i ] ) );
+                }
+                else
+                {
+                    sink.WriteUInt8( static_cast< uint8_t >( ( sizes[ i ] << 4 ) | ( ( i + 1 < sizes.size() ) ? ( sizes[ i + 1 ] & 0x0F ) : 0 ) ) );
+                    
+                    i++;
+                }
+            }
+            
+            return;
+        }
+        
+        sink.WriteBigEndianUInt32( this->impl->_sampleSize );
+        sink.WriteBigEndianUInt32( this->GetSampleCount() );
+        
+        if( this->impl->_sampleSize == 0 )
+        {
+            for( uint32_t size: sizes )
+            {
+                sink.WriteBigEndianUInt32( size );
+            }
+        }
+    }
+    
+    std::vector< std::pair< std::string, std::string > > STSZ::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Sample size",  std::to_string( this->GetSampleSize() ) } );
+        props.push_back( { "Sample count", std::to_string( this->GetSampleCount() ) } );
+        
+        return props;
+    }
+    
+    uint32_t STSZ::GetSampleSize( void ) const
+    {
+        return this->impl->_sampleSize;
+    }
+    
+    uint32_t STSZ::GetSampleCount( void ) const
+    {
+        return ( this->impl->_sampleSize != 0 ) ? this->impl->_sampleCount : static_cast< uint32_t >( this->impl->_entrySizes.size() );
+    }
+    
+    uint32_t STSZ::GetSampleSizeAt( uint32_t index ) const
+    {
+        return ( this->impl->_sampleSize != 0 ) ? this->impl->_sampleSize : this->impl->_entrySizes.at( index );
+    }
+    
+    const std::vector< uint32_t > & STSZ::GetEntrySizes( void ) const
+    {
+        return this->impl->_entrySizes;
+    }
+    
+    void STSZ::SetSampleSize( uint32_t size, uint32_t count )
+    {
+        this->impl->_sampleSize  = size;
+        this->impl->_sampleCount = count;
+        
+        this->impl->_entrySizes.clear();
+    }
+    
+    void STSZ::AddEntrySize( uint32_t value )
+    {
+        this->impl->_sampleSize = 0;
+        
+        this->impl->_entrySizes.push_back( value );
+    }
+    
+    void STSZ::ClearEntrySizes( void )
+    {
+        this->impl->_sampleSize  = 0;
+        this->impl->_sampleCount = 0;
+        
+        this->impl->_entrySizes.clear();
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::STSZ >::IMPL::IMPL( void ):
+    _sampleSize( 0 ),
+    _sampleCount( 0 ),
+    _fieldSize( 16 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STSZ >::IMPL::IMPL( const IMPL & o ):
+    _sampleSize( o._sampleSize ),
+    _sampleCount( o._sampleCount ),
+    _fieldSize( o._fieldSize ),
+    _entrySizes( o._entrySizes )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STSZ >::IMPL::~IMPL( void )
+{}
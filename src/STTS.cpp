@@ -0,0 +1,105 @@
+/*!
+ * @file        STTS.cpp
+ */
+
+#include <ISOBMFF/STTS.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::STTS >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        std::vector< ISOBMFF::STTS::Entry > _entries;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::STTS
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    STTS::STTS( void ): FullBox( "stts" )
+    {}
+    
+    void STTS::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint32_t count;
+        
+        FullBox::ReadData( parser, stream );
+        
+        count = stream.ReadBigEndianUInt32();
+        
+        if( static_cast< uint64_t >( count ) * 8 > stream.GetBytesAvailable() )
+        {
+            throw std::runtime_error( "stts entry count exceeds the box size" );
+        }
+        
+        this->impl->_entries.resize( count );
+        
+        for( auto & entry: this->impl->_entries )
+        {
+            entry.sampleCount = stream.ReadBigEndianUInt32();
+            entry.sampleDelta = stream.ReadBigEndianUInt32();
+        }
+    }
+    
+    void STTS::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->impl->_entries.size() ) );
+        
+        for( const auto & entry: this->impl->_entries )
+        {
+            sink.WriteBigEndianUInt32( entry.sampleCount );
+            sink.WriteBigEndianUInt32( entry.sampleDelta );
+        }
+    }
+    
+    std::vector< std::pair< std::string, std::string > > STTS::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Entries", std::to_string( this->impl->_entries.size() ) } );
+        
+        return props;
+    }
+    
+    const std::vector< STTS::Entry > & STTS::GetEntries( void ) const
+    {
+        return this->impl->_entries;
+    }
+    
+    void STTS::AddEntry( uint32_t sampleCount, uint32_t sampleDelta )
+    {
+        if( this->impl->_entries.empty() == false && this->impl->_entries.back().sampleDelta == sampleDelta )
+        {
+            this->impl->_entries.back().sampleCount += sampleCount;
+        }
+        else
+        {
+            this->impl->_entries.push_back( { sampleCount, sampleDelta } );
+        }
+    }
+    
+    void STTS::ClearEntries( void )
+    {
+        this->impl->_entries.clear();
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::STTS >::IMPL::IMPL( void )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STTS >::IMPL::IMPL( const IMPL & o ):
+    _entries( o._entries )
+{}
+
+XS::PIMPL::Object< ISOBMFF::STTS >::IMPL::~IMPL( void )
+{}
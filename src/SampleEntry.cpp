@@ -0,0 +1,139 @@
+/*!
+ * @file        SampleEntry.cpp
+ */
+
+#include <ISOBMFF/SampleEntry.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/FRMA.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::SampleEntry >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint16_t    _dataReferenceIndex;
+        std::string _codecs;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::SampleEntry
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    SampleEntry::SampleEntry( const std::string & name ): ContainerBox( name )
+    {}
+    
+    void SampleEntry::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        uint8_t reserved[ 6 ];
+        
+        stream.Read( reserved, sizeof( reserved ) );
+        
+        this->SetDataReferenceIndex( stream.ReadBigEndianUInt16() );
+        this->ReadFields( parser, stream );
+        
+        ContainerBox::ReadData( parser, stream );
+        
+        this->impl->_codecs = this->MakeCodecs();
+    }
+    
+    void SampleEntry::WriteData( BoxSink & sink ) const
+    {
+        uint8_t reserved[ 6 ] = {};
+        
+        sink.Write( reserved, sizeof( reserved ) );
+        sink.WriteBigEndianUInt16( this->GetDataReferenceIndex() );
+        
+        this->WriteFields( sink );
+        
+        ContainerBox::WriteData( sink );
+    }
+    
+    void SampleEntry::WriteDescription( std::ostream & os, std::size_t indentLevel ) const
+    {
+        ContainerBox::WriteDescription( os, indentLevel );
+    }
+    
+    std::vector< std::pair< std::string, std::string > > SampleEntry::GetDisplayableProperties( void ) const
+    {
+        auto props( ContainerBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Data reference index", std::to_string( this->GetDataReferenceIndex() ) } );
+        props.push_back( { "Codecs",               this->GetCodecs() } );
+        
+        return props;
+    }
+    
+    uint16_t SampleEntry::GetDataReferenceIndex( void ) const
+    {
+        return this->impl->_dataReferenceIndex;
+    }
+    
+    void SampleEntry::SetDataReferenceIndex( uint16_t value )
+    {
+        this->impl->_dataReferenceIndex = value;
+    }
+    
+    std::string SampleEntry::GetCodingName( void ) const
+    {
+        std::string name( this->GetName() );
+        
+        if( name == "encv" || name == "enca" )
+        {
+            std::shared_ptr< ContainerBox > sinf;
+            std::shared_ptr< FRMA >         frma;
+            
+            sinf = this->GetTypedBox< ContainerBox >( "sinf" );
+            
+            if( sinf != nullptr )
+            {
+                frma = sinf->GetTypedBox< FRMA >( "frma" );
+            }
+            
+            if( frma != nullptr )
+            {
+                return frma->GetDataFormat();
+            }
+        }
+        
+        return name;
+    }
+    
+    const std::string & SampleEntry::GetCodecs( void ) const
+    {
+        return this->impl->_codecs;
+    }
+    
+    void SampleEntry::ReadFields( IParser * parser, BinaryStream & stream )
+    {
+        ( void )parser;
+        ( void )stream;
+    }
+    
+    void SampleEntry::WriteFields( BoxSink & sink ) const
+    {
+        ( void )sink;
+    }
+    
+    std::string SampleEntry::MakeCodecs( void ) const
+    {
+        return this->GetCodingName();
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::SampleEntry >::IMPL::IMPL( void ):
+    _dataReferenceIndex( 0 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::SampleEntry >::IMPL::IMPL( const IMPL & o ):
+    _dataReferenceIndex( o._dataReferenceIndex ),
+    _codecs( o._codecs )
+{}
+
+XS::PIMPL::Object< ISOBMFF::SampleEntry >::IMPL::~IMPL( void )
+{}
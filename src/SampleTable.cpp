@@ -0,0 +1,258 @@
+/*!
+ * @file        SampleTable.cpp
+ */
+
+#include <ISOBMFF/SampleTable.hpp>
+#include <ISOBMFF/TKHD.hpp>
+#include <ISOBMFF/MDHD.hpp>
+#include <ISOBMFF/HDLR.hpp>
+#include <ISOBMFF/STSD.hpp>
+#include <ISOBMFF/STTS.hpp>
+#include <ISOBMFF/CTTS.hpp>
+#include <ISOBMFF/STSS.hpp>
+#include <ISOBMFF/STSZ.hpp>
+#include <ISOBMFF/STSC.hpp>
+#include <ISOBMFF/STCO.hpp>
+#include <stdexcept>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::SampleTable >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint32_t                                    _trackID;
+        uint32_t                                    _timescale;
+        std::string                                 _handlerType;
+        uint64_t                                    _duration;
+        bool                                        _hasSyncSamples;
+        bool                                        _hasCompositionOffsets;
+        std::shared_ptr< ISOBMFF::STSD >            _stsd;
+        std::vector< ISOBMFF::SampleTable::Sample > _samples;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::SampleTable
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    SampleTable::SampleTable( void )
+    {}
+    
+    SampleTable::SampleTable( const ContainerBox & trak )
+    {
+        std::shared_ptr< TKHD >         tkhd;
+        std::shared_ptr< ContainerBox > mdia;
+        std::shared_ptr< ContainerBox > minf;
+        std::shared_ptr< ContainerBox > stbl;
+        std::shared_ptr< MDHD >         mdhd;
+        std::shared_ptr< HDLR >         hdlr;
+        std::shared_ptr< STTS >         stts;
+        std::shared_ptr< CTTS >         ctts;
+        std::shared_ptr< STSS >         stss;
+        std::shared_ptr< STSZ >         stsz;
+        std::shared_ptr< STSC >         stsc;
+        std::shared_ptr< STCO >         stco;
+        uint64_t                        time;
+        size_t                          i;
+        
+        tkhd = trak.GetTypedBox< TKHD >( "tkhd" );
+        mdia = trak.GetTypedBox< ContainerBox >( "mdia" );
+        minf = ( mdia != nullptr ) ? mdia->GetTypedBox< ContainerBox >( "minf" ) : nullptr;
+        stbl = ( minf != nullptr ) ? minf->GetTypedBox< ContainerBox >( "stbl" ) : nullptr;
+        
+        if( tkhd == nullptr || stbl == nullptr )
+        {
+            throw std::runtime_error( "trak box has no tkhd or stbl box" );
+        }
+        
+        mdhd = mdia->GetTypedBox< MDHD >( "mdhd" );
+        hdlr = mdia->GetTypedBox< HDLR >( "hdlr" );
+        stts = stbl->GetTypedBox< STTS >( "stts" );
+        ctts = stbl->GetTypedBox< CTTS >( "ctts" );
+        stss = stbl->GetTypedBox< STSS >( "stss" );
+        stsz = stbl->GetTypedBox< STSZ >( ( stbl->GetBox( "stz2" ) != nullptr ) ? "stz2" : "stsz" );
+        stsc = stbl->GetTypedBox< STSC >( "stsc" );
+        stco = stbl->GetTypedBox< STCO >( ( stbl->GetBox( "co64" ) != nullptr ) ? "co64" : "stco" );
+        
+        this->impl->_stsd = stbl->GetTypedBox< STSD >( "stsd" );
+        
+        if( mdhd == nullptr || stts == nullptr || stsz == nullptr || stsc == nullptr || stco == nullptr )
+        {
+            throw std::runtime_error( "stbl box is missing a sample table" );
+        }
+        
+        this->impl->_trackID               = tkhd->GetTrackID();
+        this->impl->_timescale             = mdhd->GetTimescale();
+        this->impl->_handlerType           = ( hdlr != nullptr ) ? hdlr->GetHandlerType() : "";
+        this->impl->_hasSyncSamples        = stss != nullptr;
+        this->impl->_hasCompositionOffsets = ctts != nullptr;
+        
+        auto & samples = this->impl->_samples;
+        
+        samples.resize( stsz->GetSampleCount() );
+        
+        for( i = 0; i < samples.size(); i++ )
+        {
+            samples[ i ].size              = stsz->GetSampleSizeAt( static_cast< uint32_t >( i ) );
+            samples[ i ].compositionOffset = 0;
+            samples[ i ].sync              = stss == nullptr;
+        }
+        
+        /* Decoding times */
+        time = 0;
+        i    = 0;
+        
+        for( const auto & entry: stts->GetEntries() )
+        {
+            if( entry.sampleCount > samples.size() - i )
+            {
+                throw std::runtime_error( "stts covers more samples than stsz" );
+            }
+            
+            for( uint32_t n = 0; n < entry.sampleCount; n++, i++ )
+            {
+                samples[ i ].decodeTime = time;
+                samples[ i ].duration   = entry.sampleDelta;
+                time                   += entry.sampleDelta;
+            }
+        }
+        
+        if( i != samples.size() )
+        {
+            throw std::runtime_error( "stts covers fewer samples than stsz" );
+        }
+        
+        this->impl->_duration = time;
+        
+        /* Composition offsets, missing entries default to 0 */
+        if( ctts != nullptr )
+        {
+            i = 0;
+            
+            for( const auto & entry: ctts->GetEntries() )
+            {
+                for( uint32_t n = 0; n < entry.sampleCount && i < samples.size(); n++, i++ )
+                {
+                    samples[ i ].compositionOffset = entry.sampleOffset;
+                }
+            }
+        }
+        
+        if( stss != nullptr )
+        {
+            for( uint32_t number: stss->GetSampleNumbers() )
+            {
+                if( number == 0 || number > samples.size() )
+                {
+                    throw std::runtime_error( "stss sample number out of range" );
+                }
+                
+                samples[ number - 1 ].sync = true;
+            }
+        }
+        
+        /* Chunks: an stsc entry applies up to the first chunk of the next entry */
+        {
+            const auto & entries = stsc->GetEntries();
+            const auto & offsets = stco->GetChunkOffsets();
+            uint64_t     offset;
+            size_t       e;
+            
+            i = 0;
+            e = 0;
+            
+            for( size_t chunk = 0; chunk < offsets.size() && i < samples.size(); chunk++ )
+            {
+                while( e + 1 < entries.size() && entries[ e + 1 ].firstChunk <= chunk + 1 )
+                {
+                    e++;
+                }
+                
+                if( e >= entries.size() || entries[ e ].firstChunk > chunk + 1 )
+                {
+                    throw std::runtime_error( "stsc does not cover chunk " + std::to_string( chunk + 1 ) );
+                }
+                
+                offset = offsets[ chunk ];
+                
+                for( uint32_t n = 0; n < entries[ e ].samplesPerChunk && i < samples.size(); n++, i++ )
+                {
+                    samples[ i ].offset           = offset;
+                    samples[ i ].descriptionIndex = entries[ e ].sampleDescriptionIndex;
+                    offset                       += samples[ i ].size;
+                }
+            }
+            
+            if( i != samples.size() )
+            {
+                throw std::runtime_error( "Chunks hold fewer samples than stsz" );
+            }
+        }
+    }
+    
+    uint32_t SampleTable::GetTrackID( void ) const
+    {
+        return this->impl->_trackID;
+    }
+    
+    uint32_t SampleTable::GetTimescale( void ) const
+    {
+        return this->impl->_timescale;
+    }
+    
+    std::string SampleTable::GetHandlerType( void ) const
+    {
+        return this->impl->_handlerType;
+    }
+    
+    uint64_t SampleTable::GetDuration( void ) const
+    {
+        return this->impl->_duration;
+    }
+    
+    bool SampleTable::HasSyncSamples( void ) const
+    {
+        return this->impl->_hasSyncSamples;
+    }
+    
+    bool SampleTable::HasCompositionOffsets( void ) const
+    {
+        return this->impl->_hasCompositionOffsets;
+    }
+    
+    std::shared_ptr< STSD > SampleTable::GetSampleDescriptions( void ) const
+    {
+        return this->impl->_stsd;
+    }
+    
+    const std::vector< SampleTable::Sample > & SampleTable::GetSamples( void ) const
+    {
+        return this->impl->_samples;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::SampleTable >::IMPL::IMPL( void ):
+    _trackID( 0 ),
+    _timescale( 0 ),
+    _duration( 0 ),
+    _hasSyncSamples( false ),
+    _hasCompositionOffsets( false )
+{}
+
+XS::PIMPL::Object< ISOBMFF::SampleTable >::IMPL::IMPL( const IMPL & o ):
+    _trackID( o._trackID ),
+    _timescale( o._timescale ),
+    _handlerType( o._handlerType ),
+    _duration( o._duration ),
+    _hasSyncSamples( o._hasSyncSamples ),
+    _hasCompositionOffsets( o._hasCompositionOffsets ),
+    _stsd( o._stsd ),
+    _samples( o._samples )
+{}
+
+XS::PIMPL::Object< ISOBMFF::SampleTable >::IMPL::~IMPL( void )
+{}
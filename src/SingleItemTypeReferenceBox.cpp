@@ -29,6 +29,7 @@
  */
 
 #include <ISOBMFF/SingleItemTypeReferenceBox.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/IREF.hpp>
 #include <ISOBMFF/IParser.hpp>
 #include <ISOBMFF/Utils.hpp>
@@ -44,6 +45,8 @@ class XS::PIMPL::Object< ISOBMFF::SingleItemTypeReferenceBox >::IMPL
         
         uint32_t                _fromItemID;
         std::vector< uint32_t > _toItemIDs;
+        bool                    _largeItemIDs;
+        bool                    _unparsed;
 };
 
 #define XS_PIMPL_CLASS ISOBMFF::SingleItemTypeReferenceBox
@@ -62,6 +65,11 @@ namespace ISOBMFF
         
         iref = static_cast< const IREF * >( parser->GetInfo( "iref" ) );
         
+        this->impl->_toItemIDs.clear();
+        
+        this->impl->_largeItemIDs = false;
+        this->impl->_unparsed     = ( iref == nullptr );
+        
         if( iref == nullptr )
         {
             Box::ReadData( parser, stream );
@@ -82,6 +90,8 @@ namespace ISOBMFF
         }
         else if( iref->GetVersion() == 1 )
         {
+            this->impl->_largeItemIDs = true;
+            
             this->SetFromItemID( stream.ReadBigEndianUInt32() );
             
             count = stream.ReadBigEndianUInt16();
@@ -93,6 +103,44 @@ namespace ISOBMFF
         }
     }
     
+    void SingleItemTypeReferenceBox::WriteData( BoxSink & sink ) const
+    {
+        bool large;
+        
+        if( this->impl->_unparsed )
+        {
+            Box::WriteData( sink );
+            
+            return;
+        }
+        
+        /* Item IDs are 32 bits in version 1 of the parent iref box */
+        large = this->impl->_largeItemIDs;
+        
+        if( large )
+        {
+            sink.WriteBigEndianUInt32( this->GetFromItemID() );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt16( static_cast< uint16_t >( this->GetFromItemID() ) );
+        }
+        
+        sink.WriteBigEndianUInt16( static_cast< uint16_t >( this->impl->_toItemIDs.size() ) );
+        
+        for( uint32_t id: this->impl->_toItemIDs )
+        {
+            if( large )
+            {
+                sink.WriteBigEndianUInt32( id );
+            }
+            else
+            {
+                sink.WriteBigEndianUInt16( static_cast< uint16_t >( id ) );
+            }
+        }
+    }
+    
     std::vector< std::pair< std::string, std::string > > SingleItemTypeReferenceBox::GetDisplayableProperties( void ) const
     {
         auto props( Box::GetDisplayableProperties() );
@@ -125,12 +173,16 @@ namespace ISOBMFF
 }
 
 XS::PIMPL::Object< ISOBMFF::SingleItemTypeReferenceBox >::IMPL::IMPL( void ):
-    _fromItemID( 0 )
+    _fromItemID( 0 ),
+    _largeItemIDs( false ),
+    _unparsed( false )
 {}
 
 XS::PIMPL::Object< ISOBMFF::SingleItemTypeReferenceBox >::IMPL::IMPL( const IMPL & o ):
     _fromItemID( o._fromItemID ),
-    _toItemIDs( o._toItemIDs )
+    _toItemIDs( o._toItemIDs ),
+    _largeItemIDs( o._largeItemIDs ),
+    _unparsed( o._unparsed )
 {}
 
 XS::PIMPL::Object< ISOBMFF::SingleItemTypeReferenceBox >::IMPL::~IMPL( void )
@@ -0,0 +1,384 @@
+#include "StreamDemuxPool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// Fixed pool with one task deque per worker. Workers take their own tasks in FIFO order and steal from
+// the back of the others' deques when they run dry, so a burst on one worker spreads over the pool.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(size_t threadCount) {
+        threadCount = std::max<size_t>(threadCount, 1);
+        for (size_t i = 0; i < threadCount; ++i) {
+            m_queues.emplace_back(new Queue);
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            m_threads.emplace_back([this, i]() { run(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    // Tasks submitted from a worker stay on that worker's deque; others are spread round-robin.
+    void submit(Task task) {
+        size_t index = t_pool == this ? t_index : m_nextQueue++ % m_queues.size();
+        // Counted before it can be taken, so that a worker never decrements first
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            ++m_pending;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+            m_queues[index]->tasks.push_back(std::move(task));
+        }
+        m_wake.notify_one();
+    }
+
+    size_t threadCount() const {
+        return m_threads.size();
+    }
+
+private:
+    struct Queue {
+        std::mutex          mutex;
+        std::deque<Task>    tasks;
+    };
+
+    bool take(size_t index, Task &task) {
+        {
+            auto &own = *m_queues[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < m_queues.size(); ++i) {
+            auto &victim = *m_queues[(index + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(size_t index) {
+        t_pool = this;
+        t_index = index;
+        for (;;) {
+            Task task;
+            if (take(index, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(m_sleepMutex);
+                    --m_pending;
+                }
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wake.wait(lock, [this]() { return m_stop || m_pending > 0; });
+            if (m_stop && m_pending == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread>            m_threads;
+    std::atomic<size_t>                 m_nextQueue{0};
+    std::mutex                          m_sleepMutex;
+    std::condition_variable             m_wake;
+    size_t                              m_pending{0};   // Submitted tasks not taken yet
+    bool                                m_stop{false};
+
+    static thread_local WorkStealingPool   *t_pool;
+    static thread_local size_t              t_index;
+};
+
+thread_local WorkStealingPool *WorkStealingPool::t_pool = nullptr;
+thread_local size_t WorkStealingPool::t_index = 0;
+
+}
+
+
+struct StreamDemuxPool::Private {
+    using Clock = std::chrono::steady_clock;
+
+    // A stream gets this many chunks per turn before it is queued behind the other streams again
+    static constexpr size_t ChunksPerTurn = 16;
+
+    struct Chunk {
+        std::vector<uint8_t>    data;
+        Clock::time_point       queuedAt;
+        bool                    endOfStream{false};
+    };
+
+    struct Stream {
+        explicit Stream(StreamId streamId) : id(streamId) {}
+
+        const StreamId      id;
+        FMP4StreamParser    parser;     // Only used by the worker draining the stream
+
+        // Guarded by mutex
+        std::mutex          mutex;
+        std::deque<Chunk>   queue;
+        bool                scheduled{false};   // A drain task is queued or running
+        bool                ended{false};
+        bool                failed{false};
+        StreamStats         stats;
+    };
+
+    explicit Private(size_t threadCount) : m_pool(threadCount) {}
+
+    StreamId addStream(const ConfigureCallback &configure) {
+        StreamId id = m_nextId++;
+        auto stream = std::make_shared<Stream>(id);
+        if (configure) {
+            configure(stream->parser);
+        }
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        m_streams.emplace(id, std::move(stream));
+        return id;
+    }
+
+    bool enqueue(StreamId id, Chunk &&chunk) {
+        auto stream = findStream(id);
+        if (!stream) {
+            return false;
+        }
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            if (stream->ended || stream->failed) {
+                return false;
+            }
+            stream->ended = chunk.endOfStream;
+            stream->stats.queuedChunks += 1;
+            stream->stats.queuedBytes += chunk.data.size();
+            stream->queue.push_back(std::move(chunk));
+            schedule = !stream->scheduled;
+            stream->scheduled = true;
+        }
+        if (schedule) {
+            {
+                std::lock_guard<std::mutex> lock(m_idleMutex);
+                ++m_scheduledStreams;
+            }
+            m_pool.submit([this, stream]() { drain(stream); });
+        }
+        return true;
+    }
+
+    void setErrorCallback(const ErrorCallback &callback) {
+        m_errorCallback = callback;
+    }
+
+    void setBackpressureCallback(const BackpressureCallback &callback) {
+        m_backpressureCallback = callback;
+    }
+
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        m_idle.wait(lock, [this]() { return m_scheduledStreams == 0; });
+    }
+
+    StreamStats getStreamStats(StreamId id) const {
+        auto stream = findStream(id);
+        if (!stream) {
+            throw std::runtime_error("Unknown stream " + std::to_string(id));
+        }
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        return stream->stats;
+    }
+
+    size_t streamCount() const {
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        return m_streams.size();
+    }
+
+    size_t threadCount() const {
+        return m_pool.threadCount();
+    }
+
+private:
+    std::shared_ptr<Stream> findStream(StreamId id) const {
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        auto it = m_streams.find(id);
+        return it != m_streams.end() ? it->second : nullptr;
+    }
+
+    void removeStream(StreamId id) {
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        m_streams.erase(id);
+    }
+
+    void unschedule() {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        if (--m_scheduledStreams == 0) {
+            m_idle.notify_all();
+        }
+    }
+
+    void drain(const std::shared_ptr<Stream> &stream) {
+        for (size_t turn = 0; turn < ChunksPerTurn; ++turn) {
+            Chunk chunk;
+            {
+                std::lock_guard<std::mutex> lock(stream->mutex);
+                if (stream->queue.empty() || stream->failed) {
+                    stream->queue.clear();
+                    stream->scheduled = false;
+                    break;
+                }
+                chunk = std::move(stream->queue.front());
+                stream->queue.pop_front();
+            }
+            parseChunk(*stream, chunk);
+            if (turn + 1 == ChunksPerTurn) {
+                m_pool.submit([this, stream]() { drain(stream); });
+                return;
+            }
+        }
+        unschedule();
+    }
+
+    void parseChunk(Stream &stream, const Chunk &chunk) {
+        auto start = Clock::now();
+        auto status = FMP4StreamParser::ParseStatus::Ok;
+        try {
+            if (chunk.endOfStream) {
+                stream.parser.setEndOfStream();
+            } else {
+                status = stream.parser.parse(chunk.data.data(), chunk.data.size());
+            }
+        } catch (const std::exception &error) {
+            {
+                std::lock_guard<std::mutex> lock(stream.mutex);
+                stream.failed = true;
+                stream.stats.queuedChunks = 0;
+                stream.stats.queuedBytes = 0;
+            }
+            removeStream(stream.id);
+            if (m_errorCallback) {
+                m_errorCallback(stream.id, error);
+            }
+            return;
+        }
+        auto end = Clock::now();
+        const bool backpressure = status == FMP4StreamParser::ParseStatus::Backpressure;
+        bool changed = false;
+        {
+            auto parseTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(end - chunk.queuedAt);
+            std::lock_guard<std::mutex> lock(stream.mutex);
+            auto &stats = stream.stats;
+            stats.queuedChunks -= 1;
+            stats.queuedBytes -= chunk.data.size();
+            stats.parsedChunks += 1;
+            stats.parsedBytes += chunk.data.size();
+            stats.lastParseTime = parseTime;
+            stats.maxParseTime = std::max(stats.maxParseTime, parseTime);
+            stats.lastLatency = latency;
+            stats.maxLatency = std::max(stats.maxLatency, latency);
+            stats.parser = stream.parser.getStats();
+            changed = stats.backpressure != backpressure;
+            stats.backpressure = backpressure;
+        }
+        if (changed && m_backpressureCallback) {
+            m_backpressureCallback(stream.id, backpressure);
+        }
+        if (chunk.endOfStream) {
+            removeStream(stream.id);
+        }
+    }
+
+    std::atomic<StreamId>                                   m_nextId{1};
+    mutable std::mutex                                      m_streamsMutex;
+    std::unordered_map<StreamId, std::shared_ptr<Stream>>   m_streams;
+    ErrorCallback                                           m_errorCallback;
+    BackpressureCallback                                    m_backpressureCallback;
+
+    std::mutex                  m_idleMutex;
+    std::condition_variable     m_idle;
+    size_t                      m_scheduledStreams{0};
+
+    // Last member: workers are joined before the streams they drain are destroyed
+    WorkStealingPool            m_pool;
+};
+
+constexpr size_t StreamDemuxPool::Private::ChunksPerTurn;
+
+
+StreamDemuxPool::StreamDemuxPool(size_t threadCount) {
+    m_impl = std::make_unique<Private>(threadCount);
+}
+
+StreamDemuxPool::~StreamDemuxPool() {
+    m_impl->waitIdle();
+}
+
+StreamDemuxPool::StreamId StreamDemuxPool::addStream(const ConfigureCallback &configure) {
+    return m_impl->addStream(configure);
+}
+
+bool StreamDemuxPool::push(StreamId id, const uint8_t *data, size_t size) {
+    return push(id, std::vector<uint8_t>(data, data + size));
+}
+
+bool StreamDemuxPool::push(StreamId id, std::vector<uint8_t> &&data) {
+    Private::Chunk chunk;
+    chunk.data = std::move(data);
+    chunk.queuedAt = Private::Clock::now();
+    return m_impl->enqueue(id, std::move(chunk));
+}
+
+bool StreamDemuxPool::endStream(StreamId id) {
+    Private::Chunk chunk;
+    chunk.queuedAt = Private::Clock::now();
+    chunk.endOfStream = true;
+    return m_impl->enqueue(id, std::move(chunk));
+}
+
+void StreamDemuxPool::onError(const ErrorCallback &callback) {
+    m_impl->setErrorCallback(callback);
+}
+
+void StreamDemuxPool::onBackpressure(const BackpressureCallback &callback) {
+    m_impl->setBackpressureCallback(callback);
+}
+
+void StreamDemuxPool::waitIdle() {
+    m_impl->waitIdle();
+}
+
+StreamDemuxPool::StreamStats StreamDemuxPool::getStreamStats(StreamId id) const {
+    return m_impl->getStreamStats(id);
+}
+
+size_t StreamDemuxPool::streamCount() const {
+    return m_impl->streamCount();
+}
+
+size_t StreamDemuxPool::threadCount() const {
+    return m_impl->threadCount();
+}
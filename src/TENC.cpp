@@ -0,0 +1,102 @@
+#include <ISOBMFF/TENC.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/Utils.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::TENC >::IMPL
+{
+public:
+
+    IMPL()                  = default;
+    IMPL( const IMPL & o )  = default;
+    ~IMPL()                 = default;
+
+    uint8_t              default_crypt_byte_block{0};
+    uint8_t              default_skip_byte_block{0};
+    uint8_t              default_is_protected{0};
+    uint8_t              default_per_sample_iv_size{0};
+    std::vector<uint8_t> default_kid;
+    std::vector<uint8_t> default_constant_iv;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::TENC
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF{
+
+    TENC::TENC() : FullBox("tenc") {
+
+    }
+
+    void TENC::ReadData(IParser *parser, BinaryStream &stream) {
+        FullBox::ReadData(parser, stream);
+        stream.ReadUInt8();
+        uint8_t pattern = stream.ReadUInt8();
+        impl->default_crypt_byte_block = GetVersion() > 0 ? static_cast<uint8_t>(pattern >> 4) : 0;
+        impl->default_skip_byte_block = GetVersion() > 0 ? static_cast<uint8_t>(pattern & 0x0F) : 0;
+        impl->default_is_protected = stream.ReadUInt8();
+        impl->default_per_sample_iv_size = stream.ReadUInt8();
+        impl->default_kid.resize(16);
+        stream.Read(impl->default_kid.data(), 16);
+        impl->default_constant_iv.clear();
+        if (impl->default_is_protected == 1 && impl->default_per_sample_iv_size == 0) {
+            impl->default_constant_iv.resize(stream.ReadUInt8());
+            stream.Read(impl->default_constant_iv.data(), impl->default_constant_iv.size());
+        }
+    }
+
+    void TENC::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+        sink.WriteUInt8(0);
+        sink.WriteUInt8(GetVersion() > 0 ? static_cast<uint8_t>((impl->default_crypt_byte_block << 4) | (impl->default_skip_byte_block & 0x0F)) : 0);
+        sink.WriteUInt8(impl->default_is_protected);
+        sink.WriteUInt8(impl->default_per_sample_iv_size);
+        sink.Write(impl->default_kid);
+        if (impl->default_is_protected == 1 && impl->default_per_sample_iv_size == 0) {
+            sink.WriteUInt8(static_cast<uint8_t>(impl->default_constant_iv.size()));
+            sink.Write(impl->default_constant_iv);
+        }
+    }
+
+    KeyValueStringList TENC::GetDisplayableProperties() const {
+        auto props = FullBox::GetDisplayableProperties();
+        props.push_back( { "DefaultCryptByteBlock", std::to_string( GetDefaultCryptByteBlock() ) } );
+        props.push_back( { "DefaultSkipByteBlock", std::to_string( GetDefaultSkipByteBlock() ) } );
+        props.push_back( { "DefaultIsProtected", std::to_string( IsProtected() ) } );
+        props.push_back( { "DefaultPerSampleIVSize", std::to_string( GetDefaultPerSampleIVSize() ) } );
+        props.push_back( { "DefaultKID", Utils::ToHexString( GetDefaultKID() ) } );
+        if (!impl->default_constant_iv.empty()) {
+            props.push_back( { "DefaultConstantIV", Utils::ToHexString( GetDefaultConstantIV() ) } );
+        }
+        return props;
+    }
+
+    void TENC::WriteDescription(std::ostream &os, std::size_t indentLevel) const {
+        FullBox::WriteDescription( os, indentLevel );
+    }
+
+    uint8_t TENC::GetDefaultCryptByteBlock() const {
+        return impl->default_crypt_byte_block;
+    }
+
+    uint8_t TENC::GetDefaultSkipByteBlock() const {
+        return impl->default_skip_byte_block;
+    }
+
+    bool TENC::IsProtected() const {
+        return impl->default_is_protected != 0;
+    }
+
+    uint8_t TENC::GetDefaultPerSampleIVSize() const {
+        return impl->default_per_sample_iv_size;
+    }
+
+    const std::vector<uint8_t>& TENC::GetDefaultKID() const {
+        return impl->default_kid;
+    }
+
+    const std::vector<uint8_t>& TENC::GetDefaultConstantIV() const {
+        return impl->default_constant_iv;
+    }
+}
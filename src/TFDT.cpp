@@ -0,0 +1,61 @@
+#include <ISOBMFF/TFDT.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/ContainerBox.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::TFDT >::IMPL
+{
+public:
+
+    IMPL()                  = default;
+    IMPL( const IMPL & o )  = default;
+    ~IMPL()                 = default;
+
+    uint64_t base_media_decode_time{0}; // 32bit for version 0
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::TFDT
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF{
+
+    TFDT::TFDT() : FullBox("tfdt") {
+
+    }
+
+    void TFDT::ReadData(IParser *parser, BinaryStream &stream) {
+        FullBox::ReadData(parser, stream);
+        if (GetVersion() == 1) {
+            SetBaseMediaDecodeTime( stream.ReadBigEndianUInt64() );
+        } else {
+            SetBaseMediaDecodeTime( stream.ReadBigEndianUInt32() );
+        }
+    }
+
+    void TFDT::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+        if (GetVersion() == 1) {
+            sink.WriteBigEndianUInt64(impl->base_media_decode_time);
+        } else {
+            sink.WriteBigEndianUInt32(static_cast<uint32_t>(impl->base_media_decode_time));
+        }
+    }
+
+    KeyValueStringList TFDT::GetDisplayableProperties() const {
+        auto props = FullBox::GetDisplayableProperties();
+        props.push_back( { "BaseMediaDecodeTime", std::to_string( GetBaseMediaDecodeTime() ) } );
+        return props;
+    }
+
+    void TFDT::WriteDescription(std::ostream &os, std::size_t indentLevel) const {
+        FullBox::WriteDescription( os, indentLevel );
+    }
+
+    uint64_t TFDT::GetBaseMediaDecodeTime() const {
+        return impl->base_media_decode_time;
+    }
+
+    void TFDT::SetBaseMediaDecodeTime(uint64_t value) {
+        impl->base_media_decode_time = value;
+    }
+}
@@ -1,4 +1,5 @@
 #include <ISOBMFF/TFHD.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 
 /**
  * <h1>4cc = "{@value #TYPE}"</h1>
@@ -43,6 +44,12 @@ namespace ISOBMFF {
 
     void TFHD::ReadData(IParser *parser, BinaryStream &stream) {
         FullBox::ReadData(parser, stream);
+        // Instances may be reused: optional fields must not keep previous values
+        impl->base_data_offset = 0;
+        impl->sample_description_index = 0;
+        impl->default_sample_duration = 0;
+        impl->default_sample_size = 0;
+        impl->default_sample_flags = 0;
         SetTrackID( stream.ReadBigEndianUInt32() );
 
         if (hasBaseDataOffset()) {
@@ -62,6 +69,27 @@ namespace ISOBMFF {
         }
     }
 
+    void TFHD::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+        sink.WriteBigEndianUInt32(impl->track_ID);
+
+        if (hasBaseDataOffset()) {
+            sink.WriteBigEndianUInt64(impl->base_data_offset);
+        }
+        if (hasSampleDescriptionIndex()) {
+            sink.WriteBigEndianUInt32(impl->sample_description_index);
+        }
+        if (hasDefaultSampleDuration()) {
+            sink.WriteBigEndianUInt32(impl->default_sample_duration);
+        }
+        if (hasDefaultSampleSize()) {
+            sink.WriteBigEndianUInt32(impl->default_sample_size);
+        }
+        if (hasDefaultSampleFlags()) {
+            sink.WriteBigEndianUInt32(impl->default_sample_flags);
+        }
+    }
+
     KeyValueStringList TFHD::GetDisplayableProperties() const {
         auto props = FullBox::GetDisplayableProperties();
         props.push_back( { "TrackID", std::to_string( GetTrackID()) } );
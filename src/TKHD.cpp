@@ -29,6 +29,8 @@
  */
 
 #include <ISOBMFF/TKHD.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <cstring>
 
 template<>
 class XS::PIMPL::Object< ISOBMFF::TKHD >::IMPL
@@ -101,6 +103,38 @@ namespace ISOBMFF
         this->SetHeight( stream.ReadBigEndianFixedPoint( 16, 16 ) );
     }
     
+    void TKHD::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        if( this->GetVersion() == 1 )
+        {
+            sink.WriteBigEndianUInt64( this->GetCreationTime() );
+            sink.WriteBigEndianUInt64( this->GetModificationTime() );
+            sink.WriteBigEndianUInt32( this->GetTrackID() );
+            sink.WriteBigEndianUInt32( this->impl->_reserved1 );
+            sink.WriteBigEndianUInt64( this->GetDuration() );
+        }
+        else
+        {
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetCreationTime() ) );
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetModificationTime() ) );
+            sink.WriteBigEndianUInt32( this->GetTrackID() );
+            sink.WriteBigEndianUInt32( this->impl->_reserved1 );
+            sink.WriteBigEndianUInt32( static_cast< uint32_t >( this->GetDuration() ) );
+        }
+        
+        sink.WriteBigEndianUInt32( this->impl->_reserved2[ 0 ] );
+        sink.WriteBigEndianUInt32( this->impl->_reserved2[ 1 ] );
+        sink.WriteBigEndianUInt16( this->GetLayer() );
+        sink.WriteBigEndianUInt16( this->GetAlternateGroup() );
+        sink.WriteBigEndianUInt16( this->GetVolume() );
+        sink.WriteBigEndianUInt16( this->impl->_reserved3 );
+        sink.WriteMatrix( this->GetMatrix() );
+        sink.WriteBigEndianFixedPoint( this->GetWidth(), 16, 16 );
+        sink.WriteBigEndianFixedPoint( this->GetHeight(), 16, 16 );
+    }
+    
     std::vector< std::pair< std::string, std::string > > TKHD::GetDisplayableProperties( void ) const
     {
         auto props( FullBox::GetDisplayableProperties() );
@@ -0,0 +1,137 @@
+/*!
+ * @file        TREX.cpp
+ */
+
+#include <ISOBMFF/TREX.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/Utils.hpp>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::TREX >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint32_t _trackID;
+        uint32_t _defaultSampleDescriptionIndex;
+        uint32_t _defaultSampleDuration;
+        uint32_t _defaultSampleSize;
+        uint32_t _defaultSampleFlags;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::TREX
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    TREX::TREX( void ): FullBox( "trex" )
+    {}
+    
+    void TREX::ReadData( IParser * parser, BinaryStream & stream )
+    {
+        FullBox::ReadData( parser, stream );
+        
+        this->SetTrackID( stream.ReadBigEndianUInt32() );
+        this->SetDefaultSampleDescriptionIndex( stream.ReadBigEndianUInt32() );
+        this->SetDefaultSampleDuration( stream.ReadBigEndianUInt32() );
+        this->SetDefaultSampleSize( stream.ReadBigEndianUInt32() );
+        this->SetDefaultSampleFlags( stream.ReadBigEndianUInt32() );
+    }
+    
+    void TREX::WriteData( BoxSink & sink ) const
+    {
+        FullBox::WriteData( sink );
+        
+        sink.WriteBigEndianUInt32( this->GetTrackID() );
+        sink.WriteBigEndianUInt32( this->GetDefaultSampleDescriptionIndex() );
+        sink.WriteBigEndianUInt32( this->GetDefaultSampleDuration() );
+        sink.WriteBigEndianUInt32( this->GetDefaultSampleSize() );
+        sink.WriteBigEndianUInt32( this->GetDefaultSampleFlags() );
+    }
+    
+    std::vector< std::pair< std::string, std::string > > TREX::GetDisplayableProperties( void ) const
+    {
+        auto props( FullBox::GetDisplayableProperties() );
+        
+        props.push_back( { "Track ID",                          std::to_string( this->GetTrackID() ) } );
+        props.push_back( { "Default sample description index",  std::to_string( this->GetDefaultSampleDescriptionIndex() ) } );
+        props.push_back( { "Default sample duration",           std::to_string( this->GetDefaultSampleDuration() ) } );
+        props.push_back( { "Default sample size",               std::to_string( this->GetDefaultSampleSize() ) } );
+        props.push_back( { "Default sample flags",              Utils::ToHexString( this->GetDefaultSampleFlags() ) } );
+        
+        return props;
+    }
+    
+    uint32_t TREX::GetTrackID( void ) const
+    {
+        return this->impl->_trackID;
+    }
+    
+    uint32_t TREX::GetDefaultSampleDescriptionIndex( void ) const
+    {
+        return this->impl->_defaultSampleDescriptionIndex;
+    }
+    
+    uint32_t TREX::GetDefaultSampleDuration( void ) const
+    {
+        return this->impl->_defaultSampleDuration;
+    }
+    
+    uint32_t TREX::GetDefaultSampleSize( void ) const
+    {
+        return this->impl->_defaultSampleSize;
+    }
+    
+    uint32_t TREX::GetDefaultSampleFlags( void ) const
+    {
+        return this->impl->_defaultSampleFlags;
+    }
+    
+    void TREX::SetTrackID( uint32_t value )
+    {
+        this->impl->_trackID = value;
+    }
+    
+    void TREX::SetDefaultSampleDescriptionIndex( uint32_t value )
+    {
+        this->impl->_defaultSampleDescriptionIndex = value;
+    }
+    
+    void TREX::SetDefaultSampleDuration( uint32_t value )
+    {
+        this->impl->_defaultSampleDuration = value;
+    }
+    
+    void TREX::SetDefaultSampleSize( uint32_t value )
+    {
+        this->impl->_defaultSampleSize = value;
+    }
+    
+    void TREX::SetDefaultSampleFlags( uint32_t value )
+    {
+        this->impl->_defaultSampleFlags = value;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::TREX >::IMPL::IMPL( void ):
+    _trackID( 0 ),
+    _defaultSampleDescriptionIndex( 1 ),
+    _defaultSampleDuration( 0 ),
+    _defaultSampleSize( 0 ),
+    _defaultSampleFlags( 0 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::TREX >::IMPL::IMPL( const IMPL & o ):
+    _trackID( o._trackID ),
+    _defaultSampleDescriptionIndex( o._defaultSampleDescriptionIndex ),
+    _defaultSampleDuration( o._defaultSampleDuration ),
+    _defaultSampleSize( o._defaultSampleSize ),
+    _defaultSampleFlags( o._defaultSampleFlags )
+{}
+
+XS::PIMPL::Object< ISOBMFF::TREX >::IMPL::~IMPL( void )
+{}
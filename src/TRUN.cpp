@@ -1,4 +1,5 @@
 #include <ISOBMFF/TRUN.hpp>
+#include <ISOBMFF/BoxSink.hpp>
 #include <ISOBMFF/ContainerBox.hpp>
 
 template<>
@@ -43,6 +44,10 @@ namespace ISOBMFF{
 
     void TRUN::ReadData(IParser *parser, BinaryStream &stream) {
         FullBox::ReadData(parser, stream);
+        // Instances may be reused: keep the capacity of the entries only
+        impl->data_offset = 0;
+        impl->first_sample_flags = 0;
+        impl->entries.clear();
         SetSampleCount( stream.ReadBigEndianUInt32() );
         if (hasDataOffset()) {
             impl->data_offset = stream.ReadBigEndianUInt32();
@@ -68,6 +73,31 @@ namespace ISOBMFF{
         }
     }
 
+    void TRUN::WriteData(BoxSink &sink) const {
+        FullBox::WriteData(sink);
+        sink.WriteBigEndianUInt32(static_cast<uint32_t>(impl->entries.size()));
+        if (hasDataOffset()) {
+            sink.WriteBigEndianUInt32(static_cast<uint32_t>(impl->data_offset));
+        }
+        if (hasFirstSampleFlags()) {
+            sink.WriteBigEndianUInt32(impl->first_sample_flags);
+        }
+        for (const SampleEntry &entry : impl->entries) {
+            if (hasSampleDuration()) {
+                sink.WriteBigEndianUInt32(entry.sample_duration);
+            }
+            if (hasSampleSize()) {
+                sink.WriteBigEndianUInt32(entry.sample_size);
+            }
+            if (hasSampleFlags()) {
+                sink.WriteBigEndianUInt32(entry.sample_flags);
+            }
+            if (hasSampleCTO()) {
+                sink.WriteBigEndianUInt32(entry.sample_composition_time_offset);
+            }
+        }
+    }
+
     KeyValueStringList TRUN::GetDisplayableProperties() const {
         auto props = FullBox::GetDisplayableProperties();
         props.push_back( { "SampleCount", std::to_string( GetSampleCount() ) } );
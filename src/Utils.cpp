@@ -118,5 +118,31 @@ namespace ISOBMFF
             
             return ss.str();
         }
+        
+        std::string ToHexString( const std::vector< uint8_t > & v )
+        {
+            std::stringstream ss;
+            
+            ss << "0x" << std::hex << std::uppercase << std::setfill( '0' );
+            
+            for( uint8_t u: v )
+            {
+                ss << std::setw( 2 ) << static_cast< uint32_t >( u );
+            }
+            
+            return ss.str();
+        }
+        
+        std::string FourCCToString( uint32_t fourcc )
+        {
+            std::string s( 4, ' ' );
+            
+            s[ 0 ] = static_cast< char >( ( fourcc >> 24 ) & 0xFF );
+            s[ 1 ] = static_cast< char >( ( fourcc >> 16 ) & 0xFF );
+            s[ 2 ] = static_cast< char >( ( fourcc >>  8 ) & 0xFF );
+            s[ 3 ] = static_cast< char >(   fourcc         & 0xFF );
+            
+            return s;
+        }
     }
 }
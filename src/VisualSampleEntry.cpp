@@ -0,0 +1,294 @@
+/*!
+ * @file        VisualSampleEntry.cpp
+ */
+
+#include <ISOBMFF/VisualSampleEntry.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <ISOBMFF/BinaryStream.hpp>
+#include <ISOBMFF/AVCC.hpp>
+#include <ISOBMFF/HVCC.hpp>
+#include <cstdio>
+#include <cstring>
+
+template<>
+class XS::PIMPL::Object< ISOBMFF::VisualSampleEntry >::IMPL
+{
+    public:
+        
+        IMPL( void );
+        IMPL( const IMPL & o );
+        ~IMPL( void );
+        
+        uint16_t    _width;
+        uint16_t    _height;
+        double      _horizontalResolution;
+        double      _verticalResolution;
+        uint16_t    _frameCount;
+        std::string _compressorName;
+        uint16_t    _depth;
+};
+
+#define XS_PIMPL_CLASS ISOBMFF::VisualSampleEntry
+#include <XS/PIMPL/Object-IMPL.hpp>
+
+namespace ISOBMFF
+{
+    static std::string AVCCodecs( const std::string & name, const AVCC & avcc )
+    {
+        char s[ 8 ];
+        
+        snprintf
+        (
+            s,
+            sizeof( s ),
+            "%02X%02X%02X",
+            static_cast< unsigned int >( avcc.GetAVCProfileIndication() ),
+            static_cast< unsigned int >( avcc.GetProfileCompatibility() ),
+            static_cast< unsigned int >( avcc.GetAVCLevelIndication() )
+        );
+        
+        return name + "." + s;
+    }
+    
+    static std::string HEVCCodecs( const std::string & name, const HVCC & hvcc )
+    {
+        std::string codecs( name + "." );
+        uint32_t    flags;
+        uint32_t    reversed;
+        uint64_t    constraints;
+        int         last;
+        char        s[ 16 ];
+        
+        if( hvcc.GetGeneralProfileSpace() > 0 )
+        {
+            codecs += static_cast< char >( 'A' + hvcc.GetGeneralProfileSpace() - 1 );
+        }
+        
+        codecs += std::to_string( hvcc.GetGeneralProfileIDC() );
+        
+        /* Compatibility flags are written in reverse bit order */
+        flags    = hvcc.GetGeneralProfileCompatibilityFlags();
+        reversed = 0;
+        
+        for( unsigned int i = 0; i < 32; i++ )
+        {
+            reversed = ( reversed << 1 ) | ( ( flags >> i ) & 1 );
+        }
+        
+        snprintf( s, sizeof( s ), ".%X", static_cast< unsigned int >( reversed ) );
+        
+        codecs += s;
+        codecs += ( hvcc.GetGeneralTierFlag() ) ? ".H" : ".L";
+        codecs += std::to_string( hvcc.GetGeneralLevelIDC() );
+        
+        /* Six constraint bytes, trailing zero bytes omitted */
+        constraints = hvcc.GetGeneralConstraintIndicatorFlags();
+        
+        for( last = 5; last >= 0; last-- )
+        {
+            if( ( ( constraints >> ( ( 5 - last ) * 8 ) ) & 0xFF ) != 0 )
+            {
+                break;
+            }
+        }
+        
+        for( int i = 0; i <= last; i++ )
+        {
+            snprintf( s, sizeof( s ), ".%02X", static_cast< unsigned int >( ( constraints >> ( ( 5 - i ) * 8 ) ) & 0xFF ) );
+            
+            codecs += s;
+        }
+        
+        return codecs;
+    }
+    
+    VisualSampleEntry::VisualSampleEntry( const std::string & name ): SampleEntry( name )
+    {}
+    
+    void VisualSampleEntry::ReadFields( IParser * parser, BinaryStream & stream )
+    {
+        uint8_t reserved[ 16 ];
+        uint8_t compressorName[ 32 ];
+        uint8_t length;
+        
+        ( void )parser;
+        
+        /* pre_defined, reserved and pre_defined[ 3 ] */
+        stream.Read( reserved, sizeof( reserved ) );
+        
+        this->SetWidth( stream.ReadBigEndianUInt16() );
+        this->SetHeight( stream.ReadBigEndianUInt16() );
+        this->SetHorizontalResolution( stream.ReadBigEndianFixedPoint( 16, 16 ) );
+        this->SetVerticalResolution( stream.ReadBigEndianFixedPoint( 16, 16 ) );
+        stream.ReadBigEndianUInt32();
+        this->SetFrameCount( stream.ReadBigEndianUInt16() );
+        
+        stream.Read( compressorName, sizeof( compressorName ) );
+        
+        length = ( compressorName[ 0 ] < 31 ) ? compressorName[ 0 ] : 31;
+        
+        this->SetCompressorName( std::string( reinterpret_cast< char * >( compressorName + 1 ), length ) );
+        this->SetDepth( stream.ReadBigEndianUInt16() );
+        
+        /* pre_defined = -1 */
+        stream.ReadBigEndianUInt16();
+    }
+    
+    void VisualSampleEntry::WriteFields( BoxSink & sink ) const
+    {
+        uint8_t     reserved[ 16 ] = {};
+        uint8_t     compressorName[ 32 ] = {};
+        std::string name( this->GetCompressorName() );
+        
+        sink.Write( reserved, sizeof( reserved ) );
+        sink.WriteBigEndianUInt16( this->GetWidth() );
+        sink.WriteBigEndianUInt16( this->GetHeight() );
+        sink.WriteBigEndianFixedPoint( this->GetHorizontalResolution(), 16, 16 );
+        sink.WriteBigEndianFixedPoint( this->GetVerticalResolution(), 16, 16 );
+        sink.WriteBigEndianUInt32( 0 );
+        sink.WriteBigEndianUInt16( this->GetFrameCount() );
+        
+        compressorName[ 0 ] = static_cast< uint8_t >( ( name.size() < 31 ) ? name.size() : 31 );
+        
+        memcpy( compressorName + 1, name.data(), compressorName[ 0 ] );
+        
+        sink.Write( compressorName, sizeof( compressorName ) );
+        sink.WriteBigEndianUInt16( this->GetDepth() );
+        sink.WriteBigEndianUInt16( 0xFFFF );
+    }
+    
+    std::string VisualSampleEntry::MakeCodecs( void ) const
+    {
+        std::string             name( this->GetCodingName() );
+        std::shared_ptr< AVCC > avcc;
+        std::shared_ptr< HVCC > hvcc;
+        
+        if( name == "avc1" || name == "avc3" )
+        {
+            avcc = this->GetTypedBox< AVCC >( "avcC" );
+            
+            if( avcc != nullptr )
+            {
+                return AVCCodecs( name, *( avcc ) );
+            }
+        }
+        else if( name == "hvc1" || name == "hev1" )
+        {
+            hvcc = this->GetTypedBox< HVCC >( "hvcC" );
+            
+            if( hvcc != nullptr )
+            {
+                return HEVCCodecs( name, *( hvcc ) );
+            }
+        }
+        
+        return name;
+    }
+    
+    std::vector< std::pair< std::string, std::string > > VisualSampleEntry::GetDisplayableProperties( void ) const
+    {
+        auto props( SampleEntry::GetDisplayableProperties() );
+        
+        props.push_back( { "Width",                 std::to_string( this->GetWidth() ) } );
+        props.push_back( { "Height",                std::to_string( this->GetHeight() ) } );
+        props.push_back( { "Horizontal resolution", std::to_string( this->GetHorizontalResolution() ) } );
+        props.push_back( { "Vertical resolution",   std::to_string( this->GetVerticalResolution() ) } );
+        props.push_back( { "Frame count",           std::to_string( this->GetFrameCount() ) } );
+        props.push_back( { "Compressor name",       this->GetCompressorName() } );
+        props.push_back( { "Depth",                 std::to_string( this->GetDepth() ) } );
+        
+        return props;
+    }
+    
+    uint16_t VisualSampleEntry::GetWidth( void ) const
+    {
+        return this->impl->_width;
+    }
+    
+    uint16_t VisualSampleEntry::GetHeight( void ) const
+    {
+        return this->impl->_height;
+    }
+    
+    double VisualSampleEntry::GetHorizontalResolution( void ) const
+    {
+        return this->impl->_horizontalResolution;
+    }
+    
+    double VisualSampleEntry::GetVerticalResolution( void ) const
+    {
+        return this->impl->_verticalResolution;
+    }
+    
+    uint16_t VisualSampleEntry::GetFrameCount( void ) const
+    {
+        return this->impl->_frameCount;
+    }
+    
+    std::string VisualSampleEntry::GetCompressorName( void ) const
+    {
+        return this->impl->_compressorName;
+    }
+    
+    uint16_t VisualSampleEntry::GetDepth( void ) const
+    {
+        return this->impl->_depth;
+    }
+    
+    void VisualSampleEntry::SetWidth( uint16_t value )
+    {
+        this->impl->_width = value;
+    }
+    
+    void VisualSampleEntry::SetHeight( uint16_t value )
+    {
+        this->impl->_height = value;
+    }
+    
+    void VisualSampleEntry::SetHorizontalResolution( double value )
+    {
+        this->impl->_horizontalResolution = value;
+    }
+    
+    void VisualSampleEntry::SetVerticalResolution( double value )
+    {
+        this->impl->_verticalResolution = value;
+    }
+    
+    void VisualSampleEntry::SetFrameCount( uint16_t value )
+    {
+        this->impl->_frameCount = value;
+    }
+    
+    void VisualSampleEntry::SetCompressorName( const std::string & value )
+    {
+        this->impl->_compressorName = value;
+    }
+    
+    void VisualSampleEntry::SetDepth( uint16_t value )
+    {
+        this->impl->_depth = value;
+    }
+}
+
+XS::PIMPL::Object< ISOBMFF::VisualSampleEntry >::IMPL::IMPL( void ):
+    _width( 0 ),
+    _height( 0 ),
+    _horizontalResolution( 72 ),
+    _verticalResolution( 72 ),
+    _frameCount( 1 ),
+    _depth( 0x18 )
+{}
+
+XS::PIMPL::Object< ISOBMFF::VisualSampleEntry >::IMPL::IMPL( const IMPL & o ):
+    _width( o._width ),
+    _height( o._height ),
+    _horizontalResolution( o._horizontalResolution ),
+    _verticalResolution( o._verticalResolution ),
+    _frameCount( o._frameCount ),
+    _compressorName( o._compressorName ),
+    _depth( o._depth )
+{}
+
+XS::PIMPL::Object< ISOBMFF::VisualSampleEntry >::IMPL::~IMPL( void )
+{}
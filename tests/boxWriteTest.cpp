@@ -0,0 +1,88 @@
+/**
+ *
+ * Regression test for the box writer: every top-level box of a parsed file, written back with Box::Write, must
+ * give the bytes of the source file, both from BoxSink::GetBytes and through BoxSink::WriteTo.
+ *
+ * Usage: boxWriteTest [file]
+ *
+ */
+
+#include <ISOBMFF/Parser.hpp>
+#include <ISOBMFF/File.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+std::vector<uint8_t> readFile(const std::string &path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+int main(int argc, char **argv) {
+    std::string filename = argc > 1 ? argv[1] : "tests/output.m4s";
+    std::vector<uint8_t> file = readFile(filename);
+    if (file.empty()) {
+        std::cerr << "Could not open file " + filename << '\n';
+        return 1;
+    }
+
+    try {
+        ISOBMFF::Parser parser;
+        parser.Parse(filename);
+
+        // Each box on its own, to name the first one that differs
+        ISOBMFF::BoxSink sink;
+        uint64_t offset = 0;
+        unsigned boxes = 0;
+        for (const auto &box : parser.GetFile()->GetBoxes()) {
+            ISOBMFF::BoxSink boxSink;
+            box->Write(boxSink);
+            auto bytes = boxSink.GetBytes();
+            if (bytes.size() > file.size() - offset || !std::equal(bytes.begin(), bytes.end(), file.begin() + offset)) {
+                std::cerr << "Box " << boxes << " (" << box->GetName() << ") at offset " << offset << ": "
+                          << bytes.size() << " bytes written differ from the source\n";
+                return 1;
+            }
+            offset += bytes.size();
+            boxes++;
+            box->Write(sink);
+        }
+        if (offset != file.size()) {
+            std::cerr << "Wrote " << offset << " bytes, expected " << file.size() << '\n';
+            return 1;
+        }
+
+        const std::string output = "tests/boxWrite.mp4";
+        int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << output << ": " << strerror(errno) << '\n';
+            return 1;
+        }
+        try {
+            sink.WriteTo(fd);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+        if (readFile(output) != file) {
+            std::cerr << "WriteTo output differs from the source\n";
+            return 1;
+        }
+
+        std::cout << boxes << " boxes, " << offset << " bytes in " << sink.GetSegments().size()
+                  << " segments, 0 failures\n";
+        return 0;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ *
+ * Regression test for Clipper: clipping a range out of a clip must give the same file as clipping the
+ * corresponding range out of the source directly, edit lists and keyframe alignment included.
+ *
+ * Usage: clipRoundTripTest [fragmented file]
+ *
+ */
+
+#include <Clipper.h>
+#include <Defragmenter.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+std::vector<uint8_t> readFile(const std::string &path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+// Writes output with the given writer, and returns the file
+std::vector<uint8_t> writeFile(const std::string &output, const std::function<void(int)> &write) {
+    int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(output + ": " + strerror(errno));
+    }
+    try {
+        write(fd);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    return readFile(output);
+}
+
+struct Case {
+    // Range of the first clip in the source, then range of the second clip in the first
+    double start;
+    double end;
+    double innerStart;
+    double innerEnd;
+};
+
+int main(int argc, char **argv) {
+    std::string filename = argc > 1 ? argv[1] : "tests/output.m4s";
+    const std::string directory = "tests/clipRoundTrip";
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << directory << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        const std::string progressive = directory + "/progressive.mp4";
+        writeFile(progressive, [&](int fd) { Defragmenter({filename}).write(fd); });
+
+        // Keyframe-aligned and unaligned starts, from the start of the source and from the middle of it
+        const std::vector<Case> cases = {
+            {2, 8, 1, 4},
+            {2.5, 9, 1.25, 4},
+            {0, 10, 3.3, 7.1},
+            {4.2, 20, 0.5, 2.5},
+            {1, 30, 10.7, 12.05},
+        };
+        unsigned failures = 0;
+        for (size_t i = 0; i < cases.size(); i++) {
+            const auto &c = cases[i];
+            const std::string prefix = directory + "/" + std::to_string(i);
+            writeFile(prefix + "_clip.mp4", [&](int fd) { Clipper(progressive, c.start, c.end).write(fd); });
+            auto twice = writeFile(prefix + "_twice.mp4", [&](int fd) {
+                Clipper(prefix + "_clip.mp4", c.innerStart, c.innerEnd).write(fd);
+            });
+            auto direct = writeFile(prefix + "_direct.mp4", [&](int fd) {
+                Clipper(progressive, c.start + c.innerStart, c.start + c.innerEnd).write(fd);
+            });
+            if (twice != direct) {
+                std::cerr << "Clip " << c.innerStart << "-" << c.innerEnd << " s of clip " << c.start << "-" << c.end
+                          << " s: " << twice.size() << " bytes, direct clip " << direct.size() << " bytes\n";
+                failures++;
+            }
+        }
+
+        std::cout << cases.size() << " clips, " << failures << " failures\n";
+        return failures == 0 ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,154 @@
+/**
+ *
+ * Regression test for Defragmenter with an init segment and media segments: segments that start with styp or
+ * directly with moof, with no ftyp or sidx box, must give the same progressive file as the fragmented file.
+ *
+ * Usage: defragmentSegmentsTest [file]
+ *
+ */
+
+#include <Defragmenter.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+struct TopLevelBox {
+    std::string type;
+    std::vector<uint8_t> data;     // Header included
+};
+
+std::vector<TopLevelBox> splitBoxes(const std::vector<uint8_t> &file) {
+    std::vector<TopLevelBox> boxes;
+    size_t offset = 0;
+    while (file.size() - offset >= 8) {
+        uint64_t size = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            size = (size << 8) | file[offset + i];
+        }
+        if (size == 1 && file.size() - offset >= 16) {
+            size = 0;
+            for (size_t i = 8; i < 16; ++i) {
+                size = (size << 8) | file[offset + i];
+            }
+        } else if (size == 0) {
+            size = file.size() - offset;
+        }
+        if (size < 8 || size > file.size() - offset) {
+            throw std::runtime_error("Invalid box size at offset " + std::to_string(offset));
+        }
+        const uint8_t *begin = file.data() + offset;
+        boxes.push_back({std::string(reinterpret_cast<const char*>(begin) + 4, 4),
+                         std::vector<uint8_t>(begin, begin + size)});
+        offset += static_cast<size_t>(size);
+    }
+    return boxes;
+}
+
+void writeFile(const std::string &path, const std::vector<uint8_t> &data) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!output) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+std::vector<uint8_t> readFile(const std::string &path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+// Defragments the inputs into output, and returns the progressive file
+std::vector<uint8_t> defragment(const std::vector<std::string> &inputs, const std::string &output,
+                                uint64_t &sampleCount) {
+    int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(output + ": " + strerror(errno));
+    }
+    try {
+        Defragmenter defragmenter(inputs);
+        defragmenter.write(fd);
+        sampleCount = defragmenter.sampleCount();
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    return readFile(output);
+}
+
+int main(int argc, char **argv) {
+    std::string filename = argc > 1 ? argv[1] : "tests/output.m4s";
+    std::vector<uint8_t> file = readFile(filename);
+    if (file.empty()) {
+        std::cerr << "Could not open file " + filename << '\n';
+        return 1;
+    }
+
+    const std::string directory = "tests/segments";
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << directory << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        // Init segment, and one media segment per moof and mdat pair, without the sidx boxes
+        std::vector<uint8_t> init;
+        std::vector<std::vector<uint8_t>> segments;
+        for (const auto &box : splitBoxes(file)) {
+            if (box.type == "ftyp" || box.type == "moov") {
+                init.insert(init.end(), box.data.begin(), box.data.end());
+            } else if (box.type == "moof") {
+                segments.emplace_back(box.data);
+            } else if (box.type == "mdat" && !segments.empty()) {
+                segments.back().insert(segments.back().end(), box.data.begin(), box.data.end());
+            }
+        }
+        if (segments.empty()) {
+            std::cerr << filename << " has no fragments\n";
+            return 1;
+        }
+
+        uint64_t referenceSamples = 0;
+        auto reference = defragment({filename}, directory + "/reference.mp4", referenceSamples);
+
+        // styp with major brand msdh, compatible brands msdh and msix
+        const std::vector<uint8_t> styp = {0, 0, 0, 24, 's', 't', 'y', 'p', 'm', 's', 'd', 'h', 0, 0, 0, 0,
+                                           'm', 's', 'd', 'h', 'm', 's', 'i', 'x'};
+        unsigned failures = 0;
+        for (bool withStyp : {true, false}) {
+            const std::string prefix = directory + (withStyp ? "/styp_" : "/bare_");
+            std::vector<std::string> inputs = {prefix + "init.mp4"};
+            writeFile(inputs.back(), init);
+            for (size_t i = 0; i < segments.size(); ++i) {
+                std::vector<uint8_t> segment = withStyp ? styp : std::vector<uint8_t>();
+                segment.insert(segment.end(), segments[i].begin(), segments[i].end());
+                inputs.push_back(prefix + std::to_string(i) + ".m4s");
+                writeFile(inputs.back(), segment);
+            }
+
+            uint64_t samples = 0;
+            auto output = defragment(inputs, prefix + "output.mp4", samples);
+            if (samples != referenceSamples || output != reference) {
+                std::cerr << (withStyp ? "styp" : "Bare") << " segments: " << samples << " samples, "
+                          << output.size() << " bytes, expected " << referenceSamples << " samples, "
+                          << reference.size() << " bytes\n";
+                ++failures;
+            }
+        }
+
+        std::cout << segments.size() << " segments, " << referenceSamples << " samples, " << failures
+                  << " failures\n";
+        return failures == 0 ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,147 @@
+/**
+ *
+ * Regression test for Faststart: a progressive file with moov moved after mdat, and its chunk offsets moved
+ * accordingly, must be rewritten to the bytes of the original file. A file that is already faststart must be
+ * copied unchanged.
+ *
+ * Usage: faststartRoundTripTest [fragmented file]
+ *
+ */
+
+#include <Defragmenter.h>
+#include <Faststart.h>
+#include <ISOBMFF/Parser.hpp>
+#include <ISOBMFF/File.hpp>
+#include <ISOBMFF/ContainerBox.hpp>
+#include <ISOBMFF/STCO.hpp>
+#include <ISOBMFF/BoxSink.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+std::vector<uint8_t> readFile(const std::string &path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+// Writes output with the given writer, and returns the file
+std::vector<uint8_t> writeFile(const std::string &output, const std::function<void(int)> &write) {
+    int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(output + ": " + strerror(errno));
+    }
+    try {
+        write(fd);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    return readFile(output);
+}
+
+// The boxes of a progressive file in their order, with moov last and the chunk offsets moved by its size
+std::vector<uint8_t> moveMoovLast(const std::string &path) {
+    auto file = readFile(path);
+    ISOBMFF::Parser parser;
+    parser.AddOption(ISOBMFF::Parser::Options::SkipMDATData);
+    parser.Parse(path);
+
+    std::shared_ptr<ISOBMFF::ContainerBox> moov;
+    uint64_t moovStart = 0;
+    uint64_t moovSize = 0;
+    uint64_t start = 0;
+    for (const auto &box : parser.GetFile()->GetBoxes()) {
+        const uint64_t end = box->GetDataOffset() + box->GetDataLength();
+        if (box->GetName() == "moov") {
+            moov = std::static_pointer_cast<ISOBMFF::ContainerBox>(box);
+            moovStart = start;
+            moovSize = end - start;
+        }
+        start = end;
+    }
+    if (!moov || start != file.size()) {
+        throw std::runtime_error("No moov box in " + path);
+    }
+
+    for (const auto &trakBox : moov->Container::GetBoxes("trak")) {
+        auto trak = std::static_pointer_cast<ISOBMFF::ContainerBox>(trakBox);
+        auto mdia = trak->GetTypedBox<ISOBMFF::ContainerBox>("mdia");
+        auto minf = mdia ? mdia->GetTypedBox<ISOBMFF::ContainerBox>("minf") : nullptr;
+        auto stbl = minf ? minf->GetTypedBox<ISOBMFF::ContainerBox>("stbl") : nullptr;
+        auto stco = stbl ? stbl->GetTypedBox<ISOBMFF::STCO>(stbl->GetBox("co64") ? "co64" : "stco") : nullptr;
+        if (!stco) {
+            throw std::runtime_error("trak box without stco or co64 box in " + path);
+        }
+        stco->AddToChunkOffsets(-static_cast<int64_t>(moovSize));
+    }
+
+    ISOBMFF::BoxSink sink;
+    moov->Write(sink);
+    auto moovBytes = sink.GetBytes();
+    if (moovBytes.size() != moovSize) {
+        throw std::runtime_error("moov box size changed when written back");
+    }
+    std::vector<uint8_t> moved(file.begin(), file.begin() + static_cast<ptrdiff_t>(moovStart));
+    moved.insert(moved.end(), file.begin() + static_cast<ptrdiff_t>(moovStart + moovSize), file.end());
+    moved.insert(moved.end(), moovBytes.begin(), moovBytes.end());
+    return moved;
+}
+
+int main(int argc, char **argv) {
+    std::string filename = argc > 1 ? argv[1] : "tests/output.m4s";
+    const std::string directory = "tests/faststartRoundTrip";
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << directory << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        const std::string progressive = directory + "/progressive.mp4";
+        const std::string moovLast = directory + "/moovLast.mp4";
+        auto reference = writeFile(progressive, [&](int fd) { Defragmenter({filename}).write(fd); });
+        auto moved = moveMoovLast(progressive);
+        writeFile(moovLast, [&](int fd) {
+            if (write(fd, moved.data(), moved.size()) != static_cast<ssize_t>(moved.size())) {
+                throw std::runtime_error(moovLast + ": " + strerror(errno));
+            }
+        });
+
+        unsigned failures = 0;
+        bool faststart = true;
+        auto output = writeFile(directory + "/faststart.mp4", [&](int fd) {
+            Faststart rewriter(moovLast);
+            faststart = rewriter.isFaststart();
+            rewriter.write(fd);
+        });
+        if (faststart || output != reference) {
+            std::cerr << "moov-last file: " << output.size() << " bytes, expected " << reference.size() << " bytes\n";
+            failures++;
+        }
+
+        auto copy = writeFile(directory + "/copy.mp4", [&](int fd) {
+            Faststart rewriter(progressive);
+            faststart = rewriter.isFaststart();
+            rewriter.write(fd);
+        });
+        if (!faststart || copy != reference) {
+            std::cerr << "Faststart file: " << copy.size() << " bytes, expected an unchanged copy\n";
+            failures++;
+        }
+
+        std::cout << reference.size() << " bytes, " << failures << " failures\n";
+        return failures == 0 ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
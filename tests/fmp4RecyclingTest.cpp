@@ -0,0 +1,94 @@
+/**
+ *
+ * Regression test for FMP4StreamParser box recycling: with small mdat boxes buffered and large ones passed
+ * through, a recycled mdat must never expose the payload of an earlier fragment.
+ *
+ * Usage: fmp4RecyclingTest [file]
+ *
+ */
+
+#include <FMP4StreamParser.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct Delivered {
+    std::vector<Frame> frames;
+    uint64_t mdatSize;
+};
+
+std::vector<Delivered> parse(const std::vector<uint8_t> &file, bool recycle, uint64_t passThroughThreshold) {
+    std::vector<Delivered> fragments;
+    FMP4StreamParser parser;
+    parser.setBoxRecycling(recycle);
+    parser.setMdatPassThroughThreshold(passThroughThreshold);
+    parser.onFragment([&fragments](const Fragment &fragment) {
+        fragments.push_back({fragment.getFrames(), fragment.mdat->GetDataLength()});
+    });
+    // Pushed in small chunks, so that passed-through payloads arrive in several parts
+    for (size_t offset = 0; offset < file.size(); offset += 4096) {
+        parser.parse(file.data() + offset, std::min<size_t>(4096, file.size() - offset));
+    }
+    parser.setEndOfStream();
+    return fragments;
+}
+
+bool sameFrames(const std::vector<Frame> &a, const std::vector<Frame> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].pts != b[i].pts || a[i].data != b[i].data) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    std::string filename = argc > 1 ? argv[1] : "tests/output.m4s";
+    std::ifstream input(filename, std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Could not open file " + filename << '\n';
+        return 1;
+    }
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    const uint64_t threshold = 31000;
+    auto reference = parse(file, false, UINT64_MAX);
+    auto recycled = parse(file, true, threshold);
+    if (reference.empty() || recycled.size() != reference.size()) {
+        std::cerr << "Expected " << reference.size() << " fragments, got " << recycled.size() << '\n';
+        return 1;
+    }
+
+    unsigned buffered = 0;
+    unsigned passedThrough = 0;
+    unsigned failures = 0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        if (reference[i].mdatSize > threshold) {
+            ++passedThrough;
+            if (!recycled[i].frames.empty() || recycled[i].mdatSize != 0) {
+                std::cerr << "Fragment " << i << ": passed-through mdat exposes " << recycled[i].frames.size()
+                          << " frames, " << recycled[i].mdatSize << " bytes\n";
+                ++failures;
+            }
+        } else {
+            ++buffered;
+            if (!sameFrames(recycled[i].frames, reference[i].frames)) {
+                std::cerr << "Fragment " << i << ": buffered mdat frames differ\n";
+                ++failures;
+            }
+        }
+    }
+    if (buffered == 0 || passedThrough == 0) {
+        std::cerr << "The input does not mix buffered and passed-through mdat boxes\n";
+        return 1;
+    }
+
+    std::cout << buffered << " buffered and " << passedThrough << " passed-through fragments, " << failures
+              << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+/**
+ *
+ * Regression test for Fragmenter and Defragmenter: a progressive file fragmented then defragmented again must
+ * keep every sample (timing, size, flags and payload), and fragmenting the result must give the same fragmented
+ * file as the first time.
+ *
+ * Usage: fragmentRoundTripTest [fragmented file]
+ *
+ */
+
+#include <Defragmenter.h>
+#include <Fragmenter.h>
+#include <ISOBMFF/Parser.hpp>
+#include <ISOBMFF/File.hpp>
+#include <ISOBMFF/ContainerBox.hpp>
+#include <ISOBMFF/SampleTable.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+std::vector<uint8_t> readFile(const std::string &path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+// Writes output with the given writer, and returns the file
+std::vector<uint8_t> writeFile(const std::string &output, const std::function<void(int)> &write) {
+    int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(output + ": " + strerror(errno));
+    }
+    try {
+        write(fd);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    return readFile(output);
+}
+
+std::vector<ISOBMFF::SampleTable> sampleTables(const std::string &path) {
+    ISOBMFF::Parser parser;
+    parser.AddOption(ISOBMFF::Parser::Options::SkipMDATData);
+    parser.Parse(path);
+    auto moov = parser.GetFile()->GetTypedBox<ISOBMFF::ContainerBox>("moov");
+    if (!moov) {
+        throw std::runtime_error("No moov box in " + path);
+    }
+    std::vector<ISOBMFF::SampleTable> tables;
+    for (const auto &trak : moov->Container::GetBoxes("trak")) {
+        tables.emplace_back(static_cast<const ISOBMFF::ContainerBox &>(*trak));
+    }
+    return tables;
+}
+
+// Number of samples that differ between two progressive files
+uint64_t compareSamples(const std::string &expectedPath, const std::string &actualPath, uint64_t &sampleCount) {
+    auto expectedFile = readFile(expectedPath);
+    auto actualFile = readFile(actualPath);
+    auto expected = sampleTables(expectedPath);
+    auto actual = sampleTables(actualPath);
+    if (expected.size() != actual.size()) {
+        std::cerr << actual.size() << " tracks, expected " << expected.size() << '\n';
+        return 1;
+    }
+
+    uint64_t differences = 0;
+    sampleCount = 0;
+    for (size_t t = 0; t < expected.size(); t++) {
+        const auto &a = expected[t].GetSamples();
+        const auto &b = actual[t].GetSamples();
+        if (a.size() != b.size() || expected[t].GetTrackID() != actual[t].GetTrackID()) {
+            std::cerr << "Track " << expected[t].GetTrackID() << ": " << b.size() << " samples, expected "
+                      << a.size() << '\n';
+            differences++;
+            continue;
+        }
+        for (size_t i = 0; i < a.size(); i++) {
+            const bool inFiles = a[i].offset + a[i].size <= expectedFile.size()
+                              && b[i].offset + b[i].size <= actualFile.size();
+            if (!inFiles || a[i].size != b[i].size || a[i].decodeTime != b[i].decodeTime
+                || a[i].duration != b[i].duration || a[i].compositionOffset != b[i].compositionOffset
+                || a[i].descriptionIndex != b[i].descriptionIndex || a[i].sync != b[i].sync
+                || !std::equal(expectedFile.begin() + static_cast<ptrdiff_t>(a[i].offset),
+                               expectedFile.begin() + static_cast<ptrdiff_t>(a[i].offset + a[i].size),
+                               actualFile.begin() + static_cast<ptrdiff_t>(b[i].offset))) {
+                if (differences == 0) {
+                    std::cerr << "Track " << expected[t].GetTrackID() << ": sample " << i << " differs\n";
+                }
+                differences++;
+            }
+        }
+        sampleCount += a.size();
+    }
+    return differences;
+}
+
+int main(int argc, char **argv) {
+    std::string filename = argc > 1 ? argv[1] : "tests/output.m4s";
+    const std::string directory = "tests/fragmentRoundTrip";
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << directory << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        const std::string progressive = directory + "/progressive.mp4";
+        const std::string fragmented = directory + "/fragmented.mp4";
+        const std::string defragmented = directory + "/defragmented.mp4";
+        const std::string refragmented = directory + "/refragmented.mp4";
+
+        writeFile(progressive, [&](int fd) { Defragmenter({filename}).write(fd); });
+        auto first = writeFile(fragmented, [&](int fd) { Fragmenter(progressive).write(fd); });
+        writeFile(defragmented, [&](int fd) { Defragmenter({fragmented}).write(fd); });
+        auto second = writeFile(refragmented, [&](int fd) { Fragmenter(defragmented).write(fd); });
+
+        uint64_t samples = 0;
+        uint64_t failures = compareSamples(progressive, defragmented, samples);
+        if (samples == 0) {
+            std::cerr << filename << " has no samples\n";
+            return 1;
+        }
+        if (second != first) {
+            std::cerr << "Fragmenting the defragmented file gives " << second.size() << " bytes, expected "
+                      << first.size() << " bytes\n";
+            failures++;
+        }
+
+        std::cout << samples << " samples, " << failures << " failures\n";
+        return failures == 0 ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,208 @@
+/**
+ *
+ * Regression test for NalConverter: the SSE2 and AVX2 start code scanners must find the same positions as the
+ * scalar one, and the in place conversions in both directions must give the same bytes as the copying ones, for
+ * 1, 2 and 4-byte lengths and Annex-B data that mixes 3 and 4-byte start codes, which moves NAL units both ways.
+ *
+ * Usage: nalConverterTest [samples per length size]
+ *
+ */
+
+#include <NalConverter.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct Sample {
+    std::vector<uint8_t> lengthPrefixed;
+    std::vector<uint8_t> annexB;        // 4-byte start codes, as toAnnexB() writes them
+    std::vector<uint8_t> mixedAnnexB;   // 3 and 4-byte start codes, leading and trailing zero bytes
+    bool mixedDisplacement;             // Whether converting mixedAnnexB in place moves units both ways
+};
+
+// A NAL unit payload with runs of zero bytes, escaped like emulation prevention does, and a last byte above zero
+std::vector<uint8_t> payload(std::mt19937 &random, size_t maxSize) {
+    std::uniform_int_distribution<size_t> sizes(1, maxSize);
+    std::uniform_int_distribution<int> bytes(0, 7);
+    size_t size = sizes(random);
+    std::vector<uint8_t> nal;
+    size_t zeros = 0;
+    while (nal.size() < size) {
+        uint8_t byte = static_cast<uint8_t>(bytes(random) < 3 ? 0 : random());
+        if (zeros == 2 && byte <= 3) {
+            nal.push_back(3);
+            zeros = 0;
+        }
+        nal.push_back(byte);
+        zeros = byte == 0 ? zeros + 1 : 0;
+    }
+    if (nal.back() == 0) {
+        nal.push_back(0x80);
+    }
+    return nal;
+}
+
+Sample makeSample(std::mt19937 &random, size_t lengthSize) {
+    std::uniform_int_distribution<int> units(1, 8);
+    std::uniform_int_distribution<int> coin(0, 1);
+    const size_t maxSize = lengthSize == 1 ? 200 : 600;
+    Sample sample;
+    size_t count = static_cast<size_t>(units(random));
+    size_t in = 0, out = 0;
+    bool forward = false, backward = false;
+    for (size_t i = 0; i < count; i++) {
+        auto nal = payload(random, maxSize);
+        for (size_t j = lengthSize; j > 0; j--) {
+            sample.lengthPrefixed.push_back(static_cast<uint8_t>(nal.size() >> (8 * (j - 1))));
+        }
+        sample.lengthPrefixed.insert(sample.lengthPrefixed.end(), nal.begin(), nal.end());
+        sample.annexB.insert(sample.annexB.end(), {0, 0, 0, 1});
+        sample.annexB.insert(sample.annexB.end(), nal.begin(), nal.end());
+
+        std::vector<uint8_t> startCode = {0, 0, 1};
+        if (coin(random)) {
+            startCode.insert(startCode.begin(), 0);
+        }
+        if (i == 0 && coin(random)) {
+            startCode.insert(startCode.begin(), 0);
+        }
+        sample.mixedAnnexB.insert(sample.mixedAnnexB.end(), startCode.begin(), startCode.end());
+        in += startCode.size();
+        out += lengthSize;
+        forward = forward || out > in;
+        backward = backward || out < in;
+        sample.mixedAnnexB.insert(sample.mixedAnnexB.end(), nal.begin(), nal.end());
+        in += nal.size();
+        out += nal.size();
+        if (coin(random) && coin(random)) {
+            sample.mixedAnnexB.push_back(0);
+            in++;
+        }
+    }
+    sample.mixedDisplacement = forward && backward;
+    return sample;
+}
+
+// Compares every scanner with the scalar one from each position of data, and returns the number of differences
+unsigned compareScanners(const std::vector<uint8_t> &data) {
+    unsigned failures = 0;
+    const uint8_t *end = data.data() + data.size();
+    for (auto scanner : {NalConverter::Scanner::Sse2, NalConverter::Scanner::Avx2}) {
+        if (!NalConverter::isSupported(scanner)) {
+            continue;
+        }
+        for (const uint8_t *begin = data.data(); begin <= end; begin++) {
+            const uint8_t *expected = NalConverter::findStartCode(begin, end, NalConverter::Scanner::Scalar);
+            const uint8_t *actual = NalConverter::findStartCode(begin, end, scanner);
+            if (actual != expected) {
+                if (failures == 0) {
+                    std::cerr << "Scanner " << static_cast<int>(scanner) << " from offset " << begin - data.data()
+                              << " of " << data.size() << ": " << actual - data.data() << ", expected "
+                              << expected - data.data() << '\n';
+                }
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+// Converts with both overloads, and returns false if they differ from the expected bytes
+bool checkConversion(const std::string &what, const std::vector<uint8_t> &input, const std::vector<uint8_t> &expected,
+                     size_t (NalConverter::*inPlace)(uint8_t*, size_t, size_t),
+                     size_t (NalConverter::*copying)(const uint8_t*, size_t, uint8_t*, size_t),
+                     NalConverter &converter) {
+    std::vector<uint8_t> copy(expected.size());
+    copy.resize((converter.*copying)(input.data(), input.size(), copy.data(), copy.size()));
+
+    // Room for the shift of mixed displacements: each unit moves by at most its start code size
+    std::vector<uint8_t> buffer(input);
+    buffer.resize(input.size() + expected.size());
+    buffer.resize((converter.*inPlace)(buffer.data(), input.size(), buffer.size()));
+
+    if (copy != expected || buffer != expected) {
+        std::cerr << what << ": " << copy.size() << " bytes copied, " << buffer.size() << " bytes in place, expected "
+                  << expected.size() << '\n';
+        return false;
+    }
+    return true;
+}
+
+// Parses a positive count, the whole argument
+bool parseCount(const char *argument, unsigned &value) {
+    char *end = nullptr;
+    errno = 0;
+    unsigned long parsed = std::strtoul(argument, &end, 10);
+    if (errno != 0 || end == argument || *end != '\0' || argument[0] == '-' || parsed == 0
+        || parsed > std::numeric_limits<unsigned>::max()) {
+        return false;
+    }
+    value = static_cast<unsigned>(parsed);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    unsigned count = 2000;
+    if (argc > 2 || (argc > 1 && !parseCount(argv[1], count))) {
+        std::cerr << "Usage: nalConverterTest [samples per length size]\n";
+        return 1;
+    }
+
+    try {
+        std::mt19937 random(42);
+        unsigned failures = 0;
+
+        // Start codes at every alignment and ends within the last SIMD block
+        std::vector<uint8_t> data(200);
+        for (unsigned round = 0; round < 200; round++) {
+            std::uniform_int_distribution<int> bytes(0, 5);
+            for (auto &byte : data) {
+                int value = bytes(random);
+                byte = static_cast<uint8_t>(value < 3 ? 0 : value == 3 ? 1 : random());
+            }
+            data.resize(round % 2 == 0 ? 200 : round);
+            failures += compareScanners(data);
+            data.resize(200);
+        }
+
+        unsigned samples = 0, mixed = 0;
+        for (size_t lengthSize : {1, 2, 4}) {
+            NalConverter converter(lengthSize);
+            for (unsigned i = 0; i < count; i++) {
+                Sample sample = makeSample(random, lengthSize);
+                if (i < 100) {
+                    failures += compareScanners(sample.mixedAnnexB);
+                }
+                const std::string what = std::to_string(lengthSize) + "-byte lengths, sample " + std::to_string(i);
+                if (!checkConversion(what + " to Annex-B", sample.lengthPrefixed, sample.annexB,
+                                     &NalConverter::toAnnexB, &NalConverter::toAnnexB, converter)
+                    || !checkConversion(what + " to length-prefixed", sample.annexB, sample.lengthPrefixed,
+                                        &NalConverter::toLengthPrefixed, &NalConverter::toLengthPrefixed, converter)
+                    || !checkConversion(what + " with mixed start codes to length-prefixed", sample.mixedAnnexB,
+                                        sample.lengthPrefixed, &NalConverter::toLengthPrefixed,
+                                        &NalConverter::toLengthPrefixed, converter)) {
+                    failures++;
+                }
+                mixed += sample.mixedDisplacement ? 1 : 0;
+                samples++;
+            }
+        }
+        if (mixed == 0) {
+            std::cerr << "No sample moves NAL units both ways\n";
+            failures++;
+        }
+
+        std::cout << samples << " samples, " << mixed << " with mixed displacements, " << failures << " failures\n";
+        return failures == 0 ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
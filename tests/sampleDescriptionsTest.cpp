@@ -0,0 +1,140 @@
+/**
+ *
+ * Regression test for the StopAfterMOOV parser option: the codecs strings of every track must be the ones of a full
+ * parse, for a fragmented file, a faststart file and a file with moov last, while the other stbl boxes and the boxes
+ * after moov are never read.
+ *
+ * Usage: sampleDescriptionsTest [fragmented file]
+ *
+ */
+
+#include <Defragmenter.h>
+#include <ISOBMFF/Parser.hpp>
+#include <ISOBMFF/File.hpp>
+#include <ISOBMFF/ContainerBox.hpp>
+#include <ISOBMFF/STSD.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+std::vector<uint8_t> readFile(const std::string &path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path, const std::vector<uint8_t> &data) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!output) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+std::shared_ptr<ISOBMFF::ContainerBox> child(const std::shared_ptr<ISOBMFF::ContainerBox> &box, const char *name) {
+    return box ? box->GetTypedBox<ISOBMFF::ContainerBox>(name) : nullptr;
+}
+
+// Codecs strings of each track, and the number of boxes of stbl, besides stsd, that were read
+std::vector<std::vector<std::string>> trackCodecs(const ISOBMFF::Parser &parser, unsigned &readBoxes) {
+    auto moov = parser.GetFile()->GetTypedBox<ISOBMFF::ContainerBox>("moov");
+    if (!moov) {
+        throw std::runtime_error("No moov box in " + parser.GetPath());
+    }
+    std::vector<std::vector<std::string>> codecs;
+    readBoxes = 0;
+    for (const auto &trak : moov->Container::GetBoxes("trak")) {
+        auto stbl = child(child(child(std::static_pointer_cast<ISOBMFF::ContainerBox>(trak), "mdia"), "minf"), "stbl");
+        auto stsd = stbl ? stbl->GetTypedBox<ISOBMFF::STSD>("stsd") : nullptr;
+        if (!stsd) {
+            throw std::runtime_error("trak box without stsd box in " + parser.GetPath());
+        }
+        codecs.push_back(stsd->GetCodecs());
+        for (const auto &box : stbl->GetBoxes()) {
+            readBoxes += box != stsd && !box->IsDataSkipped() ? 1 : 0;
+        }
+    }
+    return codecs;
+}
+
+// Moves moov after the other top-level boxes: the chunk offsets are wrong, but only stsd is read
+std::vector<uint8_t> moveMoovLast(const std::vector<uint8_t> &file) {
+    std::vector<uint8_t> others, moov;
+    size_t offset = 0;
+    while (file.size() - offset >= 8) {
+        size_t size = (static_cast<size_t>(file[offset]) << 24) | (static_cast<size_t>(file[offset + 1]) << 16)
+                    | (static_cast<size_t>(file[offset + 2]) << 8) | file[offset + 3];
+        if (size < 8 || size > file.size() - offset) {
+            throw std::runtime_error("Invalid box size at offset " + std::to_string(offset));
+        }
+        auto &target = std::memcmp(&file[offset + 4], "moov", 4) == 0 ? moov : others;
+        target.insert(target.end(), file.begin() + static_cast<ptrdiff_t>(offset),
+                      file.begin() + static_cast<ptrdiff_t>(offset + size));
+        offset += size;
+    }
+    others.insert(others.end(), moov.begin(), moov.end());
+    return others;
+}
+
+int main(int argc, char **argv) {
+    std::string filename = argc > 1 ? argv[1] : "tests/output.m4s";
+    const std::string directory = "tests/sampleDescriptions";
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << directory << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        const std::string progressive = directory + "/progressive.mp4";
+        const std::string moovLast = directory + "/moovLast.mp4";
+        int fd = open(progressive.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error(progressive + ": " + strerror(errno));
+        }
+        try {
+            Defragmenter({filename}).write(fd);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+        writeFile(moovLast, moveMoovLast(readFile(progressive)));
+
+        unsigned failures = 0;
+        size_t tracks = 0;
+        for (const auto &path : {filename, progressive, moovLast}) {
+            ISOBMFF::Parser full;
+            full.Parse(path);
+            ISOBMFF::Parser fast;
+            fast.AddOption(ISOBMFF::Parser::Options::StopAfterMOOV);
+            fast.Parse(path);
+
+            unsigned fullBoxes = 0, fastBoxes = 0;
+            auto expected = trackCodecs(full, fullBoxes);
+            auto actual = trackCodecs(fast, fastBoxes);
+            auto last = fast.GetFile()->GetBoxes().back();
+            if (actual != expected || expected.empty() || expected.front().empty()) {
+                std::cerr << path << ": codecs differ from a full parse\n";
+                failures++;
+            }
+            if (fastBoxes != 0 || fullBoxes == 0 || last->GetName() != "moov") {
+                std::cerr << path << ": " << fastBoxes << " stbl boxes read, last box " << last->GetName() << '\n';
+                failures++;
+            }
+            tracks += expected.size();
+        }
+
+        std::cout << tracks << " tracks, " << failures << " failures\n";
+        return failures == 0 ? 0 : 1;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
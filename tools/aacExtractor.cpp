@@ -1,49 +1,88 @@
 /**
  *
- * Example stream parsing of a fragmented MP4 file
+ * Example stream parsing of a fragmented MP4 file: extracts the AAC track as a single ADTS file.
+ * Fragments of other tracks are skipped; fragments with several tracks are rejected.
  *
  */
 
+#include <ADTSWriter.h>
 #include <FMP4StreamParser.h>
+#include <ISOBMFF/ContainerBox.hpp>
+#include <ISOBMFF/ESDS.hpp>
+#include <ISOBMFF/TFHD.hpp>
+#include <ISOBMFF/TKHD.hpp>
+#include <fcntl.h>
+#include <unistd.h>
 #include <fstream>
 #include <iostream>
-#include <ISOBMFF/MFHD.hpp>
-
-void writeToFile(const std::string &filenamePrefix, const std::vector<Frame> &frames) {
-    for(int i = 0; i < frames.size(); ++i) {
-        std::string filename = "/tmp/aacEx/" + filenamePrefix + "_frame_" + std::to_string(i);
-        std::cout << "Writing " << filename << "...\n";
-        std::ofstream out(filename);
-        out.write((char*)frames[i].data.data(), frames[i].data.size());
-        out.close();
-    }
-}
-
-void fragmentCallback(const Fragment &fragment) {
-    auto mfhd = fragment.moof->GetTypedBox<ISOBMFF::MFHD>("mfhd");
-    if (mfhd) {
-        auto sequenceNumber = mfhd->GetSequenceNumber();
-        writeToFile("frag_" + std::to_string(sequenceNumber), fragment.getFrames());
-    }
-}
-
-int main(int argc, char **argv) {
-    FMP4StreamParser parser;
-    parser.onFragment(fragmentCallback);
+#include <memory>
 
+int main() {
     std::string filename = "tests/output.m4s";
+    std::string outputName = "/tmp/aacEx/output.aac";
     std::ifstream input(filename);
     if (!input.is_open()) {
         std::cerr << "Could not open file " + filename << '\n';
         return 1;
     }
 
+    int fd = ::open(outputName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Could not create file " + outputName << '\n';
+        return 1;
+    }
+
+    std::unique_ptr<ADTSWriter> writer;
+    uint32_t trackID = 0;
+    uint32_t audioTrackID = 0;
+
+    FMP4StreamParser parser;
+    // The esds of the init segment gives the ADTS header, and the tkhd before it in the same trak the track
+    parser.setBoxAction("moov", FMP4StreamParser::BoxAction::Parse);
+    parser.on<ISOBMFF::TKHD>([&](const ISOBMFF::TKHD &tkhd) {
+        trackID = tkhd.GetTrackID();
+    });
+    parser.on<ISOBMFF::ESDS>([&](const ISOBMFF::ESDS &esds) {
+        if (!writer) {
+            writer.reset(new ADTSWriter(fd, esds));
+            audioTrackID = trackID;
+        }
+    });
+    parser.onFragment([&](const Fragment &fragment) {
+        if (!writer) {
+            return;
+        }
+        // Samples are only located for the first traf
+        if (fragment.moof->Container::GetBoxes("traf").size() != 1) {
+            throw std::runtime_error("Fragments with several tracks are not supported");
+        }
+        auto traf = fragment.moof->GetTypedBox<ISOBMFF::ContainerBox>("traf");
+        auto tfhd = traf->GetTypedBox<ISOBMFF::TFHD>("tfhd");
+        if (tfhd && tfhd->GetTrackID() == audioTrackID) {
+            writer->write(fragment.getFrames());
+        }
+    });
     parser.setInputStream(&input);
 
-    do {
-        parser.parse();
-    } while(!parser.isEOS());
+    try {
+        do {
+            parser.parse();
+        } while(!parser.isEOS());
 
+        if (!writer) {
+            std::cerr << "No AAC track in " + filename << '\n';
+            ::close(fd);
+            return 1;
+        }
+        writer->flush();
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        ::close(fd);
+        return 1;
+    }
+
+    std::cout << "Wrote " << writer->framesWritten() << " frames (" << writer->bytesWritten() << " bytes) to "
+              << outputName << " in " << writer->writeCalls() << " write calls\n";
+    ::close(fd);
     return 0;
 }
-
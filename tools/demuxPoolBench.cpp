@@ -0,0 +1,151 @@
+/**
+ *
+ * Benchmark for StreamDemuxPool.
+ * Pushes a fragmented MP4 file in chunks into many streams from several producer threads, checks that every
+ * stream produces output byte-identical to a single parser, and reports the per-stream queue depth and
+ * parse latency.
+ *
+ * Usage: demuxPoolBench [threads] [streams] [chunk bytes] [file]
+ *
+ */
+
+#include <StreamDemuxPool.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+void appendFrames(std::vector<uint8_t> &out, const Fragment &fragment) {
+    for(const auto &frame : fragment.getFrames()) {
+        for(int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(frame.pts) >> shift));
+        }
+        out.insert(out.end(), frame.data.begin(), frame.data.end());
+    }
+}
+
+template<class T>
+T percentile(std::vector<T> values, double p) {
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * static_cast<double>(values.size() - 1))];
+}
+
+// Parses a positive count, the whole argument
+bool parseCount(const char *argument, unsigned &value) {
+    char *end = nullptr;
+    errno = 0;
+    unsigned long parsed = std::strtoul(argument, &end, 10);
+    if (errno != 0 || end == argument || *end != '\0' || argument[0] == '-' || parsed == 0
+        || parsed > std::numeric_limits<unsigned>::max()) {
+        return false;
+    }
+    value = static_cast<unsigned>(parsed);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    unsigned threadCount = std::max(2u, std::thread::hardware_concurrency());
+    unsigned streamCount = 0;
+    unsigned chunkSize   = 4096;
+    if (argc > 5 || (argc > 1 && !parseCount(argv[1], threadCount)) || (argc > 2 && !parseCount(argv[2], streamCount))
+        || (argc > 3 && !parseCount(argv[3], chunkSize))) {
+        std::cerr << "Usage: demuxPoolBench [threads] [streams] [chunk bytes] [file]\n";
+        return 1;
+    }
+    if (argc <= 2) {
+        streamCount = threadCount * 64;
+    }
+    std::string filename = argc > 4 ? argv[4] : "tests/output.m4s";
+
+    std::ifstream input(filename, std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Could not open file " + filename << '\n';
+        return 1;
+    }
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    std::vector<uint8_t> reference;
+    {
+        FMP4StreamParser parser;
+        parser.onFragment([&reference](const Fragment &fragment) { appendFrames(reference, fragment); });
+        parser.parse(file.data(), file.size());
+        parser.setEndOfStream();
+    }
+
+    // Each stream's output is only written by the worker parsing it
+    std::vector<std::vector<uint8_t>> outputs(streamCount);
+    std::vector<StreamDemuxPool::StreamId> ids(streamCount);
+    std::vector<size_t> maxQueuedChunks(streamCount, 0);
+    std::vector<StreamDemuxPool::StreamStats> stats(streamCount);
+    std::atomic<unsigned> errors{0};
+
+    StreamDemuxPool pool(threadCount);
+    pool.onError([&errors](StreamDemuxPool::StreamId, const std::exception &error) {
+        std::cerr << error.what() << '\n';
+        ++errors;
+    });
+    for(unsigned i = 0; i < streamCount; ++i) {
+        auto &output = outputs[i];
+        ids[i] = pool.addStream([&output](FMP4StreamParser &parser) {
+            parser.onFragment([&output](const Fragment &fragment) { appendFrames(output, fragment); });
+        });
+    }
+
+    // Producers interleave the chunks of their streams, like live inputs arriving together
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for(unsigned p = 0; p < threadCount; ++p) {
+        producers.emplace_back([&, p]() {
+            for(size_t offset = 0; offset < file.size(); offset += chunkSize) {
+                size_t size = std::min<size_t>(chunkSize, file.size() - offset);
+                for(unsigned i = p; i < streamCount; i += threadCount) {
+                    pool.push(ids[i], file.data() + offset, size);
+                    maxQueuedChunks[i] = std::max(maxQueuedChunks[i], pool.getStreamStats(ids[i]).queuedChunks);
+                }
+            }
+        });
+    }
+    for(auto &producer : producers) {
+        producer.join();
+    }
+    pool.waitIdle();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Streams are removed once ended: read their statistics first
+    for(unsigned i = 0; i < streamCount; ++i) {
+        stats[i] = pool.getStreamStats(ids[i]);
+        pool.endStream(ids[i]);
+    }
+    pool.waitIdle();
+
+    unsigned mismatches = 0;
+    std::vector<size_t> depths;
+    std::vector<long long> latencies;
+    std::vector<long long> parseTimes;
+    for(unsigned i = 0; i < streamCount; ++i) {
+        mismatches += outputs[i] != reference ? 1 : 0;
+        depths.push_back(maxQueuedChunks[i]);
+        latencies.push_back(stats[i].maxLatency.count());
+        parseTimes.push_back(stats[i].maxParseTime.count());
+    }
+
+    double megabytes = static_cast<double>(file.size()) * streamCount / (1024.0 * 1024.0);
+    std::cout << streamCount << " streams on " << pool.threadCount() << " threads in " << elapsed.count() << " s ("
+              << megabytes / elapsed.count() << " MB/s), " << mismatches << " mismatches, " << errors << " errors\n"
+              << "max queued chunks per stream: median " << percentile(depths, 0.5) << ", p99 "
+              << percentile(depths, 0.99) << ", max " << percentile(depths, 1.0) << '\n'
+              << "max latency per stream (us): median " << percentile(latencies, 0.5) << ", p99 "
+              << percentile(latencies, 0.99) << ", max " << percentile(latencies, 1.0) << '\n'
+              << "max parse time per stream (us): median " << percentile(parseTimes, 0.5) << ", p99 "
+              << percentile(parseTimes, 0.99) << ", max " << percentile(parseTimes, 1.0) << '\n';
+
+    return mismatches == 0 && errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+/**
+ *
+ * Multi-threaded stress benchmark for FMP4StreamParser.
+ * Parses many in-memory copies of a fragmented MP4 file concurrently and checks that every
+ * parser produces output byte-identical to a single-threaded run.
+ *
+ * Usage: fmp4StressBench [threads] [copies] [file]
+ *
+ */
+
+#include <FMP4StreamParser.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Read-only istream buffer over memory shared by all threads
+struct MemoryBuffer : public std::streambuf {
+    MemoryBuffer(const char *data, size_t size) {
+        char *begin = const_cast<char *>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+void appendFrame(std::vector<uint8_t> &out, const Frame &frame) {
+    for(int shift = 56; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(frame.pts) >> shift));
+    }
+    out.insert(out.end(), frame.data.begin(), frame.data.end());
+}
+
+// Serializes every frame (pts + payload) of every fragment
+std::vector<uint8_t> parseCopy(const std::string &file) {
+    std::vector<uint8_t> out;
+    MemoryBuffer buffer(file.data(), file.size());
+    std::istream input(&buffer);
+
+    FMP4StreamParser parser;
+    parser.onFragment([&out](const Fragment &fragment) {
+        for(const auto &frame : fragment.getFrames()) {
+            appendFrame(out, frame);
+        }
+    });
+    parser.setInputStream(&input);
+    do {
+        parser.parse();
+    } while(!parser.isEOS());
+    return out;
+}
+
+// Parses a positive count, the whole argument
+bool parseCount(const char *argument, unsigned &value) {
+    char *end = nullptr;
+    errno = 0;
+    unsigned long parsed = std::strtoul(argument, &end, 10);
+    if (errno != 0 || end == argument || *end != '\0' || argument[0] == '-' || parsed == 0
+        || parsed > std::numeric_limits<unsigned>::max()) {
+        return false;
+    }
+    value = static_cast<unsigned>(parsed);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    unsigned threadCount = std::max(2u, std::thread::hardware_concurrency());
+    unsigned copies = 0;
+    if (argc > 4 || (argc > 1 && !parseCount(argv[1], threadCount)) || (argc > 2 && !parseCount(argv[2], copies))) {
+        std::cerr << "Usage: fmp4StressBench [threads] [copies] [file]\n";
+        return 1;
+    }
+    if (argc <= 2) {
+        copies = threadCount * 16;
+    }
+    std::string filename = argc > 3 ? argv[3] : "tests/output.m4s";
+
+    std::ifstream input(filename, std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "Could not open file " + filename << '\n';
+        return 1;
+    }
+    std::string file((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    auto reference = parseCopy(file);
+
+    std::atomic<unsigned> next{0};
+    std::atomic<unsigned> mismatches{0};
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&]() {
+            while(next++ < copies) {
+                if (parseCopy(file) != reference) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double megabytes = static_cast<double>(file.size()) * copies / (1024.0 * 1024.0);
+    std::cout << copies << " copies on " << threadCount << " threads in " << elapsed.count() << " s ("
+              << megabytes / elapsed.count() << " MB/s), " << mismatches << " mismatches\n";
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+/**
+ *
+ * Catalogues the HEIF/HEIC/AVIF images of a directory tree from their metadata only.
+ * Each file is parsed up to its meta box (usually a single read of the file head), never
+ * reading mdat, and one tab-separated record is printed per file:
+ *
+ *   path  width  height  rotation  colour  bits  thumbnail_offset  thumbnail_length
+ *
+ * Values refer to the primary item; missing values are printed as "-".
+ *
+ * Usage: heifScan <directory> [threads]
+ *
+ */
+
+#include <ISOBMFF.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+static bool isHeifFile(const fs::path &path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension == ".heic" || extension == ".heif" || extension == ".hif" || extension == ".avif";
+}
+
+static void appendField(std::string &out, const std::string &value) {
+    out += '\t';
+    out += value.empty() ? "-" : value;
+}
+
+static void appendRecord(std::string &out, ISOBMFF::Parser &parser, const std::string &path) {
+    parser.Parse(path);
+
+    auto meta = parser.GetFile()->GetTypedBox<ISOBMFF::META>("meta");
+    if (!meta) {
+        throw std::runtime_error("no meta box");
+    }
+    ISOBMFF::ItemIndex index(*meta);
+    const auto *primary = index.GetPrimaryItem();
+    if (!primary) {
+        throw std::runtime_error("no primary item");
+    }
+
+    out += path;
+    appendField(out, primary->ispe ? std::to_string(primary->ispe->GetDisplayWidth()) : "");
+    appendField(out, primary->ispe ? std::to_string(primary->ispe->GetDisplayHeight()) : "");
+    appendField(out, primary->irot ? std::to_string(primary->irot->GetAngle() * 90) : "");
+    appendField(out, primary->colr ? primary->colr->GetColourType() : "");
+    std::string bits;
+    if (primary->pixi) {
+        auto channels = primary->pixi->GetChannels();
+        if (!channels.empty()) {
+            bits = std::to_string(channels.front()->GetBitsPerChannel());
+        }
+    }
+    appendField(out, bits);
+
+    std::string thumbnailOffset, thumbnailLength;
+    const auto *thumbnail = primary->thumbnails.empty() ? nullptr : index.GetItem(primary->thumbnails.front());
+    if (thumbnail && thumbnail->location) {
+        auto ranges = parser.GetItemDataRanges(thumbnail->itemID);
+        if (!ranges.empty()) {
+            uint64_t length = 0;
+            for (const auto &range : ranges) {
+                length += range.second;
+            }
+            thumbnailOffset = std::to_string(ranges.front().first);
+            thumbnailLength = std::to_string(length);
+        }
+    }
+    appendField(out, thumbnailOffset);
+    appendField(out, thumbnailLength);
+    out += '\n';
+}
+
+// Parses a positive count, the whole argument
+bool parseCount(const char *argument, unsigned &value) {
+    char *end = nullptr;
+    errno = 0;
+    unsigned long parsed = std::strtoul(argument, &end, 10);
+    if (errno != 0 || end == argument || *end != '\0' || argument[0] == '-' || parsed == 0
+        || parsed > std::numeric_limits<unsigned>::max()) {
+        return false;
+    }
+    value = static_cast<unsigned>(parsed);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    if (argc < 2 || argc > 3 || (argc > 2 && !parseCount(argv[2], threadCount))) {
+        std::cerr << "Usage: heifScan <directory> [threads]\n";
+        return 1;
+    }
+    fs::path root(argv[1]);
+
+    std::vector<std::string> paths;
+    boost::system::error_code error;
+    for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+        if (fs::is_regular_file(it->status()) && isHeifFile(it->path())) {
+            paths.push_back(it->path().string());
+        }
+    }
+    if (error) {
+        std::cerr << root.string() << ": " << error.message() << '\n';
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> failures{0};
+    std::mutex outputMutex;
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&]() {
+            // One parser per thread: registering the box types is the expensive part of constructing one
+            ISOBMFF::Parser parser;
+            parser.AddOption(ISOBMFF::Parser::Options::StopAfterMETA);
+
+            std::string out;
+            std::string errors;
+            auto flush = [&]() {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cout << out;
+                std::cerr << errors;
+                out.clear();
+                errors.clear();
+            };
+
+            for (size_t n = next++; n < paths.size(); n = next++) {
+                size_t mark = out.size();
+                try {
+                    appendRecord(out, parser, paths[n]);
+                } catch (const std::exception &e) {
+                    out.resize(mark);
+                    errors += paths[n] + ": " + e.what() + '\n';
+                    ++failures;
+                }
+                if (out.size() > 64 * 1024) {
+                    flush();
+                }
+            }
+            flush();
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cerr << paths.size() << " files (" << failures << " failed) on " << threadCount << " threads in "
+              << elapsed.count() << " s (" << paths.size() / std::max(elapsed.count(), 1e-9) << " files/s)\n";
+    return failures == 0 ? 0 : 2;
+}
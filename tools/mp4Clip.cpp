@@ -0,0 +1,53 @@
+/**
+ *
+ * Cuts a time range out of a progressive MP4. Tracks start at the previous keyframe, and an edit list starts
+ * the presentation at the exact time. Only the samples of the range are copied, in the kernel.
+ *
+ * Usage: mp4Clip <input> <output|-> <start seconds> <end seconds>
+ *
+ */
+
+#include <Clipper.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+int main(int argc, char **argv) {
+    if (argc != 5) {
+        std::cerr << "Usage: mp4Clip <input> <output|-> <start seconds> <end seconds>\n";
+        return 1;
+    }
+    std::string input(argv[1]);
+    std::string output(argv[2]);
+    double start = std::stod(argv[3]);
+    double end = std::stod(argv[4]);
+
+    int fd = output == "-" ? STDOUT_FILENO : open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << output << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        auto begin = std::chrono::steady_clock::now();
+        Clipper clipper(input, start, end);
+        clipper.write(fd);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        std::cerr << "keyframe at " << clipper.keyframeTime() << " s, " << clipper.sampleCount() << " samples, "
+                  << clipper.bytesCopied() << " bytes copied in " << clipper.copyCalls() << " calls, "
+                  << elapsed.count() << " s\n";
+    } catch (const std::exception &e) {
+        std::cerr << input << ": " << e.what() << '\n';
+        return 2;
+    }
+    if (fd != STDOUT_FILENO && close(fd) != 0) {
+        std::cerr << output << ": " << strerror(errno) << '\n';
+        return 2;
+    }
+    return 0;
+}
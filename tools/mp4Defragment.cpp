@@ -0,0 +1,66 @@
+/**
+ *
+ * Converts fragmented MP4 to a progressive MP4 with moov first. The input is a fragmented file, or an
+ * init segment followed by media segments. Sample data is copied in the kernel, from the inputs to the output.
+ *
+ * Usage: mp4Defragment <input> <output|-> [segments...]
+ *
+ */
+
+#include <Defragmenter.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: mp4Defragment <input> <output|-> [segments...]\n";
+        return 1;
+    }
+    std::string output(argv[2]);
+    std::vector<std::string> inputs(argv + 3, argv + argc);
+    inputs.insert(inputs.begin(), argv[1]);
+
+    // Truncating the output would destroy the samples still to be copied
+    struct stat out;
+    if (output != "-" && stat(output.c_str(), &out) == 0) {
+        for (const auto &input : inputs) {
+            struct stat in;
+            if (stat(input.c_str(), &in) == 0 && in.st_dev == out.st_dev && in.st_ino == out.st_ino) {
+                std::cerr << output << ": the output cannot be an input file\n";
+                return 1;
+            }
+        }
+    }
+
+    int fd = output == "-" ? STDOUT_FILENO : open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << output << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        Defragmenter defragmenter(inputs);
+        defragmenter.write(fd);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cerr << defragmenter.fragmentCount() << " fragments, " << defragmenter.sampleCount() << " samples, "
+                  << defragmenter.bytesCopied() << " bytes copied in " << defragmenter.copyCalls() << " calls, "
+                  << elapsed.count() << " s\n";
+    } catch (const std::exception &e) {
+        std::cerr << inputs.front() << ": " << e.what() << '\n';
+        return 2;
+    }
+    if (fd != STDOUT_FILENO && close(fd) != 0) {
+        std::cerr << output << ": " << strerror(errno) << '\n';
+        return 2;
+    }
+    return 0;
+}
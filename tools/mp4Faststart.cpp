@@ -0,0 +1,65 @@
+/**
+ *
+ * Moves the moov box of a progressive MP4 before the media data, so that playback can start before the whole
+ * file is downloaded. Chunk offsets are patched, and the media data is copied in the kernel.
+ *
+ * Usage: mp4Faststart <input> <output|->
+ *
+ */
+
+#include <Faststart.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: mp4Faststart <input> <output|->\n";
+        return 1;
+    }
+    std::string input(argv[1]);
+    std::string output(argv[2]);
+
+    // Truncating the output would destroy the media data still to be copied
+    struct stat in, out;
+    if (output != "-" && stat(input.c_str(), &in) == 0 && stat(output.c_str(), &out) == 0
+        && in.st_dev == out.st_dev && in.st_ino == out.st_ino) {
+        std::cerr << output << ": the output cannot be the input file\n";
+        return 1;
+    }
+
+    int fd = output == "-" ? STDOUT_FILENO : open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << output << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        Faststart faststart(input);
+        faststart.write(fd);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (faststart.isFaststart()) {
+            std::cerr << "moov already before mdat, copied unchanged, ";
+        } else {
+            std::cerr << "moov of " << faststart.moovSize() << " bytes moved, " << faststart.promotedTables()
+                      << " stco tables promoted to co64, ";
+        }
+        std::cerr << faststart.bytesCopied() << " bytes copied in " << faststart.copyCalls() << " calls, "
+                  << elapsed.count() << " s\n";
+    } catch (const std::exception &e) {
+        std::cerr << input << ": " << e.what() << '\n';
+        return 2;
+    }
+    if (fd != STDOUT_FILENO && close(fd) != 0) {
+        std::cerr << output << ": " << strerror(errno) << '\n';
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ *
+ * Converts a progressive MP4 file to fragmented MP4: init segment, sidx, then keyframe-aligned
+ * moof+mdat fragments. Sample data is copied in the kernel, from the input file to the output.
+ *
+ * Usage: mp4Fragment <input> <output|-> [fragment seconds] [track ID]
+ *
+ */
+
+#include <Fragmenter.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: mp4Fragment <input> <output|-> [fragment seconds] [track ID]\n";
+        return 1;
+    }
+    Fragmenter::Options options;
+    if (argc > 3) {
+        options.fragmentDuration = std::stod(argv[3]);
+    }
+    if (argc > 4) {
+        options.trackID = static_cast<uint32_t>(std::stoul(argv[4]));
+    }
+
+    std::string output(argv[2]);
+    int fd = output == "-" ? STDOUT_FILENO : open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << output << ": " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        Fragmenter fragmenter(argv[1], options);
+        fragmenter.write(fd);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cerr << fragmenter.fragmentCount() << " fragments, " << fragmenter.bytesCopied() << " bytes copied in "
+                  << fragmenter.copyCalls() << " calls, " << elapsed.count() << " s\n";
+    } catch (const std::exception &e) {
+        std::cerr << argv[1] << ": " << e.what() << '\n';
+        return 2;
+    }
+    if (fd != STDOUT_FILENO && close(fd) != 0) {
+        std::cerr << output << ": " << strerror(errno) << '\n';
+        return 2;
+    }
+    return 0;
+}